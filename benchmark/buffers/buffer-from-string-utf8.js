@@ -0,0 +1,50 @@
+'use strict';
+
+const common = require('../common.js');
+const { TextEncoder } = require('util');
+
+const bench = common.createBenchmark(main, {
+  input: ['ascii', 'latin1', 'cjk'],
+  method: ['Buffer.from', 'TextEncoder.encode', 'TextEncoder.encodeInto'],
+  len: [16, 256, 4096, 65536],
+  n: [1e5]
+});
+
+const chars = {
+  ascii: 'hello world',
+  latin1: 'café naïveté',
+  cjk: '中文字符串測試'
+};
+
+function main({ input, method, len, n }) {
+  const str = chars[input].repeat(Math.ceil(len / chars[input].length))
+                          .slice(0, len);
+  const encoder = new TextEncoder();
+  const dest = new Uint8Array(len * 3);
+  let i;
+
+  switch (method) {
+    case '':
+      // Empty string falls through to next line as default, mostly for tests.
+    case 'Buffer.from':
+      bench.start();
+      for (i = 0; i < n; i++)
+        Buffer.from(str);
+      bench.end(n);
+      break;
+    case 'TextEncoder.encode':
+      bench.start();
+      for (i = 0; i < n; i++)
+        encoder.encode(str);
+      bench.end(n);
+      break;
+    case 'TextEncoder.encodeInto':
+      bench.start();
+      for (i = 0; i < n; i++)
+        encoder.encodeInto(str, dest);
+      bench.end(n);
+      break;
+    default:
+      throw new Error(`Unknown method "${method}"`);
+  }
+}
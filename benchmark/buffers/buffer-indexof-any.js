@@ -0,0 +1,32 @@
+'use strict';
+const common = require('../common.js');
+const fs = require('fs');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  needles: [2, 16],
+  method: ['indexOfAny', 'indexOf'],
+  n: [5e3]
+});
+
+function main({ n, needles, method }) {
+  const aliceBuffer = fs.readFileSync(
+    path.resolve(__dirname, '../fixtures/alice.html')
+  );
+  // Words that do not occur in the text, so that all of it is scanned.
+  const values = [];
+  for (let i = 0; i < needles; i++)
+    values.push(`Jabberwock${i}`);
+
+  bench.start();
+  if (method === 'indexOfAny') {
+    for (let i = 0; i < n; i++)
+      aliceBuffer.indexOfAny(values);
+  } else {
+    for (let i = 0; i < n; i++) {
+      for (let j = 0; j < values.length; j++)
+        aliceBuffer.indexOf(values[j]);
+    }
+  }
+  bench.end(n);
+}
@@ -0,0 +1,46 @@
+'use strict';
+const fs = require('fs');
+const path = require('path');
+const { pathToFileURL } = require('url');
+const common = require('../common.js');
+
+const tmpdir = require('../../test/common/tmpdir');
+const benchmarkDirectory = path.join(tmpdir.path, 'nodejs-benchmark-esm');
+
+const bench = common.createBenchmark(main, {
+  files: [3e3],
+  fanout: [2, 10],
+  size: [1024]
+}, {
+  flags: ['--experimental-modules', '--no-warnings']
+});
+
+// Writes a graph of `files` modules, in which every module imports `fanout`
+// others, and measures the time until the first module is evaluated, i.e.
+// the time that the loader takes to fetch, compile and link the graph.
+function main({ files, fanout, size }) {
+  tmpdir.refresh();
+  fs.mkdirSync(benchmarkDirectory);
+  const padding = `/* ${'x'.repeat(size)} */\n`;
+  for (let i = 0; i < files; i++) {
+    let source = padding;
+    for (let j = i * fanout + 1; j <= i * fanout + fanout && j < files; j++)
+      source += `import './${j}.mjs';\n`;
+    source += 'globalThis.onModuleEvaluated();\n';
+    fs.writeFileSync(path.join(benchmarkDirectory, `${i}.mjs`), source);
+  }
+
+  let evaluated = 0;
+  global.onModuleEvaluated = () => {
+    if (evaluated++ === 0)
+      bench.end(files);
+  };
+
+  const entry = pathToFileURL(path.join(benchmarkDirectory, '0.mjs'));
+  bench.start();
+  import(entry.href).then(() => {
+    if (evaluated !== files)
+      throw new Error(`expected ${files} modules, evaluated ${evaluated}`);
+    tmpdir.refresh();
+  });
+}
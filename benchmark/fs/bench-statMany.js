@@ -0,0 +1,41 @@
+'use strict';
+
+const common = require('../common');
+const fs = require('fs');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  n: [10],
+  paths: [1e4],
+  method: ['statMany', 'stat']
+});
+
+function main({ n, paths, method }) {
+  const dir = path.resolve(__dirname, '..');
+  const files = fs.readdirSync(dir).map((name) => path.join(dir, name));
+  const list = [];
+  for (let i = 0; i < paths; i++)
+    list.push(files[i % files.length]);
+
+  function statAll(cb) {
+    if (method === 'statMany') {
+      fs.statMany(list, cb);
+      return;
+    }
+    let pending = list.length;
+    for (const file of list) {
+      fs.stat(file, () => {
+        if (--pending === 0) cb();
+      });
+    }
+  }
+
+  bench.start();
+  (function r(cntr) {
+    if (cntr-- <= 0) {
+      bench.end(n * paths);
+      return;
+    }
+    statAll(() => r(cntr));
+  }(n));
+}
@@ -0,0 +1,51 @@
+'use strict';
+
+const common = require('../common');
+const fs = require('fs');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  n: [10],
+  dir: ['lib', 'test'],
+  walker: ['walk', 'readdir']
+});
+
+// Walks the tree with one fs.readdir() call per directory.
+function readdirRecursive(dir, cb) {
+  let pending = 1;
+  let entries = 0;
+  (function read(dir) {
+    fs.readdir(dir, { withFileTypes: true }, (err, dirents) => {
+      if (err) throw err;
+      for (const dirent of dirents) {
+        entries++;
+        if (dirent.isDirectory()) {
+          pending++;
+          read(path.join(dir, dirent.name));
+        }
+      }
+      if (--pending === 0) cb(entries);
+    });
+  })(dir);
+}
+
+async function walk(dir) {
+  let entries = 0;
+  for await (const batch of fs.walk(dir))
+    entries += batch.length;
+  return entries;
+}
+
+function main({ n, dir, walker }) {
+  const fullPath = path.resolve(__dirname, '../../', dir);
+  bench.start();
+  (function r(cntr) {
+    if (cntr-- <= 0)
+      return bench.end(n);
+    if (walker === 'walk') {
+      walk(fullPath).then(() => r(cntr));
+    } else {
+      readdirRecursive(fullPath, () => r(cntr));
+    }
+  }(n));
+}
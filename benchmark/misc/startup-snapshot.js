@@ -0,0 +1,30 @@
+'use strict';
+// Measures process startup with and without the embedded startup snapshot.
+const common = require('../common.js');
+const { spawnSync } = require('child_process');
+const path = require('path');
+
+const bench = common.createBenchmark(main, {
+  script: ['test/fixtures/semicolon', 'benchmark/fixtures/require-cachable'],
+  snapshot: ['on', 'off'],
+  n: [30]
+});
+
+function main({ script, snapshot, n }) {
+  const argv = [];
+  if (snapshot === 'off')
+    argv.push('--no-node-snapshot');
+  argv.push('--expose-internals', path.resolve(__dirname, '../../',
+                                               `${script}.js`));
+
+  bench.start();
+  for (let i = 0; i < n; i++) {
+    const child = spawnSync(process.execPath, argv);
+    if (child.status !== 0) {
+      console.error(`${child.stdout}`);
+      console.error(`${child.stderr}`);
+      throw new Error(`Error during node startup, exit code ${child.status}`);
+    }
+  }
+  bench.end(n);
+}
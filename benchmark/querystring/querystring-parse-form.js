@@ -0,0 +1,34 @@
+'use strict';
+const common = require('../common.js');
+const querystring = require('querystring');
+
+const bench = common.createBenchmark(main, {
+  encoding: ['none', 'percent', 'utf8'],
+  pairs: [10, 1000],
+  n: [1e4],
+});
+
+// Builds an application/x-www-form-urlencoded body like a browser would
+// submit for a form with `pairs` fields.
+function createBody(encoding, pairs) {
+  const value = {
+    none: 'the+quick+brown+fox',
+    percent: 'the%20quick%2Fbrown%26fox%3D',
+    utf8: '%E2%82%AC%20%C3%A9t%C3%A9+%F0%9F%98%80'
+  }[encoding];
+  const fields = [];
+  for (let i = 0; i < pairs; i++)
+    fields.push(`field${i}=${value}`);
+  return fields.join('&');
+}
+
+function main({ encoding, pairs, n }) {
+  const body = createBody(encoding, pairs);
+  const options = { maxKeys: 0 };
+  querystring.parse(body, null, null, options);
+
+  bench.start();
+  for (let i = 0; i < n; i += 1)
+    querystring.parse(body, null, null, options);
+  bench.end(n);
+}
@@ -0,0 +1,47 @@
+'use strict';
+const common = require('../common.js');
+const { URLSearchParams } = require('url');
+
+const bench = common.createBenchmark(main, {
+  operation: ['parse', 'serialize'],
+  encoding: ['none', 'percent', 'utf8'],
+  pairs: [10, 1000],
+  n: [1e4],
+});
+
+// Builds an application/x-www-form-urlencoded body like a browser would
+// submit for a form with `pairs` fields.
+function createBody(encoding, pairs) {
+  const value = {
+    none: 'the+quick+brown+fox',
+    percent: 'the%20quick%2Fbrown%26fox%3D',
+    utf8: '%E2%82%AC%20%C3%A9t%C3%A9+%F0%9F%98%80'
+  }[encoding];
+  const fields = [];
+  for (let i = 0; i < pairs; i++)
+    fields.push(`field${i}=${value}`);
+  return fields.join('&');
+}
+
+function main({ operation, encoding, pairs, n }) {
+  const body = createBody(encoding, pairs);
+  const params = new URLSearchParams(body);
+
+  switch (operation) {
+    case 'parse':
+      bench.start();
+      for (let i = 0; i < n; i += 1)
+        new URLSearchParams(body);
+      bench.end(n);
+      break;
+    case 'serialize':
+      params.toString();
+      bench.start();
+      for (let i = 0; i < n; i += 1)
+        params.toString();
+      bench.end(n);
+      break;
+    default:
+      throw new Error(`Unknown operation "${operation}"`);
+  }
+}
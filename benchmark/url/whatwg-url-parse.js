@@ -0,0 +1,72 @@
+'use strict';
+const common = require('../common.js');
+const URL = require('url').URL;
+const assert = require('assert');
+
+// Parses URLs and reads some of their properties, to measure the parser and
+// what the properties cost once the components are sliced out lazily.
+const bench = common.createBenchmark(main, {
+  type: common.urlDataTypes,
+  e: [1],
+  access: ['none', 'href', 'hostname', 'pathname', 'all']
+});
+
+const props = ['href', 'protocol', 'username', 'password', 'host', 'hostname',
+               'port', 'pathname', 'search', 'hash'];
+
+function parse(data) {
+  const len = data.length;
+  var result = new URL(data[0]);  // Avoid dead code elimination
+  bench.start();
+  for (let i = 0; i < len; ++i) {
+    result = new URL(data[i]);
+  }
+  bench.end(len);
+  return result;
+}
+
+function parseAndGet(data, prop) {
+  const len = data.length;
+  var result = new URL(data[0])[prop];  // Avoid dead code elimination
+  bench.start();
+  for (let i = 0; i < len; ++i) {
+    result = new URL(data[i])[prop];
+  }
+  bench.end(len);
+  return result;
+}
+
+function parseAndGetAll(data) {
+  const len = data.length;
+  var result = '';
+  bench.start();
+  for (let i = 0; i < len; ++i) {
+    const url = new URL(data[i]);
+    for (const prop of props)
+      result = url[prop];
+  }
+  bench.end(len);
+  return result;
+}
+
+function main({ e, type, access }) {
+  const data = common.bakeUrlData(type, +e, false, false);
+  var noDead;  // Avoid dead code elimination.
+  switch (access) {
+    case 'none':
+      noDead = parse(data);
+      break;
+    case 'href':
+    case 'hostname':
+    case 'pathname':
+      noDead = parseAndGet(data, access);
+      break;
+    case 'all':
+      noDead = parseAndGetAll(data);
+      break;
+    default:
+      throw new Error(`Unknown access ${access}`);
+  }
+
+  assert.ok(noDead !== undefined);
+}
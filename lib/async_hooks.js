@@ -16,6 +16,8 @@ const { registerDestroyHook } = internal_async_hooks;
 const {
   executionAsyncId,
   triggerAsyncId,
+  getAsyncContext,
+  setAsyncContext,
   // Private API
   getHookArrays,
   enableHooks,
@@ -27,6 +29,9 @@ const {
   emitBefore,
   emitAfter,
   emitDestroy,
+  captureAsyncContext,
+  enterAsyncContext,
+  exitAsyncContext,
   initHooksExist,
 } = internal_async_hooks;
 
@@ -151,6 +156,7 @@ class AsyncResource {
     const asyncId = newAsyncId();
     this[async_id_symbol] = asyncId;
     this[trigger_async_id_symbol] = triggerAsyncId;
+    captureAsyncContext(this);
 
     if (initHooksExist()) {
       emitInit(asyncId, type, triggerAsyncId, this);
@@ -167,11 +173,13 @@ class AsyncResource {
   runInAsyncScope(fn, thisArg, ...args) {
     const asyncId = this[async_id_symbol];
     emitBefore(asyncId, this[trigger_async_id_symbol]);
+    const prevAsyncContext = enterAsyncContext(this);
     try {
       if (thisArg === undefined)
         return fn(...args);
       return Reflect.apply(fn, thisArg, args);
     } finally {
+      exitAsyncContext(prevAsyncContext);
       emitAfter(asyncId);
     }
   }
@@ -201,6 +209,8 @@ module.exports = {
   createHook,
   executionAsyncId,
   triggerAsyncId,
+  getAsyncContext,
+  setAsyncContext,
   // Embedder API
   AsyncResource,
 };
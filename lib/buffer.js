@@ -27,8 +27,10 @@ const {
   byteLengthUtf8,
   compare: _compare,
   compareOffset,
+  createExternalString: _createExternalString,
   createFromString,
   fill: bindingFill,
+  indexOfAny: _indexOfAny,
   indexOfBuffer,
   indexOfNumber,
   indexOfString,
@@ -36,8 +38,7 @@ const {
   swap32: _swap32,
   swap64: _swap64,
   kMaxLength,
-  kStringMaxLength,
-  zeroFill: bindingZeroFill
+  kStringMaxLength
 } = internalBinding('buffer');
 const {
   getOwnNonIndexProperties,
@@ -82,7 +83,8 @@ const {
 
 const {
   FastBuffer,
-  addBufferPrototypeMethods
+  addBufferPrototypeMethods,
+  createUnsafeBuffer
 } = require('internal/buffer');
 
 FastBuffer.prototype.constructor = Buffer;
@@ -103,30 +105,16 @@ const constants = Object.defineProperties({}, {
 });
 
 Buffer.poolSize = 8 * 1024;
-let poolSize, poolOffset, allocPool;
-
-// A toggle used to access the zero fill setting of the array buffer allocator
-// in C++.
-// |zeroFill| can be undefined when running inside an isolate where we
-// do not own the ArrayBuffer allocator.  Zero fill is always on in that case.
-const zeroFill = bindingZeroFill || [0];
+let poolSize, poolOffset, allocPool, allocBuffer;
 
 const encodingsMap = Object.create(null);
 for (let i = 0; i < encodings.length; ++i)
   encodingsMap[encodings[i]] = i;
 
-function createUnsafeBuffer(size) {
-  zeroFill[0] = 0;
-  try {
-    return new FastBuffer(size);
-  } finally {
-    zeroFill[0] = 1;
-  }
-}
-
 function createPool() {
   poolSize = Buffer.poolSize;
-  allocPool = createUnsafeBuffer(poolSize).buffer;
+  allocBuffer = createUnsafeBuffer(poolSize);
+  allocPool = allocBuffer.buffer;
   poolOffset = 0;
 }
 createPool();
@@ -383,6 +371,21 @@ function allocate(size) {
 }
 
 function fromStringFast(string, ops) {
+  if (ops === encodingOps.utf8) {
+    // UTF-8 never takes more than three bytes per UTF-16 code unit. If that
+    // fits into the pool, the string is written in a single pass, without
+    // measuring it first.
+    const maxLength = string.length * 3;
+    if (maxLength < (Buffer.poolSize >>> 1) &&
+        maxLength <= (poolSize - poolOffset)) {
+      const actual = allocBuffer.utf8Write(string, poolOffset, maxLength);
+      const b = new FastBuffer(allocPool, poolOffset, actual);
+      poolOffset += actual;
+      alignPool();
+      return b;
+    }
+  }
+
   const length = ops.byteLength(string);
 
   if (length >= (Buffer.poolSize >>> 1))
@@ -923,6 +926,47 @@ Buffer.prototype.includes = function includes(val, byteOffset, encoding) {
   return this.indexOf(val, byteOffset, encoding) !== -1;
 };
 
+// Receives the index of the value that indexOfAny() found.
+const indexOfAnyResult = new Uint32Array(1);
+
+Buffer.prototype.indexOfAny = function indexOfAny(values, byteOffset,
+                                                  encoding) {
+  if (!Array.isArray(values))
+    throw new ERR_INVALID_ARG_TYPE('values', 'Array', values);
+  if (typeof byteOffset === 'string') {
+    encoding = byteOffset;
+    byteOffset = undefined;
+  } else if (byteOffset > 0x7fffffff) {
+    byteOffset = 0x7fffffff;
+  } else if (byteOffset < -0x80000000) {
+    byteOffset = -0x80000000;
+  }
+  // Coerce to Number. Values like null and [] become 0.
+  byteOffset = +byteOffset;
+  if (Number.isNaN(byteOffset))
+    byteOffset = 0;
+
+  const needles = new Array(values.length);
+  for (let i = 0; i < values.length; i++) {
+    const value = values[i];
+    if (typeof value === 'string') {
+      needles[i] = fromString(value, encoding);
+    } else if (isUint8Array(value)) {
+      needles[i] = value;
+    } else {
+      throw new ERR_INVALID_ARG_TYPE(
+        `values[${i}]`, ['string', 'Buffer', 'Uint8Array'], value
+      );
+    }
+  }
+
+  const index = _indexOfAny(this, needles, byteOffset, indexOfAnyResult);
+  return {
+    index,
+    valueIndex: index === -1 ? -1 : indexOfAnyResult[0]
+  };
+};
+
 // Usage:
 //    buffer.fill(number[, offset[, end]])
 //    buffer.fill(buffer[, offset[, end]])
@@ -1123,6 +1167,15 @@ Buffer.prototype.swap64 = function swap64() {
 
 Buffer.prototype.toLocaleString = Buffer.prototype.toString;
 
+// Returns a string that points into the memory of `buffer` instead of
+// copying it to the V8 heap.
+function createExternalString(buffer, start, end) {
+  if (!isUint8Array(buffer)) {
+    throw new ERR_INVALID_ARG_TYPE('buffer', ['Buffer', 'Uint8Array'], buffer);
+  }
+  return _createExternalString(buffer, start, end);
+}
+
 let transcode;
 if (internalBinding('config').hasIntl) {
   const {
@@ -1157,6 +1210,7 @@ if (internalBinding('config').hasIntl) {
 module.exports = {
   Buffer,
   SlowBuffer,
+  createExternalString,
   transcode,
   // Legacy
   kMaxLength,
@@ -265,6 +265,62 @@ function resolve(hostname, rrtype, callback) {
   }
 }
 
+// resolver.lookup(hostname[, options], callback) takes the same arguments
+// as dns.lookup(), so that it can be used as the `lookup` option of
+// net.connect() and http.request(). The name is looked up with A and AAAA
+// queries, which use the cache of a resolver that has one. If the queries
+// find no addresses or fail, the name is passed on to dns.lookup(), which
+// also consults the hosts file and other sources of the operating system.
+function resolverLookup(hostname, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = 0;
+  }
+  const hasOptionsObject = options !== null && typeof options === 'object';
+  const family = (hasOptionsObject ? options.family : options) >>> 0;
+  const all = hasOptionsObject && options.all === true;
+
+  // dns.lookup() validates the arguments, and answers empty hostnames and IP
+  // addresses without a query.
+  if (!hostname || typeof hostname !== 'string' || isIP(hostname) ||
+      typeof callback !== 'function' ||
+      (family !== 0 && family !== 4 && family !== 6)) {
+    return lookup(hostname, options, callback);
+  }
+
+  const families = family === 0 ? [4, 6] : [family];
+  const addresses = [];
+  const query = (index) => {
+    const queryFamily = families[index];
+    const resolve = queryFamily === 4 ? this.resolve4 : this.resolve6;
+    resolve.call(this, hostname, (err, result) => {
+      if (err && err.code === 'ECANCELLED')
+        return callback(err);
+      if (!err) {
+        for (const address of result)
+          addresses.push({ address, family: queryFamily });
+      }
+      if ((all || addresses.length === 0) && index + 1 < families.length)
+        return query(index + 1);
+
+      if (addresses.length === 0)
+        lookup(hostname, options, callback);
+      else if (all)
+        callback(null, addresses);
+      else
+        callback(null, addresses[0].address, addresses[0].family);
+    });
+  };
+  query(0);
+  return {};
+}
+
+Object.defineProperty(resolverLookup, 'name', { value: 'lookup' });
+Object.defineProperty(resolverLookup, customPromisifyArgs,
+                      { value: ['address', 'family'], enumerable: false });
+
+Resolver.prototype.lookup = resolverLookup;
+
 function defaultResolverSetServers(servers) {
   const resolver = new Resolver();
 
@@ -61,19 +61,23 @@ const internalUtil = require('internal/util');
 const {
   copyObject,
   Dirent,
+  getCopyTreeOptions,
   getDirents,
   getOptions,
   getValidatedPath,
+  getValidatedPaths,
   handleErrorFromBinding,
   nullCheck,
   preprocessSymlinkDestination,
   Stats,
+  StatsBatch,
   getStatsFromBinding,
   realpathCacheKey,
   stringToFlags,
   stringToSymlinkType,
   toUnixTimestamp,
   validateBufferArray,
+  validateCopyTreePaths,
   validateOffsetLengthRead,
   validateOffsetLengthWrite,
   validatePath,
@@ -82,8 +86,10 @@ const {
 } = require('internal/fs/utils');
 const {
   Dir,
+  DirWalker,
   opendir,
-  opendirSync
+  opendirSync,
+  walk
 } = require('internal/fs/dir');
 const {
   CHAR_FORWARD_SLASH,
@@ -104,7 +110,6 @@ let fs;
 // Lazy loaded
 let promises = null;
 let watchers;
-let ReadFileContext;
 let ReadStream;
 let WriteStream;
 let rimraf;
@@ -232,71 +237,19 @@ function existsSync(path) {
   return ctx.errno === undefined;
 }
 
-function readFileAfterOpen(err, fd) {
-  const context = this.context;
-
-  if (err) {
-    context.callback(err);
-    return;
-  }
-
-  context.fd = fd;
-
-  const req = new FSReqCallback();
-  req.oncomplete = readFileAfterStat;
-  req.context = context;
-  binding.fstat(fd, false, req);
-}
-
-function readFileAfterStat(err, stats) {
-  const context = this.context;
-
-  if (err)
-    return context.close(err);
-
-  const size = context.size = isFileType(stats, S_IFREG) ? stats[8] : 0;
-
-  if (size > kMaxLength) {
-    err = new ERR_FS_FILE_TOO_LARGE(size);
-    return context.close(err);
-  }
-
-  try {
-    if (size === 0) {
-      context.buffers = [];
-    } else {
-      context.buffer = Buffer.allocUnsafeSlow(size);
-    }
-  } catch (err) {
-    return context.close(err);
-  }
-  context.read();
-}
-
 function readFile(path, options, callback) {
   callback = maybeCallback(callback || options);
   options = getOptions(options, { flag: 'r' });
-  if (!ReadFileContext)
-    ReadFileContext = require('internal/fs/read_file_context');
-  const context = new ReadFileContext(callback, options.encoding);
-  context.isUserFd = isFd(path); // File descriptor ownership
-
+  // The whole file is opened, read and closed in one go on the threadpool.
   const req = new FSReqCallback();
-  req.context = context;
-  req.oncomplete = readFileAfterOpen;
+  req.oncomplete = callback;
 
-  if (context.isUserFd) {
-    process.nextTick(function tick() {
-      req.oncomplete(null, path);
-    });
-    return;
+  let flags = 0;
+  if (!isFd(path)) {
+    path = pathModule.toNamespacedPath(getValidatedPath(path));
+    flags = stringToFlags(options.flag || 'r');
   }
-
-  path = getValidatedPath(path);
-  binding.open(pathModule.toNamespacedPath(path),
-               stringToFlags(options.flag || 'r'),
-               0o666,
-               req);
+  binding.readFile(path, flags, options.encoding || undefined, req);
 }
 
 function tryStatSync(fd, isUserFd) {
@@ -906,6 +859,44 @@ function stat(path, options = { bigint: false }, callback) {
   binding.stat(pathModule.toNamespacedPath(path), options.bigint, req);
 }
 
+function statManyImpl(paths, bigint, followLinks, callback) {
+  if (paths.length === 0) {
+    const fields = bigint ? new BigUint64Array(0) : new Float64Array(0);
+    process.nextTick(callback, null,
+                     new StatsBatch(fields, new Int32Array(0)));
+    return;
+  }
+  const req = new FSReqCallback(bigint);
+  req.oncomplete = (err, result) => {
+    if (err) {
+      callback(err);
+      return;
+    }
+    callback(null, new StatsBatch(result[0], result[1]));
+  };
+  binding.statMany(paths, bigint, followLinks, req);
+}
+
+function lstatMany(paths, options = { bigint: false }, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = {};
+  }
+  callback = makeCallback(callback);
+  paths = getValidatedPaths(paths);
+  statManyImpl(paths, !!options.bigint, false, callback);
+}
+
+function statMany(paths, options = { bigint: false }, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = {};
+  }
+  callback = makeCallback(callback);
+  paths = getValidatedPaths(paths);
+  statManyImpl(paths, !!options.bigint, true, callback);
+}
+
 function fstatSync(fd, options = {}) {
   validateInt32(fd, 'fd', 0);
   const ctx = { fd };
@@ -1218,59 +1209,26 @@ function futimesSync(fd, atime, mtime) {
   handleErrorFromBinding(ctx);
 }
 
-function writeAll(fd, isUserFd, buffer, offset, length, position, callback) {
-  // write(fd, buffer, offset, length, position, callback)
-  fs.write(fd, buffer, offset, length, position, (writeErr, written) => {
-    if (writeErr) {
-      if (isUserFd) {
-        callback(writeErr);
-      } else {
-        fs.close(fd, function close() {
-          callback(writeErr);
-        });
-      }
-    } else if (written === length) {
-      if (isUserFd) {
-        callback(null);
-      } else {
-        fs.close(fd, callback);
-      }
-    } else {
-      offset += written;
-      length -= written;
-      if (position !== null) {
-        position += written;
-      }
-      writeAll(fd, isUserFd, buffer, offset, length, position, callback);
-    }
-  });
-}
-
 function writeFile(path, data, options, callback) {
   callback = maybeCallback(callback || options);
   options = getOptions(options, { encoding: 'utf8', mode: 0o666, flag: 'w' });
   const flag = options.flag || 'w';
+  const isUserFd = isFd(path); // File descriptor ownership
 
-  if (isFd(path)) {
-    writeFd(path, true);
-    return;
+  if (!isUserFd) {
+    path = pathModule.toNamespacedPath(getValidatedPath(path));
   }
-
-  fs.open(path, flag, options.mode, (openErr, fd) => {
-    if (openErr) {
-      callback(openErr);
-    } else {
-      writeFd(fd, false);
-    }
-  });
-
-  function writeFd(fd, isUserFd) {
-    const buffer = isArrayBufferView(data) ?
-      data : Buffer.from('' + data, options.encoding || 'utf8');
-    const position = (/a/.test(flag) || isUserFd) ? null : 0;
-
-    writeAll(fd, isUserFd, buffer, 0, buffer.byteLength, position, callback);
+  if (!isArrayBufferView(data)) {
+    data = '' + data;
   }
+  const mode = parseMode(options.mode, 'mode', 0o666);
+  const position = (/a/.test(flag) || isUserFd) ? -1 : 0;
+
+  // The whole file is opened, written and closed in one go on the threadpool.
+  const req = new FSReqCallback();
+  req.oncomplete = callback;
+  binding.writeFile(path, data, stringToFlags(flag), mode, position,
+                    options.encoding || 'utf8', req);
 }
 
 function writeFileSync(path, data, options) {
@@ -1338,14 +1296,17 @@ function watch(filename, options, listener) {
 
   if (options.persistent === undefined) options.persistent = true;
   if (options.recursive === undefined) options.recursive = false;
+  if (options.coalesceWindow === undefined) options.coalesceWindow = 0;
+  validateUint32(options.coalesceWindow, 'options.coalesceWindow');
 
   if (!watchers)
     watchers = require('internal/fs/watchers');
-  const watcher = new watchers.FSWatcher();
+  const watcher = new watchers.FSWatcher(options.recursive);
   watcher[watchers.kFSWatchStart](filename,
                                   options.persistent,
                                   options.recursive,
-                                  options.encoding);
+                                  options.encoding,
+                                  options.coalesceWindow);
 
   if (listener) {
     watcher.addListener('change', listener);
@@ -1806,6 +1767,31 @@ function copyFileSync(src, dest, flags) {
   handleErrorFromBinding(ctx);
 }
 
+function copyTree(src, dest, options, callback) {
+  if (typeof options === 'function') {
+    callback = options;
+    options = undefined;
+  }
+  callback = makeCallback(callback);
+
+  src = getValidatedPath(src, 'src');
+  dest = getValidatedPath(dest, 'dest');
+  validateCopyTreePaths(src, dest);
+  const { flags, onProgress } = getCopyTreeOptions(options);
+
+  const req = new FSReqCallback();
+  req.oncomplete = (err, counts) => {
+    if (err) {
+      callback(err);
+      return;
+    }
+    callback(null, { files: counts[0], directories: counts[1] });
+  };
+  binding.copyTree(pathModule.toNamespacedPath(src),
+                   pathModule.toNamespacedPath(dest),
+                   flags, onProgress, req);
+}
+
 function lazyLoadStreams() {
   if (!ReadStream) {
     ({ ReadStream, WriteStream } = require('internal/fs/streams'));
@@ -1836,6 +1822,7 @@ module.exports = fs = {
   closeSync,
   copyFile,
   copyFileSync,
+  copyTree,
   createReadStream,
   createWriteStream,
   exists,
@@ -1861,6 +1848,7 @@ module.exports = fs = {
   link,
   linkSync,
   lstat,
+  lstatMany,
   lstatSync,
   mkdir,
   mkdirSync,
@@ -1885,6 +1873,7 @@ module.exports = fs = {
   rmdir,
   rmdirSync,
   stat,
+  statMany,
   statSync,
   symlink,
   symlinkSync,
@@ -1895,6 +1884,7 @@ module.exports = fs = {
   unlinkSync,
   utimes,
   utimesSync,
+  walk,
   watch,
   watchFile,
   writeFile,
@@ -1904,6 +1894,7 @@ module.exports = fs = {
   writev,
   writevSync,
   Dir,
+  DirWalker,
   Dirent,
   Stats,
 
@@ -42,6 +42,12 @@ const { async_hook_fields, async_id_fields, owner_symbol } = async_wrap;
 const { pushAsyncIds: pushAsyncIds_, popAsyncIds: popAsyncIds_ } = async_wrap;
 // For performance reasons, only track Promises when a hook is enabled.
 const { enablePromiseHook, disablePromiseHook } = async_wrap;
+// The async context is stored natively so that it can be propagated through
+// AsyncWraps and Promises without calling into JS.
+const {
+  getAsyncContext: getAsyncContext_,
+  setAsyncContext: setAsyncContext_
+} = async_wrap;
 // Properties in active_hooks are used to keep track of the set of hooks being
 // executed in case another hook is enabled/disabled. The new set of hooks is
 // then restored once the active set of hooks is finished executing.
@@ -76,7 +82,8 @@ const { enqueueMicrotask } = internalBinding('task_queue');
 // for a given step, that step can bail out early.
 const { kInit, kBefore, kAfter, kDestroy, kTotals, kPromiseResolve,
         kCheck, kExecutionAsyncId, kAsyncIdCounter, kTriggerAsyncId,
-        kDefaultTriggerAsyncId, kStackLength } = async_wrap.constants;
+        kDefaultTriggerAsyncId, kStackLength,
+        kUsesAsyncContext } = async_wrap.constants;
 
 // Used in AsyncHook and AsyncResource.
 const async_id_symbol = Symbol('asyncId');
@@ -86,6 +93,9 @@ const before_symbol = Symbol('before');
 const after_symbol = Symbol('after');
 const destroy_symbol = Symbol('destroy');
 const promise_resolve_symbol = Symbol('promiseResolve');
+const async_context_symbol = Symbol('asyncContext');
+// Returned by enterAsyncContext() when there was nothing to enter.
+const kNoAsyncContext = Symbol('kNoAsyncContext');
 const emitBeforeNative = emitHookFactory(before_symbol, 'emitBeforeNative');
 const emitAfterNative = emitHookFactory(after_symbol, 'emitAfterNative');
 const emitDestroyNative = emitHookFactory(destroy_symbol, 'emitDestroyNative');
@@ -422,6 +432,46 @@ function popAsyncIds(asyncId) {
 }
 
 
+function getAsyncContext() {
+  if (async_hook_fields[kUsesAsyncContext] === 0)
+    return undefined;
+  return getAsyncContext_();
+}
+
+function setAsyncContext(value) {
+  setAsyncContext_(value);
+}
+
+// Used by resources that are implemented in JS, the native ones are handled by
+// AsyncWrap and InternalCallbackScope.
+function captureAsyncContext(resource) {
+  if (async_hook_fields[kUsesAsyncContext] !== 0)
+    resource[async_context_symbol] = getAsyncContext_();
+}
+
+function enterAsyncContext(resource) {
+  if (async_hook_fields[kUsesAsyncContext] === 0)
+    return kNoAsyncContext;
+  const prev = getAsyncContext_();
+  setAsyncContext_(resource[async_context_symbol]);
+  return prev;
+}
+
+// Same as enterAsyncContext(), for a context that was captured natively.
+function switchAsyncContext(value) {
+  if (async_hook_fields[kUsesAsyncContext] === 0)
+    return kNoAsyncContext;
+  const prev = getAsyncContext_();
+  setAsyncContext_(value);
+  return prev;
+}
+
+function exitAsyncContext(prev) {
+  if (prev !== kNoAsyncContext)
+    setAsyncContext_(prev);
+}
+
+
 function executionAsyncId() {
   return async_id_fields[kExecutionAsyncId];
 }
@@ -434,6 +484,8 @@ function triggerAsyncId() {
 module.exports = {
   executionAsyncId,
   triggerAsyncId,
+  getAsyncContext,
+  setAsyncContext,
   // Private API
   getHookArrays,
   symbols: {
@@ -461,6 +513,10 @@ module.exports = {
   emitBefore: emitBeforeScript,
   emitAfter: emitAfterScript,
   emitDestroy: emitDestroyScript,
+  captureAsyncContext,
+  enterAsyncContext,
+  switchAsyncContext,
+  exitAsyncContext,
   registerDestroyHook,
   nativeHooks: {
     init: emitInitNative,
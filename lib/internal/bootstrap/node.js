@@ -288,12 +288,18 @@ process.emitWarning = emitWarning;
 
   const { getTimerCallbacks } = require('internal/timers');
   const { setupTimers } = internalBinding('timers');
-  const { processImmediate, processTimers } = getTimerCallbacks(runNextTicks);
-  // Sets two per-Environment callbacks that will be run from libuv:
+  const {
+    processImmediate,
+    processTimers,
+    processWheelTimers
+  } = getTimerCallbacks(runNextTicks);
+  // Sets three per-Environment callbacks that will be run from libuv:
   // - processImmediate will be run in the callback of the per-Environment
   //   check handle.
   // - processTimers will be run in the callback of the per-Environment timer.
-  setupTimers(processImmediate, processTimers);
+  // - processWheelTimers will be run in the callback of the timer of the
+  //   per-Environment timing wheel.
+  setupTimers(processImmediate, processTimers, processWheelTimers);
   // Note: only after this point are the timers effective
 }
 
@@ -407,7 +413,6 @@ function setupBuffer() {
   // Only after this point can C++ use Buffer::New()
   bufferBinding.setBufferPrototype(Buffer.prototype);
   delete bufferBinding.setBufferPrototype;
-  delete bufferBinding.zeroFill;
 
   Object.defineProperty(global, 'Buffer', {
     value: Buffer,
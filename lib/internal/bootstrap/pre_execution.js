@@ -7,6 +7,8 @@ const { Buffer } = require('buffer');
 const { ERR_MANIFEST_ASSERT_INTEGRITY } = require('internal/errors').codes;
 
 function prepareMainThreadExecution(expandArgv1 = false) {
+  refreshRuntimeOptions();
+
   // Patch the process object with legacy properties and normalizations
   patchProcessObject(expandArgv1);
   setupTraceCategoryState();
@@ -63,6 +65,13 @@ function prepareMainThreadExecution(expandArgv1 = false) {
   initializeFrozenIntrinsics();
 }
 
+// The bootstrap may come from the startup snapshot, so the state that it
+// derived from the process that built the snapshot is computed again here.
+function refreshRuntimeOptions() {
+  require('internal/options').refreshOptions();
+  require('internal/buffer').reconnectZeroFillToggle();
+}
+
 function patchProcessObject(expandArgv1) {
   const {
     patchProcessObject: patchProcessObjectNative
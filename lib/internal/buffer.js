@@ -20,7 +20,8 @@ const {
   latin1Write,
   hexWrite,
   ucs2Write,
-  utf8Write
+  utf8Write,
+  getZeroFillToggle
 } = internalBinding('buffer');
 
 // Temporary buffers to convert numbers.
@@ -939,6 +940,24 @@ function writeFloatBackwards(val, offset = 0) {
 
 class FastBuffer extends Uint8Array {}
 
+// A toggle used to access the zero fill setting of the array buffer allocator
+// in C++. It is reconnected after the startup snapshot is deserialized, as the
+// toggle in the snapshot no longer points to the allocator.
+let zeroFill = getZeroFillToggle();
+
+function createUnsafeBuffer(size) {
+  zeroFill[0] = 0;
+  try {
+    return new FastBuffer(size);
+  } finally {
+    zeroFill[0] = 1;
+  }
+}
+
+function reconnectZeroFillToggle() {
+  zeroFill = getZeroFillToggle();
+}
+
 function addBufferPrototypeMethods(proto) {
   proto.readBigUInt64LE = readBigUInt64LE,
   proto.readBigUInt64BE = readBigUInt64BE,
@@ -1004,5 +1023,7 @@ function addBufferPrototypeMethods(proto) {
 
 module.exports = {
   FastBuffer,
-  addBufferPrototypeMethods
+  addBufferPrototypeMethods,
+  createUnsafeBuffer,
+  reconnectZeroFillToggle
 };
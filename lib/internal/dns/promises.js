@@ -4,6 +4,7 @@ const { Object } = primordials;
 
 const {
   bindDefaultResolver,
+  createChannel,
   Resolver: CallbackResolver,
   validateHints,
   emitInvalidHostnameWarning,
@@ -14,7 +15,6 @@ const { isIP, isLegalPort } = require('internal/net');
 const {
   getaddrinfo,
   getnameinfo,
-  ChannelWrap,
   GetAddrInfoReqWrap,
   GetNameInfoReqWrap,
   QueryReqWrap
@@ -212,11 +212,12 @@ const resolveMap = Object.create(null);
 
 // Resolver instances correspond 1:1 to c-ares channels.
 class Resolver {
-  constructor() {
-    this._handle = new ChannelWrap();
+  constructor(options) {
+    this._handle = createChannel(options);
   }
 }
 
+Resolver.prototype.getCacheStats = CallbackResolver.prototype.getCacheStats;
 Resolver.prototype.getServers = CallbackResolver.prototype.getServers;
 Resolver.prototype.setServers = CallbackResolver.prototype.setServers;
 Resolver.prototype.resolveAny = resolveMap.ANY = resolver('queryAny');
@@ -16,17 +16,55 @@ const {
   ERR_INVALID_IP_ADDRESS,
   ERR_INVALID_OPT_VALUE
 } = errors.codes;
+const { validateUint32 } = require('internal/validators');
+
+const kDefaultCacheOptions = {
+  maxTtl: 300,
+  negativeTtl: 5,
+  maxEntries: 1000
+};
+
+function createChannel(options) {
+  if (options === undefined)
+    return new ChannelWrap();
+  if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+
+  let { cache } = options;
+  if (cache === undefined || cache === false)
+    return new ChannelWrap();
+  if (cache === true)
+    cache = {};
+  else if (cache === null || typeof cache !== 'object')
+    throw new ERR_INVALID_ARG_TYPE('options.cache', ['boolean', 'Object'],
+                                   cache);
+
+  const {
+    maxTtl = kDefaultCacheOptions.maxTtl,
+    negativeTtl = kDefaultCacheOptions.negativeTtl,
+    maxEntries = kDefaultCacheOptions.maxEntries
+  } = cache;
+  validateUint32(maxTtl, 'options.cache.maxTtl');
+  validateUint32(negativeTtl, 'options.cache.negativeTtl');
+  validateUint32(maxEntries, 'options.cache.maxEntries', true);
+  return new ChannelWrap(maxTtl, negativeTtl, maxEntries);
+}
 
 // Resolver instances correspond 1:1 to c-ares channels.
 class Resolver {
-  constructor() {
-    this._handle = new ChannelWrap();
+  constructor(options) {
+    this._handle = createChannel(options);
   }
 
   cancel() {
     this._handle.cancel();
   }
 
+  getCacheStats() {
+    const [hits, misses, coalesced, entries] = this._handle.getCacheStats();
+    return { hits, misses, coalesced, entries };
+  }
+
   getServers() {
     return this._handle.getServers().map((val) => {
       if (!val[1] || val[1] === IANA_DNS_PORT)
@@ -156,6 +194,7 @@ function emitInvalidHostnameWarning(hostname) {
 
 module.exports = {
   bindDefaultResolver,
+  createChannel,
   getDefaultResolver,
   setDefaultResolver,
   validateHints,
@@ -2,12 +2,14 @@
 
 const { Object } = primordials;
 
+const { Buffer } = require('buffer');
 const pathModule = require('path');
 const binding = internalBinding('fs');
 const dirBinding = internalBinding('fs_dir');
 const {
   codes: {
     ERR_DIR_CLOSED,
+    ERR_INVALID_ARG_TYPE,
     ERR_INVALID_CALLBACK,
     ERR_MISSING_ARGS
   }
@@ -16,11 +18,18 @@ const {
 const { FSReqCallback } = binding;
 const internalUtil = require('internal/util');
 const {
+  Dirent,
   getDirent,
   getOptions,
+  getStatsFromBinding,
   getValidatedPath,
   handleErrorFromBinding
 } = require('internal/fs/utils');
+const {
+  validateInteger,
+  validateUint32
+} = require('internal/validators');
+const { kFsStatsFieldsNumber } = binding;
 
 const kDirHandle = Symbol('kDirHandle');
 const kDirPath = Symbol('kDirPath');
@@ -215,8 +224,188 @@ function opendirSync(path, options) {
   return new Dir(handle, path, options);
 }
 
+// Must match DirWalker::kEntryFields.
+const kWalkEntryFields = 4;
+const kMaxWalkDepth = 2 ** 32 - 1;
+
+const kWalkerHandle = Symbol('kWalkerHandle');
+const kWalkerPath = Symbol('kWalkerPath');
+const kWalkerClosed = Symbol('kWalkerClosed');
+const kWalkerReading = Symbol('kWalkerReading');
+const kWalkerEncoding = Symbol('kWalkerEncoding');
+
+function validateBatchIndex(batch, index) {
+  validateInteger(index, 'index', 0, batch.length - 1);
+  return index;
+}
+
+// The entries that a DirWalker read at once. Paths, types and stats are kept
+// in the buffers that the binding returned, and are only turned into strings
+// and objects on request.
+class DirWalkBatch {
+  constructor(paths, entries, stats, encoding) {
+    this.paths = paths;
+    this.entries = entries;
+    this.stats = stats;
+    this.encoding = encoding;
+  }
+
+  get length() {
+    return this.entries.length / kWalkEntryFields;
+  }
+
+  getPath(index) {
+    const i = validateBatchIndex(this, index);
+    const start = i === 0 ? 0 : this.entries[(i - 1) * kWalkEntryFields];
+    const end = this.entries[i * kWalkEntryFields];
+    if (this.encoding === 'buffer')
+      return this.paths.slice(start, end);
+    return this.paths.toString(this.encoding, start, end);
+  }
+
+  getDirent(index) {
+    const i = validateBatchIndex(this, index);
+    return new Dirent(this.getPath(i), this.entries[i * kWalkEntryFields + 1]);
+  }
+
+  getDepth(index) {
+    return this.entries[validateBatchIndex(this, index) * kWalkEntryFields + 2];
+  }
+
+  getError(index) {
+    return this.entries[validateBatchIndex(this, index) * kWalkEntryFields + 3];
+  }
+
+  getStats(index) {
+    const i = validateBatchIndex(this, index);
+    if (this.stats === undefined ||
+        this.entries[i * kWalkEntryFields + 3] !== 0) {
+      return undefined;
+    }
+    return getStatsFromBinding(this.stats, i * kFsStatsFieldsNumber);
+  }
+}
+
+class DirWalker {
+  constructor(handle, path, encoding) {
+    if (handle == null) throw new ERR_MISSING_ARGS('handle');
+    this[kWalkerHandle] = handle;
+    this[kWalkerPath] = path;
+    this[kWalkerEncoding] = encoding;
+    this[kWalkerClosed] = false;
+    this[kWalkerReading] = false;
+  }
+
+  get path() {
+    return this[kWalkerPath];
+  }
+
+  read() {
+    if (this[kWalkerClosed] === true) {
+      throw new ERR_DIR_CLOSED();
+    }
+    // Batches are read one at a time, in order.
+    if (this[kWalkerReading] !== false) {
+      return this[kWalkerReading].then(() => this.read());
+    }
+
+    const promise = new Promise((resolve, reject) => {
+      const req = new FSReqCallback();
+      req.oncomplete = (err, result) => {
+        this[kWalkerReading] = false;
+        if (err) {
+          reject(err);
+        } else if (result === null) {
+          resolve(null);
+        } else {
+          resolve(new DirWalkBatch(result[0], result[1], result[2],
+                                   this[kWalkerEncoding]));
+        }
+      };
+      this[kWalkerHandle].read(req);
+    });
+    this[kWalkerReading] = promise.then(() => {}, () => {});
+    return promise;
+  }
+
+  close() {
+    if (this[kWalkerClosed] === true) {
+      throw new ERR_DIR_CLOSED();
+    }
+    this[kWalkerClosed] = true;
+    const closeHandle = () => this[kWalkerHandle].close();
+    if (this[kWalkerReading] !== false)
+      return this[kWalkerReading].then(closeHandle);
+    closeHandle();
+    return Promise.resolve();
+  }
+
+  async* entries() {
+    try {
+      while (true) {
+        const batch = await this.read();
+        if (batch === null) {
+          break;
+        }
+        yield batch;
+      }
+    } finally {
+      if (this[kWalkerClosed] === false)
+        await this.close();
+    }
+  }
+}
+
+Object.defineProperty(DirWalker.prototype, Symbol.asyncIterator, {
+  value: DirWalker.prototype.entries,
+  enumerable: false,
+  writable: true,
+  configurable: true,
+});
+
+function walk(path, options) {
+  path = getValidatedPath(path);
+  options = {
+    encoding: 'utf8',
+    maxDepth: Infinity,
+    stats: false,
+    skip: [],
+    batchSize: 1024,
+    ...getOptions(options, {})
+  };
+
+  let maxDepth = options.maxDepth;
+  if (maxDepth === Infinity) {
+    maxDepth = kMaxWalkDepth;
+  } else {
+    validateUint32(maxDepth, 'options.maxDepth');
+  }
+  if (!Array.isArray(options.skip)) {
+    throw new ERR_INVALID_ARG_TYPE('options.skip', 'Array', options.skip);
+  }
+  for (let i = 0; i < options.skip.length; i++) {
+    const name = options.skip[i];
+    if (typeof name !== 'string' && !Buffer.isBuffer(name)) {
+      throw new ERR_INVALID_ARG_TYPE(`options.skip[${i}]`,
+                                     ['string', 'Buffer'], name);
+    }
+  }
+  validateUint32(options.batchSize, 'options.batchSize', true);
+
+  const handle = new dirBinding.DirWalker(
+    pathModule.toNamespacedPath(path),
+    maxDepth,
+    options.stats === true,
+    options.skip,
+    options.batchSize
+  );
+  return new DirWalker(handle, path, options.encoding);
+}
+
 module.exports = {
   Dir,
+  DirWalker,
   opendir,
-  opendirSync
+  opendirSync,
+  walk
 };
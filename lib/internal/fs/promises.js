@@ -21,16 +21,20 @@ const { isUint8Array } = require('internal/util/types');
 const { rimrafPromises } = require('internal/fs/rimraf');
 const {
   copyObject,
+  getCopyTreeOptions,
   getDirents,
   getOptions,
   getStatsFromBinding,
   getValidatedPath,
+  getValidatedPaths,
   nullCheck,
   preprocessSymlinkDestination,
   stringToFlags,
+  StatsBatch,
   stringToSymlinkType,
   toUnixTimestamp,
   validateBufferArray,
+  validateCopyTreePaths,
   validateOffsetLengthRead,
   validateOffsetLengthWrite,
   validateRmdirOptions,
@@ -140,8 +144,7 @@ async function writeFileHandle(filehandle, data, options) {
   } while (remaining > 0);
 }
 
-// Note: This is different from kReadFileBufferLength used for non-promisified
-// fs.readFile.
+// Only used for FileHandles, paths are read by a single native request.
 const kReadFileMaxChunkSize = 16384;
 
 async function readFileHandle(filehandle, options) {
@@ -200,6 +203,17 @@ async function copyFile(src, dest, flags) {
 
 // Note that unlike fs.open() which uses numeric file descriptors,
 // fsPromises.open() uses the fs.FileHandle class.
+async function copyTree(src, dest, options) {
+  src = getValidatedPath(src, 'src');
+  dest = getValidatedPath(dest, 'dest');
+  validateCopyTreePaths(src, dest);
+  const { flags, onProgress } = getCopyTreeOptions(options);
+  const counts = await binding.copyTree(pathModule.toNamespacedPath(src),
+                                        pathModule.toNamespacedPath(dest),
+                                        flags, onProgress, kUsePromises);
+  return { files: counts[0], directories: counts[1] };
+}
+
 async function open(path, flags, mode) {
   path = getValidatedPath(path);
   if (arguments.length < 2) flags = 'r';
@@ -390,6 +404,26 @@ async function stat(path, options = { bigint: false }) {
   return getStatsFromBinding(result);
 }
 
+async function statManyImpl(paths, bigint, followLinks) {
+  if (paths.length === 0) {
+    const fields = bigint ? new BigUint64Array(0) : new Float64Array(0);
+    return new StatsBatch(fields, new Int32Array(0));
+  }
+  const result = await binding.statMany(paths, bigint, followLinks,
+                                        kUsePromises);
+  return new StatsBatch(result[0], result[1]);
+}
+
+async function lstatMany(paths, options = { bigint: false }) {
+  paths = getValidatedPaths(paths);
+  return statManyImpl(paths, !!options.bigint, false);
+}
+
+async function statMany(paths, options = { bigint: false }) {
+  paths = getValidatedPaths(paths);
+  return statManyImpl(paths, !!options.bigint, true);
+}
+
 async function link(existingPath, newPath) {
   existingPath = getValidatedPath(existingPath, 'existingPath');
   newPath = getValidatedPath(newPath, 'newPath');
@@ -484,8 +518,14 @@ async function writeFile(path, data, options) {
   if (path instanceof FileHandle)
     return writeFileHandle(path, data, options);
 
-  const fd = await open(path, flag, options.mode);
-  return writeFileHandle(fd, data, options).finally(fd.close.bind(fd));
+  path = getValidatedPath(path);
+  if (!isUint8Array(data))
+    data = '' + data;
+  // The whole file is opened, written and closed in one go on the threadpool.
+  return binding.writeFile(pathModule.toNamespacedPath(path), data,
+                           stringToFlags(flag),
+                           parseMode(options.mode, 'mode', 0o666), -1,
+                           options.encoding || 'utf8', kUsePromises);
 }
 
 async function appendFile(path, data, options) {
@@ -502,14 +542,18 @@ async function readFile(path, options) {
   if (path instanceof FileHandle)
     return readFileHandle(path, options);
 
-  const fd = await open(path, flag, 0o666);
-  return readFileHandle(fd, options).finally(fd.close.bind(fd));
+  path = getValidatedPath(path);
+  // The whole file is opened, read and closed in one go on the threadpool.
+  return binding.readFile(pathModule.toNamespacedPath(path),
+                          stringToFlags(flag), options.encoding || undefined,
+                          kUsePromises);
 }
 
 module.exports = {
   exports: {
     access,
     copyFile,
+    copyTree,
     open,
     opendir: promisify(opendir),
     rename,
@@ -520,7 +564,9 @@ module.exports = {
     readlink,
     symlink,
     lstat,
+    lstatMany,
     stat,
+    statMany,
     link,
     unlink,
     chmod,
@@ -4,6 +4,7 @@
 // - All code related to the glob dependency has been removed.
 // - Bring your own custom fs module is not currently supported.
 // - Some basic code cleanup.
+// - Trees are removed by a single native request outside of Windows.
 'use strict';
 const {
   chmod,
@@ -20,6 +21,7 @@ const {
   unlinkSync
 } = require('fs');
 const { join } = require('path');
+const { FSReqCallback, rmTree } = internalBinding('fs');
 const { setTimeout } = require('timers');
 const notEmptyErrorCodes = new Set(['ENOTEMPTY', 'EEXIST', 'EPERM']);
 const isWindows = process.platform === 'win32';
@@ -31,17 +33,19 @@ const numRetries = isWindows ? 100 : 1;
 function rimraf(path, options, callback) {
   let timeout = 0;  // For EMFILE handling.
   let busyTries = 0;
+  // Windows needs the EPERM workarounds below.
+  const impl = isWindows ? _rimraf : _rimrafNative;
 
-  _rimraf(path, options, function CB(err) {
+  impl(path, options, function CB(err) {
     if (err) {
       if ((err.code === 'EBUSY' || err.code === 'ENOTEMPTY' ||
            err.code === 'EPERM') && busyTries < options.maxBusyTries) {
         busyTries++;
-        return setTimeout(_rimraf, busyTries * 100, path, options, CB);
+        return setTimeout(impl, busyTries * 100, path, options, CB);
       }
 
       if (err.code === 'EMFILE' && timeout < options.emfileWait)
-        return setTimeout(_rimraf, timeout++, path, options, CB);
+        return setTimeout(impl, timeout++, path, options, CB);
 
       // The file is already gone.
       if (err.code === 'ENOENT')
@@ -53,6 +57,14 @@ function rimraf(path, options, callback) {
 }
 
 
+// Removes the whole tree on the threadpool, see RmTreeJob in node_file.cc.
+function _rimrafNative(path, options, callback) {
+  const req = new FSReqCallback();
+  req.oncomplete = (err) => callback(err);
+  rmTree(path, req);
+}
+
+
 function _rimraf(path, options, callback) {
   // SunOS lets the root user unlink directories. Use lstat here to make sure
   // it's not a directory.
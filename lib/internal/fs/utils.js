@@ -59,6 +59,7 @@ const {
   UV_DIRENT_CHAR,
   UV_DIRENT_BLOCK
 } = internalBinding('constants').fs;
+const { kFsStatsFieldsNumber } = internalBinding('fs');
 
 const isWindows = process.platform === 'win32';
 
@@ -419,6 +420,28 @@ function getStatsFromBinding(stats, offset = 0) {
   );
 }
 
+// The result of fs.statMany() and fs.lstatMany(). The stats of all paths are
+// kept in one typed array, and Stats objects are only created on request.
+class StatsBatch {
+  constructor(fields, errors) {
+    this.fields = fields;
+    this.errors = errors;
+  }
+
+  get length() {
+    return this.errors.length;
+  }
+
+  getStats(index) {
+    validateUint32(index, 'index');
+    if (index >= this.length)
+      throw new ERR_OUT_OF_RANGE('index', `< ${this.length}`, index);
+    if (this.errors[index] !== 0)
+      return undefined;
+    return getStatsFromBinding(this.fields, index * kFsStatsFieldsNumber);
+  }
+}
+
 function stringToFlags(flags) {
   if (typeof flags === 'number') {
     return flags;
@@ -537,6 +560,49 @@ const getValidatedPath = hideStackFrames((fileURLOrPath, propName = 'path') => {
   return path;
 });
 
+const getValidatedPaths = hideStackFrames((paths, propName = 'paths') => {
+  if (!Array.isArray(paths))
+    throw new ERR_INVALID_ARG_TYPE(propName, 'Array', paths);
+  const result = new Array(paths.length);
+  for (let i = 0; i < paths.length; i++) {
+    result[i] = pathModule.toNamespacedPath(
+      getValidatedPath(paths[i], `${propName}[${i}]`));
+  }
+  return result;
+});
+
+// A tree cannot be copied into itself.
+const validateCopyTreePaths = hideStackFrames((src, dest) => {
+  const relative = pathModule.relative(pathModule.resolve(`${src}`),
+                                       pathModule.resolve(`${dest}`));
+  if (relative === '' ||
+      (relative !== '..' && !relative.startsWith(`..${pathModule.sep}`) &&
+       !pathModule.isAbsolute(relative))) {
+    throw new ERR_INVALID_ARG_VALUE('dest', dest,
+                                    'must not be inside of src');
+  }
+});
+
+// fs.copyTree() takes either the COPYFILE_* flags or an options object.
+// Returns the flags, and the progress callback for the binding, if any.
+const getCopyTreeOptions = hideStackFrames((options) => {
+  if (options === undefined || typeof options === 'number')
+    return { flags: options | 0, onProgress: undefined };
+  if (options === null || typeof options !== 'object')
+    throw new ERR_INVALID_ARG_TYPE('options', ['number', 'Object'], options);
+  const { flags, onProgress } = options;
+  if (onProgress === undefined)
+    return { flags: flags | 0, onProgress: undefined };
+  if (typeof onProgress !== 'function') {
+    throw new ERR_INVALID_ARG_TYPE('options.onProgress', 'Function',
+                                   onProgress);
+  }
+  return {
+    flags: flags | 0,
+    onProgress: (files, directories) => onProgress({ files, directories })
+  };
+});
+
 const validateBufferArray = hideStackFrames((buffers, propName = 'buffers') => {
   if (!Array.isArray(buffers))
     throw new ERR_INVALID_ARG_TYPE(propName, 'ArrayBufferView[]', buffers);
@@ -591,9 +657,11 @@ module.exports = {
   copyObject,
   Dirent,
   getDirent,
+  getCopyTreeOptions,
   getDirents,
   getOptions,
   getValidatedPath,
+  getValidatedPaths,
   handleErrorFromBinding,
   nullCheck,
   preprocessSymlinkDestination,
@@ -602,8 +670,10 @@ module.exports = {
   stringToFlags,
   stringToSymlinkType,
   Stats,
+  StatsBatch,
   toUnixTimestamp,
   validateBufferArray,
+  validateCopyTreePaths,
   validateOffsetLengthRead,
   validateOffsetLengthWrite,
   validatePath,
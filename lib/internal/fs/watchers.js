@@ -5,11 +5,12 @@ const { Object } = primordials;
 const errors = require('internal/errors');
 const {
   kFsStatsFieldsNumber,
-  StatWatcher: _StatWatcher
+  StatPoller
 } = internalBinding('fs');
-const { FSEvent } = internalBinding('fs_event_wrap');
-const { UV_ENOSPC } = internalBinding('uv');
+const { FSEvent, InotifyWatcher } = internalBinding('fs_event_wrap');
+const { UV_ENOSPC, UV_ENOTDIR } = internalBinding('uv');
 const { EventEmitter } = require('events');
+const { AsyncResource } = require('async_hooks');
 const {
   getStatsFromBinding,
   getValidatedPath
@@ -18,7 +19,7 @@ const {
   defaultTriggerAsyncIdScope,
   symbols: { owner_symbol }
 } = require('internal/async_hooks');
-const { toNamespacedPath } = require('path');
+const { resolve, toNamespacedPath } = require('path');
 const { validateUint32 } = require('internal/validators');
 const assert = require('internal/assert');
 
@@ -54,6 +55,78 @@ function onchange(newStatus, stats) {
             getStatsFromBinding(stats, kFsStatsFieldsNumber));
 }
 
+// Instead of a handle per file, StatWatchers share a native StatPoller for
+// each stats format. It passes the changes of all files to
+// onStatPollerChange() as [ids, statuses, stats], where `stats` holds the
+// current and previous stats of every change.
+const statPollers = [null, null];
+const statPollerSizes = [0, 0];
+const persistentPolledFiles = [0, 0];
+const polledFiles = new Map();
+let nextPolledFileId = 0;
+
+function onStatPollerChange(ids, statuses, stats) {
+  const size = 2 * kFsStatsFieldsNumber;
+  for (let i = 0; i < ids.length; i++) {
+    // The watcher may have been stopped by a listener of an earlier change.
+    const file = polledFiles.get(ids[i]);
+    if (file !== undefined) {
+      file.runInAsyncScope(onchange, file, statuses[i],
+                           stats.subarray(i * size, (i + 1) * size));
+    }
+  }
+}
+
+function updateStatPoller(index) {
+  const poller = statPollers[index];
+  if (statPollerSizes[index] === 0) {
+    poller.close();
+    statPollers[index] = null;
+  } else if (persistentPolledFiles[index] > 0) {
+    poller.ref();
+  } else {
+    poller.unref();
+  }
+}
+
+// Stands in for the handle of a StatWatcher, and is its async resource.
+class PolledFile extends AsyncResource {
+  constructor(watcher, filename, persistent, interval) {
+    super('STATWATCHER', { requireManualDestroy: true });
+    this[owner_symbol] = watcher;
+    this.index = watcher[kUseBigint] ? 1 : 0;
+    this.persistent = persistent;
+    this.id = nextPolledFileId;
+    nextPolledFileId = (nextPolledFileId + 1) | 0;
+
+    if (statPollers[this.index] === null) {
+      const poller = new StatPoller(this.index === 1);
+      poller.onchange = onStatPollerChange;
+      statPollers[this.index] = poller;
+    }
+    statPollers[this.index].add(this.id, filename, interval);
+    polledFiles.set(this.id, this);
+    statPollerSizes[this.index]++;
+    if (persistent)
+      persistentPolledFiles[this.index]++;
+    updateStatPoller(this.index);
+  }
+
+  getAsyncId() {
+    return this.asyncId();
+  }
+
+  close() {
+    statPollers[this.index].remove(this.id);
+    polledFiles.delete(this.id);
+    statPollerSizes[this.index]--;
+    if (this.persistent)
+      persistentPolledFiles[this.index]--;
+    updateStatPoller(this.index);
+    this.emitDestroy();
+  }
+}
+
 // FIXME(joyeecheung): this method is not documented.
 // At the moment if filename is undefined, we
 // 1. Throw an Error if it's the first time .start() is called
@@ -64,28 +137,20 @@ StatWatcher.prototype.start = function(filename, persistent, interval) {
   if (this._handle !== null)
     return;
 
-  this._handle = new _StatWatcher(this[kUseBigint]);
-  this._handle[owner_symbol] = this;
-  this._handle.onchange = onchange;
-  if (!persistent)
-    this._handle.unref();
-
   // uv_fs_poll is a little more powerful than ev_stat but we curb it for
   // the sake of backwards compatibility
   this[kOldStatus] = -1;
 
   filename = getValidatedPath(filename, 'filename');
   validateUint32(interval, 'interval');
-  const err = this._handle.start(toNamespacedPath(filename), interval);
-  if (err) {
-    const error = errors.uvException({
-      errno: err,
-      syscall: 'watch',
-      path: filename
-    });
-    error.filename = filename;
-    throw error;
-  }
+  // The poller watches the directory of a file for hints, which it can only
+  // find for absolute paths.
+  if (typeof filename === 'string')
+    filename = resolve(filename);
+  this._handle = new PolledFile(this,
+                                toNamespacedPath(filename),
+                                persistent,
+                                interval);
 };
 
 // FIXME(joyeecheung): this method is not documented while there is
@@ -104,11 +169,95 @@ StatWatcher.prototype.stop = function() {
   this._handle = null;
 };
 
+// On Linux, libuv does not watch directory trees, so recursive watchers use
+// a single native InotifyWatcher that is shared by all of them instead. Each
+// watcher adds its directory as a root with its own id, and the events of all
+// roots arrive in batches of [id, eventType, filename, ...]. If a directory
+// below a root cannot be watched, e.g. with ENOSPC, the eventType is the
+// error number instead.
+let inotify = null;
+const inotifyRoots = new Map();
+let nextInotifyRootId = 0;
+let persistentInotifyRoots = 0;
+
+function onInotifyChange(events) {
+  for (let i = 0; i < events.length; i += 3) {
+    // The watcher may have been closed by a listener of an earlier event.
+    const handle = inotifyRoots.get(events[i]);
+    if (handle === undefined)
+      continue;
+    const eventType = events[i + 1];
+    if (typeof eventType === 'number')
+      handle.onchange(eventType, '', handle.filename);
+    else
+      handle.onchange(0, eventType, events[i + 2]);
+  }
+}
+
+function updateInotify() {
+  if (inotifyRoots.size === 0) {
+    inotify.close();
+    inotify = null;
+  } else if (persistentInotifyRoots > 0) {
+    inotify.ref();
+  } else {
+    inotify.unref();
+  }
+}
+
+// Stands in for the FSEvent handle of a recursive FSWatcher on Linux.
+class InotifyRoot {
+  constructor() {
+    this.onchange = null;
+    this.initialized = false;
+    this.id = -1;
+    this.persistent = false;
+    this.filename = null;
+  }
+
+  start(filename, persistent, recursive, encoding, coalesceWindow) {
+    if (inotify === null) {
+      const handle = new InotifyWatcher();
+      const err = handle.start();
+      if (err)
+        return err;
+      handle.onchange = onInotifyChange;
+      inotify = handle;
+    }
+    const id = nextInotifyRootId;
+    nextInotifyRootId = (nextInotifyRootId + 1) | 0;
+    const err = inotify.add(id, resolve(filename), coalesceWindow, encoding);
+    if (err === 0) {
+      inotifyRoots.set(id, this);
+      this.initialized = true;
+      this.id = id;
+      this.persistent = persistent;
+      this.filename = filename;
+      if (persistent)
+        persistentInotifyRoots++;
+    }
+    updateInotify();
+    return err;
+  }
 
-function FSWatcher() {
+  close() {
+    if (!this.initialized)
+      return;
+    this.initialized = false;
+    inotify.remove(this.id);
+    inotifyRoots.delete(this.id);
+    if (this.persistent)
+      persistentInotifyRoots--;
+    updateInotify();
+  }
+}
+
+
+function FSWatcher(recursive) {
   EventEmitter.call(this);
 
-  this._handle = new FSEvent();
+  this._handle = recursive && InotifyWatcher !== undefined ?
+    new InotifyRoot() : new FSEvent();
   this._handle[owner_symbol] = this;
 
   this._handle.onchange = (status, eventType, filename) => {
@@ -125,7 +274,9 @@ function FSWatcher() {
       const error = errors.uvException({
         errno: status,
         syscall: 'watch',
-        path: filename
+        path: filename,
+        message: status === UV_ENOSPC ?
+          'System limit for number of file watchers reached' : ''
       });
       error.filename = filename;
       this.emit('error', error);
@@ -146,21 +297,35 @@ Object.setPrototypeOf(FSWatcher, EventEmitter);
 FSWatcher.prototype[kFSWatchStart] = function(filename,
                                               persistent,
                                               recursive,
-                                              encoding) {
+                                              encoding,
+                                              coalesceWindow = 0) {
   if (this._handle === null) {  // closed
     return;
   }
-  assert(this._handle instanceof FSEvent, 'handle must be a FSEvent');
+  assert(this._handle instanceof FSEvent ||
+         this._handle instanceof InotifyRoot, 'handle must be a FSEvent');
   if (this._handle.initialized) {  // already started
     return;
   }
 
   filename = getValidatedPath(filename, 'filename');
 
-  const err = this._handle.start(toNamespacedPath(filename),
-                                 persistent,
-                                 recursive,
-                                 encoding);
+  let err = this._handle.start(toNamespacedPath(filename),
+                               persistent,
+                               recursive,
+                               encoding,
+                               coalesceWindow);
+  if (err === UV_ENOTDIR && this._handle instanceof InotifyRoot) {
+    // Files are watched as usual.
+    const handle = new FSEvent();
+    handle[owner_symbol] = this;
+    handle.onchange = this._handle.onchange;
+    this._handle = handle;
+    err = handle.start(toNamespacedPath(filename),
+                       persistent,
+                       recursive,
+                       encoding);
+  }
   if (err) {
     const error = errors.uvException({
       errno: err,
@@ -180,7 +345,8 @@ FSWatcher.prototype.close = function() {
   if (this._handle === null) {  // closed
     return;
   }
-  assert(this._handle instanceof FSEvent, 'handle must be a FSEvent');
+  assert(this._handle instanceof FSEvent ||
+         this._handle instanceof InotifyRoot, 'handle must be a FSEvent');
   if (!this._handle.initialized) {  // not started
     return;
   }
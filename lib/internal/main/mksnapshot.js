@@ -0,0 +1,25 @@
+'use strict';
+
+// Runs the entry script of a snapshot that is built with
+// `node_mksnapshot --blob`, see tools/snapshot/snapshot_builder.cc.
+// The process is not prepared for execution here, since pre-execution sets up
+// the stdio streams, signal handlers and other native state that cannot be
+// part of a snapshot. For the same reason, the entry can only require the
+// built-in modules.
+
+const path = require('path');
+const { NativeModule } = require('internal/bootstrap/loaders');
+const {
+  ERR_UNKNOWN_BUILTIN_MODULE
+} = require('internal/errors').codes;
+
+function requireBuiltin(id) {
+  if (!NativeModule.canBeRequiredByUsers(id))
+    throw new ERR_UNKNOWN_BUILTIN_MODULE(id);
+  return require(id);
+}
+
+return function runEntry(entry, filename) {
+  filename = path.resolve(filename);
+  entry(requireBuiltin, filename, path.dirname(filename));
+};
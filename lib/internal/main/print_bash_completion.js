@@ -1,12 +1,16 @@
 'use strict';
-const { options, aliases } = require('internal/options');
+const {
+  getOptionsFromBinding,
+  getAliasesFromBinding
+} = require('internal/options');
 
 const {
   prepareMainThreadExecution
 } = require('internal/bootstrap/pre_execution');
 
 function print(stream) {
-  const all_opts = [...options.keys(), ...aliases.keys()];
+  const all_opts = [...getOptionsFromBinding().keys(),
+                    ...getAliasesFromBinding().keys()];
 
   stream.write(`_node_complete() {
   local cur_word options
@@ -151,7 +151,12 @@ function format({ options, aliases = new Map(), firstColumn, secondColumn }) {
 }
 
 function print(stream) {
-  const { options, aliases } = require('internal/options');
+  const {
+    getOptionsFromBinding,
+    getAliasesFromBinding
+  } = require('internal/options');
+  const options = getOptionsFromBinding();
+  const aliases = getAliasesFromBinding();
 
   // Use 75 % of the available width, and at least 70 characters.
   const width = Math.max(70, (stream.columns || 0) * 0.75);
@@ -43,6 +43,11 @@ const fs = require('fs');
 const internalFS = require('internal/fs/utils');
 const path = require('path');
 const {
+  internalModuleBundleStat,
+  internalModuleClearDirectoryCache,
+  internalModuleFindFile,
+  internalModuleReadBundle,
+  internalModuleReadBundleCodeCache,
   internalModuleReadJSON,
   internalModuleStat
 } = internalBinding('fs');
@@ -58,10 +63,23 @@ const enableSourceMaps = getOptionValue('--enable-source-maps');
 const preserveSymlinks = getOptionValue('--preserve-symlinks');
 const preserveSymlinksMain = getOptionValue('--preserve-symlinks-main');
 const experimentalModules = getOptionValue('--experimental-modules');
+const resolutionCacheFile = getOptionValue('--experimental-resolution-cache');
+const hasModuleBundle = getOptionValue('--experimental-bundle') !== '';
+const hasCodeCacheDir = getOptionValue('--experimental-code-cache-dir') !== '';
 const manifest = getOptionValue('--experimental-policy') ?
   require('internal/process/policy').manifest :
   null;
-const { compileFunction } = internalBinding('contextify');
+const {
+  compileFunction,
+  createCodeCacheForFunction
+} = internalBinding('contextify');
+
+let codeCache;  // Lazily loaded, only used with --experimental-code-cache-dir.
+function lazyCodeCache() {
+  if (codeCache === undefined)
+    codeCache = require('internal/modules/code_cache');
+  return codeCache;
+}
 
 const {
   ERR_INVALID_ARG_VALUE,
@@ -110,6 +128,15 @@ function enrichCJSError(err) {
   }
 }
 
+// The stat() results, and with --experimental-resolution-cache the directory
+// listings, are only kept while a top-level require() runs, so that files
+// that are created later are found.
+function resetStatCache(enable) {
+  statCache = enable ? new Map() : null;
+  if (resolutionCacheFile)
+    internalModuleClearDirectoryCache();
+}
+
 function stat(filename) {
   filename = path.toNamespacedPath(filename);
   if (statCache !== null) {
@@ -332,6 +359,9 @@ function tryFile(requestPath, isMain) {
 }
 
 function toRealPath(requestPath) {
+  // Files in the module bundle do not exist on disk.
+  if (hasModuleBundle && internalModuleBundleStat(requestPath) === 0)
+    return requestPath;
   return fs.realpathSync(requestPath, {
     [internalFS.realpathCacheKey]: realpathCache
   });
@@ -339,6 +369,20 @@ function toRealPath(requestPath) {
 
 // Given a path, check if the file exists with any of the set extensions
 function tryExtensions(p, exts, isMain) {
+  // With --experimental-resolution-cache, all extensions are looked up in the
+  // cached listing of the directory with a single call.
+  if (resolutionCacheFile) {
+    const index = internalModuleFindFile(path.toNamespacedPath(p), exts);
+    if (index === -1)
+      return false;
+
+    const filename = p + exts[index];
+    if (preserveSymlinks && !isMain) {
+      return path.resolve(filename);
+    }
+    return toRealPath(filename);
+  }
+
   for (var i = 0; i < exts.length; i++) {
     const filename = tryFile(p + exts[i], isMain);
 
@@ -458,7 +502,50 @@ function resolveExportsTarget(pkgPath, target, subpath, basePath, mappingKey) {
   throw e;
 }
 
+// With --experimental-resolution-cache, the results of Module._findPath() are
+// saved when the process exits and used by the next one, which then does not
+// have to touch the file system to resolve the modules it has seen before.
+let resolutionCacheLoaded = false;
+let resolutionCacheChanged = false;
+
+function loadResolutionCache() {
+  resolutionCacheLoaded = true;
+  process.on('exit', saveResolutionCache);
+
+  let cache;
+  try {
+    cache = JSON.parse(fs.readFileSync(resolutionCacheFile, 'utf8'));
+  } catch {
+    return;
+  }
+  if (cache !== null && typeof cache === 'object' &&
+      cache.version === process.version &&
+      cache.paths !== null && typeof cache.paths === 'object') {
+    Object.assign(Module._pathCache, cache.paths);
+  }
+}
+
+function saveResolutionCache() {
+  if (!resolutionCacheChanged)
+    return;
+  const tmp = `${resolutionCacheFile}.${process.pid}.tmp`;
+  try {
+    fs.writeFileSync(tmp, JSON.stringify({
+      version: process.version,
+      paths: Module._pathCache
+    }));
+    fs.renameSync(tmp, resolutionCacheFile);
+  } catch {
+    try {
+      fs.unlinkSync(tmp);
+    } catch {}
+  }
+}
+
 Module._findPath = function(request, paths, isMain) {
+  if (resolutionCacheFile && !resolutionCacheLoaded)
+    loadResolutionCache();
+
   const absoluteRequest = path.isAbsolute(request);
   if (absoluteRequest) {
     paths = [''];
@@ -528,6 +615,7 @@ Module._findPath = function(request, paths, isMain) {
 
     if (filename) {
       Module._pathCache[cacheKey] = filename;
+      resolutionCacheChanged = true;
       return filename;
     }
   }
@@ -859,7 +947,14 @@ Module.prototype.require = function(id) {
 var resolvedArgv;
 let hasPausedEntry = false;
 
-function wrapSafe(filename, content) {
+function getCachedData(filename, codeCacheEntry) {
+  if (codeCacheEntry !== undefined && codeCacheEntry.cachedData !== undefined)
+    return codeCacheEntry.cachedData;
+  if (hasModuleBundle)
+    return internalModuleReadBundleCodeCache(filename);
+}
+
+function wrapSafe(filename, content, codeCacheEntry) {
   if (patched) {
     const wrapper = Module.wrap(content);
     return vm.runInThisContext(wrapper, {
@@ -879,7 +974,7 @@ function wrapSafe(filename, content) {
       filename,
       0,
       0,
-      undefined,
+      getCachedData(filename, codeCacheEntry),
       false,
       undefined,
       [],
@@ -898,6 +993,9 @@ function wrapSafe(filename, content) {
     throw err;
   }
 
+  if (codeCacheEntry !== undefined)
+    codeCacheEntry.compiled(compiled.cachedDataRejected === true);
+
   if (experimentalModules) {
     const { callbackMap } = internalBinding('module_wrap');
     callbackMap.set(compiled.cacheKey, {
@@ -925,7 +1023,9 @@ Module.prototype._compile = function(content, filename) {
   }
 
   maybeCacheSourceMap(filename, content, this);
-  const compiledWrapper = wrapSafe(filename, content);
+  const codeCacheEntry = patched || !hasCodeCacheDir ? undefined :
+    lazyCodeCache().getCodeCacheEntry(filename, content);
+  const compiledWrapper = wrapSafe(filename, content, codeCacheEntry);
 
   var inspectorWrapper = null;
   if (getOptionValue('--inspect-brk') && process._eval == null) {
@@ -950,7 +1050,7 @@ Module.prototype._compile = function(content, filename) {
   const exports = this.exports;
   const thisValue = exports;
   const module = this;
-  if (requireDepth === 0) statCache = new Map();
+  if (requireDepth === 0) resetStatCache(true);
   if (inspectorWrapper) {
     result = inspectorWrapper(compiledWrapper, thisValue, exports,
                               require, module, filename, dirname);
@@ -958,10 +1058,21 @@ Module.prototype._compile = function(content, filename) {
     result = compiledWrapper.call(thisValue, exports, require, module,
                                   filename, dirname);
   }
-  if (requireDepth === 0) statCache = null;
+  if (requireDepth === 0) resetStatCache(false);
+  if (codeCacheEntry !== undefined)
+    codeCacheEntry.save(() => createCodeCacheForFunction(compiledWrapper));
   return result;
 };
 
+function readModuleSource(filename) {
+  if (hasModuleBundle) {
+    const content = internalModuleReadBundle(filename);
+    if (content !== undefined)
+      return content;
+  }
+  return fs.readFileSync(filename, 'utf8');
+}
+
 // Native extension for .js
 let warnRequireESM = true;
 Module._extensions['.js'] = function(module, filename) {
@@ -990,14 +1101,14 @@ Module._extensions['.js'] = function(module, filename) {
       }
     }
   }
-  const content = fs.readFileSync(filename, 'utf8');
+  const content = readModuleSource(filename);
   module._compile(content, filename);
 };
 
 
 // Native extension for .json
 Module._extensions['.json'] = function(module, filename) {
-  const content = fs.readFileSync(filename, 'utf8');
+  const content = readModuleSource(filename);
 
   if (manifest) {
     const moduleURL = pathToFileURL(filename);
@@ -1151,6 +1262,10 @@ Module._preloadModules = function(requests) {
     parent.require(requests[n]);
 };
 
+Module.getCodeCacheStats = function getCodeCacheStats() {
+  return lazyCodeCache().getCodeCacheStats();
+};
+
 Module.syncBuiltinESMExports = function syncBuiltinESMExports() {
   for (const mod of NativeModule.map.values()) {
     if (mod.canBeRequiredByUsers) {
@@ -0,0 +1,140 @@
+'use strict';
+
+// A persistent V8 code cache for user modules, enabled through
+// --experimental-code-cache-dir.
+//
+// The cache of a module is produced once the module has been evaluated, so
+// that it also covers the functions that were compiled lazily while it ran,
+// and is consumed when the module is compiled again by a later process.
+// Entries are keyed by the filename (or URL) of the module and V8's cached
+// data version tag. Each entry starts with the hash of the source it was
+// produced for and is ignored if the source has changed since.
+
+const { Buffer } = require('buffer');
+const { getOptionValue } = require('internal/options');
+const { hashSource } = internalBinding('contextify');
+const { debuglog } = require('internal/util/debuglog');
+const debug = debuglog('code_cache');
+const fs = require('fs');
+const path = require('path');
+
+const cacheDir = getOptionValue('--experimental-code-cache-dir');
+const kHashLength = 16;
+
+let versionTag;
+let cacheDirCreated = false;
+const pendingModules = [];
+
+const stats = {
+  hits: 0,
+  misses: 0,
+  rejected: 0,
+  written: 0
+};
+
+function getEntryPath(key) {
+  if (versionTag === undefined)
+    versionTag = internalBinding('v8').cachedDataVersionTag();
+  return path.join(cacheDir, hashSource(`${versionTag}\0${key}`));
+}
+
+class CodeCacheEntry {
+  constructor(key, source) {
+    this.key = key;
+    this.sourceHash = hashSource(source);
+    this.cachedData = undefined;
+
+    let data;
+    try {
+      data = fs.readFileSync(getEntryPath(key));
+    } catch {
+      stats.misses++;
+      return;
+    }
+    if (data.length <= kHashLength ||
+        data.latin1Slice(0, kHashLength) !== this.sourceHash) {
+      debug('stale entry for %s', key);
+      stats.misses++;
+      return;
+    }
+    this.cachedData = data.subarray(kHashLength);
+  }
+
+  // Must be called once the module has been compiled, with whether V8
+  // rejected the cached data, e.g. because of different V8 flags.
+  compiled(rejected) {
+    if (this.cachedData === undefined)
+      return;
+    if (rejected) {
+      debug('rejected entry for %s', this.key);
+      stats.rejected++;
+      this.cachedData = undefined;
+    } else {
+      stats.hits++;
+    }
+  }
+
+  // Writes a new entry, unless the existing one was used successfully.
+  // `createCachedData` is only called if that is needed.
+  save(createCachedData) {
+    if (this.cachedData !== undefined)
+      return;
+    const data = createCachedData();
+    if (data === undefined || data.length === 0)
+      return;
+
+    const file = getEntryPath(this.key);
+    // Entries are written to a temporary file first, so that other processes
+    // that use the same directory never see a partially written one.
+    const tmp = `${file}.${process.pid}.tmp`;
+    try {
+      if (!cacheDirCreated) {
+        fs.mkdirSync(cacheDir, { recursive: true });
+        cacheDirCreated = true;
+      }
+      fs.writeFileSync(tmp, Buffer.concat([
+        Buffer.from(this.sourceHash, 'latin1'),
+        data
+      ]));
+      fs.renameSync(tmp, file);
+      stats.written++;
+    } catch (err) {
+      debug('cannot write entry for %s: %s', this.key, err.message);
+      try {
+        fs.unlinkSync(tmp);
+      } catch {}
+    }
+  }
+}
+
+// Returns a CodeCacheEntry if the code cache is enabled.
+function getCodeCacheEntry(key, source) {
+  if (!cacheDir)
+    return;
+  return new CodeCacheEntry(key, source);
+}
+
+// ES modules are evaluated as a graph, so their entries are only written
+// by savePendingModules() once the graph has been evaluated.
+function addPendingModule(entry, module) {
+  if (entry.cachedData === undefined)
+    pendingModules.push({ entry, module });
+}
+
+function savePendingModules() {
+  while (pendingModules.length > 0) {
+    const { entry, module } = pendingModules.pop();
+    entry.save(() => module.createCachedData());
+  }
+}
+
+function getCodeCacheStats() {
+  return { ...stats };
+}
+
+module.exports = {
+  addPendingModule,
+  getCodeCacheEntry,
+  getCodeCacheStats,
+  savePendingModules
+};
@@ -11,6 +11,8 @@ const preserveSymlinksMain = getOptionValue('--preserve-symlinks-main');
 const experimentalJsonModules = getOptionValue('--experimental-json-modules');
 const typeFlag = getOptionValue('--input-type');
 const experimentalWasmModules = getOptionValue('--experimental-wasm-modules');
+const hasModuleBundle = getOptionValue('--experimental-bundle') !== '';
+const { internalModuleBundleStat } = internalBinding('fs');
 const { resolve: moduleWrapResolve,
         getPackageType } = internalBinding('module_wrap');
 const { URL, pathToFileURL, fileURLToPath } = require('internal/url');
@@ -81,7 +83,9 @@ function resolve(specifier, parentURL) {
 
   let url = moduleWrapResolve(specifier, parentURL);
 
-  if (isMain ? !preserveSymlinksMain : !preserveSymlinks) {
+  // Files in the module bundle do not exist on disk.
+  if ((isMain ? !preserveSymlinksMain : !preserveSymlinks) &&
+      !(hasModuleBundle && internalModuleBundleStat(fileURLToPath(url)) === 0)) {
     const real = realpathSync(fileURLToPath(url), {
       [internalFS.realpathCacheKey]: realpathCache
     });
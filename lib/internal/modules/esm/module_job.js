@@ -10,6 +10,7 @@ const { ModuleWrap } = internalBinding('module_wrap');
 
 const { decorateErrorStack } = require('internal/util');
 const { getOptionValue } = require('internal/options');
+const { savePendingModules } = require('internal/modules/code_cache');
 const assert = require('internal/assert');
 const resolvedPromise = SafePromise.resolve();
 
@@ -106,7 +107,9 @@ class ModuleJob {
     const module = await this.instantiate();
     const timeout = -1;
     const breakOnSigint = false;
-    return { module, result: module.evaluate(timeout, breakOnSigint) };
+    const result = module.evaluate(timeout, breakOnSigint);
+    savePendingModules();
+    return { module, result };
   }
 }
 Object.setPrototypeOf(ModuleJob.prototype, null);
@@ -32,6 +32,10 @@ const {
 const readFileAsync = promisify(fs.readFile);
 const JsonParse = JSON.parse;
 const { maybeCacheSourceMap } = require('internal/source_map/source_map_cache');
+const {
+  addPendingModule,
+  getCodeCacheEntry
+} = require('internal/modules/code_cache');
 const moduleWrap = internalBinding('module_wrap');
 const { ModuleWrap } = moduleWrap;
 
@@ -57,6 +61,15 @@ function getSource(url) {
   }
 }
 
+// Like getSource(), but returns the source as a string. Files are read and
+// decoded in a single trip to the threadpool.
+function getSourceString(url) {
+  const parsed = new URL(url);
+  if (parsed.protocol === 'file:')
+    return moduleWrap.readSource(fileURLToPath(parsed));
+  return `${getSource(url)}`;
+}
+
 function errPath(url) {
   const parsed = new URL(url);
   if (parsed.protocol === 'file:') {
@@ -76,10 +89,19 @@ async function importModuleDynamically(specifier, { url }) {
 
 // Strategy for loading a standard JavaScript module
 translators.set('module', async function moduleStrategy(url) {
-  const source = `${await getSource(url)}`;
+  const source = await getSourceString(url);
   maybeCacheSourceMap(url, source);
   debug(`Translating StandardModule ${url}`);
-  const module = new ModuleWrap(source, url);
+  const codeCacheEntry = getCodeCacheEntry(url, source);
+  let module;
+  if (codeCacheEntry !== undefined) {
+    module = new ModuleWrap(source, url, undefined, 0, 0,
+                            codeCacheEntry.cachedData);
+    codeCacheEntry.compiled(module.cachedDataRejected === true);
+    addPendingModule(codeCacheEntry, module);
+  } else {
+    module = new ModuleWrap(source, url);
+  }
   moduleWrap.callbackMap.set(module, {
     initializeImportMeta,
     importModuleDynamically,
@@ -148,7 +170,7 @@ translators.set('json', async function jsonStrategy(url) {
       }, ['default'], url);
     }
   }
-  const content = `${await getSource(url)}`;
+  const content = await getSourceString(url);
   if (pathname) {
     // A require call could have been called on the same file during loading and
     // that resolves synchronously. To make sure we always return the identical
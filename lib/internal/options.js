@@ -1,18 +1,43 @@
 'use strict';
 
 const { getOptions } = internalBinding('options');
-const { options, aliases } = getOptions();
+
+let optionsMap;
+let aliasesMap;
+
+// The options are queried from C++ the first time they are needed, and again
+// after refreshOptions(). This keeps the values of the process that built the
+// startup snapshot out of the processes that are started from it.
+function getOptionsFromBinding() {
+  if (!optionsMap) {
+    ({ options: optionsMap, aliases: aliasesMap } = getOptions());
+  }
+  return optionsMap;
+}
+
+function getAliasesFromBinding() {
+  if (!aliasesMap) {
+    getOptionsFromBinding();
+  }
+  return aliasesMap;
+}
 
 function getOptionValue(option) {
-  const result = options.get(option);
+  const result = getOptionsFromBinding().get(option);
   if (!result) {
     return undefined;
   }
   return result.value;
 }
 
+function refreshOptions() {
+  optionsMap = undefined;
+  aliasesMap = undefined;
+}
+
 module.exports = {
-  options,
-  aliases,
-  getOptionValue
+  getOptionsFromBinding,
+  getAliasesFromBinding,
+  getOptionValue,
+  refreshOptions
 };
@@ -237,7 +237,12 @@ function buildAllowedFlags() {
   const {
     envSettings: { kAllowedInEnvironment }
   } = internalBinding('options');
-  const { options, aliases } = require('internal/options');
+  const {
+    getOptionsFromBinding,
+    getAliasesFromBinding
+  } = require('internal/options');
+  const options = getOptionsFromBinding();
+  const aliases = getAliasesFromBinding();
 
   const allowedNodeEnvironmentFlags = [];
   for (const [name, info] of options) {
@@ -32,6 +32,9 @@ const {
   emitBefore,
   emitAfter,
   emitDestroy,
+  captureAsyncContext,
+  enterAsyncContext,
+  exitAsyncContext,
   symbols: { async_id_symbol, trigger_async_id_symbol }
 } = require('internal/async_hooks');
 const {
@@ -68,6 +71,7 @@ function processTicksAndRejections() {
     while (tock = queue.shift()) {
       const asyncId = tock[async_id_symbol];
       emitBefore(asyncId, tock[trigger_async_id_symbol]);
+      const prevAsyncContext = enterAsyncContext(tock);
 
       try {
         const callback = tock.callback;
@@ -84,6 +88,7 @@ function processTicksAndRejections() {
           }
         }
       } finally {
+        exitAsyncContext(prevAsyncContext);
         if (destroyHooksExist())
           emitDestroy(asyncId);
       }
@@ -127,6 +132,7 @@ function nextTick(callback) {
     callback,
     args
   };
+  captureAsyncContext(tickObject);
   if (initHooksExist())
     emitInit(asyncId, 'TickObject', triggerAsyncId, tickObject);
   queue.push(tickObject);
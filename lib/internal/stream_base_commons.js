@@ -8,16 +8,24 @@ const {
   kArrayBufferOffset,
   kBytesWritten,
   kLastWriteWasAsync,
-  streamBaseState
+  streamBaseState,
+  setupBatchedReads
 } = internalBinding('stream_wrap');
 const { UV_EOF } = internalBinding('uv');
+const { triggerUncaughtException } = internalBinding('errors');
 const {
   codes: {
     ERR_INVALID_CALLBACK
   },
   errnoException
 } = require('internal/errors');
-const { owner_symbol } = require('internal/async_hooks').symbols;
+const {
+  symbols: { owner_symbol },
+  emitBefore,
+  emitAfter,
+  switchAsyncContext,
+  exitAsyncContext
+} = require('internal/async_hooks');
 const {
   kTimeout,
   setUnrefTimeout,
@@ -217,6 +225,38 @@ function onStreamRead(arrayBuffer) {
   }
 }
 
+// Called from C++ once per event loop iteration with the reads of all handles
+// that use batched reads, see `handle.useBatchedReads()`. Each read is passed
+// as a [handle, nread, arrayBuffer, asyncId, triggerAsyncId, asyncContext]
+// tuple, flattened into a single array.
+function onStreamReadBatch(batch) {
+  for (let i = 0; i < batch.length; i += 6) {
+    const handle = batch[i];
+    const stream = handle[owner_symbol];
+    // Reads may have been queued before the stream was destroyed.
+    if (stream === undefined || stream.destroyed)
+      continue;
+
+    const asyncId = batch[i + 3];
+    emitBefore(asyncId, batch[i + 4]);
+    const prevAsyncContext = switchAsyncContext(batch[i + 5]);
+    try {
+      streamBaseState[kReadBytesOrError] = batch[i + 1];
+      streamBaseState[kArrayBufferOffset] = 0;
+      handle.onread(batch[i + 2]);
+    } catch (err) {
+      // Make sure that one failing stream does not drop the reads of the
+      // remaining ones.
+      triggerUncaughtException(err, false /* fromPromise */);
+    } finally {
+      exitAsyncContext(prevAsyncContext);
+    }
+    emitAfter(asyncId);
+  }
+}
+
+setupBatchedReads(onStreamReadBatch);
+
 function setStreamTimeout(msecs, callback) {
   if (this.destroyed)
     return;
@@ -71,6 +71,13 @@
 // Timeout lists and the object map lookup of a specific list by the duration of
 // timers within (or creation of a new list). However, these operations combined
 // have shown to be trivial in comparison to other timers architectures.
+//
+// The unrefed timeouts that core creates through setUnrefTimeout(), mostly the
+// idle timeouts of sockets, are an exception: there can be a very large number
+// of them and they are refreshed on every read and write. They are kept in a
+// native timing wheel (see src/timer_wheel.h) instead, where scheduling and
+// refreshing them does not allocate and is constant-time. Expired timeouts are
+// passed back to JS by their id in a single call, see processWheelTimers().
 
 const { Math, Object } = primordials;
 
@@ -78,7 +85,10 @@ const {
   scheduleTimer,
   toggleTimerRef,
   getLibuvNow,
-  immediateInfo
+  immediateInfo,
+  newWheelTimer,
+  scheduleWheelTimer,
+  releaseWheelTimer
 } = internalBinding('timers');
 
 const {
@@ -90,7 +100,10 @@ const {
   emitInit,
   emitBefore,
   emitAfter,
-  emitDestroy
+  emitDestroy,
+  captureAsyncContext,
+  enterAsyncContext,
+  exitAsyncContext
 } = require('internal/async_hooks');
 
 // Symbols for storing async id state.
@@ -120,6 +133,12 @@ const TIMEOUT_MAX = 2 ** 31 - 1;
 let timerListId = Number.MIN_SAFE_INTEGER;
 
 const kRefed = Symbol('refed');
+const kWheelId = Symbol('wheelId');
+const kWheelArmed = Symbol('wheelArmed');
+
+// The timeouts that are currently on the native timing wheel, indexed by their
+// id on the wheel.
+const wheelTimeouts = [];
 
 // Create a single linked list instance only once at startup
 const immediateQueue = new ImmediateList();
@@ -143,13 +162,12 @@ function initAsyncResource(resource, type) {
   const asyncId = resource[async_id_symbol] = newAsyncId();
   const triggerAsyncId =
     resource[trigger_async_id_symbol] = getDefaultTriggerAsyncId();
+  captureAsyncContext(resource);
   if (initHooksExist())
     emitInit(asyncId, type, triggerAsyncId, resource);
 }
 
-// Timer constructor function.
-// The entire prototype is defined in lib/timers.js
-function Timeout(callback, after, args, isRepeat) {
+function getTimeoutDuration(after) {
   after *= 1; // Coalesce to number or NaN
   if (!(after >= 1 && after <= TIMEOUT_MAX)) {
     if (after > TIMEOUT_MAX) {
@@ -160,6 +178,13 @@ function Timeout(callback, after, args, isRepeat) {
     }
     after = 1; // Schedule on next tick, follows browser behavior
   }
+  return after;
+}
+
+// Timer constructor function.
+// The entire prototype is defined in lib/timers.js
+function Timeout(callback, after, args, isRepeat) {
+  after = getTimeoutDuration(after);
 
   this._idleTimeout = after;
   this._idlePrev = this;
@@ -218,6 +243,77 @@ Timeout.prototype.hasRef = function() {
   return !!this[kRefed];
 };
 
+// A timeout that lives on the native timing wheel. These are never refed and
+// never repeat.
+function WheelTimeout(callback, after) {
+  this._idleTimeout = getTimeoutDuration(after);
+  this._idleStart = null;
+  this._onTimeout = null;
+  this._onTimeout = callback;
+  this._timerArgs = undefined;
+  this._repeat = null;
+  this._destroyed = false;
+
+  this[kRefed] = false;
+  this[kWheelId] = -1;
+  this[kWheelArmed] = false;
+
+  initAsyncResource(this, 'Timeout');
+}
+Object.setPrototypeOf(WheelTimeout.prototype, Timeout.prototype);
+
+WheelTimeout.prototype.refresh = function() {
+  if (this._idleTimeout >= 0)
+    scheduleWheelTimeout(this);
+
+  return this;
+};
+
+WheelTimeout.prototype.unref = function() {
+  return this;
+};
+
+WheelTimeout.prototype.ref = function() {
+  return this;
+};
+
+WheelTimeout.prototype.hasRef = function() {
+  return false;
+};
+
+function scheduleWheelTimeout(timer) {
+  let id = timer[kWheelId];
+  if (id === -1) {
+    id = timer[kWheelId] = newWheelTimer();
+    wheelTimeouts[id] = timer;
+  }
+
+  if (timer._destroyed) {
+    timer._destroyed = false;
+    initAsyncResource(timer, 'Timeout');
+  }
+
+  timer[kWheelArmed] = true;
+  timer._idleStart = scheduleWheelTimer(id, Math.trunc(timer._idleTimeout));
+}
+
+function releaseWheelTimeout(timer) {
+  const id = timer[kWheelId];
+  releaseWheelTimer(id);
+  wheelTimeouts[id] = undefined;
+  timer[kWheelId] = -1;
+  timer[kWheelArmed] = false;
+}
+
+// Called by unenroll() in lib/timers.js.
+function unenrollWheelTimeout(timer) {
+  if (timer[kWheelId] !== -1)
+    releaseWheelTimeout(timer);
+
+  // If refresh is called later, then we want to make sure not to insert again
+  timer._idleTimeout = -1;
+}
+
 function TimersList(expiry, msecs) {
   this._idleNext = this; // Create the list with the linkedlist properties to
   this._idlePrev = this; // Prevent any unnecessary hidden class changes.
@@ -348,8 +444,8 @@ function setUnrefTimeout(callback, after) {
     throw new ERR_INVALID_CALLBACK(callback);
   }
 
-  const timer = new Timeout(callback, after, undefined, false);
-  unrefActive(timer);
+  const timer = new WheelTimeout(callback, after);
+  scheduleWheelTimeout(timer);
 
   return timer;
 }
@@ -432,6 +528,7 @@ function getTimerCallbacks(runNextTicks) {
 
       const asyncId = immediate[async_id_symbol];
       emitBefore(asyncId, immediate[trigger_async_id_symbol]);
+      const prevAsyncContext = enterAsyncContext(immediate);
 
       try {
         const argv = immediate._argv;
@@ -440,6 +537,7 @@ function getTimerCallbacks(runNextTicks) {
         else
           immediate._onImmediate(...argv);
       } finally {
+        exitAsyncContext(prevAsyncContext);
         immediate._onImmediate = null;
 
         if (destroyHooksExist())
@@ -520,6 +618,7 @@ function getTimerCallbacks(runNextTicks) {
       }
 
       emitBefore(asyncId, timer[trigger_async_id_symbol]);
+      const prevAsyncContext = enterAsyncContext(timer);
 
       let start;
       if (timer._repeat)
@@ -532,6 +631,7 @@ function getTimerCallbacks(runNextTicks) {
         else
           timer._onTimeout(...args);
       } finally {
+        exitAsyncContext(prevAsyncContext);
         if (timer._repeat && timer._idleTimeout !== -1) {
           timer._idleTimeout = timer._repeat;
           if (start === undefined)
@@ -567,9 +667,59 @@ function getTimerCallbacks(runNextTicks) {
     }
   }
 
+  // Position in the current batch of expired wheel timeouts. If a callback
+  // throws, the batch is resumed from here once the exception was handled.
+  let wheelIndex = 0;
+
+  function processWheelTimers(ids) {
+    if (wheelIndex === 0) {
+      // None of these timeouts is scheduled anymore. Any of them that is
+      // armed again by the time it is reached was refreshed by an earlier
+      // callback (or is a new timeout that reused a released id) and is not
+      // due yet.
+      for (var i = 0; i < ids.length; i++)
+        wheelTimeouts[ids[i]][kWheelArmed] = false;
+    }
+
+    let ranAtLeastOneTimer = false;
+    while (wheelIndex < ids.length) {
+      const timer = wheelTimeouts[ids[wheelIndex++]];
+      if (timer === undefined || timer[kWheelArmed])
+        continue;
+
+      if (ranAtLeastOneTimer)
+        runNextTicks();
+      else
+        ranAtLeastOneTimer = true;
+
+      const asyncId = timer[async_id_symbol];
+      emitBefore(asyncId, timer[trigger_async_id_symbol]);
+      const prevAsyncContext = enterAsyncContext(timer);
+
+      try {
+        timer._onTimeout();
+      } finally {
+        exitAsyncContext(prevAsyncContext);
+        if (!timer[kWheelArmed] && timer[kWheelId] !== -1) {
+          releaseWheelTimeout(timer);
+
+          if (destroyHooksExist() && !timer._destroyed) {
+            emitDestroy(asyncId);
+          }
+          timer._destroyed = true;
+        }
+      }
+
+      emitAfter(asyncId);
+    }
+
+    wheelIndex = 0;
+  }
+
   return {
     processImmediate,
-    processTimers
+    processTimers,
+    processWheelTimers
   };
 }
 
@@ -579,9 +729,11 @@ module.exports = {
   async_id_symbol,
   trigger_async_id_symbol,
   Timeout,
+  WheelTimeout,
   kRefed,
   initAsyncResource,
   setUnrefTimeout,
+  unenrollWheelTimeout,
   getTimerDuration,
   immediateQueue,
   getTimerCallbacks,
@@ -5,7 +5,7 @@ const { Object, Reflect } = primordials;
 const { inspect } = require('internal/util/inspect');
 const {
   encodeStr,
-  hexTable,
+  hasDefaultUnescape,
   isHexTable
 } = require('internal/querystring');
 
@@ -46,8 +46,12 @@ const {
   encodeAuth,
   toUSVString: _toUSVString,
   parse,
+  parseFormUrlencoded,
+  parseHref,
+  serializeFormUrlencoded,
   setURLConstructor,
   URL_FLAGS_CANNOT_BE_BASE,
+  URL_FLAGS_FAILED,
   URL_FLAGS_HAS_FRAGMENT,
   URL_FLAGS_HAS_HOST,
   URL_FLAGS_HAS_PASSWORD,
@@ -62,7 +66,23 @@ const {
   kPathStart,
   kPort,
   kQuery,
-  kSchemeStart
+  kSchemeStart,
+  kURLComponentsCount,
+  kURLFlags,
+  kURLFragmentEnd,
+  kURLFragmentStart,
+  kURLHostEnd,
+  kURLHostStart,
+  kURLPasswordEnd,
+  kURLPasswordStart,
+  kURLPathEnd,
+  kURLPathStart,
+  kURLPort,
+  kURLQueryEnd,
+  kURLQueryStart,
+  kURLSchemeEnd,
+  kURLUsernameEnd,
+  kURLUsernameStart
 } = internalBinding('url');
 
 const context = Symbol('context');
@@ -98,24 +118,181 @@ function serializeTupleOrigin(scheme, host, port) {
   return `${scheme}//${host}${port === null ? '' : `:${port}`}`;
 }
 
+const kHref = Symbol('href');
+const kRanges = Symbol('ranges');
+const kSchemeValue = Symbol('scheme');
+const kUsernameValue = Symbol('username');
+const kPasswordValue = Symbol('password');
+const kHostValue = Symbol('host');
+const kPortValue = Symbol('port');
+const kPathValue = Symbol('path');
+const kQueryValue = Symbol('query');
+const kFragmentValue = Symbol('fragment');
+
 // This class provides the internal state of a URL object. An instance of this
 // class is stored in every URL object and is accessed internally by setters
 // and getters. It roughly corresponds to the concept of a URL record in the
 // URL Standard, with a few differences. It is also the object transported to
 // the C++ binding.
+//
+// A parsed context keeps the href returned by the binding and the ranges of
+// its components, and the components are only sliced out of it when they are
+// read. The first change to a component copies all of them, after which the
+// href has to be serialized again.
 // Refs: https://url.spec.whatwg.org/#concept-url
 class URLContext {
   constructor() {
     this.flags = 0;
-    this.scheme = ':';
-    this.username = '';
-    this.password = '';
-    this.host = null;
-    this.port = null;
-    this.path = [];
-    this.query = null;
-    this.fragment = null;
+    this[kHref] = null;
+    this[kRanges] = null;
+    this[kSchemeValue] = ':';
+    this[kUsernameValue] = '';
+    this[kPasswordValue] = '';
+    this[kHostValue] = null;
+    this[kPortValue] = null;
+    this[kPathValue] = [];
+    this[kQueryValue] = null;
+    this[kFragmentValue] = null;
+  }
+
+  get scheme() {
+    if (this[kHref] === null)
+      return this[kSchemeValue];
+    return this[kHref].slice(0, this[kRanges][kURLSchemeEnd]);
+  }
+
+  set scheme(value) {
+    detachHref(this);
+    this[kSchemeValue] = value;
+  }
+
+  get username() {
+    if (this[kHref] === null)
+      return this[kUsernameValue];
+    return sliceComponent(this, URL_FLAGS_HAS_USERNAME,
+                          kURLUsernameStart, kURLUsernameEnd, '');
+  }
+
+  set username(value) {
+    detachHref(this);
+    this[kUsernameValue] = value;
+  }
+
+  get password() {
+    if (this[kHref] === null)
+      return this[kPasswordValue];
+    return sliceComponent(this, URL_FLAGS_HAS_PASSWORD,
+                          kURLPasswordStart, kURLPasswordEnd, '');
+  }
+
+  set password(value) {
+    detachHref(this);
+    this[kPasswordValue] = value;
+  }
+
+  get host() {
+    if (this[kHref] === null)
+      return this[kHostValue];
+    return sliceComponent(this, URL_FLAGS_HAS_HOST,
+                          kURLHostStart, kURLHostEnd, null);
+  }
+
+  set host(value) {
+    detachHref(this);
+    this[kHostValue] = value;
+  }
+
+  get port() {
+    return this[kPortValue];
+  }
+
+  set port(value) {
+    detachHref(this);
+    this[kPortValue] = value;
+  }
+
+  get path() {
+    if (this[kHref] === null)
+      return this[kPathValue];
+    const flags = this[kRanges][kURLFlags];
+    if ((flags & URL_FLAGS_HAS_PATH) === 0)
+      return [];
+    const pathname = this[kHref].slice(this[kRanges][kURLPathStart],
+                                       this[kRanges][kURLPathEnd]);
+    if ((flags & URL_FLAGS_CANNOT_BE_BASE) !== 0)
+      return [pathname];
+    if (pathname === '')
+      return [];
+    return pathname.slice(1).split('/');
+  }
+
+  set path(value) {
+    detachHref(this);
+    this[kPathValue] = value;
+  }
+
+  get query() {
+    if (this[kHref] === null)
+      return this[kQueryValue];
+    return sliceComponent(this, URL_FLAGS_HAS_QUERY,
+                          kURLQueryStart, kURLQueryEnd, null);
+  }
+
+  set query(value) {
+    detachHref(this);
+    this[kQueryValue] = value;
+  }
+
+  get fragment() {
+    if (this[kHref] === null)
+      return this[kFragmentValue];
+    return sliceComponent(this, URL_FLAGS_HAS_FRAGMENT,
+                          kURLFragmentStart, kURLFragmentEnd, null);
+  }
+
+  set fragment(value) {
+    detachHref(this);
+    this[kFragmentValue] = value;
   }
+
+  [inspect.custom]() {
+    const view = new URLContextView();
+    view.flags = this.flags;
+    view.scheme = this.scheme;
+    view.username = this.username;
+    view.password = this.password;
+    view.host = this.host;
+    view.port = this.port;
+    view.path = this.path;
+    view.query = this.query;
+    view.fragment = this.fragment;
+    return view;
+  }
+}
+
+// Shows the components of a URLContext as plain properties when inspected.
+const URLContextView = class URLContext {};
+
+function sliceComponent(ctx, flag, start, end, missing) {
+  const ranges = ctx[kRanges];
+  if ((ranges[kURLFlags] & flag) === 0)
+    return missing;
+  return ctx[kHref].slice(ranges[start], ranges[end]);
+}
+
+// Copies the components out of the parsed href before one of them changes.
+function detachHref(ctx) {
+  if (ctx[kHref] === null)
+    return;
+  ctx[kSchemeValue] = ctx.scheme;
+  ctx[kUsernameValue] = ctx.username;
+  ctx[kPasswordValue] = ctx.password;
+  ctx[kHostValue] = ctx.host;
+  ctx[kPathValue] = ctx.path;
+  ctx[kQueryValue] = ctx.query;
+  ctx[kFragmentValue] = ctx.fragment;
+  ctx[kHref] = null;
+  ctx[kRanges] = null;
 }
 
 class URLSearchParams {
@@ -220,27 +397,40 @@ class URLSearchParams {
   }
 }
 
-function onParseComplete(flags, protocol, username, password,
-                         host, port, path, query, fragment) {
-  const ctx = this[context];
+// Filled in by parseHref() with the flags, the port and the ranges of the
+// other components of the href that it returns.
+const urlComponents = new Int32Array(kURLComponentsCount);
+
+// Parses `input` into the context of `url`. The binding returns the whole URL
+// as a single string, and the context slices the components out of it when
+// they are first needed, which is a lot cheaper than creating each of them in
+// C++.
+function parseInto(url, input, base) {
+  const href = parseHref(input, base, urlComponents);
+  if (href === undefined)
+    return;
+  const flags = urlComponents[kURLFlags];
+  if ((flags & URL_FLAGS_FAILED) !== 0)
+    throw new ERR_INVALID_URL(href);
+
+  const ctx = url[context];
   ctx.flags = flags;
-  ctx.scheme = protocol;
-  ctx.username = (flags & URL_FLAGS_HAS_USERNAME) !== 0 ? username : '';
-  ctx.password = (flags & URL_FLAGS_HAS_PASSWORD) !== 0 ? password : '';
-  ctx.port = port;
-  ctx.path = (flags & URL_FLAGS_HAS_PATH) !== 0 ? path : [];
-  ctx.query = query;
-  ctx.fragment = fragment;
-  ctx.host = host;
-  if (!this[searchParams]) { // Invoked from URL constructor
-    this[searchParams] = new URLSearchParams();
-    this[searchParams][context] = this;
+  ctx[kHref] = href;
+  ctx[kRanges] = urlComponents.slice();
+  ctx[kSchemeValue] = undefined;
+  ctx[kUsernameValue] = undefined;
+  ctx[kPasswordValue] = undefined;
+  ctx[kHostValue] = undefined;
+  const port = urlComponents[kURLPort];
+  ctx[kPortValue] = port > -1 ? port : null;
+  ctx[kPathValue] = undefined;
+  ctx[kQueryValue] = undefined;
+  ctx[kFragmentValue] = undefined;
+  if (!url[searchParams]) { // Invoked from URL constructor
+    url[searchParams] = new URLSearchParams();
+    url[searchParams][context] = url;
   }
-  initSearchParams(this[searchParams], query);
-}
-
-function onParseError(flags, input) {
-  throw new ERR_INVALID_URL(input);
+  initSearchParams(url[searchParams], ctx.query);
 }
 
 function onParseProtocolComplete(flags, protocol, username, password,
@@ -316,8 +506,7 @@ class URL {
       base_context = new URL(base)[context];
     }
     this[context] = new URLContext();
-    parse(input, -1, base_context, undefined, onParseComplete.bind(this),
-          onParseError);
+    parseInto(this, input, base_context);
   }
 
   get [special]() {
@@ -429,20 +618,22 @@ Object.defineProperties(URL.prototype, {
     configurable: true,
     // eslint-disable-next-line func-name-matching
     value: function toString() {
-      return this[kFormat]({});
+      return this.href;
     }
   },
   href: {
     enumerable: true,
     configurable: true,
     get() {
+      const href = this[context][kHref];
+      if (href !== null)
+        return href;
       return this[kFormat]({});
     },
     set(input) {
       // toUSVString is not needed.
       input = `${input}`;
-      parse(input, -1, undefined, undefined, onParseComplete.bind(this),
-            onParseError);
+      parseInto(this, input, undefined);
     }
   },
   origin: {  // readonly
@@ -597,6 +788,12 @@ Object.defineProperties(URL.prototype, {
     configurable: true,
     get() {
       const ctx = this[context];
+      const href = ctx[kHref];
+      if (href !== null) {
+        const ranges = ctx[kRanges];
+        if ((ranges[kURLFlags] & URL_FLAGS_HAS_PATH) !== 0)
+          return href.slice(ranges[kURLPathStart], ranges[kURLPathEnd]);
+      }
       if (this[cannotBeBase])
         return ctx.path[0];
       if (ctx.path.length === 0)
@@ -675,7 +872,7 @@ Object.defineProperties(URL.prototype, {
     configurable: true,
     // eslint-disable-next-line func-name-matching
     value: function toJSON() {
-      return this[kFormat]({});
+      return this.href;
     }
   }
 });
@@ -706,6 +903,17 @@ function initSearchParams(url, init) {
 // application/x-www-form-urlencoded parser
 // Ref: https://url.spec.whatwg.org/#concept-urlencoded-parser
 function parseParams(qs) {
+  // The native parser handles ASCII input, which is what form bodies and
+  // query strings normally are. It decodes like the default
+  // querystring.unescape(), which the code below uses.
+  if (querystring === undefined)
+    querystring = require('querystring');
+  if (hasDefaultUnescape(querystring)) {
+    const pairs = parseFormUrlencoded(qs, 0);
+    if (pairs !== undefined)
+      return pairs;
+  }
+
   const out = [];
   var pairStart = 0;
   var lastPos = 0;
@@ -803,44 +1011,12 @@ function parseParams(qs) {
   return out;
 }
 
-// Adapted from querystring's implementation.
-// Ref: https://url.spec.whatwg.org/#concept-urlencoded-byte-serializer
-const noEscape = [
-/*
-  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, A, B, C, D, E, F
-*/
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x00 - 0x0F
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10 - 0x1F
-  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, // 0x20 - 0x2F
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, // 0x30 - 0x3F
-  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40 - 0x4F
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, // 0x50 - 0x5F
-  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60 - 0x6F
-  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0  // 0x70 - 0x7F
-];
-
-// Special version of hexTable that uses `+` for U+0020 SPACE.
-const paramHexTable = hexTable.slice();
-paramHexTable[0x20] = '+';
-
 // application/x-www-form-urlencoded serializer
 // Ref: https://url.spec.whatwg.org/#concept-urlencoded-serializer
 function serializeParams(array) {
-  const len = array.length;
-  if (len === 0)
+  if (array.length === 0)
     return '';
-
-  const firstEncodedParam = encodeStr(array[0], noEscape, paramHexTable);
-  const firstEncodedValue = encodeStr(array[1], noEscape, paramHexTable);
-  let output = `${firstEncodedParam}=${firstEncodedValue}`;
-
-  for (var i = 2; i < len; i += 2) {
-    const encodedParam = encodeStr(array[i], noEscape, paramHexTable);
-    const encodedValue = encodeStr(array[i + 1], noEscape, paramHexTable);
-    output += `&${encodedParam}=${encodedValue}`;
-  }
-
-  return output;
+  return serializeFormUrlencoded(array);
 }
 
 // Mainly to mitigate func-name-matching ESLint rule
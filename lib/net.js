@@ -93,6 +93,7 @@ const {
 const { isUint8Array } = require('internal/util/types');
 const { validateInt32, validateString } = require('internal/validators');
 const kLastWriteQueueSize = Symbol('lastWriteQueueSize');
+const kBatchReads = Symbol('kBatchReads');
 const {
   DTRACE_NET_SERVER_CONNECTION,
   DTRACE_NET_STREAM_END
@@ -241,6 +242,8 @@ function initSocketHandle(self) {
         self[kBuffer] = userBuf;
       }
       self._handle.useUserBuffer(userBuf);
+    } else if (self[kBatchReads]) {
+      self._handle.useBatchedReads();
     }
   }
 }
@@ -287,6 +290,7 @@ function Socket(options) {
 
   // Default to *not* allowing half open sockets.
   this.allowHalfOpen = Boolean(allowHalfOpen);
+  this[kBatchReads] = Boolean(options.batchReads);
 
   if (options.handle) {
     this._handle = options.handle; // private
@@ -1185,6 +1189,7 @@ function Server(options, connectionListener) {
 
   this.allowHalfOpen = options.allowHalfOpen || false;
   this.pauseOnConnect = !!options.pauseOnConnect;
+  this[kBatchReads] = !!options.batchReads;
 }
 Object.setPrototypeOf(Server.prototype, EventEmitter.prototype);
 Object.setPrototypeOf(Server, EventEmitter);
@@ -1534,6 +1539,7 @@ function onconnection(err, clientHandle) {
     handle: clientHandle,
     allowHalfOpen: self.allowHalfOpen,
     pauseOnCreate: self.pauseOnConnect,
+    batchReads: self[kBatchReads],
     readable: true,
     writable: true
   });
@@ -4,12 +4,15 @@ const { Object } = primordials;
 
 const {
   ELDHistogram: _ELDHistogram,
+  ThreadPoolHistogram: _ThreadPoolHistogram,
   PerformanceEntry,
   mark: _mark,
   clearMark: _clearMark,
   measure: _measure,
   milestones,
+  loopPhases,
   observerCounts,
+  threadpoolPending,
   setupObservers,
   timeOrigin,
   timeOriginTimestamp,
@@ -33,7 +36,22 @@ const {
   NODE_PERFORMANCE_MILESTONE_LOOP_START,
   NODE_PERFORMANCE_MILESTONE_LOOP_EXIT,
   NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE,
-  NODE_PERFORMANCE_MILESTONE_ENVIRONMENT
+  NODE_PERFORMANCE_MILESTONE_ENVIRONMENT,
+
+  NODE_PERFORMANCE_LOOP_PHASE_TIMERS,
+  NODE_PERFORMANCE_LOOP_PHASE_POLL,
+  NODE_PERFORMANCE_LOOP_PHASE_IDLE,
+  NODE_PERFORMANCE_LOOP_PHASE_CHECK,
+  NODE_PERFORMANCE_LOOP_PHASE_CLOSE,
+
+  NODE_THREADPOOL_WORK_TYPE_FS,
+  NODE_THREADPOOL_WORK_TYPE_CRYPTO,
+  NODE_THREADPOOL_WORK_TYPE_ZLIB,
+  NODE_THREADPOOL_WORK_TYPE_NAPI,
+
+  NODE_THREADPOOL_WORK_METRIC_WAIT,
+  NODE_THREADPOOL_WORK_METRIC_RUN,
+  NODE_THREADPOOL_WORK_METRIC_TOTAL
 } = constants;
 
 const { AsyncResource } = require('async_hooks');
@@ -64,6 +82,23 @@ const kGetEntries = Symbol('get-entries');
 const kIndex = Symbol('index');
 const kMarks = Symbol('marks');
 const kCount = Symbol('count');
+const kType = Symbol('type');
+const kMetric = Symbol('metric');
+
+const threadpoolWorkTypes = {
+  __proto__: null,
+  'fs': NODE_THREADPOOL_WORK_TYPE_FS,
+  'crypto': NODE_THREADPOOL_WORK_TYPE_CRYPTO,
+  'zlib': NODE_THREADPOOL_WORK_TYPE_ZLIB,
+  'napi': NODE_THREADPOOL_WORK_TYPE_NAPI
+};
+
+const threadpoolWorkMetrics = {
+  __proto__: null,
+  'wait': NODE_THREADPOOL_WORK_METRIC_WAIT,
+  'run': NODE_THREADPOOL_WORK_METRIC_RUN,
+  'total': NODE_THREADPOOL_WORK_METRIC_TOTAL
+};
 
 const observers = {};
 const observerableTypes = [
@@ -153,6 +188,10 @@ function getMilestoneTimestamp(milestoneIdx) {
   return ns / 1e6 - timeOrigin;
 }
 
+function getLoopPhaseTime(phaseIdx) {
+  return loopPhases[phaseIdx] / 1e6;
+}
+
 class PerformanceNodeTiming extends PerformanceEntry {
   get name() {
     return 'node';
@@ -194,6 +233,10 @@ class PerformanceNodeTiming extends PerformanceEntry {
     return getMilestoneTimestamp(NODE_PERFORMANCE_MILESTONE_BOOTSTRAP_COMPLETE);
   }
 
+  get idleTime() {
+    return getLoopPhaseTime(NODE_PERFORMANCE_LOOP_PHASE_IDLE);
+  }
+
   [kInspect]() {
     return {
       name: 'node',
@@ -205,7 +248,8 @@ class PerformanceNodeTiming extends PerformanceEntry {
       bootstrapComplete: this.bootstrapComplete,
       environment: this.environment,
       loopStart: this.loopStart,
-      loopExit: this.loopExit
+      loopExit: this.loopExit,
+      idleTime: this.idleTime
     };
   }
 }
@@ -406,6 +450,45 @@ class Performance {
     }
   }
 
+  eventLoopUtilization(util1, util2) {
+    const loopStart = nodeTiming.loopStart;
+    if (loopStart <= 0)
+      return { idle: 0, active: 0, utilization: 0 };
+
+    const idle = nodeTiming.idleTime;
+    const active = now() - timeOrigin - loopStart - idle;
+
+    if (util2) {
+      const idleDelta = util1.idle - util2.idle;
+      const activeDelta = util1.active - util2.active;
+      return {
+        idle: idleDelta,
+        active: activeDelta,
+        utilization: activeDelta / (idleDelta + activeDelta)
+      };
+    }
+    if (util1) {
+      const idleDelta = idle - util1.idle;
+      const activeDelta = active - util1.active;
+      return {
+        idle: idleDelta,
+        active: activeDelta,
+        utilization: activeDelta / (idleDelta + activeDelta)
+      };
+    }
+    return { idle, active, utilization: active / (idle + active) };
+  }
+
+  eventLoopPhases() {
+    return {
+      timers: getLoopPhaseTime(NODE_PERFORMANCE_LOOP_PHASE_TIMERS),
+      poll: getLoopPhaseTime(NODE_PERFORMANCE_LOOP_PHASE_POLL),
+      idle: getLoopPhaseTime(NODE_PERFORMANCE_LOOP_PHASE_IDLE),
+      check: getLoopPhaseTime(NODE_PERFORMANCE_LOOP_PHASE_CHECK),
+      close: getLoopPhaseTime(NODE_PERFORMANCE_LOOP_PHASE_CLOSE)
+    };
+  }
+
   timerify(fn) {
     if (typeof fn !== 'function') {
       throw new ERR_INVALID_ARG_TYPE('fn', 'Function', fn);
@@ -546,7 +629,7 @@ function sortedInsert(list, entry) {
   list.splice(location, 0, entry);
 }
 
-class ELDHistogram {
+class Histogram {
   constructor(handle) {
     this[kHandle] = handle;
     this[kMap] = new Map();
@@ -589,6 +672,29 @@ class ELDHistogram {
   }
 }
 
+class ELDHistogram extends Histogram {}
+
+class ThreadpoolHistogram extends Histogram {
+  constructor(handle, type, metric) {
+    super(handle);
+    this[kType] = type;
+    this[kMetric] = metric;
+  }
+
+  get type() { return this[kType]; }
+  get metric() { return this[kMetric]; }
+  get pending() { return threadpoolPending[threadpoolWorkTypes[this[kType]]]; }
+
+  [kInspect]() {
+    return {
+      type: this.type,
+      metric: this.metric,
+      pending: this.pending,
+      ...super[kInspect]()
+    };
+  }
+}
+
 function monitorEventLoopDelay(options = {}) {
   if (typeof options !== 'object' || options === null) {
     throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
@@ -604,10 +710,38 @@ function monitorEventLoopDelay(options = {}) {
   return new ELDHistogram(new _ELDHistogram(resolution));
 }
 
+function monitorThreadpool(options = {}) {
+  if (typeof options !== 'object' || options === null) {
+    throw new ERR_INVALID_ARG_TYPE('options', 'Object', options);
+  }
+  const { type = 'fs', metric = 'total' } = options;
+  if (typeof type !== 'string') {
+    throw new ERR_INVALID_ARG_TYPE('options.type', 'string', type);
+  }
+  if (threadpoolWorkTypes[type] === undefined) {
+    throw new ERR_INVALID_OPT_VALUE('type', type);
+  }
+  if (typeof metric !== 'string') {
+    throw new ERR_INVALID_ARG_TYPE('options.metric', 'string', metric);
+  }
+  if (threadpoolWorkMetrics[metric] === undefined) {
+    throw new ERR_INVALID_OPT_VALUE('metric', metric);
+  }
+  if (type === 'fs' && metric !== 'total') {
+    // libuv does not report when fs requests start running.
+    throw new ERR_INVALID_OPT_VALUE('metric', metric);
+  }
+  return new ThreadpoolHistogram(
+    new _ThreadPoolHistogram(threadpoolWorkTypes[type],
+                             threadpoolWorkMetrics[metric]),
+    type, metric);
+}
+
 module.exports = {
   performance,
   PerformanceObserver,
-  monitorEventLoopDelay
+  monitorEventLoopDelay,
+  monitorThreadpool
 };
 
 Object.defineProperty(module.exports, 'constants', {
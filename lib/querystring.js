@@ -25,12 +25,14 @@
 
 const { Object } = primordials;
 
-const { Buffer } = require('buffer');
 const {
   encodeStr,
   hexTable,
-  isHexTable
+  isHexTable,
+  qsUnescape,
+  unescapeBuffer
 } = require('internal/querystring');
+const { parseFormUrlencoded } = internalBinding('url');
 const QueryString = module.exports = {
   unescapeBuffer,
   // `unescape()` is a JS global, so we need to use a different local name
@@ -46,77 +48,6 @@ const QueryString = module.exports = {
   decode: parse
 };
 
-const unhexTable = [
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 0 - 15
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 16 - 31
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 32 - 47
-  +0, +1, +2, +3, +4, +5, +6, +7, +8, +9, -1, -1, -1, -1, -1, -1, // 48 - 63
-  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 64 - 79
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 80 - 95
-  -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 96 - 111
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 112 - 127
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, // 128 ...
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1  // ... 255
-];
-// A safe fast alternative to decodeURIComponent
-function unescapeBuffer(s, decodeSpaces) {
-  const out = Buffer.allocUnsafe(s.length);
-  var index = 0;
-  var outIndex = 0;
-  var currentChar;
-  var nextChar;
-  var hexHigh;
-  var hexLow;
-  const maxLength = s.length - 2;
-  // Flag to know if some hex chars have been decoded
-  var hasHex = false;
-  while (index < s.length) {
-    currentChar = s.charCodeAt(index);
-    if (currentChar === 43 /* '+' */ && decodeSpaces) {
-      out[outIndex++] = 32; // ' '
-      index++;
-      continue;
-    }
-    if (currentChar === 37 /* '%' */ && index < maxLength) {
-      currentChar = s.charCodeAt(++index);
-      hexHigh = unhexTable[currentChar];
-      if (!(hexHigh >= 0)) {
-        out[outIndex++] = 37; // '%'
-      } else {
-        nextChar = s.charCodeAt(++index);
-        hexLow = unhexTable[nextChar];
-        if (!(hexLow >= 0)) {
-          out[outIndex++] = 37; // '%'
-          out[outIndex++] = currentChar;
-          currentChar = nextChar;
-        } else {
-          hasHex = true;
-          currentChar = hexHigh * 16 + hexLow;
-        }
-      }
-    }
-    out[outIndex++] = currentChar;
-    index++;
-  }
-  return hasHex ? out.slice(0, outIndex) : out;
-}
-
-
-function qsUnescape(s, decodeSpaces) {
-  try {
-    return decodeURIComponent(s);
-  } catch {
-    return QueryString.unescapeBuffer(s, decodeSpaces).toString();
-  }
-}
-
-
 // These characters do not need escaping when generating query strings:
 // ! - . _ ~
 // ' ( ) *
@@ -261,6 +192,17 @@ function parse(qs, sep, eq, options) {
   }
   const customDecode = (decode !== qsUnescape);
 
+  if (!customDecode &&
+      QueryString.unescapeBuffer === unescapeBuffer &&
+      sepCodes === defSepCodes && eqCodes === defEqCodes) {
+    const parsed = parseFormUrlencoded(qs, pairs);
+    if (parsed !== undefined) {
+      for (var j = 0; j < parsed.length; j += 2)
+        addKeyVal(obj, parsed[j], parsed[j + 1], false, false, decode);
+      return obj;
+    }
+  }
+
   var lastPos = 0;
   var sepIdx = 0;
   var eqIdx = 0;
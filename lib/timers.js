@@ -31,6 +31,8 @@ const L = require('internal/linkedlist');
 const {
   async_id_symbol,
   Timeout,
+  WheelTimeout,
+  unenrollWheelTimeout,
   decRefCount,
   immediateInfoFields: {
     kCount,
@@ -68,6 +70,11 @@ function unenroll(item) {
   }
   item._destroyed = true;
 
+  if (item instanceof WheelTimeout) {
+    unenrollWheelTimeout(item);
+    return;
+  }
+
   L.remove(item);
 
   // We only delete refed lists because unrefed ones are incredibly likely
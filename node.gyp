@@ -123,7 +123,6 @@
       'lib/internal/freeze_intrinsics.js',
       'lib/internal/fs/dir.js',
       'lib/internal/fs/promises.js',
-      'lib/internal/fs/read_file_context.js',
       'lib/internal/fs/rimraf.js',
       'lib/internal/fs/streams.js',
       'lib/internal/fs/sync_write_stream.js',
@@ -138,6 +137,7 @@
       'lib/internal/main/eval_string.js',
       'lib/internal/main/eval_stdin.js',
       'lib/internal/main/inspect.js',
+      'lib/internal/main/mksnapshot.js',
       'lib/internal/main/print_bash_completion.js',
       'lib/internal/main/print_help.js',
       'lib/internal/main/prof_process.js',
@@ -147,6 +147,7 @@
       'lib/internal/main/worker_thread.js',
       'lib/internal/modules/cjs/helpers.js',
       'lib/internal/modules/cjs/loader.js',
+      'lib/internal/modules/code_cache.js',
       'lib/internal/modules/esm/loader.js',
       'lib/internal/modules/esm/create_dynamic_module.js',
       'lib/internal/modules/esm/default_resolve.js',
@@ -439,13 +440,15 @@
               'process_outputs_as_sources': 1,
               'inputs': [
                 '<(mkcodecache_exec)',
+                'tools/code_cache/startup_profile.txt',
               ],
               'outputs': [
                 '<(SHARED_INTERMEDIATE_DIR)/node_code_cache.cc',
               ],
               'action': [
-                '<@(_inputs)',
+                '<(mkcodecache_exec)',
                 '<@(_outputs)',
+                'tools/code_cache/startup_profile.txt',
               ],
             },
           ],
@@ -518,6 +521,7 @@
         'src/js_native_api_v8.h',
         'src/js_native_api_v8_internals.h',
         'src/js_stream.cc',
+        'src/module_bundle.cc',
         'src/module_wrap.cc',
         'src/node.cc',
         'src/node_api.cc',
@@ -531,6 +535,7 @@
         'src/node_domain.cc',
         'src/node_env_var.cc',
         'src/node_errors.cc',
+        'src/node_external_reference.cc',
         'src/node_file.cc',
         'src/node_http_parser.cc',
         'src/node_http2.cc',
@@ -571,6 +576,7 @@
         'src/string_bytes.cc',
         'src/string_decoder.cc',
         'src/tcp_wrap.cc',
+        'src/timer_wheel.cc',
         'src/timers.cc',
         'src/tracing/agent.cc',
         'src/tracing/node_trace_buffer.cc',
@@ -599,6 +605,7 @@
         'src/js_stream.h',
         'src/memory_tracker.h',
         'src/memory_tracker-inl.h',
+        'src/module_bundle.h',
         'src/module_wrap.h',
         'src/node.h',
         'src/node_api.h',
@@ -610,6 +617,7 @@
         'src/node_contextify.h',
         'src/node_dir.h',
         'src/node_errors.h',
+        'src/node_external_reference.h',
         'src/node_file.h',
         'src/node_http2.h',
         'src/node_http2_state.h',
@@ -651,6 +659,7 @@
         'src/string_decoder-inl.h',
         'src/string_search.h',
         'src/tcp_wrap.h',
+        'src/timer_wheel.h',
         'src/tracing/agent.h',
         'src/tracing/node_trace_buffer.h',
         'src/tracing/node_trace_writer.h',
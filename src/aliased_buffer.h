@@ -9,6 +9,10 @@
 
 namespace node {
 
+// The index of the JS array of an AliasedBuffer in the data that is added to
+// the startup snapshot with SnapshotCreator::AddData().
+typedef size_t AliasedBufferIndex;
+
 /**
  * Do not use this class directly when creating instances of it - use the
  * Aliased*Array defined at the end of this file instead.
@@ -32,9 +36,19 @@ template <class NativeT,
           typename = std::enable_if_t<std::is_scalar<NativeT>::value>>
 class AliasedBufferBase {
  public:
-  AliasedBufferBase(v8::Isolate* isolate, const size_t count)
-      : isolate_(isolate), count_(count), byte_offset_(0) {
+  AliasedBufferBase(v8::Isolate* isolate,
+                    const size_t count,
+                    const AliasedBufferIndex* index = nullptr)
+      : isolate_(isolate),
+        count_(count),
+        byte_offset_(0),
+        buffer_(nullptr),
+        index_(index) {
     CHECK_GT(count, 0);
+    if (index != nullptr) {
+      // Will be deserialized later.
+      return;
+    }
     const v8::HandleScope handle_scope(isolate_);
     const size_t size_in_bytes =
         MultiplyWithOverflowCheck(sizeof(NativeT), count);
@@ -62,8 +76,17 @@ class AliasedBufferBase {
       v8::Isolate* isolate,
       const size_t byte_offset,
       const size_t count,
-      const AliasedBufferBase<uint8_t, v8::Uint8Array>& backing_buffer)
-      : isolate_(isolate), count_(count), byte_offset_(byte_offset) {
+      const AliasedBufferBase<uint8_t, v8::Uint8Array>& backing_buffer,
+      const AliasedBufferIndex* index = nullptr)
+      : isolate_(isolate),
+        count_(count),
+        byte_offset_(byte_offset),
+        buffer_(nullptr),
+        index_(index) {
+    if (index != nullptr) {
+      // Will be deserialized later.
+      return;
+    }
     const v8::HandleScope handle_scope(isolate_);
 
     v8::Local<v8::ArrayBuffer> ab = backing_buffer.GetArrayBuffer();
@@ -85,16 +108,40 @@ class AliasedBufferBase {
       : isolate_(that.isolate_),
         count_(that.count_),
         byte_offset_(that.byte_offset_),
-        buffer_(that.buffer_) {
+        buffer_(that.buffer_),
+        index_(nullptr) {
+    DCHECK_NULL(that.index_);
     js_array_ = v8::Global<V8T>(that.isolate_, that.GetJSArray());
   }
 
+  AliasedBufferIndex Serialize(v8::Local<v8::Context> context,
+                               v8::SnapshotCreator* creator) {
+    DCHECK_NULL(index_);
+    return creator->AddData(context, GetJSArray());
+  }
+
+  inline void Deserialize(v8::Local<v8::Context> context) {
+    DCHECK_NOT_NULL(index_);
+    v8::Local<V8T> arr =
+        context->GetDataFromSnapshotOnce<V8T>(*index_).ToLocalChecked();
+    // An owning buffer may have been grown before it was serialized.
+    if (byte_offset_ == 0) count_ = arr->Length();
+    DCHECK_EQ(count_, arr->Length());
+    DCHECK_EQ(byte_offset_, arr->ByteOffset());
+    uint8_t* raw =
+        static_cast<uint8_t*>(arr->Buffer()->GetContents().Data());
+    buffer_ = reinterpret_cast<NativeT*>(raw + byte_offset_);
+    js_array_.Reset(isolate_, arr);
+    index_ = nullptr;
+  }
+
   AliasedBufferBase& operator=(AliasedBufferBase&& that) noexcept {
     this->~AliasedBufferBase();
     isolate_ = that.isolate_;
     count_ = that.count_;
     byte_offset_ = that.byte_offset_;
     buffer_ = that.buffer_;
+    index_ = that.index_;
 
     js_array_.Reset(isolate_, that.js_array_.Get(isolate_));
 
@@ -155,6 +202,7 @@ class AliasedBufferBase {
    *  Get the underlying v8 TypedArray overlayed on top of the native buffer
    */
   v8::Local<V8T> GetJSArray() const {
+    DCHECK_NULL(index_);
     return js_array_.Get(isolate_);
   }
 
@@ -248,6 +296,9 @@ class AliasedBufferBase {
   size_t byte_offset_;
   NativeT* buffer_;
   v8::Global<V8T> js_array_;
+
+  // Deserialize data
+  const AliasedBufferIndex* index_ = nullptr;
 };
 
 typedef AliasedBufferBase<int32_t, v8::Int32Array> AliasedInt32Array;
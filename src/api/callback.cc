@@ -56,6 +56,22 @@ InternalCallbackScope::InternalCallbackScope(Environment* env,
     return;
   }
 
+  // Enter the async context captured by the resource. This happens outside
+  // of the HandleScope below so that the previous value stays alive until
+  // Close().
+  AsyncHooks* async_hooks = env->async_hooks();
+  if (async_hooks->uses_async_context()) {
+    Local<Value> value;
+    if (object.IsEmpty() ||
+        !object->GetPrivate(env->context(),
+                            env->async_context_private_symbol())
+            .ToLocal(&value)) {
+      value = v8::Undefined(env->isolate());
+    }
+    prev_async_context_ = async_hooks->async_context();
+    async_hooks->set_async_context(value);
+  }
+
   HandleScope handle_scope(env->isolate());
   // If you hit this assertion, you forgot to enter the v8::Context first.
   CHECK_EQ(Environment::GetCurrent(env->isolate()), env);
@@ -87,6 +103,9 @@ void InternalCallbackScope::Close() {
   if (pushed_ids_)
     env_->async_hooks()->pop_async_id(async_context_.async_id);
 
+  if (!prev_async_context_.IsEmpty())
+    env_->async_hooks()->set_async_context(prev_async_context_);
+
   if (failed_) return;
 
   if (async_context_.async_id != 0) {
@@ -23,6 +23,7 @@
 #include "async_wrap-inl.h"
 #include "env-inl.h"
 #include "node_errors.h"
+#include "node_external_reference.h"
 #include "tracing/traced_value.h"
 #include "util-inl.h"
 
@@ -226,6 +227,32 @@ static PromiseWrap* extractPromiseWrap(Local<Promise> promise) {
   return nullptr;
 }
 
+// Carries the async context from the point where a promise reaction is
+// created to where it runs. This only touches the promise's private
+// properties and never creates a PromiseWrap.
+static void AsyncContextPromiseHook(Environment* env,
+                                    PromiseHookType type,
+                                    Local<Promise> promise) {
+  AsyncHooks* async_hooks = env->async_hooks();
+  Local<Context> context = env->context();
+  if (type == PromiseHookType::kInit) {
+    Local<Value> value = async_hooks->async_context();
+    if (!value->IsUndefined()) {
+      USE(promise->SetPrivate(
+          context, env->async_context_private_symbol(), value));
+    }
+  } else if (type == PromiseHookType::kBefore) {
+    Local<Value> value;
+    if (!promise->GetPrivate(context, env->async_context_private_symbol())
+             .ToLocal(&value)) {
+      value = Undefined(env->isolate());
+    }
+    async_hooks->push_async_context(value);
+  } else if (type == PromiseHookType::kAfter) {
+    async_hooks->pop_async_context();
+  }
+}
+
 static void PromiseHook(PromiseHookType type, Local<Promise> promise,
                         Local<Value> parent) {
   Local<Context> context = promise->CreationContext();
@@ -235,6 +262,11 @@ static void PromiseHook(PromiseHookType type, Local<Promise> promise,
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "EnvPromiseHook", env);
 
+  if (env->async_hooks()->uses_async_context())
+    AsyncContextPromiseHook(env, type, promise);
+
+  if (!env->async_hooks()->promise_hook_enabled()) return;
+
   PromiseWrap* wrap = extractPromiseWrap(promise);
   if (type == PromiseHookType::kInit || wrap == nullptr) {
     bool silent = type != PromiseHookType::kInit;
@@ -326,18 +358,43 @@ static void SetupHooks(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void UpdatePromiseHook(Environment* env) {
+  // The per-Isolate API provides no way of knowing whether there are multiple
+  // users of the PromiseHook. That hopefully goes away when V8 introduces
+  // a per-context API.
+  AsyncHooks* async_hooks = env->async_hooks();
+  bool needed = async_hooks->promise_hook_enabled() ||
+                async_hooks->uses_async_context();
+  env->isolate()->SetPromiseHook(needed ? PromiseHook : nullptr);
+}
+
+
 static void EnablePromiseHook(const FunctionCallbackInfo<Value>& args) {
-  args.GetIsolate()->SetPromiseHook(PromiseHook);
+  Environment* env = Environment::GetCurrent(args);
+  env->async_hooks()->set_promise_hook_enabled(true);
+  UpdatePromiseHook(env);
 }
 
 
 static void DisablePromiseHook(const FunctionCallbackInfo<Value>& args) {
-  Isolate* isolate = args.GetIsolate();
+  Environment* env = Environment::GetCurrent(args);
+  env->async_hooks()->set_promise_hook_enabled(false);
+  UpdatePromiseHook(env);
+}
 
-  // The per-Isolate API provides no way of knowing whether there are multiple
-  // users of the PromiseHook. That hopefully goes away when V8 introduces
-  // a per-context API.
-  isolate->SetPromiseHook(nullptr);
+
+static void GetAsyncContext(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  args.GetReturnValue().Set(env->async_hooks()->async_context());
+}
+
+
+static void SetAsyncContext(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  bool was_used = env->async_hooks()->uses_async_context();
+  env->async_hooks()->set_async_context(args[0]);
+  if (!was_used)
+    UpdatePromiseHook(env);
 }
 
 
@@ -470,6 +527,8 @@ void AsyncWrap::Initialize(Local<Object> target,
   env->SetMethod(target, "queueDestroyAsyncId", QueueDestroyAsyncId);
   env->SetMethod(target, "enablePromiseHook", EnablePromiseHook);
   env->SetMethod(target, "disablePromiseHook", DisablePromiseHook);
+  env->SetMethod(target, "getAsyncContext", GetAsyncContext);
+  env->SetMethod(target, "setAsyncContext", SetAsyncContext);
   env->SetMethod(target, "registerDestroyHook", RegisterDestroyHook);
 
   PropertyAttribute ReadOnlyDontDelete =
@@ -528,6 +587,7 @@ void AsyncWrap::Initialize(Local<Object> target,
   SET_HOOKS_CONSTANT(kAsyncIdCounter);
   SET_HOOKS_CONSTANT(kDefaultTriggerAsyncId);
   SET_HOOKS_CONSTANT(kStackLength);
+  SET_HOOKS_CONSTANT(kUsesAsyncContext);
 #undef SET_HOOKS_CONSTANT
   FORCE_SET_TARGET_FIELD(target, "constants", constants);
 
@@ -565,6 +625,24 @@ void AsyncWrap::Initialize(Local<Object> target,
   }
 }
 
+void AsyncWrap::RegisterExternalReferences(
+    ExternalReferenceRegistry* registry) {
+  registry->Register(SetupHooks);
+  registry->Register(PushAsyncIds);
+  registry->Register(PopAsyncIds);
+  registry->Register(QueueDestroyAsyncId);
+  registry->Register(EnablePromiseHook);
+  registry->Register(DisablePromiseHook);
+  registry->Register(GetAsyncContext);
+  registry->Register(SetAsyncContext);
+  registry->Register(RegisterDestroyHook);
+  registry->Register(AsyncWrapObject::New);
+  registry->Register(AsyncWrap::GetAsyncId);
+  registry->Register(AsyncWrap::AsyncReset);
+  registry->Register(AsyncWrap::GetProviderType);
+  registry->Register(PromiseWrap::getIsChainedPromise);
+}
+
 
 AsyncWrap::AsyncWrap(Environment* env,
                      Local<Object> object,
@@ -693,6 +771,12 @@ void AsyncWrap::AsyncReset(Local<Object> resource, double execution_async_id,
       UNREACHABLE();
   }
 
+  if (env()->async_hooks()->uses_async_context()) {
+    USE(resource->SetPrivate(env()->context(),
+                             env()->async_context_private_symbol(),
+                             env()->async_hooks()->async_context()));
+  }
+
   if (silent) return;
 
   EmitAsyncInit(env(), resource,
@@ -780,3 +864,5 @@ Local<Object> AsyncWrap::GetOwner(Environment* env, Local<Object> obj) {
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(async_wrap, node::AsyncWrap::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(async_wrap,
+                               node::AsyncWrap::RegisterExternalReferences)
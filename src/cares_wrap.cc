@@ -30,10 +30,14 @@
 #include "uv.h"
 
 #include <cerrno>
+#include <climits>
 #include <cstring>
+#include <algorithm>
 #include <memory>
-#include <vector>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #ifdef __POSIX__
 # include <netdb.h>
@@ -66,8 +70,10 @@ using v8::Int32;
 using v8::Integer;
 using v8::Local;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 namespace {
@@ -122,6 +128,7 @@ inline const char* ToErrorCodeString(int status) {
 }
 
 class ChannelWrap;
+class QueryWrap;
 
 struct node_ares_task : public MemoryRetainer {
   ChannelWrap* channel;
@@ -150,6 +157,16 @@ using node_ares_task_list =
 
 class ChannelWrap : public AsyncWrap {
  public:
+  // The answers to A and AAAA queries, as received from the server. Only
+  // used if the resolver was created with the `cache` option.
+  struct CacheEntry {
+    int status;
+    MallocedBuffer<unsigned char> buf;
+    // uv_now() at the time the answer was received, and at which it expires.
+    uint64_t received;
+    uint64_t expires;
+  };
+
   ChannelWrap(Environment* env, Local<Object> object);
   ~ChannelWrap() override;
 
@@ -171,10 +188,30 @@ class ChannelWrap : public AsyncWrap {
   inline int active_query_count() { return active_query_count_; }
   inline node_ares_task_list* task_list() { return &task_list_; }
 
+  void EnableCache(uint32_t max_ttl, uint32_t negative_ttl, size_t max_entries);
+  inline bool cache_enabled() const { return max_cache_entries_ > 0; }
+  // Returns nullptr if there is no answer for `key` that has not expired.
+  const CacheEntry* LookupCache(const std::string& key);
+  void StoreInCache(const std::string& key,
+                    int type,
+                    int status,
+                    const unsigned char* buf,
+                    int len);
+  void ClearCache();
+  // Returns false if there is no query for `key` in flight yet, in which case
+  // the caller is expected to send one and to pass the answer to the queries
+  // returned by TakePendingQueries() afterwards.
+  bool JoinPendingQuery(const std::string& key, QueryWrap* wrap);
+  std::vector<QueryWrap*> TakePendingQueries(const std::string& key);
+
   void MemoryInfo(MemoryTracker* tracker) const override {
     if (timer_handle_ != nullptr)
       tracker->TrackField("timer_handle", *timer_handle_);
     tracker->TrackField("task_list", task_list_, "node_ares_task_list");
+    size_t cache_size = 0;
+    for (const auto& entry : cache_)
+      cache_size += entry.first.size() + entry.second.buf.size;
+    tracker->TrackFieldWithSize("cache", cache_size, "CacheEntry");
   }
 
   SET_MEMORY_INFO_NAME(ChannelWrap)
@@ -182,6 +219,8 @@ class ChannelWrap : public AsyncWrap {
 
   static void AresTimeout(uv_timer_t* handle);
 
+  static void GetCacheStats(const FunctionCallbackInfo<Value>& args);
+
  private:
   uv_timer_t* timer_handle_;
   ares_channel channel_;
@@ -190,6 +229,16 @@ class ChannelWrap : public AsyncWrap {
   bool library_inited_;
   int active_query_count_;
   node_ares_task_list task_list_;
+
+  // In seconds.
+  uint32_t max_cache_ttl_ = 0;
+  uint32_t negative_cache_ttl_ = 0;
+  size_t max_cache_entries_ = 0;
+  std::unordered_map<std::string, CacheEntry> cache_;
+  std::unordered_map<std::string, std::vector<QueryWrap*>> pending_queries_;
+  double cache_hits_ = 0;
+  double cache_misses_ = 0;
+  double coalesced_queries_ = 0;
 };
 
 ChannelWrap::ChannelWrap(Environment* env,
@@ -206,14 +255,31 @@ ChannelWrap::ChannelWrap(Environment* env,
   Setup();
 }
 
+// new ChannelWrap([maxTtl, negativeTtl, maxEntries])
 void ChannelWrap::New(const FunctionCallbackInfo<Value>& args) {
   CHECK(args.IsConstructCall());
-  CHECK_EQ(args.Length(), 0);
+  CHECK(args.Length() == 0 || args.Length() == 3);
 
   Environment* env = Environment::GetCurrent(args);
-  new ChannelWrap(env, args.This());
+  ChannelWrap* channel = new ChannelWrap(env, args.This());
+  if (args.Length() == 3) {
+    CHECK(args[0]->IsUint32());
+    CHECK(args[1]->IsUint32());
+    CHECK(args[2]->IsUint32());
+    channel->EnableCache(args[0].As<Uint32>()->Value(),
+                         args[1].As<Uint32>()->Value(),
+                         args[2].As<Uint32>()->Value());
+  }
 }
 
+}  // anonymous namespace
+
+// Lookups for the same hostname, family and flags that are started while
+// one of them is in flight wait for its result instead of taking up another
+// threadpool thread. The lookup that is in flight is kept in
+// env->pending_getaddrinfo_requests under its key, and owns the requests
+// that wait for it. Each of those keeps its own async context and
+// `verbatim` setting.
 class GetAddrInfoReqWrap : public ReqWrap<uv_getaddrinfo_t> {
  public:
   GetAddrInfoReqWrap(Environment* env,
@@ -226,8 +292,17 @@ class GetAddrInfoReqWrap : public ReqWrap<uv_getaddrinfo_t> {
 
   bool verbatim() const { return verbatim_; }
 
+  const std::string& key() const { return key_; }
+  void set_key(const std::string& key) { key_ = key; }
+
+  std::vector<std::unique_ptr<GetAddrInfoReqWrap>>* waiting() {
+    return &waiting_;
+  }
+
  private:
   const bool verbatim_;
+  std::string key_;
+  std::vector<std::unique_ptr<GetAddrInfoReqWrap>> waiting_;
 };
 
 GetAddrInfoReqWrap::GetAddrInfoReqWrap(Environment* env,
@@ -237,6 +312,7 @@ GetAddrInfoReqWrap::GetAddrInfoReqWrap(Environment* env,
     , verbatim_(verbatim) {
 }
 
+namespace {
 
 class GetNameInfoReqWrap : public ReqWrap<uv_getnameinfo_t> {
  public:
@@ -452,8 +528,6 @@ void cares_wrap_hostent_cpy(struct hostent* dest, const struct hostent* src) {
   dest->h_addrtype = src->h_addrtype;
 }
 
-class QueryWrap;
-
 void ChannelWrap::Setup() {
   struct ares_options options;
   memset(&options, 0, sizeof(options));
@@ -505,6 +579,9 @@ void ChannelWrap::CloseTimer() {
 }
 
 ChannelWrap::~ChannelWrap() {
+  // ares_destroy() fails the queries that are still in flight, the queries
+  // that wait for them are going away as well.
+  pending_queries_.clear();
   ares_destroy(channel_);
 
   if (library_inited_) {
@@ -523,6 +600,139 @@ void ChannelWrap::ModifyActivityQueryCount(int count) {
 }
 
 
+void ChannelWrap::EnableCache(uint32_t max_ttl,
+                              uint32_t negative_ttl,
+                              size_t max_entries) {
+  max_cache_ttl_ = max_ttl;
+  negative_cache_ttl_ = std::min(negative_ttl, max_ttl);
+  max_cache_entries_ = max_entries;
+}
+
+
+const ChannelWrap::CacheEntry* ChannelWrap::LookupCache(
+    const std::string& key) {
+  auto it = cache_.find(key);
+  if (it == cache_.end())
+    return nullptr;
+  if (it->second.expires <= uv_now(env()->event_loop())) {
+    cache_.erase(it);
+    return nullptr;
+  }
+  cache_hits_++;
+  return &it->second;
+}
+
+
+// Successful answers are kept for the smallest TTL of their records, and
+// answers that have no records, or for names that do not exist, for the
+// negative TTL. Both are capped at the maximum TTL.
+void ChannelWrap::StoreInCache(const std::string& key,
+                               int type,
+                               int status,
+                               const unsigned char* buf,
+                               int len) {
+  uint32_t ttl = 0;
+  if (status == ARES_SUCCESS) {
+    int naddrttls;
+    int min_ttl = INT_MAX;
+    int r;
+    if (type == ns_t_a) {
+      ares_addrttl addrttls[256];
+      naddrttls = arraysize(addrttls);
+      r = ares_parse_a_reply(buf, len, nullptr, addrttls, &naddrttls);
+      for (int i = 0; i < naddrttls; i++)
+        min_ttl = std::min(min_ttl, addrttls[i].ttl);
+    } else {
+      CHECK_EQ(type, ns_t_aaaa);
+      ares_addr6ttl addrttls[256];
+      naddrttls = arraysize(addrttls);
+      r = ares_parse_aaaa_reply(buf, len, nullptr, addrttls, &naddrttls);
+      for (int i = 0; i < naddrttls; i++)
+        min_ttl = std::min(min_ttl, addrttls[i].ttl);
+    }
+    if (r == ARES_SUCCESS && naddrttls > 0)
+      ttl = std::min<uint32_t>(std::max(min_ttl, 0), max_cache_ttl_);
+    else if (r == ARES_ENODATA)
+      ttl = negative_cache_ttl_;
+  } else if (status == ARES_ENODATA || status == ARES_ENOTFOUND) {
+    ttl = negative_cache_ttl_;
+  }
+  if (ttl == 0)
+    return;
+
+  const uint64_t now = uv_now(env()->event_loop());
+  if (cache_.size() >= max_cache_entries_ && cache_.count(key) == 0) {
+    for (auto it = cache_.begin(); it != cache_.end();) {
+      if (it->second.expires <= now)
+        it = cache_.erase(it);
+      else
+        ++it;
+    }
+    // Still full, make room for the new entry.
+    if (cache_.size() >= max_cache_entries_)
+      cache_.erase(cache_.begin());
+  }
+
+  CacheEntry& entry = cache_[key];
+  entry.status = status;
+  if (status == ARES_SUCCESS) {
+    entry.buf = MallocedBuffer<unsigned char>(len);
+    memcpy(entry.buf.data, buf, len);
+  } else {
+    entry.buf = MallocedBuffer<unsigned char>();
+  }
+  entry.received = now;
+  entry.expires = now + static_cast<uint64_t>(ttl) * 1000;
+}
+
+
+void ChannelWrap::ClearCache() {
+  cache_.clear();
+}
+
+
+bool ChannelWrap::JoinPendingQuery(const std::string& key, QueryWrap* wrap) {
+  auto it = pending_queries_.find(key);
+  if (it == pending_queries_.end()) {
+    pending_queries_.emplace(key, std::vector<QueryWrap*>());
+    cache_misses_++;
+    return false;
+  }
+  it->second.push_back(wrap);
+  coalesced_queries_++;
+  return true;
+}
+
+
+std::vector<QueryWrap*> ChannelWrap::TakePendingQueries(
+    const std::string& key) {
+  std::vector<QueryWrap*> queries;
+  auto it = pending_queries_.find(key);
+  if (it != pending_queries_.end()) {
+    queries = std::move(it->second);
+    pending_queries_.erase(it);
+  }
+  return queries;
+}
+
+
+// getCacheStats() returns [hits, misses, coalesced, entries]
+void ChannelWrap::GetCacheStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  ChannelWrap* channel;
+  ASSIGN_OR_RETURN_UNWRAP(&channel, args.Holder());
+
+  Local<Value> stats[] = {
+    Number::New(env->isolate(), channel->cache_hits_),
+    Number::New(env->isolate(), channel->cache_misses_),
+    Number::New(env->isolate(), channel->coalesced_queries_),
+    Number::New(env->isolate(), static_cast<double>(channel->cache_.size()))
+  };
+  args.GetReturnValue().Set(
+      Array::New(env->isolate(), stats, arraysize(stats)));
+}
+
+
 /**
  * This function is to check whether current servers are fallback servers
  * when cares initialized.
@@ -608,10 +818,38 @@ class QueryWrap : public AsyncWrap {
     TRACE_EVENT_NESTABLE_ASYNC_BEGIN1(
       TRACING_CATEGORY_NODE2(dns, native), trace_name_, this,
       "name", TRACE_STR_COPY(name));
+
+    if (channel_->cache_enabled() && dnsclass == ns_c_in &&
+        (type == ns_t_a || type == ns_t_aaaa)) {
+      // Names are case-insensitive.
+      cache_key_ = ToLower(std::to_string(type) + ":" + name);
+      cache_type_ = type;
+
+      const ChannelWrap::CacheEntry* entry =
+          channel_->LookupCache(cache_key_);
+      if (entry != nullptr) {
+        cache_age_ =
+            (uv_now(env()->event_loop()) - entry->received) / 1000;
+        SetResponse(entry->status, entry->buf.data, entry->buf.size);
+        return;
+      }
+      if (channel_->JoinPendingQuery(cache_key_, this))
+        return;
+    }
+
     ares_query(channel_->cares_channel(), name, dnsclass, type, Callback,
                MakeCallbackPointer());
   }
 
+  // Answers that come from the cache report the time that their records
+  // have left, like the server would.
+  template <typename T>
+  void AgeAddrTTLs(T* addrttls, int naddrttls) const {
+    const int age = std::min<uint64_t>(cache_age_, INT_MAX);
+    for (int i = 0; i < naddrttls; i++)
+      addrttls[i].ttl = std::max(addrttls[i].ttl - age, 0);
+  }
+
   struct ResponseData {
     int status;
     bool is_host;
@@ -654,19 +892,32 @@ class QueryWrap : public AsyncWrap {
     QueryWrap* wrap = FromCallbackPointer(arg);
     if (wrap == nullptr) return;
 
+    wrap->SetResponse(status, answer_buf, answer_len);
+
+    if (!wrap->cache_key_.empty() && status != ARES_EDESTRUCTION) {
+      ChannelWrap* channel = wrap->channel_;
+      channel->StoreInCache(
+          wrap->cache_key_, wrap->cache_type_, status, answer_buf, answer_len);
+      for (QueryWrap* query : channel->TakePendingQueries(wrap->cache_key_))
+        query->SetResponse(status, answer_buf, answer_len);
+    }
+  }
+
+  void SetResponse(int status, const unsigned char* answer_buf,
+                   int answer_len) {
     unsigned char* buf_copy = nullptr;
     if (status == ARES_SUCCESS) {
       buf_copy = node::Malloc<unsigned char>(answer_len);
       memcpy(buf_copy, answer_buf, answer_len);
     }
 
-    wrap->response_data_ = std::make_unique<ResponseData>();
-    ResponseData* data = wrap->response_data_.get();
+    response_data_ = std::make_unique<ResponseData>();
+    ResponseData* data = response_data_.get();
     data->status = status;
     data->is_host = false;
     data->buf = MallocedBuffer<unsigned char>(buf_copy, answer_len);
 
-    wrap->QueueResponseCallback(status);
+    QueueResponseCallback(status);
   }
 
   static void Callback(void* arg, int status, int timeouts,
@@ -740,6 +991,11 @@ class QueryWrap : public AsyncWrap {
  private:
   std::unique_ptr<ResponseData> response_data_;
   const char* trace_name_;
+  // Only set for queries that go through the cache of the channel.
+  std::string cache_key_;
+  int cache_type_ = 0;
+  // In seconds, for answers that come from the cache.
+  uint64_t cache_age_ = 0;
   // Pointer to pointer to 'this' that can be reset from the destructor,
   // in order to let Callback() know that 'this' no longer exists.
   QueryWrap** callback_ptr_ = nullptr;
@@ -1387,6 +1643,7 @@ class QueryAWrap: public QueryWrap {
       return;
     }
 
+    AgeAddrTTLs(addrttls, naddrttls);
     Local<Array> ttls = AddrTTLToArray<ares_addrttl>(env(),
                                                      addrttls,
                                                      naddrttls);
@@ -1433,6 +1690,7 @@ class QueryAaaaWrap: public QueryWrap {
       return;
     }
 
+    AgeAddrTTLs(addrttls, naddrttls);
     Local<Array> ttls = AddrTTLToArray<ares_addr6ttl>(env(),
                                                       addrttls,
                                                       naddrttls);
@@ -1809,9 +2067,9 @@ static void Query(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
-  std::unique_ptr<GetAddrInfoReqWrap> req_wrap {
-      static_cast<GetAddrInfoReqWrap*>(req->data)};
+void OnGetAddrInfo(GetAddrInfoReqWrap* req_wrap,
+                   int status,
+                   const struct addrinfo* res) {
   Environment* env = req_wrap->env();
 
   HandleScope handle_scope(env->isolate());
@@ -1865,10 +2123,8 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
     argv[1] = results;
   }
 
-  uv_freeaddrinfo(res);
-
   TRACE_EVENT_NESTABLE_ASYNC_END2(
-      TRACING_CATEGORY_NODE2(dns, native), "lookup", req_wrap.get(),
+      TRACING_CATEGORY_NODE2(dns, native), "lookup", req_wrap,
       "count", n, "verbatim", verbatim);
 
   // Make the callback into JavaScript
@@ -1876,6 +2132,22 @@ void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
 }
 
 
+void AfterGetAddrInfo(uv_getaddrinfo_t* req, int status, struct addrinfo* res) {
+  std::unique_ptr<GetAddrInfoReqWrap> req_wrap {
+      static_cast<GetAddrInfoReqWrap*>(req->data)};
+  Environment* env = req_wrap->env();
+
+  // Lookups that are started from the callbacks need a request of their own.
+  env->pending_getaddrinfo_requests.erase(req_wrap->key());
+
+  OnGetAddrInfo(req_wrap.get(), status, res);
+  for (const auto& waiting : *req_wrap->waiting())
+    OnGetAddrInfo(waiting.get(), status, res);
+
+  uv_freeaddrinfo(res);
+}
+
+
 void AfterGetNameInfo(uv_getnameinfo_t* req,
                       int status,
                       const char* hostname,
@@ -1984,14 +2256,26 @@ void GetAddrInfo(const FunctionCallbackInfo<Value>& args) {
       "family",
       family == AF_INET ? "ipv4" : family == AF_INET6 ? "ipv6" : "unspec");
 
+  std::string key = std::to_string(family) + ':' + std::to_string(flags) + ':';
+  key.append(*hostname, hostname.length());
+  auto pending = env->pending_getaddrinfo_requests.find(key);
+  if (pending != env->pending_getaddrinfo_requests.end()) {
+    pending->second->waiting()->push_back(std::move(req_wrap));
+    args.GetReturnValue().Set(0);
+    return;
+  }
+
   int err = req_wrap->Dispatch(uv_getaddrinfo,
                                AfterGetAddrInfo,
                                *hostname,
                                nullptr,
                                &hints);
-  if (err == 0)
+  if (err == 0) {
+    req_wrap->set_key(key);
+    env->pending_getaddrinfo_requests.emplace(key, req_wrap.get());
     // Release ownership of the pointer allowing the ownership to be transferred
     USE(req_wrap.release());
+  }
 
   args.GetReturnValue().Set(err);
 }
@@ -2141,8 +2425,11 @@ void SetServers(const FunctionCallbackInfo<Value>& args) {
   else
     err = ARES_EBADSTR;
 
-  if (err == ARES_SUCCESS)
+  if (err == ARES_SUCCESS) {
     channel->set_is_servers_default(false);
+    // Other servers may give other answers.
+    channel->ClearCache();
+  }
 
   args.GetReturnValue().Set(err);
 }
@@ -2245,6 +2532,8 @@ void Initialize(Local<Object> target,
   env->SetProtoMethodNoSideEffect(channel_wrap, "getServers", GetServers);
   env->SetProtoMethod(channel_wrap, "setServers", SetServers);
   env->SetProtoMethod(channel_wrap, "cancel", Cancel);
+  env->SetProtoMethodNoSideEffect(channel_wrap, "getCacheStats",
+                                  ChannelWrap::GetCacheStats);
 
   Local<String> channelWrapString =
       FIXED_ONE_BYTE_STRING(env->isolate(), "ChannelWrap");
@@ -64,28 +64,37 @@ inline MultiIsolatePlatform* IsolateData::platform() const {
   return platform_;
 }
 
-inline AsyncHooks::AsyncHooks()
-    : async_ids_stack_(env()->isolate(), 16 * 2),
-      fields_(env()->isolate(), kFieldsCount),
-      async_id_fields_(env()->isolate(), kUidFieldsCount) {
+inline AsyncHooks::AsyncHooks(const SerializeInfo* info)
+    : async_ids_stack_(env()->isolate(),
+                       16 * 2,
+                       MAYBE_FIELD_PTR(info, async_ids_stack)),
+      fields_(env()->isolate(), kFieldsCount, MAYBE_FIELD_PTR(info, fields)),
+      async_id_fields_(env()->isolate(),
+                       kUidFieldsCount,
+                       MAYBE_FIELD_PTR(info, async_id_fields)) {
   v8::HandleScope handle_scope(env()->isolate());
 
-  // Always perform async_hooks checks, not just when async_hooks is enabled.
-  // TODO(AndreasMadsen): Consider removing this for LTS releases.
-  // See discussion in https://github.com/nodejs/node/pull/15454
-  // When removing this, do it by reverting the commit. Otherwise the test
-  // and flag changes won't be included.
-  fields_[kCheck] = 1;
-
-  // kDefaultTriggerAsyncId should be -1, this indicates that there is no
-  // specified default value and it should fallback to the executionAsyncId.
-  // 0 is not used as the magic value, because that indicates a missing context
-  // which is different from a default context.
-  async_id_fields_[AsyncHooks::kDefaultTriggerAsyncId] = -1;
-
-  // kAsyncIdCounter should start at 1 because that'll be the id the execution
-  // context during bootstrap (code that runs before entering uv_run()).
-  async_id_fields_[AsyncHooks::kAsyncIdCounter] = 1;
+  // The provider strings are always created, the fields of a deserialized
+  // AsyncHooks keep the values they had when the snapshot was taken.
+  if (info == nullptr) {
+    // Always perform async_hooks checks, not just when async_hooks is enabled.
+    // TODO(AndreasMadsen): Consider removing this for LTS releases.
+    // See discussion in https://github.com/nodejs/node/pull/15454
+    // When removing this, do it by reverting the commit. Otherwise the test
+    // and flag changes won't be included.
+    fields_[kCheck] = 1;
+
+    // kDefaultTriggerAsyncId should be -1, this indicates that there is no
+    // specified default value and it should fallback to the
+    // executionAsyncId. 0 is not used as the magic value, because that
+    // indicates a missing context which is different from a default context.
+    async_id_fields_[AsyncHooks::kDefaultTriggerAsyncId] = -1;
+
+    // kAsyncIdCounter should start at 1 because that'll be the id the
+    // execution context during bootstrap (code that runs before entering
+    // uv_run()).
+    async_id_fields_[AsyncHooks::kAsyncIdCounter] = 1;
+  }
 
   // Create all the provider strings that will be passed to JS. Place them in
   // an array so the array index matches the PROVIDER id offset. This way the
@@ -188,6 +197,46 @@ inline void AsyncHooks::clear_async_id_stack() {
 // The DefaultTriggerAsyncIdScope(AsyncWrap*) constructor is defined in
 // async_wrap-inl.h to avoid a circular dependency.
 
+inline bool AsyncHooks::uses_async_context() {
+  return fields_[kUsesAsyncContext] != 0;
+}
+
+inline v8::Local<v8::Value> AsyncHooks::async_context() {
+  v8::Isolate* isolate = env()->isolate();
+  if (async_context_.IsEmpty())
+    return v8::Undefined(isolate);
+  return PersistentToLocal::Strong(async_context_);
+}
+
+inline void AsyncHooks::set_async_context(v8::Local<v8::Value> value) {
+  fields_[kUsesAsyncContext] = 1;
+  if (value->IsUndefined())
+    async_context_.Reset();
+  else
+    async_context_.Reset(env()->isolate(), value);
+}
+
+inline void AsyncHooks::push_async_context(v8::Local<v8::Value> value) {
+  async_context_stack_.emplace_back(env()->isolate(), async_context());
+  set_async_context(value);
+}
+
+inline void AsyncHooks::pop_async_context() {
+  // The stack may be empty if the async context was first used from within
+  // a promise reaction.
+  if (async_context_stack_.empty()) return;
+  async_context_ = std::move(async_context_stack_.back());
+  async_context_stack_.pop_back();
+}
+
+inline bool AsyncHooks::promise_hook_enabled() const {
+  return promise_hook_enabled_;
+}
+
+inline void AsyncHooks::set_promise_hook_enabled(bool enabled) {
+  promise_hook_enabled_ = enabled;
+}
+
 inline AsyncHooks::DefaultTriggerAsyncIdScope ::DefaultTriggerAsyncIdScope(
     Environment* env, double default_trigger_async_id)
     : async_hooks_(env->async_hooks()) {
@@ -224,15 +273,18 @@ inline size_t Environment::async_callback_scope_depth() const {
 }
 
 inline void Environment::PushAsyncCallbackScope() {
-  async_callback_scope_depth_++;
+  if (async_callback_scope_depth_++ == 0)
+    performance_state_->EnterCallbackScope();
 }
 
 inline void Environment::PopAsyncCallbackScope() {
-  async_callback_scope_depth_--;
+  if (--async_callback_scope_depth_ == 0)
+    performance_state_->LeaveCallbackScope();
 }
 
-inline ImmediateInfo::ImmediateInfo(v8::Isolate* isolate)
-    : fields_(isolate, kFieldsCount) {}
+inline ImmediateInfo::ImmediateInfo(v8::Isolate* isolate,
+                                    const SerializeInfo* info)
+    : fields_(isolate, kFieldsCount, MAYBE_FIELD_PTR(info, fields)) {}
 
 inline AliasedUint32Array& ImmediateInfo::fields() {
   return fields_;
@@ -266,8 +318,8 @@ inline void ImmediateInfo::ref_count_dec(uint32_t decrement) {
   fields_[kRefCount] -= decrement;
 }
 
-inline TickInfo::TickInfo(v8::Isolate* isolate)
-    : fields_(isolate, kFieldsCount) {}
+inline TickInfo::TickInfo(v8::Isolate* isolate, const SerializeInfo* info)
+    : fields_(isolate, kFieldsCount, MAYBE_FIELD_PTR(info, fields)) {}
 
 inline AliasedUint8Array& TickInfo::fields() {
   return fields_;
@@ -358,6 +410,10 @@ inline uv_timer_t* Environment::timer_handle() {
   return &timer_handle_;
 }
 
+inline TimerWheel* Environment::timer_wheel() {
+  return timer_wheel_.get();
+}
+
 inline Environment* Environment::from_immediate_check_handle(
     uv_check_t* handle) {
   return ContainerOf(&Environment::immediate_check_handle_, handle);
@@ -633,6 +689,10 @@ Environment::file_handle_read_wrap_freelist() {
   return file_handle_read_wrap_freelist_;
 }
 
+inline std::vector<BatchedStreamRead>& Environment::batched_stream_reads() {
+  return batched_stream_reads_;
+}
+
 inline std::shared_ptr<EnvironmentOptions> Environment::options() {
   return options_;
 }
@@ -12,6 +12,8 @@
 #include "node_process.h"
 #include "node_v8_platform-inl.h"
 #include "node_worker.h"
+#include "stream_base.h"
+#include "timer_wheel.h"
 #include "tracing/agent.h"
 #include "tracing/traced_value.h"
 #include "util-inl.h"
@@ -35,12 +37,14 @@ using v8::HandleScope;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
+using v8::MaybeLocal;
 using v8::NewStringType;
 using v8::Number;
 using v8::Object;
 using v8::Private;
 using v8::SnapshotCreator;
 using v8::StackTrace;
+using v8::StartupData;
 using v8::String;
 using v8::Symbol;
 using v8::TracingController;
@@ -261,6 +265,162 @@ void Environment::CreateProperties() {
   set_process_object(process_object);
 }
 
+bool Environment::IsSnapshotable() {
+  bool snapshotable = true;
+  // The handles, requests and BaseObjects point to native state that only
+  // exists in the process that takes the snapshot.
+  for (ReqWrapBase* req_wrap : *req_wrap_queue()) {
+    fprintf(stderr, "Cannot snapshot request %s\n",
+            req_wrap->GetAsyncWrap()->MemoryInfoName().c_str());
+    snapshotable = false;
+  }
+  for (HandleWrap* handle_wrap : *handle_wrap_queue()) {
+    fprintf(stderr, "Cannot snapshot handle %s\n",
+            handle_wrap->MemoryInfoName().c_str());
+    snapshotable = false;
+  }
+  ForEachBaseObject([&](BaseObject* obj) {
+    fprintf(stderr, "Cannot snapshot object %s\n",
+            obj->MemoryInfoName().c_str());
+    snapshotable = false;
+  });
+  if (async_hooks_.uses_async_context()) {
+    fprintf(stderr, "Cannot snapshot the async context\n");
+    snapshotable = false;
+  }
+  // Pending callbacks would never run in the processes that are started from
+  // the snapshot.
+  if (uv_is_active(reinterpret_cast<uv_handle_t*>(timer_handle()))) {
+    fprintf(stderr, "Cannot snapshot pending timers\n");
+    snapshotable = false;
+  }
+  if (immediate_info_.count() > 0) {
+    fprintf(stderr, "Cannot snapshot pending immediates\n");
+    snapshotable = false;
+  }
+  if (tick_info_.has_tick_scheduled()) {
+    fprintf(stderr, "Cannot snapshot pending process.nextTick() callbacks\n");
+    snapshotable = false;
+  }
+  return snapshotable;
+}
+
+EnvSerializeInfo Environment::Serialize(SnapshotCreator* creator) {
+  EnvSerializeInfo info;
+  Local<Context> ctx = context();
+
+  info.native_modules = std::vector<std::string>(
+      native_modules_with_cache.begin(), native_modules_with_cache.end());
+  info.native_modules.insert(info.native_modules.end(),
+                             native_modules_without_cache.begin(),
+                             native_modules_without_cache.end());
+  info.native_modules.insert(info.native_modules.end(),
+                             native_modules_in_snapshot.begin(),
+                             native_modules_in_snapshot.end());
+
+  info.async_hooks = async_hooks_.Serialize(ctx, creator);
+  info.immediate_info = immediate_info_.Serialize(ctx, creator);
+  info.tick_info = tick_info_.Serialize(ctx, creator);
+  info.performance_state = performance_state_->Serialize(ctx, creator);
+  info.stream_base_state = stream_base_state_.Serialize(ctx, creator);
+  info.should_abort_on_uncaught_toggle =
+      should_abort_on_uncaught_toggle_.Serialize(ctx, creator);
+  info.fs_stats_field_array = fs_stats_field_array_.Serialize(ctx, creator);
+  info.fs_stats_field_bigint_array =
+      fs_stats_field_bigint_array_.Serialize(ctx, creator);
+
+  size_t id = 0;
+#define V(PropertyName, TypeName)                                              \
+  do {                                                                         \
+    Local<TypeName> field = PropertyName();                                    \
+    if (!field.IsEmpty()) {                                                    \
+      size_t index = creator->AddData(field);                                  \
+      info.persistent_templates.push_back({#PropertyName, id, index});         \
+    }                                                                          \
+    id++;                                                                      \
+  } while (0);
+  ENVIRONMENT_STRONG_PERSISTENT_TEMPLATES(V)
+#undef V
+
+  id = 0;
+#define V(PropertyName, TypeName)                                              \
+  do {                                                                         \
+    Local<TypeName> field = PropertyName();                                    \
+    if (!field.IsEmpty()) {                                                    \
+      size_t index = creator->AddData(ctx, field);                             \
+      info.persistent_values.push_back({#PropertyName, id, index});            \
+    }                                                                          \
+    id++;                                                                      \
+  } while (0);
+  ENVIRONMENT_STRONG_PERSISTENT_VALUES(V)
+#undef V
+
+  return info;
+}
+
+void Environment::DeserializeProperties(const EnvSerializeInfo* info) {
+  Local<Context> ctx = context();
+
+  native_modules_in_snapshot.insert(info->native_modules.begin(),
+                                    info->native_modules.end());
+
+  // The properties that were empty when the snapshot was taken are not in
+  // the lists, so an entry is only taken when its id matches.
+  const std::vector<PropInfo>& templates = info->persistent_templates;
+  size_t i = 0;
+  size_t id = 0;
+#define V(PropertyName, TypeName)                                              \
+  do {                                                                         \
+    if (i < templates.size() && templates[i].id == id) {                       \
+      const PropInfo& prop = templates[i++];                                   \
+      DCHECK_EQ(prop.name, #PropertyName);                                     \
+      MaybeLocal<TypeName> field =                                             \
+          isolate_->GetDataFromSnapshotOnce<TypeName>(prop.index);             \
+      if (field.IsEmpty()) {                                                   \
+        fprintf(stderr, "Failed to deserialize " #PropertyName "\n");          \
+      }                                                                        \
+      set_##PropertyName(field.ToLocalChecked());                              \
+    }                                                                          \
+    id++;                                                                      \
+  } while (0);
+  ENVIRONMENT_STRONG_PERSISTENT_TEMPLATES(V)
+#undef V
+
+  const std::vector<PropInfo>& values = info->persistent_values;
+  i = 0;
+  id = 0;
+#define V(PropertyName, TypeName)                                              \
+  do {                                                                         \
+    if (i < values.size() && values[i].id == id) {                             \
+      const PropInfo& prop = values[i++];                                      \
+      DCHECK_EQ(prop.name, #PropertyName);                                     \
+      MaybeLocal<TypeName> field =                                             \
+          ctx->GetDataFromSnapshotOnce<TypeName>(prop.index);                  \
+      if (field.IsEmpty()) {                                                   \
+        fprintf(stderr, "Failed to deserialize " #PropertyName "\n");          \
+      }                                                                        \
+      set_##PropertyName(field.ToLocalChecked());                              \
+    }                                                                          \
+    id++;                                                                      \
+  } while (0);
+  ENVIRONMENT_STRONG_PERSISTENT_VALUES(V)
+#undef V
+
+  // The callback data still points to the Environment that was serialized.
+  as_callback_data()->SetAlignedPointerInInternalField(0, this);
+
+  set_has_run_bootstrapping_code(true);
+}
+
+StartupData SerializeNodeContextInternalFields(Local<Object> holder,
+                                               int index,
+                                               void* env) {
+  // Returning no data keeps the raw value of the field. The only pointer in
+  // such a field is the one in the callback data of the Environment, which
+  // DeserializeProperties() overwrites.
+  return StartupData{nullptr, 0};
+}
+
 std::string GetExecPath(const std::vector<std::string>& argv) {
   char exec_path_buf[2 * PATH_MAX];
   size_t exec_path_len = sizeof(exec_path_buf);
@@ -292,26 +452,51 @@ Environment::Environment(IsolateData* isolate_data,
                          const std::vector<std::string>& args,
                          const std::vector<std::string>& exec_args,
                          Flags flags,
-                         uint64_t thread_id)
+                         uint64_t thread_id,
+                         const EnvSerializeInfo* env_info)
     : isolate_(context->GetIsolate()),
       isolate_data_(isolate_data),
-      immediate_info_(context->GetIsolate()),
-      tick_info_(context->GetIsolate()),
+      async_hooks_(MAYBE_FIELD_PTR(env_info, async_hooks)),
+      immediate_info_(context->GetIsolate(),
+                      MAYBE_FIELD_PTR(env_info, immediate_info)),
+      tick_info_(context->GetIsolate(), MAYBE_FIELD_PTR(env_info, tick_info)),
       timer_base_(uv_now(isolate_data->event_loop())),
       exec_argv_(exec_args),
       argv_(args),
       exec_path_(GetExecPath(args)),
-      should_abort_on_uncaught_toggle_(isolate_, 1),
-      stream_base_state_(isolate_, StreamBase::kNumStreamBaseStateFields),
+      should_abort_on_uncaught_toggle_(
+          isolate_,
+          1,
+          MAYBE_FIELD_PTR(env_info, should_abort_on_uncaught_toggle)),
+      stream_base_state_(isolate_,
+                         StreamBase::kNumStreamBaseStateFields,
+                         MAYBE_FIELD_PTR(env_info, stream_base_state)),
       flags_(flags),
       thread_id_(thread_id == kNoThreadId ? AllocateThreadId() : thread_id),
-      fs_stats_field_array_(isolate_, kFsStatsBufferLength),
-      fs_stats_field_bigint_array_(isolate_, kFsStatsBufferLength),
+      fs_stats_field_array_(isolate_,
+                            kFsStatsBufferLength,
+                            MAYBE_FIELD_PTR(env_info, fs_stats_field_array)),
+      fs_stats_field_bigint_array_(
+          isolate_,
+          kFsStatsBufferLength,
+          MAYBE_FIELD_PTR(env_info, fs_stats_field_bigint_array)),
       context_(context->GetIsolate(), context) {
   // We'll be creating new objects so make sure we've entered the context.
   HandleScope handle_scope(isolate());
   Context::Scope context_scope(context);
 
+  // The aliased buffers of an Environment that comes from the snapshot have
+  // to be attached to the deserialized typed arrays before they are used.
+  if (env_info != nullptr) {
+    async_hooks_.Deserialize(context);
+    immediate_info_.Deserialize(context);
+    tick_info_.Deserialize(context);
+    should_abort_on_uncaught_toggle_.Deserialize(context);
+    stream_base_state_.Deserialize(context);
+    fs_stats_field_array_.Deserialize(context);
+    fs_stats_field_bigint_array_.Deserialize(context);
+  }
+
   set_env_vars(per_process::system_environment);
 
   // We create new copies of the per-Environment option sets, so that it is
@@ -343,8 +528,10 @@ Environment::Environment(IsolateData* isolate_data,
       },
       this);
 
-  performance_state_ =
-      std::make_unique<performance::performance_state>(isolate());
+  performance_state_ = std::make_unique<performance::performance_state>(
+      isolate(), MAYBE_FIELD_PTR(env_info, performance_state));
+  if (env_info != nullptr)
+    performance_state_->Deserialize(context);
   performance_state_->Mark(
       performance::NODE_PERFORMANCE_MILESTONE_ENVIRONMENT);
   performance_state_->Mark(performance::NODE_PERFORMANCE_MILESTONE_NODE_START,
@@ -380,9 +567,11 @@ Environment::Environment(IsolateData* isolate_data,
     async_hooks_.no_force_checks();
   }
 
-  // TODO(joyeecheung): deserialize when the snapshot covers the environment
-  // properties.
-  CreateProperties();
+  if (env_info != nullptr) {
+    DeserializeProperties(env_info);
+  } else {
+    CreateProperties();
+  }
 }
 
 Environment::~Environment() {
@@ -395,6 +584,9 @@ Environment::~Environment() {
 
   HandleScope handle_scope(isolate());
 
+  // Drop stream reads that never made it to JS.
+  batched_stream_reads_.clear();
+
 #if HAVE_INSPECTOR
   // Destroy inspector agent before erasing the context. The inspector
   // destructor depends on the context still being accessible.
@@ -439,6 +631,8 @@ void Environment::InitializeLibuv(bool start_profiler_idle_notifier) {
   CHECK_EQ(0, uv_timer_init(event_loop(), timer_handle()));
   uv_unref(reinterpret_cast<uv_handle_t*>(timer_handle()));
 
+  timer_wheel_.reset(new TimerWheel(this));
+
   uv_check_init(event_loop(), immediate_check_handle());
   uv_unref(reinterpret_cast<uv_handle_t*>(immediate_check_handle()));
 
@@ -455,11 +649,32 @@ void Environment::InitializeLibuv(bool start_profiler_idle_notifier) {
   // or check watcher runs first.  It's not 100% foolproof; if an add-on starts
   // a prepare or check watcher after us, any samples attributed to its callback
   // will be recorded with state=IDLE.
+  //
+  // The same handles drive the event loop phase accounting exposed through
+  // perf_hooks, so they are always running; the check handle is started after
+  // immediate_check_handle_ so that it runs first in the check phase.
   uv_prepare_init(event_loop(), &idle_prepare_handle_);
   uv_check_init(event_loop(), &idle_check_handle_);
   uv_unref(reinterpret_cast<uv_handle_t*>(&idle_prepare_handle_));
   uv_unref(reinterpret_cast<uv_handle_t*>(&idle_check_handle_));
 
+  uv_prepare_start(&idle_prepare_handle_, [](uv_prepare_t* handle) {
+    Environment* env = ContainerOf(&Environment::idle_prepare_handle_, handle);
+    env->performance_state()->MarkLoopPrepare();
+    if (env->profiler_idle_notifier_started())
+      env->isolate()->SetIdle(true);
+  });
+
+  uv_check_start(&idle_check_handle_, [](uv_check_t* handle) {
+    Environment* env = ContainerOf(&Environment::idle_check_handle_, handle);
+    // Deliver reads that were collected during the poll phase first, so that
+    // the time spent in JS is still attributed to the poll phase.
+    BatchedJSStreamListener::Flush(env);
+    env->performance_state()->MarkLoopCheck();
+    if (env->profiler_idle_notifier_started())
+      env->isolate()->SetIdle(false);
+  });
+
   thread_stopper()->Install(
     this, static_cast<void*>(this), [](uv_async_t* handle) {
       Environment* env = static_cast<Environment*>(handle->data);
@@ -505,6 +720,10 @@ void Environment::RegisterHandleCleanups() {
       reinterpret_cast<uv_handle_t*>(timer_handle()),
       close_and_finish,
       nullptr);
+  RegisterHandleCleanup(
+      reinterpret_cast<uv_handle_t*>(timer_wheel_->timer_handle()),
+      close_and_finish,
+      nullptr);
   RegisterHandleCleanup(
       reinterpret_cast<uv_handle_t*>(immediate_check_handle()),
       close_and_finish,
@@ -544,26 +763,11 @@ void Environment::CleanupHandles() {
 }
 
 void Environment::StartProfilerIdleNotifier() {
-  if (profiler_idle_notifier_started_)
-    return;
-
   profiler_idle_notifier_started_ = true;
-
-  uv_prepare_start(&idle_prepare_handle_, [](uv_prepare_t* handle) {
-    Environment* env = ContainerOf(&Environment::idle_prepare_handle_, handle);
-    env->isolate()->SetIdle(true);
-  });
-
-  uv_check_start(&idle_check_handle_, [](uv_check_t* handle) {
-    Environment* env = ContainerOf(&Environment::idle_check_handle_, handle);
-    env->isolate()->SetIdle(false);
-  });
 }
 
 void Environment::StopProfilerIdleNotifier() {
   profiler_idle_notifier_started_ = false;
-  uv_prepare_stop(&idle_prepare_handle_);
-  uv_check_stop(&idle_check_handle_);
 }
 
 void Environment::PrintSyncTrace() const {
@@ -696,6 +900,10 @@ void Environment::RunTimers(uv_timer_t* handle) {
   Environment* env = Environment::from_timer_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "RunTimers", env);
+  uint64_t start = uv_hrtime();
+  OnScopeLeave mark_done([&]() {
+    env->performance_state()->MarkTimersDone(start);
+  });
 
   if (!env->can_call_into_js())
     return;
@@ -758,6 +966,9 @@ void Environment::CheckImmediate(uv_check_t* handle) {
   Environment* env = Environment::from_immediate_check_handle(handle);
   TraceEventScope trace_scope(TRACING_CATEGORY_NODE1(environment),
                               "CheckImmediate", env);
+  OnScopeLeave mark_done([&]() {
+    env->performance_state()->MarkImmediatesDone();
+  });
 
   if (env->immediate_info()->count() == 0)
     return;
@@ -904,6 +1115,37 @@ void AsyncHooks::MemoryInfo(MemoryTracker* tracker) const {
   tracker->TrackField("async_id_fields", async_id_fields_);
 }
 
+ImmediateInfo::SerializeInfo ImmediateInfo::Serialize(
+    Local<Context> context, SnapshotCreator* creator) {
+  return {fields_.Serialize(context, creator)};
+}
+
+void ImmediateInfo::Deserialize(Local<Context> context) {
+  fields_.Deserialize(context);
+}
+
+TickInfo::SerializeInfo TickInfo::Serialize(Local<Context> context,
+                                            SnapshotCreator* creator) {
+  return {fields_.Serialize(context, creator)};
+}
+
+void TickInfo::Deserialize(Local<Context> context) {
+  fields_.Deserialize(context);
+}
+
+AsyncHooks::SerializeInfo AsyncHooks::Serialize(Local<Context> context,
+                                                SnapshotCreator* creator) {
+  return {async_ids_stack_.Serialize(context, creator),
+          fields_.Serialize(context, creator),
+          async_id_fields_.Serialize(context, creator)};
+}
+
+void AsyncHooks::Deserialize(Local<Context> context) {
+  async_ids_stack_.Deserialize(context);
+  fields_.Deserialize(context);
+  async_id_fields_.Deserialize(context);
+}
+
 void AsyncHooks::grow_async_ids_stack() {
   async_ids_stack_.reserve(async_ids_stack_.Length() * 3);
 
@@ -35,6 +35,7 @@
 #include "node_http2_state.h"
 #include "node_main_instance.h"
 #include "node_options.h"
+#include "node_perf_common.h"
 #include "req_wrap.h"
 #include "util.h"
 #include "uv.h"
@@ -53,6 +54,10 @@ struct nghttp2_rcbuf;
 
 namespace node {
 
+namespace cares_wrap {
+class GetAddrInfoReqWrap;
+}
+
 namespace contextify {
 class ContextifyScript;
 class CompiledFnEntry;
@@ -103,6 +108,17 @@ struct PackageConfig {
 
   v8::Global<v8::Value> exports;
 };
+
+// The entries of a directory, as seen by the CommonJS resolver when
+// --experimental-resolution-cache is used.
+struct DirectoryListing {
+  static constexpr int kNeedsStat = -1;
+
+  bool exists = false;
+  // 0 for files, 1 for directories, kNeedsStat for symbolic links and other
+  // entries whose type is only known after a stat() call.
+  std::unordered_map<std::string, int> entries;
+};
 }  // namespace loader
 
 enum class FsStatsOffset {
@@ -149,6 +165,7 @@ constexpr size_t kFsStatsBufferLength =
 #define PER_ISOLATE_PRIVATE_SYMBOL_PROPERTIES(V)                              \
   V(alpn_buffer_private_symbol, "node:alpnBuffer")                            \
   V(arrow_message_private_symbol, "node:arrowMessage")                        \
+  V(async_context_private_symbol, "node:asyncContext")                        \
   V(contextify_context_private_symbol, "node:contextify:context")             \
   V(contextify_global_private_symbol, "node:contextify:global")               \
   V(decorated_private_symbol, "node:decorated")                               \
@@ -446,7 +463,9 @@ constexpr size_t kFsStatsBufferLength =
   V(promise_reject_callback, v8::Function)                                     \
   V(script_data_constructor_function, v8::Function)                            \
   V(source_map_cache_getter, v8::Function)                                     \
+  V(stream_read_batch_function, v8::Function)                                  \
   V(tick_callback_function, v8::Function)                                      \
+  V(timer_wheel_callback_function, v8::Function)                               \
   V(timers_callback_function, v8::Function)                                    \
   V(tls_wrap_constructor_function, v8::Function)                               \
   V(trace_category_state_function, v8::Function)                               \
@@ -454,6 +473,7 @@ constexpr size_t kFsStatsBufferLength =
   V(url_constructor_function, v8::Function)
 
 class Environment;
+class TimerWheel;
 
 class IsolateData : public MemoryRetainer {
  public:
@@ -575,6 +595,16 @@ struct AllocatedBuffer {
   friend class Environment;
 };
 
+// A stream read that is waiting to be delivered to JS as part of a batch,
+// see BatchedJSStreamListener in stream_base.h.
+struct BatchedStreamRead {
+  v8::Global<v8::Object> object;
+  ssize_t nread;
+  AllocatedBuffer buffer;
+  double async_id;
+  double trigger_async_id;
+};
+
 class AsyncRequest : public MemoryRetainer {
  public:
   AsyncRequest() = default;
@@ -650,6 +680,7 @@ class AsyncHooks : public MemoryRetainer {
     kTotals,
     kCheck,
     kStackLength,
+    kUsesAsyncContext,
     kFieldsCount,
   };
 
@@ -667,6 +698,16 @@ class AsyncHooks : public MemoryRetainer {
 
   inline v8::Local<v8::String> provider_string(int idx);
 
+  struct SerializeInfo {
+    AliasedBufferIndex async_ids_stack;
+    AliasedBufferIndex fields;
+    AliasedBufferIndex async_id_fields;
+  };
+
+  SerializeInfo Serialize(v8::Local<v8::Context> context,
+                          v8::SnapshotCreator* creator);
+  void Deserialize(v8::Local<v8::Context> context);
+
   inline void no_force_checks();
   inline Environment* env();
 
@@ -674,6 +715,21 @@ class AsyncHooks : public MemoryRetainer {
   inline bool pop_async_id(double async_id);
   inline void clear_async_id_stack();  // Used in fatal exceptions.
 
+  // The async context is a single value that is captured by every async
+  // resource when it is created and restored while its callbacks run,
+  // without calling into any JS hooks. Nothing is tracked until
+  // set_async_context() has been called once.
+  inline bool uses_async_context();
+  inline v8::Local<v8::Value> async_context();
+  inline void set_async_context(v8::Local<v8::Value> value);
+  // Used by the PromiseHook, where before and after are separate calls.
+  inline void push_async_context(v8::Local<v8::Value> value);
+  inline void pop_async_context();
+
+  // Whether async_hooks wants to be notified about promises.
+  inline bool promise_hook_enabled() const;
+  inline void set_promise_hook_enabled(bool enabled);
+
   AsyncHooks(const AsyncHooks&) = delete;
   AsyncHooks& operator=(const AsyncHooks&) = delete;
   AsyncHooks(AsyncHooks&&) = delete;
@@ -704,7 +760,7 @@ class AsyncHooks : public MemoryRetainer {
 
  private:
   friend class Environment;  // So we can call the constructor.
-  inline AsyncHooks();
+  inline explicit AsyncHooks(const SerializeInfo* info);
   // Keep a list of all Persistent strings used for Provider types.
   std::array<v8::Eternal<v8::String>, AsyncWrap::PROVIDERS_LENGTH> providers_;
   // Stores the ids of the current execution context stack.
@@ -715,6 +771,10 @@ class AsyncHooks : public MemoryRetainer {
   // Attached to a Float64Array that tracks the state of async resources.
   AliasedFloat64Array async_id_fields_;
 
+  v8::Global<v8::Value> async_context_;
+  std::vector<v8::Global<v8::Value>> async_context_stack_;
+  bool promise_hook_enabled_ = false;
+
   void grow_async_ids_stack();
 };
 
@@ -743,6 +803,14 @@ class ImmediateInfo : public MemoryRetainer {
   inline void ref_count_inc(uint32_t increment);
   inline void ref_count_dec(uint32_t decrement);
 
+  struct SerializeInfo {
+    AliasedBufferIndex fields;
+  };
+
+  SerializeInfo Serialize(v8::Local<v8::Context> context,
+                          v8::SnapshotCreator* creator);
+  void Deserialize(v8::Local<v8::Context> context);
+
   ImmediateInfo(const ImmediateInfo&) = delete;
   ImmediateInfo& operator=(const ImmediateInfo&) = delete;
   ImmediateInfo(ImmediateInfo&&) = delete;
@@ -755,7 +823,7 @@ class ImmediateInfo : public MemoryRetainer {
 
  private:
   friend class Environment;  // So we can call the constructor.
-  inline explicit ImmediateInfo(v8::Isolate* isolate);
+  inline ImmediateInfo(v8::Isolate* isolate, const SerializeInfo* info);
 
   enum Fields { kCount, kRefCount, kHasOutstanding, kFieldsCount };
 
@@ -768,6 +836,14 @@ class TickInfo : public MemoryRetainer {
   inline bool has_tick_scheduled() const;
   inline bool has_rejection_to_warn() const;
 
+  struct SerializeInfo {
+    AliasedBufferIndex fields;
+  };
+
+  SerializeInfo Serialize(v8::Local<v8::Context> context,
+                          v8::SnapshotCreator* creator);
+  void Deserialize(v8::Local<v8::Context> context);
+
   SET_MEMORY_INFO_NAME(TickInfo)
   SET_SELF_SIZE(TickInfo)
   void MemoryInfo(MemoryTracker* tracker) const override;
@@ -780,7 +856,7 @@ class TickInfo : public MemoryRetainer {
 
  private:
   friend class Environment;  // So we can call the constructor.
-  inline explicit TickInfo(v8::Isolate* isolate);
+  inline TickInfo(v8::Isolate* isolate, const SerializeInfo* info);
 
   enum Fields { kHasTickScheduled = 0, kHasRejectionToWarn, kFieldsCount };
 
@@ -852,6 +928,37 @@ class CleanupHookCallback {
   uint64_t insertion_order_counter_;
 };
 
+// A persistent property of the Environment and where it is stored in the
+// snapshot. The id is the position of the property in its list, since the
+// properties that are empty when the snapshot is taken are skipped.
+struct PropInfo {
+  std::string name;  // For debugging.
+  size_t id;
+  size_t index;
+};
+
+// The state of a bootstrapped Environment that is not part of the V8 heap,
+// with the indexes of the V8 objects that it refers to in the snapshot.
+struct EnvSerializeInfo {
+  std::vector<std::string> native_modules;
+  AsyncHooks::SerializeInfo async_hooks;
+  TickInfo::SerializeInfo tick_info;
+  ImmediateInfo::SerializeInfo immediate_info;
+  performance::performance_state::SerializeInfo performance_state;
+  AliasedBufferIndex stream_base_state;
+  AliasedBufferIndex should_abort_on_uncaught_toggle;
+  AliasedBufferIndex fs_stats_field_array;
+  AliasedBufferIndex fs_stats_field_bigint_array;
+  std::vector<PropInfo> persistent_templates;
+  std::vector<PropInfo> persistent_values;
+};
+
+// Used as the internal field serializer of the contexts that are added to a
+// snapshot.
+v8::StartupData SerializeNodeContextInternalFields(v8::Local<v8::Object> holder,
+                                                   int index,
+                                                   void* env);
+
 class Environment : public MemoryRetainer {
  public:
   Environment(const Environment&) = delete;
@@ -866,6 +973,11 @@ class Environment : public MemoryRetainer {
   void MemoryInfo(MemoryTracker* tracker) const override;
 
   void CreateProperties();
+  // Returns false and prints the offending objects if the Environment holds
+  // state that cannot be put into a snapshot, e.g. handles, requests or
+  // pending callbacks. InitializeLibuv() must have been called.
+  bool IsSnapshotable();
+  EnvSerializeInfo Serialize(v8::SnapshotCreator* creator);
   // Should be called before InitializeInspector()
   void InitializeDiagnostics();
 #if HAVE_INSPECTOR && NODE_USE_V8_PLATFORM
@@ -908,7 +1020,8 @@ class Environment : public MemoryRetainer {
               const std::vector<std::string>& args,
               const std::vector<std::string>& exec_args,
               Flags flags = Flags(),
-              uint64_t thread_id = kNoThreadId);
+              uint64_t thread_id = kNoThreadId,
+              const EnvSerializeInfo* env_info = nullptr);
   ~Environment();
 
   void InitializeLibuv(bool start_profiler_idle_notifier);
@@ -954,6 +1067,7 @@ class Environment : public MemoryRetainer {
 
   static inline Environment* from_timer_handle(uv_timer_t* handle);
   inline uv_timer_t* timer_handle();
+  inline TimerWheel* timer_wheel();
 
   static inline Environment* from_immediate_check_handle(uv_check_t* handle);
   inline uv_check_t* immediate_check_handle();
@@ -1008,6 +1122,9 @@ class Environment : public MemoryRetainer {
 
   std::set<std::string> native_modules_with_cache;
   std::set<std::string> native_modules_without_cache;
+  // The modules that were compiled when the snapshot that the Environment is
+  // deserialized from was taken.
+  std::set<std::string> native_modules_in_snapshot;
 
   std::unordered_multimap<int, loader::ModuleWrap*> hash_to_module_map;
   std::unordered_map<uint32_t, loader::ModuleWrap*> id_to_module_map;
@@ -1021,6 +1138,10 @@ class Environment : public MemoryRetainer {
 
   std::unordered_map<std::string, const loader::PackageConfig>
       package_json_cache;
+  std::unordered_map<std::string, loader::DirectoryListing>
+      module_directory_cache;
+  std::unordered_map<std::string, cares_wrap::GetAddrInfoReqWrap*>
+      pending_getaddrinfo_requests;
 
   inline double* heap_statistics_buffer() const;
   inline void set_heap_statistics_buffer(double* pointer);
@@ -1049,6 +1170,8 @@ class Environment : public MemoryRetainer {
   inline std::vector<std::unique_ptr<fs::FileHandleReadWrap>>&
       file_handle_read_wrap_freelist();
 
+  inline std::vector<BatchedStreamRead>& batched_stream_reads();
+
   inline performance::performance_state* performance_state();
   inline std::unordered_map<std::string, uint64_t>* performance_marks();
 
@@ -1265,10 +1388,13 @@ class Environment : public MemoryRetainer {
   inline void ThrowError(v8::Local<v8::Value> (*fun)(v8::Local<v8::String>),
                          const char* errmsg);
 
+  void DeserializeProperties(const EnvSerializeInfo* info);
+
   std::list<binding::DLib> loaded_addons_;
   v8::Isolate* const isolate_;
   IsolateData* const isolate_data_;
   uv_timer_t timer_handle_;
+  std::unique_ptr<TimerWheel> timer_wheel_;
   uv_check_t immediate_check_handle_;
   uv_idle_t immediate_idle_handle_;
   uv_prepare_t idle_prepare_handle_;
@@ -1372,6 +1498,8 @@ class Environment : public MemoryRetainer {
   std::vector<std::unique_ptr<fs::FileHandleReadWrap>>
       file_handle_read_wrap_freelist_;
 
+  std::vector<BatchedStreamRead> batched_stream_reads_;
+
   worker::Worker* worker_context_ = nullptr;
 
   static void RunTimers(uv_timer_t* handle);
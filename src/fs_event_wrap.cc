@@ -26,23 +26,41 @@
 #include "handle_wrap.h"
 #include "string_bytes.h"
 
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#endif
 
 namespace node {
 
+using v8::Array;
 using v8::Context;
 using v8::DontDelete;
 using v8::DontEnum;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int32;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Null;
 using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::Signature;
 using v8::String;
+using v8::Uint32;
 using v8::Value;
 
 namespace {
@@ -74,6 +92,101 @@ class FSEventWrap: public HandleWrap {
   enum encoding encoding_ = kDefaultEncoding;
 };
 
+#ifdef __linux__
+// libuv watches a single directory per uv_fs_event_t on Linux. This watches
+// whole directory trees instead, with a single inotify instance that
+// lib/internal/fs/watchers.js shares between all recursive watchers of an
+// Environment. Watches are added for new subdirectories as they appear, and
+// the events of each root are coalesced for its window before they are
+// passed to JS in one batch. The directories below a root are scanned in
+// small batches from an idle handle, so that adding a large tree, or one
+// that is being filled by e.g. `npm install`, does not block the event loop.
+class InotifyWrap: public HandleWrap {
+ public:
+  static void Initialize(Environment* env, Local<Object> target);
+  static void New(const FunctionCallbackInfo<Value>& args);
+  static void Start(const FunctionCallbackInfo<Value>& args);
+  static void Add(const FunctionCallbackInfo<Value>& args);
+  static void Remove(const FunctionCallbackInfo<Value>& args);
+
+  void Close(Local<Value> close_callback = Local<Value>()) override;
+
+  SET_NO_MEMORY_INFO()
+  SET_MEMORY_INFO_NAME(InotifyWrap)
+  SET_SELF_SIZE(InotifyWrap)
+
+ private:
+  static const encoding kDefaultEncoding = UTF8;
+  static const uint32_t kWatchMask =
+      IN_ATTRIB | IN_CREATE | IN_MODIFY | IN_DELETE | IN_DELETE_SELF |
+      IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+  // The number of directories that are scanned per loop iteration.
+  static const size_t kScanBatch = 64;
+
+  struct Event {
+    bool rename;
+    bool has_filename;
+    std::string filename;  // Relative to the root.
+  };
+
+  struct Root {
+    std::string path;
+    uint64_t window;
+    enum encoding encoding;
+    uint64_t deadline;
+    std::vector<Event> pending;
+    std::unordered_set<std::string> seen;
+    // A directory below the root could not be watched, e.g. because the
+    // inotify watch limit has been reached. It is passed to JS once, and no
+    // further directories are watched for the root.
+    int error = 0;
+    bool failed = false;
+  };
+
+  // A directory that still has to be watched and read.
+  struct Scan {
+    int32_t id;
+    std::string path;
+    bool report;
+  };
+
+  struct Watch {
+    std::string path;
+    // Roots can overlap, so a directory may be watched for several of them.
+    std::vector<int32_t> roots;
+  };
+
+  InotifyWrap(Environment* env, Local<Object> object);
+  ~InotifyWrap() = default;
+
+  void OnClose() override;
+
+  static std::string Join(const std::string& dir, const char* name);
+  int WatchDir(int32_t id, const std::string& dir, bool report);
+  void ScanLater(int32_t id, std::string&& dir, bool report);
+  void ScanSome();
+  void RemoveTree(const std::string& dir, const std::vector<int32_t>& ids);
+  void ForgetPath(const std::string& path, int wd);
+  void RemoveRoot(int32_t id);
+  void Queue(int32_t id, bool rename, const std::string* path);
+  void OnEvent(const struct inotify_event* event);
+  void Flush();
+
+  static void OnPoll(uv_poll_t* handle, int status, int events);
+  static void OnTimer(uv_timer_t* handle);
+  static void OnIdle(uv_idle_t* handle);
+
+  uv_poll_t handle_;
+  uv_timer_t* timer_ = nullptr;
+  uv_idle_t* idle_ = nullptr;
+  std::deque<Scan> scans_;
+  int fd_ = -1;
+  std::unordered_map<int32_t, Root> roots_;
+  std::unordered_map<int, Watch> watches_;
+  std::unordered_map<std::string, int> wds_;
+};
+#endif  // __linux__
+
 
 FSEventWrap::FSEventWrap(Environment* env, Local<Object> object)
     : HandleWrap(env,
@@ -230,7 +343,474 @@ void FSEventWrap::OnEvent(uv_fs_event_t* handle, const char* filename,
   wrap->MakeCallback(env->onchange_string(), arraysize(argv), argv);
 }
 
+#ifdef __linux__
+InotifyWrap::InotifyWrap(Environment* env, Local<Object> object)
+    : HandleWrap(env,
+                 object,
+                 reinterpret_cast<uv_handle_t*>(&handle_),
+                 AsyncWrap::PROVIDER_FSEVENTWRAP) {
+  MarkAsUninitialized();
+}
+
+
+void InotifyWrap::Initialize(Environment* env, Local<Object> target) {
+  auto inotify_string = FIXED_ONE_BYTE_STRING(env->isolate(), "InotifyWatcher");
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(New);
+  t->InstanceTemplate()->SetInternalFieldCount(1);
+  t->SetClassName(inotify_string);
+
+  t->Inherit(AsyncWrap::GetConstructorTemplate(env));
+  env->SetProtoMethod(t, "start", Start);
+  env->SetProtoMethod(t, "add", Add);
+  env->SetProtoMethod(t, "remove", Remove);
+  env->SetProtoMethod(t, "close", HandleWrap::Close);
+  env->SetProtoMethod(t, "ref", HandleWrap::Ref);
+  env->SetProtoMethod(t, "unref", HandleWrap::Unref);
+
+  target->Set(env->context(),
+              inotify_string,
+              t->GetFunction(env->context()).ToLocalChecked()).Check();
+}
+
+
+void InotifyWrap::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  new InotifyWrap(env, args.This());
+}
+
+
+// watcher.start()
+void InotifyWrap::Start(const FunctionCallbackInfo<Value>& args) {
+  InotifyWrap* wrap = Unwrap<InotifyWrap>(args.This());
+  CHECK_NOT_NULL(wrap);
+  CHECK(wrap->IsHandleClosing());  // Check that Start() has not been called.
+  uv_loop_t* loop = wrap->env()->event_loop();
+
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == -1)
+    return args.GetReturnValue().Set(uv_translate_sys_error(errno));
+
+  int err = uv_poll_init(loop, &wrap->handle_, fd);
+  if (err != 0) {
+    close(fd);
+    return args.GetReturnValue().Set(err);
+  }
+  wrap->fd_ = fd;
+  wrap->MarkAsInitialized();
+
+  wrap->timer_ = new uv_timer_t();
+  CHECK_EQ(0, uv_timer_init(loop, wrap->timer_));
+  wrap->timer_->data = wrap;
+  // Only the poll handle keeps the loop alive, so that ref() and unref()
+  // work as usual.
+  uv_unref(reinterpret_cast<uv_handle_t*>(wrap->timer_));
+  wrap->idle_ = new uv_idle_t();
+  CHECK_EQ(0, uv_idle_init(loop, wrap->idle_));
+  wrap->idle_->data = wrap;
+  uv_unref(reinterpret_cast<uv_handle_t*>(wrap->idle_));
+
+  err = uv_poll_start(&wrap->handle_, UV_READABLE, OnPoll);
+  if (err != 0)
+    wrap->Close();
+  args.GetReturnValue().Set(err);
+}
+
+
+// watcher.add(id, path, window, encoding)
+void InotifyWrap::Add(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  InotifyWrap* wrap = Unwrap<InotifyWrap>(args.This());
+  CHECK_NOT_NULL(wrap);
+  CHECK(!wrap->IsHandleClosing());
+
+  CHECK(args[0]->IsInt32());
+  int32_t id = args[0].As<Int32>()->Value();
+  CHECK_EQ(wrap->roots_.count(id), 0);
+
+  BufferValue path_value(env->isolate(), args[1]);
+  CHECK_NOT_NULL(*path_value);
+  std::string path(*path_value, path_value.length());
+  while (path.size() > 1 && path.back() == '/')
+    path.pop_back();
+
+  CHECK(args[2]->IsUint32());
+
+  Root& root = wrap->roots_[id];
+  root.path = path;
+  root.window = args[2].As<Uint32>()->Value();
+  root.encoding = ParseEncoding(env->isolate(), args[3], kDefaultEncoding);
+
+  // Only the root itself is watched right away, so that errors such as
+  // ENOENT can be thrown from fs.watch(); the rest of the tree follows.
+  int err = wrap->WatchDir(id, path, false);
+  if (err != 0)
+    wrap->RemoveRoot(id);
+  args.GetReturnValue().Set(err);
+}
+
+
+// watcher.remove(id)
+void InotifyWrap::Remove(const FunctionCallbackInfo<Value>& args) {
+  InotifyWrap* wrap = Unwrap<InotifyWrap>(args.This());
+  CHECK_NOT_NULL(wrap);
+  CHECK(args[0]->IsInt32());
+  wrap->RemoveRoot(args[0].As<Int32>()->Value());
+}
+
+
+void InotifyWrap::Close(Local<Value> close_callback) {
+  if (timer_ != nullptr) {
+    env()->CloseHandle(timer_, [](uv_timer_t* handle) { delete handle; });
+    timer_ = nullptr;
+  }
+  if (idle_ != nullptr) {
+    env()->CloseHandle(idle_, [](uv_idle_t* handle) { delete handle; });
+    idle_ = nullptr;
+  }
+  HandleWrap::Close(close_callback);
+}
+
+
+void InotifyWrap::OnClose() {
+  if (fd_ != -1) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+
+std::string InotifyWrap::Join(const std::string& dir, const char* name) {
+  std::string path = dir;
+  if (path.back() != '/')
+    path += '/';
+  return path += name;
+}
+
+
+// Adds a watch for `dir` on behalf of the root `id`, and queues its
+// subdirectories to be scanned by ScanSome(). With `report`, a 'rename' event
+// is queued for everything that is found, which is used for directories that
+// appeared after the root was added and may have been filled before their
+// watch existed.
+int InotifyWrap::WatchDir(int32_t id, const std::string& dir, bool report) {
+  int wd = inotify_add_watch(fd_, dir.c_str(), kWatchMask);
+  if (wd == -1)
+    return uv_translate_sys_error(errno);
+  Watch& watch = watches_[wd];
+  if (watch.path.empty())
+    watch.path = dir;
+  wds_[dir] = wd;
+  if (std::find(watch.roots.begin(), watch.roots.end(), id) !=
+          watch.roots.end()) {
+    return 0;  // Already watched through another path.
+  }
+  watch.roots.push_back(id);
+
+  DIR* handle = opendir(dir.c_str());
+  if (handle == nullptr)
+    return uv_translate_sys_error(errno);
+  while (struct dirent* ent = readdir(handle)) {
+    if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+      continue;
+    std::string child = Join(dir, ent->d_name);
+    bool is_dir = ent->d_type == DT_DIR;
+    if (ent->d_type == DT_UNKNOWN) {
+      struct stat s;
+      is_dir = lstat(child.c_str(), &s) == 0 && S_ISDIR(s.st_mode);
+    }
+    if (report)
+      Queue(id, true, &child);
+    if (is_dir)
+      ScanLater(id, std::move(child), report);
+  }
+  closedir(handle);
+  return 0;
+}
+
+
+void InotifyWrap::ScanLater(int32_t id, std::string&& dir, bool report) {
+  if (scans_.empty())
+    uv_idle_start(idle_, OnIdle);
+  scans_.push_back({ id, std::move(dir), report });
+}
+
+
+void InotifyWrap::OnIdle(uv_idle_t* handle) {
+  static_cast<InotifyWrap*>(handle->data)->ScanSome();
+}
+
+
+// Watches the next batch of queued directories.
+void InotifyWrap::ScanSome() {
+  for (size_t i = 0; i < kScanBatch && !scans_.empty(); i++) {
+    Scan scan = std::move(scans_.front());
+    scans_.pop_front();
+    auto it = roots_.find(scan.id);
+    if (it == roots_.end() || it->second.failed)
+      continue;  // The root has been removed or has failed in the meantime.
+    int err = WatchDir(scan.id, scan.path, scan.report);
+    // Directories that have been removed in the meantime, or that cannot be
+    // read, are skipped. Anything else, in particular ENOSPC when the
+    // fs.inotify.max_user_watches limit is reached, would leave part of the
+    // tree unwatched without notice, so it is reported.
+    if (err != 0 && err != UV_ENOENT && err != UV_ENOTDIR &&
+        err != UV_EACCES) {
+      Root& root = roots_[scan.id];
+      root.error = err;
+      root.failed = true;
+    }
+  }
+  if (scans_.empty())
+    uv_idle_stop(idle_);
+  Flush();
+}
+
+
+// Stops watching `dir` and everything below it on behalf of the roots that
+// contain it, e.g. because it was moved elsewhere.
+void InotifyWrap::RemoveTree(const std::string& dir,
+                             const std::vector<int32_t>& ids) {
+  std::string prefix = Join(dir, "");
+  for (auto it = wds_.begin(); it != wds_.end();) {
+    const std::string& path = it->first;
+    if (path != dir && path.compare(0, prefix.size(), prefix) != 0) {
+      ++it;
+      continue;
+    }
+    auto watch_it = watches_.find(it->second);
+    if (watch_it == watches_.end()) {
+      it = wds_.erase(it);
+      continue;
+    }
+    Watch& watch = watch_it->second;
+    for (int32_t id : ids) {
+      if (roots_[id].path == path) continue;  // Watched as a root itself.
+      watch.roots.erase(std::remove(watch.roots.begin(), watch.roots.end(), id),
+                        watch.roots.end());
+    }
+    if (!watch.roots.empty()) {
+      ++it;
+      continue;
+    }
+    inotify_rm_watch(fd_, it->second);
+    watches_.erase(watch_it);
+    it = wds_.erase(it);
+  }
+}
+
+
+// The path may already belong to a newer watch if the directory was moved.
+void InotifyWrap::ForgetPath(const std::string& path, int wd) {
+  auto it = wds_.find(path);
+  if (it != wds_.end() && it->second == wd)
+    wds_.erase(it);
+}
+
+
+void InotifyWrap::RemoveRoot(int32_t id) {
+  for (auto it = watches_.begin(); it != watches_.end();) {
+    std::vector<int32_t>& ids = it->second.roots;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    if (!ids.empty()) {
+      ++it;
+      continue;
+    }
+    inotify_rm_watch(fd_, it->first);
+    ForgetPath(it->second.path, it->first);
+    it = watches_.erase(it);
+  }
+  roots_.erase(id);
+}
+
+
+// Queues an event for the root `id`, unless the same event is already
+// pending. A null `path` means that events were lost.
+void InotifyWrap::Queue(int32_t id, bool rename, const std::string* path) {
+  Root& root = roots_[id];
+  std::string filename;
+  if (path != nullptr) {
+    if (*path == root.path) {
+      // Events on the root itself are reported with its name, like libuv.
+      filename = path->substr(path->rfind('/') + 1);
+    } else {
+      filename = path->substr(Join(root.path, "").size());
+    }
+  }
+  std::string key = (rename ? "r" : "c") +
+                    (path != nullptr ? "/" + filename : std::string());
+  if (!root.seen.insert(std::move(key)).second)
+    return;
+  if (root.pending.empty())
+    root.deadline = uv_now(env()->event_loop()) + root.window;
+  root.pending.push_back({ rename, path != nullptr, std::move(filename) });
+}
+
+
+void InotifyWrap::OnPoll(uv_poll_t* handle, int status, int events) {
+  InotifyWrap* wrap = static_cast<InotifyWrap*>(handle->data);
+  if (status != 0)
+    return;
+
+  alignas(struct inotify_event) char buf[4096];
+  for (;;) {
+    ssize_t size = read(wrap->fd_, buf, sizeof(buf));
+    if (size == -1 && errno == EINTR)
+      continue;
+    if (size <= 0)
+      break;
+    for (char* p = buf; p < buf + size;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(p);
+      wrap->OnEvent(event);
+      p += sizeof(*event) + event->len;
+    }
+  }
+
+  wrap->Flush();
+}
+
+
+void InotifyWrap::OnEvent(const struct inotify_event* event) {
+  if (event->mask & IN_Q_OVERFLOW) {
+    for (const auto& root : roots_)
+      Queue(root.first, true, nullptr);
+    return;
+  }
+
+  auto it = watches_.find(event->wd);
+  if (it == watches_.end())
+    return;
+  if (event->mask & IN_IGNORED) {
+    // The directory is gone, the kernel has already removed the watch.
+    ForgetPath(it->second.path, it->first);
+    watches_.erase(it);
+    return;
+  }
+
+  // The watch may be removed below, so make copies.
+  std::string path = it->second.path;
+  std::vector<int32_t> ids = it->second.roots;
+  bool self = event->len == 0;
+  if (!self)
+    path = Join(path, event->name);
+
+  // Prefer 'rename' if both happened, like FSEventWrap::OnEvent().
+  bool rename = (event->mask & ~(IN_ATTRIB | IN_MODIFY)) != 0;
+  for (int32_t id : ids) {
+    // Changes to a directory itself are reported by its parent, except for
+    // the root.
+    if (self && roots_[id].path != path)
+      continue;
+    Queue(id, rename, &path);
+  }
+
+  if (!(event->mask & IN_ISDIR) || self)
+    return;
+  if (event->mask & IN_MOVED_FROM)
+    RemoveTree(path, ids);
+  if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+    for (int32_t id : ids) {
+      if (roots_[id].failed) continue;
+      // Queue the directory itself for what it already contains.
+      ScanLater(id, std::string(path), true);
+    }
+  }
+}
+
+
+void InotifyWrap::OnTimer(uv_timer_t* handle) {
+  static_cast<InotifyWrap*>(handle->data)->Flush();
+}
+
+
+// Passes the events of every root whose window has ended to JS, as
+// [id, eventType, filename, ...] in a single callback. A root that has failed
+// is reported as [id, errno, null] after its events.
+void InotifyWrap::Flush() {
+  Environment* env = this->env();
+  Isolate* isolate = env->isolate();
+  uint64_t now = uv_now(env->event_loop());
+
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env->context());
+
+  std::vector<Local<Value>> values;
+  for (auto& it : roots_) {
+    Root& root = it.second;
+    const bool due = !root.pending.empty() && root.deadline <= now;
+    if (!due && root.error == 0)
+      continue;
+    Local<Value> id = Integer::New(isolate, it.first);
+    if (due) {
+      for (const Event& event : root.pending) {
+        Local<Value> filename = Null(isolate);
+        if (event.has_filename) {
+          Local<Value> error;
+          MaybeLocal<Value> fn = StringBytes::Encode(isolate,
+                                                     event.filename.data(),
+                                                     event.filename.size(),
+                                                     root.encoding,
+                                                     &error);
+          if (fn.IsEmpty()) {
+            fn = StringBytes::Encode(isolate,
+                                     event.filename.data(),
+                                     event.filename.size(),
+                                     BUFFER,
+                                     &error);
+          }
+          filename = fn.ToLocalChecked();
+        }
+        values.push_back(id);
+        values.push_back(event.rename ? env->rename_string() :
+                                        env->change_string());
+        values.push_back(filename);
+      }
+      root.pending.clear();
+      root.seen.clear();
+    }
+    if (root.error != 0) {
+      values.push_back(id);
+      values.push_back(Integer::New(isolate, root.error));
+      values.push_back(Null(isolate));
+      root.error = 0;
+    }
+  }
+
+  if (!values.empty()) {
+    Local<Value> argv[] = {
+      Array::New(isolate, values.data(), values.size())
+    };
+    MakeCallback(env->onchange_string(), arraysize(argv), argv);
+  }
+
+  // The callback may have closed the watcher or added and removed roots.
+  if (IsHandleClosing())
+    return;
+  uint64_t next = UINT64_MAX;
+  for (const auto& it : roots_) {
+    if (!it.second.pending.empty())
+      next = std::min(next, it.second.deadline);
+  }
+  if (next == UINT64_MAX) {
+    uv_timer_stop(timer_);
+  } else {
+    uv_timer_start(timer_, OnTimer, next > now ? next - now : 0, 0);
+  }
+}
+#endif  // __linux__
+
+void FSEventInitialize(Local<Object> target,
+                       Local<Value> unused,
+                       Local<Context> context,
+                       void* priv) {
+  FSEventWrap::Initialize(target, unused, context, priv);
+#ifdef __linux__
+  InotifyWrap::Initialize(Environment::GetCurrent(context), target);
+#endif
+}
+
 }  // anonymous namespace
 }  // namespace node
 
-NODE_MODULE_CONTEXT_AWARE_INTERNAL(fs_event_wrap, node::FSEventWrap::Initialize)
+NODE_MODULE_CONTEXT_AWARE_INTERNAL(fs_event_wrap, node::FSEventInitialize)
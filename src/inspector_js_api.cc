@@ -2,6 +2,7 @@
 #include "inspector_agent.h"
 #include "inspector_io.h"
 #include "memory_tracker-inl.h"
+#include "node_external_reference.h"
 #include "util-inl.h"
 #include "v8.h"
 #include "v8-inspector.h"
@@ -116,6 +117,13 @@ class JSBindingsConnection : public AsyncWrap {
         .ToChecked();
   }
 
+  static void RegisterExternalReferences(
+      ExternalReferenceRegistry* registry) {
+    registry->Register(New);
+    registry->Register(Dispatch);
+    registry->Register(Disconnect);
+  }
+
   static void New(const FunctionCallbackInfo<Value>& info) {
     Environment* env = Environment::GetCurrent(info);
     CHECK(info[0]->IsFunction());
@@ -342,9 +350,32 @@ void Initialize(Local<Object> target, Local<Value> unused,
   JSBindingsConnection<MainThreadConnection>::Bind(env, target);
 }
 
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(InspectorConsoleCall);
+  registry->Register(SetConsoleExtensionInstaller);
+  registry->Register(CallAndPauseOnStart);
+  registry->Register(Open);
+  registry->Register(Url);
+  registry->Register(WaitForDebugger);
+
+  registry->Register(AsyncTaskScheduledWrapper);
+  registry->Register(InvokeAsyncTaskFnWithId<&Agent::AsyncTaskCanceled>);
+  registry->Register(InvokeAsyncTaskFnWithId<&Agent::AsyncTaskStarted>);
+  registry->Register(InvokeAsyncTaskFnWithId<&Agent::AsyncTaskFinished>);
+
+  registry->Register(RegisterAsyncHookWrapper);
+  registry->Register(IsEnabled);
+
+  JSBindingsConnection<LocalConnection>::RegisterExternalReferences(registry);
+  JSBindingsConnection<MainThreadConnection>::RegisterExternalReferences(
+      registry);
+}
+
 }  // namespace
 }  // namespace inspector
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(inspector,
                                   node::inspector::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(inspector,
+                               node::inspector::RegisterExternalReferences)
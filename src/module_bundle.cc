@@ -0,0 +1,276 @@
+#include "module_bundle.h"
+#include "util-inl.h"
+#include "uv.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace node {
+namespace loader {
+
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::NewStringType;
+using v8::String;
+
+ModuleBundle* ModuleBundle::current_ = nullptr;
+
+namespace {
+
+constexpr char kMagic[] = "NODEBNDL";
+
+#ifdef _WIN32
+constexpr char kPathSeparator = '\\';
+#else
+constexpr char kPathSeparator = '/';
+#endif
+
+// The bundle outlives every isolate, so there is nothing to free.
+class BundleSourceResource : public String::ExternalOneByteStringResource {
+ public:
+  BundleSourceResource(const char* data, size_t length)
+      : data_(data), length_(length) {}
+
+  const char* data() const override { return data_; }
+  size_t length() const override { return length_; }
+
+ private:
+  const char* data_;
+  size_t length_;
+};
+
+class Reader {
+ public:
+  Reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  bool Read(void* out, size_t length) {
+    if (size_ - offset_ < length) return false;
+    memcpy(out, data_ + offset_, length);
+    offset_ += length;
+    return true;
+  }
+
+  template <typename T>
+  bool ReadInteger(T* out) {
+    unsigned char bytes[sizeof(T)];
+    if (!Read(bytes, sizeof(bytes))) return false;
+    T value = 0;
+    for (size_t i = sizeof(T); i > 0; i--)
+      value = (value << 8) | bytes[i - 1];
+    *out = value;
+    return true;
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+  size_t offset_ = 0;
+};
+
+}  // anonymous namespace
+
+bool ModuleBundle::Load(const std::string& path) {
+  CHECK_NULL(current_);
+
+  uv_fs_t req;
+  int err = uv_fs_realpath(nullptr, &req, path.c_str(), nullptr);
+  if (err != 0) {
+    uv_fs_req_cleanup(&req);
+    return false;
+  }
+  std::string realpath(static_cast<const char*>(req.ptr));
+  uv_fs_req_cleanup(&req);
+
+  size_t sep = realpath.find_last_of(kPathSeparator);
+  CHECK_NE(sep, std::string::npos);
+  // Keep the separator of a root directory, e.g. `/` or `C:\`.
+  std::string root = realpath.substr(0, sep);
+  if (root.empty() || root.back() == ':')
+    root += kPathSeparator;
+
+  ModuleBundle* bundle = new ModuleBundle();
+  if (!bundle->Map(realpath) || !bundle->Parse(root)) {
+    // Nothing points into the memory yet, so it can be released again.
+#ifdef _WIN32
+    free(bundle->data_);
+#else
+    if (bundle->data_ != nullptr) munmap(bundle->data_, bundle->size_);
+#endif
+    delete bundle;
+    return false;
+  }
+  current_ = bundle;
+  return true;
+}
+
+bool ModuleBundle::Map(const std::string& path) {
+  uv_fs_t req;
+  uv_file fd = uv_fs_open(nullptr, &req, path.c_str(), O_RDONLY, 0, nullptr);
+  uv_fs_req_cleanup(&req);
+  if (fd < 0) return false;
+  OnScopeLeave close_fd([fd]() {
+    uv_fs_t req;
+    CHECK_EQ(0, uv_fs_close(nullptr, &req, fd, nullptr));
+    uv_fs_req_cleanup(&req);
+  });
+
+  int err = uv_fs_fstat(nullptr, &req, fd, nullptr);
+  uint64_t size = req.statbuf.st_size;
+  uv_fs_req_cleanup(&req);
+  if (err != 0 || size == 0 || size > SIZE_MAX) return false;
+
+#ifdef _WIN32
+  // There is no mmap() here, read the whole archive in one go instead.
+  char* data = UncheckedMalloc(size);
+  if (data == nullptr) return false;
+  data_ = data;
+  size_ = size;
+  size_t offset = 0;
+  while (offset < size_) {
+    uv_buf_t buf = uv_buf_init(data_ + offset,
+                               std::min<size_t>(size_ - offset, INT_MAX));
+    int r = uv_fs_read(nullptr, &req, fd, &buf, 1, offset, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (r <= 0) return false;
+    offset += r;
+  }
+#else
+  // A private mapping, so that writes through a Buffer that points into it
+  // never reach the file.
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) return false;
+  data_ = static_cast<char*>(data);
+  size_ = size;
+#endif
+  return true;
+}
+
+bool ModuleBundle::Parse(const std::string& root) {
+  Reader reader(data_, size_);
+
+  char magic[sizeof(kMagic) - 1];
+  uint32_t version;
+  uint32_t count;
+  if (!reader.Read(magic, sizeof(magic)) ||
+      memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+      !reader.ReadInteger(&version) || version != kVersion ||
+      !reader.ReadInteger(&count)) {
+    return false;
+  }
+
+  // Checks that [offset, offset + length) lies within the archive.
+  auto in_bounds = [&](uint64_t offset, uint64_t length) {
+    return offset <= size_ && length <= size_ - offset;
+  };
+
+  directories_.insert(root);
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t path_length;
+    if (!reader.ReadInteger(&path_length) || path_length == 0 ||
+        path_length > size_) {
+      return false;
+    }
+    std::string relative(path_length, '\0');
+    uint32_t flags;
+    uint64_t source_offset, source_length, cache_offset, cache_length;
+    if (!reader.Read(&relative[0], path_length) ||
+        !reader.ReadInteger(&flags) ||
+        !reader.ReadInteger(&source_offset) ||
+        !reader.ReadInteger(&source_length) ||
+        !reader.ReadInteger(&cache_offset) ||
+        !reader.ReadInteger(&cache_length) ||
+        !in_bounds(source_offset, source_length) ||
+        !in_bounds(cache_offset, cache_length)) {
+      return false;
+    }
+    // Paths are relative and use forward slashes, without empty, `.` or `..`
+    // segments.
+    if (relative.find('\0') != std::string::npos ||
+        relative.front() == '/' || relative.back() == '/' ||
+        relative.find("//") != std::string::npos ||
+        ("/" + relative + "/").find("/./") != std::string::npos ||
+        ("/" + relative + "/").find("/../") != std::string::npos) {
+      return false;
+    }
+
+    std::string path = root;
+    for (size_t start = 0; start < relative.size();) {
+      size_t end = relative.find('/', start);
+      if (end == std::string::npos) end = relative.size();
+      if (!path.empty() && path.back() != kPathSeparator)
+        path += kPathSeparator;
+      path.append(relative, start, end - start);
+      if (end != relative.size())
+        directories_.insert(path);
+      start = end + 1;
+    }
+
+    Entry entry {
+      data_ + source_offset,
+      static_cast<size_t>(source_length),
+      cache_length > 0 ? data_ + cache_offset : nullptr,
+      static_cast<size_t>(cache_length),
+      (flags & kAsciiFlag) != 0
+    };
+    files_.emplace(std::move(path), entry);
+  }
+
+  // A path cannot be both a file and a directory.
+  for (const auto& file : files_) {
+    if (directories_.count(file.first) != 0)
+      return false;
+  }
+  return true;
+}
+
+#ifdef _WIN32
+// The loaders pass namespaced paths, e.g. `\\?\C:\app\index.js`.
+static std::string WithoutNamespace(const std::string& path) {
+  if (path.compare(0, 4, "\\\\?\\") == 0 &&
+      path.compare(4, 4, "UNC\\") != 0) {
+    return path.substr(4);
+  }
+  return path;
+}
+#else
+static const std::string& WithoutNamespace(const std::string& path) {
+  return path;
+}
+#endif
+
+const ModuleBundle::Entry* ModuleBundle::Find(const std::string& path) const {
+  auto it = files_.find(WithoutNamespace(path));
+  return it != files_.end() ? &it->second : nullptr;
+}
+
+int ModuleBundle::Stat(const std::string& path) const {
+  const std::string& key = WithoutNamespace(path);
+  if (files_.count(key) != 0) return 0;
+  if (directories_.count(key) != 0) return 1;
+  return UV_ENOENT;
+}
+
+MaybeLocal<String> ModuleBundle::GetSource(Isolate* isolate,
+                                           const Entry& entry) {
+  if (entry.source_length == 0)
+    return String::Empty(isolate);
+  if (entry.source_length > static_cast<size_t>(String::kMaxLength))
+    return MaybeLocal<String>();
+  if (entry.is_ascii) {
+    return String::NewExternalOneByte(
+        isolate, new BundleSourceResource(entry.source, entry.source_length));
+  }
+  return String::NewFromUtf8(isolate,
+                             entry.source,
+                             NewStringType::kNormal,
+                             static_cast<int>(entry.source_length));
+}
+
+}  // namespace loader
+}  // namespace node
@@ -0,0 +1,81 @@
+#ifndef SRC_MODULE_BUNDLE_H_
+#define SRC_MODULE_BUNDLE_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "v8.h"
+
+namespace node {
+namespace loader {
+
+// A read-only archive of module sources and their code caches, created by
+// tools/bundle/mkbundle.js and loaded with --experimental-bundle. The archive
+// is mapped into memory once, and the module loaders look up files in its
+// index before they go to the file system. Paths in the index are relative to
+// the directory that contains the archive.
+//
+// Layout, all integers are little-endian:
+//
+//   "NODEBNDL"  uint32 version  uint32 count
+//   count * { uint32 path_length  char path[path_length]  uint32 flags
+//             uint64 source_offset  uint64 source_length
+//             uint64 cache_offset  uint64 cache_length }
+//   the sources and code caches that the offsets point to
+class ModuleBundle {
+ public:
+  static constexpr uint32_t kVersion = 1;
+  // Set for sources that only contain ASCII characters.
+  static constexpr uint32_t kAsciiFlag = 1 << 0;
+
+  struct Entry {
+    const char* source;
+    size_t source_length;
+    // nullptr if the bundle has no code cache for the file.
+    char* code_cache;
+    size_t code_cache_length;
+    bool is_ascii;
+  };
+
+  ModuleBundle(const ModuleBundle&) = delete;
+  ModuleBundle& operator=(const ModuleBundle&) = delete;
+
+  // Loads the bundle at `path`. Must be called at most once, before any
+  // Environment is created. The bundle is kept for the lifetime of the
+  // process, since the strings and buffers that are created from it point
+  // into its memory.
+  static bool Load(const std::string& path);
+  // Returns nullptr unless a bundle has been loaded.
+  static const ModuleBundle* Get() { return current_; }
+
+  // Returns nullptr if the bundle does not contain a file at `path`.
+  const Entry* Find(const std::string& path) const;
+  // Like InternalModuleStat(): returns 0 for files, 1 for directories, and
+  // UV_ENOENT for paths that are not in the bundle.
+  int Stat(const std::string& path) const;
+
+  // Returns the source of `entry` as a string. ASCII sources are not copied.
+  static v8::MaybeLocal<v8::String> GetSource(v8::Isolate* isolate,
+                                              const Entry& entry);
+
+ private:
+  ModuleBundle() = default;
+  bool Map(const std::string& path);
+  bool Parse(const std::string& root);
+
+  char* data_ = nullptr;
+  size_t size_ = 0;
+  std::unordered_map<std::string, Entry> files_;
+  std::unordered_set<std::string> directories_;
+
+  static ModuleBundle* current_;
+};
+
+}  // namespace loader
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_MODULE_BUNDLE_H_
@@ -2,16 +2,22 @@
 
 #include "env.h"
 #include "memory_tracker-inl.h"
+#include "module_bundle.h"
 #include "node_errors.h"
+#include "node_file.h"
+#include "node_internals.h"
 #include "node_url.h"
 #include "util-inl.h"
 #include "node_contextify.h"
 #include "node_watchdog.h"
+#include "string_bytes.h"
+#include "threadpoolwork-inl.h"
 
 #include <sys/stat.h>  // S_IFDIR
 
 #include <algorithm>
 #include <climits>  // PATH_MAX
+#include <memory>
 
 namespace node {
 namespace loader {
@@ -22,6 +28,9 @@ using node::contextify::ContextifyContext;
 using node::url::URL;
 using node::url::URL_FLAGS_FAILED;
 using v8::Array;
+using v8::ArrayBuffer;
+using v8::ArrayBufferView;
+using v8::Boolean;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
@@ -44,6 +53,7 @@ using v8::Promise;
 using v8::ScriptCompiler;
 using v8::ScriptOrigin;
 using v8::String;
+using v8::UnboundModuleScript;
 using v8::Undefined;
 using v8::Value;
 
@@ -100,6 +110,7 @@ ModuleWrap* ModuleWrap::GetFromID(Environment* env, uint32_t id) {
 
 // new ModuleWrap(source, url)
 // new ModuleWrap(source, url, context?, lineOffset, columnOffset)
+// new ModuleWrap(source, url, context?, lineOffset, columnOffset, cachedData?)
 // new ModuleWrap(syntheticExecutionFunction, export_names, url)
 void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -115,7 +126,7 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
   Local<Integer> line_offset;
   Local<Integer> column_offset;
 
-  if (argc == 5) {
+  if (argc >= 5) {
     // new ModuleWrap(source, url, context?, lineOffset, columnOffset)
     if (args[2]->IsUndefined()) {
       context = that->CreationContext();
@@ -142,6 +153,8 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
 
   Local<String> url;
   Local<Module> module;
+  bool consumed_cached_data = false;
+  bool cached_data_rejected = false;
 
   Local<PrimitiveArray> host_defined_options =
       PrimitiveArray::New(isolate, HostDefinedOptions::kLength);
@@ -176,6 +189,17 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
     CHECK(args[1]->IsString());
     url = args[1].As<String>();
 
+    ScriptCompiler::CachedData* cached_data = nullptr;
+    if (argc == 6 && !args[5]->IsUndefined()) {
+      CHECK(args[5]->IsArrayBufferView());
+      Local<ArrayBufferView> cached_data_buf = args[5].As<ArrayBufferView>();
+      ArrayBuffer::Contents contents =
+          cached_data_buf->Buffer()->GetContents();
+      uint8_t* data = static_cast<uint8_t*>(contents.Data());
+      cached_data = new ScriptCompiler::CachedData(
+          data + cached_data_buf->ByteOffset(), cached_data_buf->ByteLength());
+    }
+
     ShouldNotAbortOnUncaughtScope no_abort_scope(env);
     TryCatchScope try_catch(env);
 
@@ -191,8 +215,12 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
                           True(isolate),                    // is ES Module
                           host_defined_options);
       Context::Scope context_scope(context);
-      ScriptCompiler::Source source(source_text, origin);
-      if (!ScriptCompiler::CompileModule(isolate, &source).ToLocal(&module)) {
+      ScriptCompiler::Source source(source_text, origin, cached_data);
+      ScriptCompiler::CompileOptions options =
+          cached_data == nullptr ? ScriptCompiler::kNoCompileOptions :
+                                   ScriptCompiler::kConsumeCodeCache;
+      if (!ScriptCompiler::CompileModule(isolate, &source, options)
+               .ToLocal(&module)) {
         if (try_catch.HasCaught() && !try_catch.HasTerminated()) {
           CHECK(!try_catch.Message().IsEmpty());
           CHECK(!try_catch.Exception().IsEmpty());
@@ -202,6 +230,10 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
         }
         return;
       }
+      if (options == ScriptCompiler::kConsumeCodeCache) {
+        consumed_cached_data = true;
+        cached_data_rejected = source.GetCachedData()->rejected;
+      }
     }
   }
 
@@ -209,6 +241,14 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
     return;
   }
 
+  if (consumed_cached_data &&
+      !that->Set(context,
+                 env->cached_data_rejected_string(),
+                 Boolean::New(isolate, cached_data_rejected))
+           .FromMaybe(false)) {
+    return;
+  }
+
   ModuleWrap* obj = new ModuleWrap(env, that, module, url);
 
   if (synthetic) {
@@ -228,6 +268,30 @@ void ModuleWrap::New(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(that);
 }
 
+void ModuleWrap::CreateCachedData(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = args.GetIsolate();
+
+  ModuleWrap* obj;
+  ASSIGN_OR_RETURN_UNWRAP(&obj, args.This());
+  CHECK(!obj->synthetic_);
+
+  Local<Module> module = obj->module_.Get(isolate);
+  Local<UnboundModuleScript> unbound_module_script =
+      module->GetUnboundModuleScript();
+  std::unique_ptr<ScriptCompiler::CachedData> cached_data(
+      ScriptCompiler::CreateCodeCache(unbound_module_script));
+  if (!cached_data) {
+    args.GetReturnValue().Set(Buffer::New(env, 0).ToLocalChecked());
+  } else {
+    MaybeLocal<Object> buf = Buffer::Copy(
+        env,
+        reinterpret_cast<const char*>(cached_data->data),
+        cached_data->length);
+    args.GetReturnValue().Set(buf.ToLocalChecked());
+  }
+}
+
 void ModuleWrap::Link(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Isolate* isolate = args.GetIsolate();
@@ -559,6 +623,11 @@ inline DescriptorType CheckDescriptorAtFile(uv_file fd) {
 // Should be directory based -> if path/to/dir doesn't exist
 // then the cache should early-fail any path/to/dir/file check.
 DescriptorType CheckDescriptorAtPath(const std::string& path) {
+  if (const ModuleBundle* bundle = ModuleBundle::Get()) {
+    int rc = bundle->Stat(path);
+    if (rc == 0) return FILE;
+    if (rc == 1) return DIRECTORY;
+  }
   Maybe<uv_file> fd = OpenDescriptor(path);
   if (fd.IsNothing()) return NONE;
   DescriptorType type = CheckDescriptorAtFile(fd.FromJust());
@@ -567,6 +636,10 @@ DescriptorType CheckDescriptorAtPath(const std::string& path) {
 }
 
 Maybe<std::string> ReadIfFile(const std::string& path) {
+  if (const ModuleBundle* bundle = ModuleBundle::Get()) {
+    if (const ModuleBundle::Entry* entry = bundle->Find(path))
+      return Just(std::string(entry->source, entry->source_length));
+  }
   Maybe<uv_file> fd = OpenDescriptor(path);
   if (fd.IsNothing()) return Nothing<std::string>();
   DescriptorType type = CheckDescriptorAtFile(fd.FromJust());
@@ -1275,6 +1348,112 @@ void ModuleWrap::GetPackageType(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(Integer::New(env->isolate(), pkg_type));
 }
 
+namespace {
+
+// Reads the source of a module on the threadpool. Reading a file through
+// fs.readFile() from JS leaves the decoding to the main thread; this also
+// checks whether the source is plain ASCII while still on the threadpool, so
+// that the sources of the whole dependency frontier that the loader has
+// discovered are read in parallel.
+class ReadSourceJob final : public ThreadPoolWork {
+ public:
+  ReadSourceJob(Environment* env,
+                Local<Promise::Resolver> resolver,
+                std::string&& path)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_FS),
+        env_(env),
+        resolver_(env->isolate(), resolver),
+        path_(std::move(path)) {}
+
+  void DoThreadPoolWork() override {
+    ok_ = contents_.Read(path_, -1, O_RDONLY);
+    // Most sources are plain ASCII, which the main thread can then copy
+    // into a one-byte string as is instead of decoding it as UTF-8.
+    if (ok_)
+      is_ascii_ = StringBytes::IsAscii(contents_.data(), contents_.length());
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ReadSourceJob> self(this);
+    if (!env_->can_call_into_js())
+      return;
+
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Local<Context> context = env_->context();
+    Context::Scope context_scope(context);
+    // Drains the microtask queue once the promise has been settled.
+    InternalCallbackScope callback_scope(env_, env_->process_object(),
+                                         {0, 0});
+
+    Local<Promise::Resolver> resolver = resolver_.Get(isolate);
+    if (status == UV_ECANCELED) {
+      contents_.SetError(status, "read");
+      ok_ = false;
+    }
+    if (!ok_) {
+      resolver->Reject(context,
+                       contents_.ToException(isolate, path_)).Check();
+      return;
+    }
+
+    Local<Value> error;
+    MaybeLocal<Value> source = StringBytes::Encode(isolate,
+                                                   contents_.data(),
+                                                   contents_.length(),
+                                                   is_ascii_ ? LATIN1 : UTF8,
+                                                   &error);
+    if (source.IsEmpty()) {
+      CHECK(!error.IsEmpty());
+      resolver->Reject(context, error).Check();
+      return;
+    }
+    resolver->Resolve(context, source.ToLocalChecked()).Check();
+  }
+
+ private:
+  Environment* env_;
+  Global<Promise::Resolver> resolver_;
+  std::string path_;
+  fs::FileContents contents_;
+  bool ok_ = false;
+  bool is_ascii_ = false;
+};
+
+}  // anonymous namespace
+
+void ModuleWrap::ReadSource(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  // readSource(path)
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  Local<Promise::Resolver> resolver;
+  if (!Promise::Resolver::New(env->context()).ToLocal(&resolver))
+    return;
+  args.GetReturnValue().Set(resolver->GetPromise());
+
+  if (const ModuleBundle* bundle = ModuleBundle::Get()) {
+    const ModuleBundle::Entry* entry =
+        bundle->Find(std::string(*path, path.length()));
+    if (entry != nullptr) {
+      Local<String> source;
+      if (ModuleBundle::GetSource(env->isolate(), *entry).ToLocal(&source)) {
+        USE(resolver->Resolve(env->context(), source));
+      } else {
+        USE(resolver->Reject(env->context(),
+                             ERR_STRING_TOO_LONG(env->isolate())));
+      }
+      return;
+    }
+  }
+
+  ReadSourceJob* job =
+      new ReadSourceJob(env, resolver, std::string(*path, path.length()));
+  job->ScheduleWork();
+}
+
 static MaybeLocal<Promise> ImportModuleDynamically(
     Local<Context> context,
     Local<v8::ScriptOrModule> referrer,
@@ -1452,6 +1631,7 @@ void ModuleWrap::Initialize(Local<Object> target,
   env->SetProtoMethod(tpl, "instantiate", Instantiate);
   env->SetProtoMethod(tpl, "evaluate", Evaluate);
   env->SetProtoMethod(tpl, "setExport", SetSyntheticExport);
+  env->SetProtoMethod(tpl, "createCachedData", CreateCachedData);
   env->SetProtoMethodNoSideEffect(tpl, "getNamespace", GetNamespace);
   env->SetProtoMethodNoSideEffect(tpl, "getStatus", GetStatus);
   env->SetProtoMethodNoSideEffect(tpl, "getError", GetError);
@@ -1462,6 +1642,7 @@ void ModuleWrap::Initialize(Local<Object> target,
               tpl->GetFunction(context).ToLocalChecked()).Check();
   env->SetMethod(target, "resolve", Resolve);
   env->SetMethod(target, "getPackageType", GetPackageType);
+  env->SetMethod(target, "readSource", ReadSource);
   env->SetMethod(target,
                  "setImportModuleDynamicallyCallback",
                  SetImportModuleDynamicallyCallback);
@@ -26,6 +26,7 @@
 #include "debug_utils.h"
 #include "env-inl.h"
 #include "memory_tracker-inl.h"
+#include "module_bundle.h"
 #include "node_binding.h"
 #include "node_internals.h"
 #include "node_main_instance.h"
@@ -1050,22 +1051,56 @@ int Start(int argc, char** argv) {
     return result.exit_code;
   }
 
+  const std::string& module_bundle = per_process::cli_options->module_bundle;
+  if (!module_bundle.empty() && !loader::ModuleBundle::Load(module_bundle)) {
+    fprintf(stderr, "%s: cannot load module bundle %s\n",
+            argv[0], module_bundle.c_str());
+    TearDownOncePerProcess();
+    return 9;
+  }
+
   {
     Isolate::CreateParams params;
     const std::vector<size_t>* indexes = nullptr;
-    std::vector<intptr_t> external_references;
+    const EnvSerializeInfo* env_info = nullptr;
+    // Storage for a snapshot loaded through --snapshot-blob, which has to
+    // outlive the isolate.
+    std::vector<char> snapshot_data;
+    std::vector<size_t> snapshot_indexes;
+    EnvSerializeInfo snapshot_env_info;
+    v8::StartupData snapshot_blob;
 
     bool force_no_snapshot =
         per_process::cli_options->per_isolate->no_node_snapshot;
+    const std::string& snapshot_blob_path =
+        per_process::cli_options->per_isolate->snapshot_blob;
     if (!force_no_snapshot) {
       v8::StartupData* blob = NodeMainInstance::GetEmbeddedSnapshotBlob();
+      if (!snapshot_blob_path.empty()) {
+        if (!NodeMainInstance::ReadSnapshotBlob(snapshot_blob_path,
+                                                &snapshot_data,
+                                                &snapshot_indexes,
+                                                &snapshot_env_info)) {
+          fprintf(stderr, "%s: cannot load snapshot blob %s\n",
+                  argv[0], snapshot_blob_path.c_str());
+          TearDownOncePerProcess();
+          return 9;
+        }
+        snapshot_blob = { snapshot_data.data(),
+                          static_cast<int>(snapshot_data.size()) };
+        blob = &snapshot_blob;
+      }
       if (blob != nullptr) {
-        // TODO(joyeecheung): collect external references and set it in
-        // params.external_references.
-        external_references.push_back(reinterpret_cast<intptr_t>(nullptr));
-        params.external_references = external_references.data();
+        params.external_references =
+            NodeMainInstance::CollectExternalReferences().data();
         params.snapshot_blob = blob;
-        indexes = NodeMainInstance::GetIsolateDataIndexes();
+        if (snapshot_blob_path.empty()) {
+          indexes = NodeMainInstance::GetIsolateDataIndexes();
+          env_info = NodeMainInstance::GetEnvSerializeInfo();
+        } else {
+          indexes = &snapshot_indexes;
+          env_info = &snapshot_env_info;
+        }
       }
     }
 
@@ -1074,7 +1109,8 @@ int Start(int argc, char** argv) {
                                    per_process::v8_platform.Platform(),
                                    result.args,
                                    result.exec_args,
-                                   indexes);
+                                   indexes,
+                                   env_info);
     result.exit_code = main_instance.Run();
   }
 
@@ -835,7 +835,8 @@ class Work : public node::AsyncResource, public node::ThreadPoolWork {
     : AsyncResource(env->isolate,
                     async_resource,
                     *v8::String::Utf8Value(env->isolate, async_resource_name)),
-      ThreadPoolWork(env->node_env()),
+      ThreadPoolWork(env->node_env(),
+                     node::performance::NODE_THREADPOOL_WORK_TYPE_NAPI),
       _env(env),
       _data(data),
       _execute(execute),
@@ -2,6 +2,7 @@
 #include "node_errors.h"
 #include <atomic>
 #include "env-inl.h"
+#include "node_external_reference.h"
 #include "node_native_module_env.h"
 #include "util.h"
 
@@ -660,5 +661,13 @@ void RegisterBuiltinModules() {
 #undef V
 }
 
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(GetLinkedBinding);
+  registry->Register(GetInternalBinding);
+}
+
 }  // namespace binding
 }  // namespace node
+
+NODE_MODULE_EXTERNAL_REFERENCE(binding,
+                               node::binding::RegisterExternalReferences)
@@ -22,6 +22,7 @@
 #include "node_buffer.h"
 #include "node.h"
 #include "node_errors.h"
+#include "node_external_reference.h"
 #include "node_internals.h"
 
 #include "env-inl.h"
@@ -31,8 +32,10 @@
 #include "v8-profiler.h"
 #include "v8.h"
 
+#include <array>
 #include <cstring>
 #include <climits>
+#include <vector>
 
 #define THROW_AND_RETURN_UNLESS_BUFFER(env, obj)                            \
   THROW_AND_RETURN_IF_NOT_BUFFER(env, obj, "argument")                      \
@@ -47,6 +50,7 @@
 namespace node {
 namespace Buffer {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::ArrayBufferCreationMode;
 using v8::ArrayBufferView;
@@ -447,6 +451,107 @@ void CreateFromString(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// A one-byte string that points into the memory of an ArrayBuffer. The
+// resource keeps the ArrayBuffer alive for as long as the string exists.
+class ArrayBufferStringResource : public String::ExternalOneByteStringResource {
+ public:
+  ArrayBufferStringResource(Isolate* isolate,
+                            Local<ArrayBuffer> ab,
+                            const char* data,
+                            size_t length)
+      : ab_(isolate, ab), data_(data), length_(length) {}
+
+  const char* data() const override { return data_; }
+  size_t length() const override { return length_; }
+
+ private:
+  Global<ArrayBuffer> ab_;
+  const char* const data_;
+  const size_t length_;
+};
+
+
+// The contents of an ArrayBuffer that was externalized by
+// CreateExternalString(), freed once the ArrayBuffer has been collected.
+struct ExternalizedContents {
+  Isolate* isolate;
+  ArrayBuffer::Contents contents;
+
+  static void Free(char* data, void* hint) {
+    ExternalizedContents* self = static_cast<ExternalizedContents*>(hint);
+    const size_t length = self->contents.ByteLength();
+    self->contents.Deleter()(data, length, self->contents.DeleterData());
+    self->isolate->AdjustAmountOfExternalAllocatedMemory(
+        -static_cast<int64_t>(length));
+    delete self;
+  }
+};
+
+
+// createExternalString(buffer, start, end)
+void CreateExternalString(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  Local<ArrayBufferView> view = args[0].As<ArrayBufferView>();
+  const size_t byte_length = view->ByteLength();
+
+  size_t start = 0;
+  size_t end = 0;
+  THROW_AND_RETURN_IF_OOB(ParseArrayIndex(env, args[1], 0, &start));
+  THROW_AND_RETURN_IF_OOB(ParseArrayIndex(env, args[2], byte_length, &end));
+  if (end < start) end = start;
+  THROW_AND_RETURN_IF_OOB(Just(end <= byte_length));
+  const size_t length = end - start;
+
+  if (length == 0)
+    return args.GetReturnValue().SetEmptyString();
+  if (length > static_cast<size_t>(String::kMaxLength)) {
+    isolate->ThrowException(ERR_STRING_TOO_LONG(isolate));
+    return;
+  }
+
+  // Buffer() moves the contents of small typed arrays off the V8 heap, so
+  // that they do not move anymore.
+  Local<ArrayBuffer> ab = view->Buffer();
+  if (ab->IsSharedArrayBuffer()) {
+    return THROW_ERR_INVALID_ARG_VALUE(
+        env, "The buffer must not be backed by a SharedArrayBuffer");
+  }
+  const char* data =
+      static_cast<const char*>(ab->GetContents().Data()) +
+      view->ByteOffset() + start;
+  if (!StringBytes::IsAscii(data, length)) {
+    return THROW_ERR_INVALID_ARG_VALUE(
+        env, "The buffer must only contain ASCII characters");
+  }
+
+  // An ArrayBuffer that V8 still owns could be detached, e.g. by
+  // transferring it to a Worker, which would free the memory underneath the
+  // string. External ArrayBuffers are never detached by Node.js.
+  if (!ab->IsExternal()) {
+    ExternalizedContents* contents =
+        new ExternalizedContents { isolate, ab->Externalize() };
+    CallbackInfo::New(isolate,
+                      ab,
+                      ExternalizedContents::Free,
+                      static_cast<char*>(contents->contents.Data()),
+                      contents);
+    isolate->AdjustAmountOfExternalAllocatedMemory(
+        contents->contents.ByteLength());
+  }
+
+  Local<String> str;
+  if (String::NewExternalOneByte(
+          isolate,
+          new ArrayBufferStringResource(isolate, ab, data, length))
+              .ToLocal(&str)) {
+    args.GetReturnValue().Set(str);
+  }
+}
+
+
 template <encoding encoding>
 void StringSlice(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -998,6 +1103,115 @@ void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
                                 : -1);
 }
 
+// indexOfAny(buffer, needles, byteOffset, result) returns the offset of the
+// first occurrence of any of the `needles` in `buffer`, or -1, and stores the
+// index of the needle that was found in result[0]. If several needles occur
+// at that offset, the first one in `needles` wins.
+void IndexOfAny(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[1]->IsArray());
+  CHECK(args[2]->IsNumber());
+  CHECK(args[3]->IsUint32Array());
+
+  THROW_AND_RETURN_UNLESS_BUFFER(env, args[0]);
+  ArrayBufferViewContents<uint8_t> haystack_contents(args[0]);
+  const uint8_t* haystack = haystack_contents.data();
+  const size_t haystack_length = haystack_contents.length();
+  Local<Array> needles_array = args[1].As<Array>();
+  int64_t offset_i64 = args[2].As<Integer>()->Value();
+  Local<Uint32Array> result = args[3].As<Uint32Array>();
+  CHECK_GE(result->Length(), 1);
+
+  struct Needle {
+    const uint8_t* data;
+    size_t length;
+  };
+  std::vector<Needle> needles(needles_array->Length());
+  for (uint32_t i = 0; i < needles.size(); i++) {
+    Local<Value> needle;
+    if (!needles_array->Get(env->context(), i).ToLocal(&needle)) return;
+    CHECK(needle->IsArrayBufferView());
+    needles[i] = { reinterpret_cast<const uint8_t*>(Data(needle)),
+                   Length(needle) };
+  }
+
+  auto found = [&](size_t offset, uint32_t index) {
+    uint32_t* out = reinterpret_cast<uint32_t*>(
+        static_cast<char*>(result->Buffer()->GetContents().Data()) +
+        result->ByteOffset());
+    out[0] = index;
+    args.GetReturnValue().Set(static_cast<double>(offset));
+  };
+  args.GetReturnValue().Set(-1);
+
+  // An empty needle matches right away, like it does for indexOf().
+  const size_t start =
+      static_cast<size_t>(IndexOfOffset(haystack_length, offset_i64, 0, true));
+  for (uint32_t i = 0; i < needles.size(); i++) {
+    if (needles[i].length == 0)
+      return found(start, i);
+  }
+  if (needles.empty() || start >= haystack_length)
+    return;
+
+  if (needles.size() == 1) {
+    const Needle& needle = needles[0];
+    if (needle.length > haystack_length)
+      return;
+    const size_t offset = SearchString(haystack, haystack_length,
+                                       needle.data, needle.length,
+                                       start, true);
+    if (offset != haystack_length)
+      found(offset, 0);
+    return;
+  }
+
+  // Group the needles by their first byte, in order, so that each position
+  // of the haystack only needs a table lookup unless some needle may start
+  // there.
+  std::array<std::vector<uint32_t>, 256> by_first_byte;
+  size_t distinct_first_bytes = 0;
+  for (uint32_t i = 0; i < needles.size(); i++) {
+    std::vector<uint32_t>& group = by_first_byte[needles[i].data[0]];
+    if (group.empty())
+      distinct_first_bytes++;
+    group.push_back(i);
+  }
+
+  auto match_at = [&](size_t pos) -> bool {
+    for (uint32_t i : by_first_byte[haystack[pos]]) {
+      const Needle& needle = needles[i];
+      if (needle.length <= haystack_length - pos &&
+          memcmp(haystack + pos + 1, needle.data + 1, needle.length - 1) == 0) {
+        found(pos, i);
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (distinct_first_bytes == 1) {
+    // Common for delimiters, e.g. "\r\n" and "\r\n--boundary": let memchr()
+    // find the candidates.
+    const uint8_t first_byte = needles[0].data[0];
+    for (size_t pos = start; pos < haystack_length; pos++) {
+      const void* ptr =
+          memchr(haystack + pos, first_byte, haystack_length - pos);
+      if (ptr == nullptr)
+        return;
+      pos = static_cast<const uint8_t*>(ptr) - haystack;
+      if (match_at(pos))
+        return;
+    }
+    return;
+  }
+
+  for (size_t pos = start; pos < haystack_length; pos++) {
+    if (!by_first_byte[haystack[pos]].empty() && match_at(pos))
+      return;
+  }
+}
+
 
 void Swap16(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
@@ -1035,14 +1249,24 @@ static void EncodeUtf8String(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsString());
 
   Local<String> str = args[0].As<String>();
-  size_t length = str->Utf8Length(isolate);
-  AllocatedBuffer buf = env->AllocateManaged(length);
-  str->WriteUtf8(isolate,
-                 buf.data(),
-                 -1,  // We are certain that `data` is sufficiently large
-                 nullptr,
-                 String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8);
-  auto array = Uint8Array::New(buf.ToArrayBuffer(), 0, length);
+  const size_t length = str->Length();
+  // Up to this length, the string is encoded in a single pass into storage
+  // for the worst case, which is shrunk afterwards. Longer strings are
+  // measured first, so that they do not need up to three times their size.
+  static constexpr size_t kMaxOversizedLength = 1 << 20;
+  size_t storage;
+  if (length > kMaxOversizedLength)
+    storage = str->Utf8Length(isolate);
+  else if (str->IsOneByte())
+    storage = 2 * length;
+  else
+    storage = 3 * length;
+  AllocatedBuffer buf = env->AllocateManaged(storage);
+  const size_t written =
+      StringBytes::WriteUtf8(isolate, buf.data(), storage, str);
+  if (written < storage)
+    buf.Resize(written);
+  auto array = Uint8Array::New(buf.ToArrayBuffer(), 0, written);
   args.GetReturnValue().Set(array);
 }
 
@@ -1069,13 +1293,9 @@ static void EncodeInto(const FunctionCallbackInfo<Value>& args) {
       static_cast<char*>(result_arr->Buffer()->GetContents().Data()) +
       result_arr->ByteOffset());
 
-  int nchars;
-  int written = source->WriteUtf8(
-      isolate,
-      write_result,
-      dest_length,
-      &nchars,
-      String::NO_NULL_TERMINATION | String::REPLACE_INVALID_UTF8);
+  size_t nchars;
+  size_t written = StringBytes::WriteUtf8(
+      isolate, write_result, dest_length, source, &nchars);
   results[0] = nchars;
   results[1] = written;
 }
@@ -1089,6 +1309,26 @@ void SetBufferPrototype(const FunctionCallbackInfo<Value>& args) {
   env->set_buffer_prototype_object(proto);
 }
 
+// Returns a view over the zero fill setting of the ArrayBuffer allocator.
+// The view is created on demand because a view that comes from the startup
+// snapshot would point to a copy of the setting, not to the allocator.
+void GetZeroFillToggle(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  NodeArrayBufferAllocator* allocator = env->isolate_data()->node_allocator();
+  Local<ArrayBuffer> array_buffer;
+  // It can be a nullptr when running inside an isolate where we
+  // do not own the ArrayBuffer allocator.
+  if (allocator == nullptr) {
+    // Toggling a dummy array is a no-op, zero fill is always on in that case.
+    array_buffer = ArrayBuffer::New(env->isolate(), sizeof(uint32_t));
+  } else {
+    uint32_t* zero_fill_field = allocator->zero_fill_field();
+    array_buffer = ArrayBuffer::New(
+        env->isolate(), zero_fill_field, sizeof(*zero_fill_field));
+  }
+  args.GetReturnValue().Set(Uint32Array::New(array_buffer, 0, 1));
+}
+
 
 void Initialize(Local<Object> target,
                 Local<Value> unused,
@@ -1098,12 +1338,14 @@ void Initialize(Local<Object> target,
 
   env->SetMethod(target, "setBufferPrototype", SetBufferPrototype);
   env->SetMethodNoSideEffect(target, "createFromString", CreateFromString);
+  env->SetMethod(target, "createExternalString", CreateExternalString);
 
   env->SetMethodNoSideEffect(target, "byteLengthUtf8", ByteLengthUtf8);
   env->SetMethod(target, "copy", Copy);
   env->SetMethodNoSideEffect(target, "compare", Compare);
   env->SetMethodNoSideEffect(target, "compareOffset", CompareOffset);
   env->SetMethod(target, "fill", Fill);
+  env->SetMethodNoSideEffect(target, "indexOfAny", IndexOfAny);
   env->SetMethodNoSideEffect(target, "indexOfBuffer", IndexOfBuffer);
   env->SetMethodNoSideEffect(target, "indexOfNumber", IndexOfNumber);
   env->SetMethodNoSideEffect(target, "indexOfString", IndexOfString);
@@ -1137,19 +1379,45 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "ucs2Write", StringWrite<UCS2>);
   env->SetMethod(target, "utf8Write", StringWrite<UTF8>);
 
-  // It can be a nullptr when running inside an isolate where we
-  // do not own the ArrayBuffer allocator.
-  if (NodeArrayBufferAllocator* allocator =
-          env->isolate_data()->node_allocator()) {
-    uint32_t* zero_fill_field = allocator->zero_fill_field();
-    Local<ArrayBuffer> array_buffer = ArrayBuffer::New(
-        env->isolate(), zero_fill_field, sizeof(*zero_fill_field));
-    CHECK(target
-              ->Set(env->context(),
-                    FIXED_ONE_BYTE_STRING(env->isolate(), "zeroFill"),
-                    Uint32Array::New(array_buffer, 0, 1))
-              .FromJust());
-  }
+  env->SetMethod(target, "getZeroFillToggle", GetZeroFillToggle);
+}
+
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(SetBufferPrototype);
+  registry->Register(GetZeroFillToggle);
+  registry->Register(CreateFromString);
+  registry->Register(CreateExternalString);
+
+  registry->Register(ByteLengthUtf8);
+  registry->Register(Copy);
+  registry->Register(Compare);
+  registry->Register(CompareOffset);
+  registry->Register(Fill);
+  registry->Register(IndexOfAny);
+  registry->Register(IndexOfBuffer);
+  registry->Register(IndexOfNumber);
+  registry->Register(IndexOfString);
+
+  registry->Register(Swap16);
+  registry->Register(Swap32);
+  registry->Register(Swap64);
+
+  registry->Register(EncodeInto);
+  registry->Register(EncodeUtf8String);
+
+  registry->Register(StringSlice<ASCII>);
+  registry->Register(StringSlice<BASE64>);
+  registry->Register(StringSlice<LATIN1>);
+  registry->Register(StringSlice<HEX>);
+  registry->Register(StringSlice<UCS2>);
+  registry->Register(StringSlice<UTF8>);
+
+  registry->Register(StringWrite<ASCII>);
+  registry->Register(StringWrite<BASE64>);
+  registry->Register(StringWrite<LATIN1>);
+  registry->Register(StringWrite<HEX>);
+  registry->Register(StringWrite<UCS2>);
+  registry->Register(StringWrite<UTF8>);
 }
 
 }  // anonymous namespace
@@ -1157,3 +1425,4 @@ void Initialize(Local<Object> target,
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(buffer, node::Buffer::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(buffer, node::Buffer::RegisterExternalReferences)
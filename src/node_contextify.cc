@@ -30,6 +30,8 @@
 #include "module_wrap.h"
 #include "util-inl.h"
 
+#include <cinttypes>
+
 namespace node {
 namespace contextify {
 
@@ -1137,6 +1139,15 @@ void ContextifyContext::CompileFunction(
           .IsNothing())
     return;
 
+  if (options == ScriptCompiler::kConsumeCodeCache) {
+    if (result
+            ->Set(parsing_context,
+                  env->cached_data_rejected_string(),
+                  Boolean::New(isolate, source.GetCachedData()->rejected))
+            .IsNothing())
+      return;
+  }
+
   if (produce_cached_data) {
     const std::unique_ptr<ScriptCompiler::CachedData> cached_data(
         ScriptCompiler::CreateCodeCacheForFunction(fn));
@@ -1200,6 +1211,42 @@ static void WatchdogHasPendingSigint(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(ret);
 }
 
+// Unlike the cachedData produced by compileFunction(), this can be called
+// after the function has run, so that the cache also covers the inner
+// functions that were compiled lazily in the meantime.
+static void CreateCodeCacheForFunction(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsFunction());
+  std::unique_ptr<ScriptCompiler::CachedData> cached_data(
+      ScriptCompiler::CreateCodeCacheForFunction(args[0].As<Function>()));
+  if (!cached_data) return;
+  MaybeLocal<Object> buf = Buffer::Copy(
+      env,
+      reinterpret_cast<const char*>(cached_data->data),
+      cached_data->length);
+  args.GetReturnValue().Set(buf.ToLocalChecked());
+}
+
+// A 64-bit FNV-1a hash of the UTF-8 representation of a string, as a hex
+// string. Used to key code cache entries; not suitable for anything that
+// needs to withstand adversarial input.
+static void HashSource(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsString());
+  Utf8Value source(env->isolate(), args[0]);
+
+  uint64_t hash = 0xcbf29ce484222325;
+  for (size_t i = 0; i < source.length(); i++) {
+    hash ^= static_cast<uint8_t>(source[i]);
+    hash *= 0x100000001b3;
+  }
+
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016" PRIx64, hash);
+  args.GetReturnValue().Set(OneByteString(env->isolate(), buf));
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -1208,6 +1255,10 @@ void Initialize(Local<Object> target,
   ContextifyContext::Init(env, target);
   ContextifyScript::Init(env, target);
 
+  env->SetMethod(
+      target, "createCodeCacheForFunction", CreateCodeCacheForFunction);
+  env->SetMethodNoSideEffect(target, "hashSource", HashSource);
+
   env->SetMethod(target, "startSigintWatchdog", StartSigintWatchdog);
   env->SetMethod(target, "stopSigintWatchdog", StopSigintWatchdog);
   // Used in tests.
@@ -6065,7 +6065,9 @@ bool ECDH::IsKeyPairValid() {
 struct CryptoJob : public ThreadPoolWork {
   Environment* const env;
   std::unique_ptr<AsyncWrap> async_wrap;
-  inline explicit CryptoJob(Environment* env) : ThreadPoolWork(env), env(env) {}
+  inline explicit CryptoJob(Environment* env)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_CRYPTO),
+        env(env) {}
   inline void AfterThreadPoolWork(int status) final;
   virtual void AfterThreadPoolWork() = 0;
   static inline void Run(std::unique_ptr<CryptoJob> job, Local<Value> wrap);
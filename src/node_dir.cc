@@ -1,5 +1,9 @@
 #include "node_dir.h"
+#include "aliased_buffer.h"
+#include "node_buffer.h"
+#include "node_errors.h"
 #include "node_process.h"
+#include "threadpoolwork-inl.h"
 #include "util.h"
 
 #include "tracing/trace_event.h"
@@ -26,11 +30,13 @@ using fs::FSReqWrapSync;
 using fs::GetReqWrap;
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -39,6 +45,8 @@ using v8::Null;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::String;
+using v8::Uint32;
+using v8::Undefined;
 using v8::Value;
 
 #define TRACE_NAME(name) "fs_dir.sync." #name
@@ -329,6 +337,314 @@ static void OpenDir(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+#ifdef _WIN32
+constexpr char kPathSeparator = '\\';
+#else
+constexpr char kPathSeparator = '/';
+#endif
+
+static int DirentTypeFromMode(uint64_t mode) {
+  switch (mode & S_IFMT) {
+    case S_IFREG: return UV_DIRENT_FILE;
+    case S_IFDIR: return UV_DIRENT_DIR;
+#ifdef S_IFLNK
+    case S_IFLNK: return UV_DIRENT_LINK;
+#endif
+#ifdef S_IFIFO
+    case S_IFIFO: return UV_DIRENT_FIFO;
+#endif
+#ifdef S_IFSOCK
+    case S_IFSOCK: return UV_DIRENT_SOCKET;
+#endif
+    case S_IFCHR: return UV_DIRENT_CHAR;
+#ifdef S_IFBLK
+    case S_IFBLK: return UV_DIRENT_BLOCK;
+#endif
+    default: return UV_DIRENT_UNKNOWN;
+  }
+}
+
+DirWalker::DirWalker(Environment* env,
+                     Local<Object> obj,
+                     std::string&& root,
+                     uint32_t max_depth,
+                     bool want_stats,
+                     size_t batch_size,
+                     std::unordered_set<std::string>&& skip)
+    : BaseObject(env, obj),
+      root_(std::move(root)),
+      max_depth_(max_depth),
+      want_stats_(want_stats),
+      batch_size_(batch_size),
+      skip_(std::move(skip)) {
+  MakeWeak();
+}
+
+DirWalker::~DirWalker() {
+  CHECK(!reading_);
+  CloseAll();
+}
+
+std::string DirWalker::FullPath(const std::string& relative) const {
+  if (relative.empty()) return root_;
+  std::string path = root_;
+  if (path.empty() || path.back() != kPathSeparator)
+    path += kPathSeparator;
+  return path + relative;
+}
+
+int DirWalker::Push(std::string&& prefix, uint32_t depth) {
+  uv_fs_t req;
+  int err = uv_fs_opendir(nullptr, &req, FullPath(prefix).c_str(), nullptr);
+  uv_dir_t* dir = static_cast<uv_dir_t*>(req.ptr);
+  uv_fs_req_cleanup(&req);
+  if (err < 0) return err;
+
+  std::unique_ptr<Frame> frame(new Frame());
+  frame->dir = dir;
+  frame->dir->dirents = frame->dirents;
+  frame->dir->nentries = arraysize(frame->dirents);
+  frame->prefix = std::move(prefix);
+  if (!frame->prefix.empty())
+    frame->prefix += kPathSeparator;
+  frame->depth = depth;
+  stack_.emplace_back(std::move(frame));
+  return 0;
+}
+
+void DirWalker::Pop() {
+  Frame* frame = stack_.back().get();
+  uv_fs_t req;
+  if (frame->has_req)
+    uv_fs_req_cleanup(&frame->req);
+  uv_fs_closedir(nullptr, &req, frame->dir, nullptr);
+  uv_fs_req_cleanup(&req);
+  stack_.pop_back();
+}
+
+void DirWalker::CloseAll() {
+  while (!stack_.empty())
+    Pop();
+}
+
+int DirWalker::ReadBatch() {
+  paths_.clear();
+  entries_.clear();
+  stats_.clear();
+
+  if (!started_) {
+    started_ = true;
+    int err = Push(std::string(), 0);
+    if (err < 0) return err;
+  }
+
+  while (entries_.size() < batch_size_ * kEntryFields && !stack_.empty()) {
+    Frame* frame = stack_.back().get();
+    if (frame->next == frame->count) {
+      if (frame->has_req)
+        uv_fs_req_cleanup(&frame->req);
+      // Directories that cannot be read any further, e.g. because they were
+      // removed in the meantime, are treated as if they had ended.
+      int count = uv_fs_readdir(nullptr, &frame->req, frame->dir, nullptr);
+      frame->has_req = true;
+      if (count <= 0) {
+        Pop();
+        continue;
+      }
+      frame->count = count;
+      frame->next = 0;
+    }
+
+    const uv_dirent_t& dirent = frame->dirents[frame->next++];
+    if (!skip_.empty() && skip_.count(dirent.name) != 0)
+      continue;
+
+    std::string relative = frame->prefix + dirent.name;
+    int type = dirent.type;
+    int error = 0;
+    uv_stat_t stat {};
+    if (want_stats_ || type == UV_DIRENT_UNKNOWN) {
+      uv_fs_t req;
+      error = uv_fs_lstat(nullptr, &req, FullPath(relative).c_str(), nullptr);
+      if (error == 0) {
+        stat = req.statbuf;
+        if (type == UV_DIRENT_UNKNOWN)
+          type = DirentTypeFromMode(stat.st_mode);
+      }
+      uv_fs_req_cleanup(&req);
+    }
+
+    paths_ += relative;
+    entries_.push_back(static_cast<int32_t>(paths_.size()));
+    entries_.push_back(type);
+    entries_.push_back(static_cast<int32_t>(frame->depth));
+    entries_.push_back(error);
+    if (want_stats_)
+      stats_.push_back(stat);
+
+    // Symbolic links are never followed, so there cannot be any cycles.
+    if (type == UV_DIRENT_DIR && frame->depth < max_depth_) {
+      int err = Push(std::move(relative), frame->depth + 1);
+      if (err < 0 && error == 0)
+        entries_.back() = err;
+    }
+  }
+  return 0;
+}
+
+Local<Value> DirWalker::TakeBatch() {
+  Isolate* isolate = env()->isolate();
+  if (entries_.empty())
+    return Null(isolate);
+
+  const size_t count = entries_.size() / kEntryFields;
+  Local<Value> paths;
+  if (!Buffer::Copy(env(), paths_.data(), paths_.size()).ToLocal(&paths))
+    return Local<Value>();
+
+  Local<ArrayBuffer> entries_buffer =
+      ArrayBuffer::New(isolate, entries_.size() * sizeof(entries_[0]));
+  memcpy(entries_buffer->GetContents().Data(),
+         entries_.data(),
+         entries_.size() * sizeof(entries_[0]));
+
+  Local<Value> stats = Undefined(isolate);
+  if (want_stats_) {
+    const size_t fields_per_entry =
+        static_cast<size_t>(FsStatsOffset::kFsStatsFieldsNumber);
+    AliasedFloat64Array fields(isolate, fields_per_entry * count);
+    for (size_t i = 0; i < count; i++) {
+      if (entries_[i * kEntryFields + 3] == 0)
+        fs::FillStatsArray(&fields, &stats_[i], i * fields_per_entry);
+    }
+    stats = fields.GetJSArray();
+  }
+
+  Local<Value> batch[] = {
+    paths,
+    Int32Array::New(entries_buffer, 0, entries_.size()),
+    stats
+  };
+  paths_.clear();
+  entries_.clear();
+  stats_.clear();
+  return Array::New(isolate, batch, arraysize(batch));
+}
+
+void DirWalker::ReadDone() {
+  reading_ = false;
+  MakeWeak();
+}
+
+// Reads the next batch of a DirWalker.
+class DirWalkJob final : public ThreadPoolWork {
+ public:
+  DirWalkJob(Environment* env, DirWalker* walker, FSReqBase* req_wrap)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_FS),
+        env_(env),
+        walker_(walker),
+        req_wrap_(req_wrap) {}
+
+  void DoThreadPoolWork() override {
+    err_ = walker_->ReadBatch();
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<DirWalkJob> self(this);
+    std::unique_ptr<FSReqBase> req_wrap(req_wrap_);
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+
+    walker_->ReadDone();
+    if (status == UV_ECANCELED)
+      err_ = status;
+    if (err_ != 0) {
+      req_wrap->Reject(UVException(isolate, err_, "opendir", nullptr,
+                                   walker_->root().c_str()));
+      return;
+    }
+    Local<Value> batch = walker_->TakeBatch();
+    if (batch.IsEmpty()) return;
+    req_wrap->Resolve(batch);
+  }
+
+ private:
+  Environment* const env_;
+  DirWalker* const walker_;
+  FSReqBase* const req_wrap_;
+  int err_ = 0;
+};
+
+/*
+ * new DirWalker(path, maxDepth, stats, skip, batchSize)
+ *
+ * 0 path       string or Buffer, the root of the tree
+ * 1 maxDepth   uint32. entries deeper than this are not reported, the
+ *              entries of the root have depth 0
+ * 2 stats      whether every entry is lstat()'ed
+ * 3 skip       array of entry names that are neither reported nor descended
+ *              into
+ * 4 batchSize  uint32. maximum number of entries that a read() returns
+ */
+void DirWalker::New(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  CHECK(args.IsConstructCall());
+  CHECK_GE(args.Length(), 5);
+
+  BufferValue path(isolate, args[0]);
+  CHECK_NOT_NULL(*path);
+  CHECK(args[1]->IsUint32());
+  const uint32_t max_depth = args[1].As<Uint32>()->Value();
+  const bool want_stats = args[2]->IsTrue();
+
+  CHECK(args[3]->IsArray());
+  Local<Array> skip_array = args[3].As<Array>();
+  std::unordered_set<std::string> skip;
+  for (uint32_t i = 0; i < skip_array->Length(); i++) {
+    Local<Value> value;
+    if (!skip_array->Get(env->context(), i).ToLocal(&value)) return;
+    BufferValue name(isolate, value);
+    CHECK_NOT_NULL(*name);
+    skip.emplace(*name, name.length());
+  }
+
+  CHECK(args[4]->IsUint32());
+  const uint32_t batch_size = args[4].As<Uint32>()->Value();
+  CHECK_GT(batch_size, 0);
+
+  new DirWalker(env, args.This(), std::string(*path, path.length()),
+                max_depth, want_stats, batch_size, std::move(skip));
+}
+
+// walker.read(req)
+void DirWalker::Read(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK_GE(args.Length(), 1);
+
+  DirWalker* walker;
+  ASSIGN_OR_RETURN_UNWRAP(&walker, args.Holder());
+  CHECK(!walker->reading_);
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[0]);
+  CHECK_NOT_NULL(req_wrap_async);
+  // Keep the walker alive until the batch has been read.
+  walker->reading_ = true;
+  walker->ClearWeak();
+  (new DirWalkJob(env, walker, req_wrap_async))->ScheduleWork();
+  req_wrap_async->SetReturnValue(args);
+}
+
+// walker.close(), closes the directories that are still open.
+void DirWalker::Close(const FunctionCallbackInfo<Value>& args) {
+  DirWalker* walker;
+  ASSIGN_OR_RETURN_UNWRAP(&walker, args.Holder());
+  CHECK(!walker->reading_);
+  walker->started_ = true;
+  walker->CloseAll();
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -353,6 +669,17 @@ void Initialize(Local<Object> target,
             dir->GetFunction(env->context()).ToLocalChecked())
       .FromJust();
   env->set_dir_instance_template(dirt);
+
+  Local<FunctionTemplate> walker = env->NewFunctionTemplate(DirWalker::New);
+  walker->InstanceTemplate()->SetInternalFieldCount(1);
+  env->SetProtoMethod(walker, "read", DirWalker::Read);
+  env->SetProtoMethod(walker, "close", DirWalker::Close);
+  Local<String> walkerString = FIXED_ONE_BYTE_STRING(isolate, "DirWalker");
+  walker->SetClassName(walkerString);
+  target
+      ->Set(context, walkerString,
+            walker->GetFunction(env->context()).ToLocalChecked())
+      .FromJust();
 }
 
 }  // namespace fs_dir
@@ -7,6 +7,11 @@
 #include "node.h"
 #include "req_wrap-inl.h"
 
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 namespace node {
 
 namespace fs_dir {
@@ -51,6 +56,87 @@ class DirHandle : public AsyncWrap {
   bool closed_ = false;
 };
 
+// Walks a directory tree depth-first on the threadpool. Every read() returns
+// the next batch of entries, with their paths relative to the root packed
+// into a single Buffer, and optionally their lstat() results.
+class DirWalker : public BaseObject {
+ public:
+  // Per entry: end offset of the path, uv_dirent_type_t, depth, and 0 or the
+  // error that occurred while stat'ing the entry or opening it as a directory.
+  static constexpr size_t kEntryFields = 4;
+
+  ~DirWalker() override;
+
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Read(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  // Called on the threadpool. Returns 0 or the error that occurred while
+  // opening the root directory.
+  int ReadBatch();
+  // Returns [paths, entries, stats] for the last batch, or null when the walk
+  // is finished.
+  v8::Local<v8::Value> TakeBatch();
+  void ReadDone();
+
+  const std::string& root() const { return root_; }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("frames",
+                                stack_.size() * sizeof(Frame));
+    tracker->TrackField("paths", paths_);
+  }
+
+  SET_MEMORY_INFO_NAME(DirWalker)
+  SET_SELF_SIZE(DirWalker)
+
+  DirWalker(const DirWalker&) = delete;
+  DirWalker& operator=(const DirWalker&) = delete;
+
+ private:
+  // A directory that is being read, i.e. an ancestor of the next entry.
+  struct Frame {
+    uv_dir_t* dir = nullptr;
+    // Relative path of the directory, with a trailing separator unless it is
+    // the root.
+    std::string prefix;
+    uint32_t depth = 0;
+    uv_fs_t req;
+    bool has_req = false;
+    size_t count = 0;
+    size_t next = 0;
+    uv_dirent_t dirents[64];
+  };
+
+  DirWalker(Environment* env,
+            v8::Local<v8::Object> obj,
+            std::string&& root,
+            uint32_t max_depth,
+            bool want_stats,
+            size_t batch_size,
+            std::unordered_set<std::string>&& skip);
+
+  int Push(std::string&& prefix, uint32_t depth);
+  void Pop();
+  void CloseAll();
+  std::string FullPath(const std::string& relative) const;
+
+  const std::string root_;
+  const uint32_t max_depth_;
+  const bool want_stats_;
+  const size_t batch_size_;
+  const std::unordered_set<std::string> skip_;
+
+  std::vector<std::unique_ptr<Frame>> stack_;
+  bool started_ = false;
+  bool reading_ = false;
+
+  // The current batch.
+  std::string paths_;
+  std::vector<int32_t> entries_;
+  std::vector<uv_stat_t> stats_;
+};
+
 }  // namespace fs_dir
 
 }  // namespace node
@@ -2,6 +2,7 @@
 #include <cstdarg>
 
 #include "node_errors.h"
+#include "node_external_reference.h"
 #include "node_internals.h"
 #ifdef NODE_REPORT
 #include "node_report.h"
@@ -865,6 +866,13 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "triggerUncaughtException", TriggerUncaughtException);
 }
 
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(SetPrepareStackTraceCallback);
+  registry->Register(SetEnhanceStackForFatalException);
+  registry->Register(NoSideEffectsToString);
+  registry->Register(TriggerUncaughtException);
+}
+
 void DecorateErrorStack(Environment* env,
                         const errors::TryCatchScope& try_catch) {
   Local<Value> exception = try_catch.Exception();
@@ -1022,3 +1030,4 @@ void TriggerUncaughtException(Isolate* isolate, const v8::TryCatch& try_catch) {
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(errors, node::errors::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(errors, node::errors::RegisterExternalReferences)
@@ -41,6 +41,7 @@ void PrintErrorString(const char* format, ...);
   V(ERR_BUFFER_TOO_LARGE, Error)                                             \
   V(ERR_CONSTRUCT_CALL_REQUIRED, TypeError)                                  \
   V(ERR_CONSTRUCT_CALL_INVALID, TypeError)                                   \
+  V(ERR_FS_FILE_TOO_LARGE, RangeError)                                       \
   V(ERR_INVALID_ARG_VALUE, TypeError)                                        \
   V(ERR_OSSL_EVP_INVALID_DIGEST, Error)                                      \
   V(ERR_INVALID_ARG_TYPE, TypeError)                                         \
@@ -134,6 +135,14 @@ inline v8::Local<v8::Value> ERR_BUFFER_TOO_LARGE(v8::Isolate* isolate) {
   return ERR_BUFFER_TOO_LARGE(isolate, message);
 }
 
+inline v8::Local<v8::Value> ERR_FS_FILE_TOO_LARGE(v8::Isolate* isolate,
+                                                  uint64_t size) {
+  std::ostringstream message;
+  message << "File size (" << size << ") is greater than possible Buffer: ";
+  message << v8::TypedArray::kMaxLength << " bytes";
+  return ERR_FS_FILE_TOO_LARGE(isolate, message.str().c_str());
+}
+
 inline v8::Local<v8::Value> ERR_STRING_TOO_LONG(v8::Isolate* isolate) {
   char message[128];
   snprintf(message, sizeof(message),
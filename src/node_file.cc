@@ -22,7 +22,9 @@
 #include "node_file.h"
 #include "aliased_buffer.h"
 #include "memory_tracker-inl.h"
+#include "module_bundle.h"
 #include "node_buffer.h"
+#include "node_errors.h"
 #include "node_process.h"
 #include "node_stat_watcher.h"
 #include "util-inl.h"
@@ -33,6 +35,7 @@
 #include "stream_base-inl.h"
 #include "string_bytes.h"
 #include "string_search.h"
+#include "threadpoolwork-inl.h"
 
 #include <fcntl.h>
 #include <sys/types.h>
@@ -45,6 +48,7 @@
 # include <io.h>
 #endif
 
+#include <atomic>
 #include <memory>
 
 namespace node {
@@ -52,6 +56,7 @@ namespace node {
 namespace fs {
 
 using v8::Array;
+using v8::ArrayBuffer;
 using v8::Context;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
@@ -60,6 +65,7 @@ using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
 using v8::Int32;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
@@ -72,6 +78,7 @@ using v8::PropertyAttribute;
 using v8::ReadOnly;
 using v8::String;
 using v8::Symbol;
+using v8::TryCatch;
 using v8::Uint32;
 using v8::Undefined;
 using v8::Value;
@@ -475,12 +482,33 @@ void NewFSReqCallback(const FunctionCallbackInfo<Value>& args) {
   new FSReqCallback(env, args.This(), args[0]->IsTrue());
 }
 
+void FSReqBase::MarkQueued() {
+  performance::performance_state* state = env()->performance_state();
+  state->threadpool_pending[performance::NODE_THREADPOOL_WORK_TYPE_FS] += 1;
+  queued_at_ = state->is_tracking_threadpool() ? uv_hrtime() : 0;
+  is_queued_ = true;
+}
+
+void FSReqBase::MarkFinished() {
+  if (!is_queued_) return;
+  is_queued_ = false;
+  performance::performance_state* state = env()->performance_state();
+  state->threadpool_pending[performance::NODE_THREADPOOL_WORK_TYPE_FS] -= 1;
+  // libuv does not tell us when a uv_fs_t starts running on the threadpool,
+  // so only the total time spent is recorded for fs requests.
+  if (queued_at_ != 0) {
+    state->RecordThreadPoolWork(performance::NODE_THREADPOOL_WORK_TYPE_FS,
+                                queued_at_, 0, uv_hrtime());
+  }
+}
+
 FSReqAfterScope::FSReqAfterScope(FSReqBase* wrap, uv_fs_t* req)
     : wrap_(wrap),
       req_(req),
       handle_scope_(wrap->env()->isolate()),
       context_scope_(wrap->env()->context()) {
   CHECK_EQ(wrap_->req(), req);
+  wrap_->MarkFinished();
 }
 
 FSReqAfterScope::~FSReqAfterScope() {
@@ -727,6 +755,30 @@ void Close(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+static void ReturnPackageJSON(const FunctionCallbackInfo<Value>& args,
+                              const char* data,
+                              size_t length) {
+  size_t start = 0;
+  if (length >= 3 && 0 == memcmp(data, "\xEF\xBB\xBF", 3)) {
+    start = 3;  // Skip UTF-8 BOM.
+  }
+
+  const size_t size = length - start;
+  if (size == 0 || (
+    size == SearchString(&data[start], size, "\"main\"") &&
+    size == SearchString(&data[start], size, "\"exports\"") &&
+    size == SearchString(&data[start], size, "\"type\""))) {
+    return;
+  } else {
+    Local<String> chars_string =
+        String::NewFromUtf8(args.GetIsolate(),
+                            &data[start],
+                            v8::NewStringType::kNormal,
+                            size).ToLocalChecked();
+    args.GetReturnValue().Set(chars_string);
+  }
+}
+
 // Used to speed up module loading.  Returns the contents of the file as
 // a string or undefined when the file cannot be opened or "main" is not found
 // in the file.
@@ -741,6 +793,15 @@ static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
   if (strlen(*path) != path.length())
     return;  // Contains a nul byte.
 
+  if (const loader::ModuleBundle* bundle = loader::ModuleBundle::Get()) {
+    const loader::ModuleBundle::Entry* entry =
+        bundle->Find(std::string(*path, path.length()));
+    if (entry != nullptr) {
+      ReturnPackageJSON(args, entry->source, entry->source_length);
+      return;
+    }
+  }
+
   uv_fs_t open_req;
   const int fd = uv_fs_open(loop, &open_req, *path, O_RDONLY, 0, nullptr);
   uv_fs_req_cleanup(&open_req);
@@ -777,47 +838,228 @@ static void InternalModuleReadJSON(const FunctionCallbackInfo<Value>& args) {
     offset += numchars;
   } while (static_cast<size_t>(numchars) == kBlockSize);
 
-  size_t start = 0;
-  if (offset >= 3 && 0 == memcmp(&chars[0], "\xEF\xBB\xBF", 3)) {
-    start = 3;  // Skip UTF-8 BOM.
-  }
-
-  const size_t size = offset - start;
-  if (size == 0 || (
-    size == SearchString(&chars[start], size, "\"main\"") &&
-    size == SearchString(&chars[start], size, "\"exports\"") &&
-    size == SearchString(&chars[start], size, "\"type\""))) {
-    return;
-  } else {
-    Local<String> chars_string =
-        String::NewFromUtf8(isolate,
-                            &chars[start],
-                            v8::NewStringType::kNormal,
-                            size).ToLocalChecked();
-    args.GetReturnValue().Set(chars_string);
-  }
+  ReturnPackageJSON(args, chars.data(), offset);
 }
 
 // Used to speed up module loading.  Returns 0 if the path refers to
 // a file, 1 when it's a directory or < 0 on error (usually -ENOENT.)
 // The speedup comes from not creating thousands of Stat and Error objects.
+// Returns 0 for files, 1 for directories and a negative error code if the
+// path cannot be stat()ed.
+static int ModuleStat(Environment* env, const char* path) {
+  uv_fs_t req;
+  int rc = uv_fs_stat(env->event_loop(), &req, path, nullptr);
+  if (rc == 0) {
+    const uv_stat_t* const s = static_cast<const uv_stat_t*>(req.ptr);
+    rc = !!(s->st_mode & S_IFDIR);
+  }
+  uv_fs_req_cleanup(&req);
+  return rc;
+}
+
+static loader::DirectoryListing* GetDirectoryListing(Environment* env,
+                                                     const std::string& dir) {
+  auto it = env->module_directory_cache.find(dir);
+  if (it != env->module_directory_cache.end())
+    return &it->second;
+
+  loader::DirectoryListing listing;
+  uv_fs_t req;
+  if (uv_fs_scandir(env->event_loop(), &req, dir.c_str(), 0, nullptr) >= 0) {
+    listing.exists = true;
+    uv_dirent_t ent;
+    while (uv_fs_scandir_next(&req, &ent) != UV_EOF) {
+      int type;
+      switch (ent.type) {
+        case UV_DIRENT_DIR:
+          type = 1;
+          break;
+        case UV_DIRENT_LINK:
+        case UV_DIRENT_UNKNOWN:
+          type = loader::DirectoryListing::kNeedsStat;
+          break;
+        default:
+          type = 0;
+      }
+      listing.entries.emplace(ent.name, type);
+    }
+  }
+  uv_fs_req_cleanup(&req);
+
+  return &env->module_directory_cache.emplace(dir, std::move(listing))
+              .first->second;
+}
+
+// Like ModuleStat(), but answered from the listing of the parent directory,
+// which is read once and kept until the CommonJS loader clears it. Looking up
+// all the candidates in node_modules folders that do not exist, or files with
+// the wrong extension, costs one scandir() per directory this way instead of
+// one stat() per candidate.
+static int CachedModuleStat(Environment* env, const std::string& path) {
+#ifdef _WIN32
+  size_t sep = path.find_last_of("\\/");
+#else
+  size_t sep = path.find_last_of('/');
+#endif
+  // Leave roots, and drive-relative paths on Windows, to the real thing.
+  if (sep == std::string::npos || sep == 0 || sep + 1 == path.size() ||
+      path[sep - 1] == ':') {
+    return ModuleStat(env, path.c_str());
+  }
+
+  loader::DirectoryListing* listing =
+      GetDirectoryListing(env, path.substr(0, sep));
+  if (!listing->exists)
+    return UV_ENOENT;
+
+  auto it = listing->entries.find(path.substr(sep + 1));
+  if (it == listing->entries.end()) {
+#if defined(__APPLE__) || defined(_WIN32)
+    // The file system may be case-insensitive.
+    return ModuleStat(env, path.c_str());
+#else
+    return UV_ENOENT;
+#endif
+  }
+  if (it->second == loader::DirectoryListing::kNeedsStat)
+    it->second = ModuleStat(env, path.c_str());
+  return it->second;
+}
+
+static inline bool UseModuleDirectoryCache(Environment* env) {
+  return !env->options()->experimental_resolution_cache.empty();
+}
+
+// Looks the path up in the module bundle first, if there is one.
+static int BundledModuleStat(Environment* env,
+                             const std::string& path,
+                             bool use_cache) {
+  if (const loader::ModuleBundle* bundle = loader::ModuleBundle::Get()) {
+    int rc = bundle->Stat(path);
+    if (rc >= 0)
+      return rc;
+  }
+  return use_cache ? CachedModuleStat(env, path) :
+                     ModuleStat(env, path.c_str());
+}
+
 static void InternalModuleStat(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
   CHECK(args[0]->IsString());
   node::Utf8Value path(env->isolate(), args[0]);
 
-  uv_fs_t req;
-  int rc = uv_fs_stat(env->event_loop(), &req, *path, nullptr);
-  if (rc == 0) {
-    const uv_stat_t* const s = static_cast<const uv_stat_t*>(req.ptr);
-    rc = !!(s->st_mode & S_IFDIR);
+  int rc = BundledModuleStat(env,
+                             std::string(*path, path.length()),
+                             UseModuleDirectoryCache(env));
+  args.GetReturnValue().Set(rc);
+}
+
+// Drops the directory listings of CachedModuleStat(). The CommonJS loader
+// calls this when a top-level require() starts and ends, like it resets its
+// own stat() cache.
+static void InternalModuleClearDirectoryCache(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  env->module_directory_cache.clear();
+}
+
+// Used by the CommonJS resolver to look up a path with several extensions in
+// a single call. Returns the index of the first extension in args[1] for
+// which args[0] + extension is a file, or -1.
+static void InternalModuleFindFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsArray());
+  node::Utf8Value base(isolate, args[0]);
+  Local<Array> exts = args[1].As<Array>();
+  bool use_cache = UseModuleDirectoryCache(env);
+
+  std::string candidate;
+  for (uint32_t i = 0; i < exts->Length(); i++) {
+    Local<Value> ext;
+    if (!exts->Get(env->context(), i).ToLocal(&ext))
+      return;
+    CHECK(ext->IsString());
+    candidate.assign(*base, base.length());
+    candidate += *node::Utf8Value(isolate, ext);
+    int rc = BundledModuleStat(env, candidate, use_cache);
+    if (rc == 0) {
+      args.GetReturnValue().Set(static_cast<int>(i));
+      return;
+    }
   }
-  uv_fs_req_cleanup(&req);
+  args.GetReturnValue().Set(-1);
+}
+
+// Returns 0 if the module bundle contains a file at args[0], 1 if it contains
+// a directory, or a negative error code otherwise.
+static void InternalModuleBundleStat(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
 
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  const loader::ModuleBundle* bundle = loader::ModuleBundle::Get();
+  int rc = bundle != nullptr ? bundle->Stat(std::string(*path, path.length()))
+                             : UV_ENOENT;
   args.GetReturnValue().Set(rc);
 }
 
+// Returns the source of the file at args[0] from the module bundle, or
+// undefined if the bundle does not contain it.
+static void InternalModuleReadBundle(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  const loader::ModuleBundle* bundle = loader::ModuleBundle::Get();
+  if (bundle == nullptr)
+    return;
+  const loader::ModuleBundle::Entry* entry =
+      bundle->Find(std::string(*path, path.length()));
+  if (entry == nullptr)
+    return;
+
+  Local<String> source;
+  if (!loader::ModuleBundle::GetSource(env->isolate(), *entry)
+           .ToLocal(&source)) {
+    env->isolate()->ThrowException(ERR_STRING_TOO_LONG(env->isolate()));
+    return;
+  }
+  args.GetReturnValue().Set(source);
+}
+
+// Returns a Buffer with the code cache of the file at args[0] from the module
+// bundle, or undefined if there is none. The Buffer points into the bundle.
+static void InternalModuleReadBundleCodeCache(
+    const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+
+  CHECK(args[0]->IsString());
+  node::Utf8Value path(env->isolate(), args[0]);
+
+  const loader::ModuleBundle* bundle = loader::ModuleBundle::Get();
+  if (bundle == nullptr)
+    return;
+  const loader::ModuleBundle::Entry* entry =
+      bundle->Find(std::string(*path, path.length()));
+  if (entry == nullptr || entry->code_cache == nullptr)
+    return;
+
+  Local<Object> buffer;
+  if (Buffer::New(env->isolate(),
+                  entry->code_cache,
+                  entry->code_cache_length,
+                  [](char* data, void* hint) {},
+                  nullptr).ToLocal(&buffer)) {
+    args.GetReturnValue().Set(buffer);
+  }
+}
+
 static void Stat(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
 
@@ -909,6 +1151,171 @@ static void FStat(const FunctionCallbackInfo<Value>& args) {
   }
 }
 
+// The state of a statMany() call, which is split into chunks that run on the
+// threadpool in parallel. The last chunk to finish resolves the request.
+class StatManyBatch {
+ public:
+  // Small enough that other requests do not wait behind a whole batch.
+  static constexpr size_t kChunkSize = 512;
+
+  StatManyBatch(Environment* env,
+                FSReqBase* req_wrap,
+                std::vector<std::string>&& paths,
+                bool follow_links)
+      : env_(env),
+        req_wrap_(req_wrap),
+        paths_(std::move(paths)),
+        follow_links_(follow_links),
+        stats_(paths_.size()),
+        errors_(paths_.size()),
+        pending_((paths_.size() + kChunkSize - 1) / kChunkSize) {}
+
+  size_t size() const { return paths_.size(); }
+
+  void Stat(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      uv_fs_t req;
+      const char* path = paths_[i].c_str();
+      int err = follow_links_ ? uv_fs_stat(nullptr, &req, path, nullptr)
+                              : uv_fs_lstat(nullptr, &req, path, nullptr);
+      errors_[i] = err;
+      if (err == 0)
+        stats_[i] = req.statbuf;
+      uv_fs_req_cleanup(&req);
+    }
+  }
+
+  void Cancel(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+      errors_[i] = UV_ECANCELED;
+  }
+
+  void ChunkDone() {
+    CHECK_GT(pending_, 0);
+    if (--pending_ > 0) return;
+    std::unique_ptr<StatManyBatch> self(this);
+    Finish();
+  }
+
+ private:
+  template <typename AliasedBufferT>
+  Local<Value> NewStatsArray() const {
+    const size_t fields_per_entry =
+        static_cast<size_t>(FsStatsOffset::kFsStatsFieldsNumber);
+    AliasedBufferT fields(env_->isolate(), fields_per_entry * size());
+    for (size_t i = 0; i < size(); i++) {
+      if (errors_[i] == 0)
+        FillStatsArray(&fields, &stats_[i], i * fields_per_entry);
+    }
+    return fields.GetJSArray();
+  }
+
+  void Finish() {
+    std::unique_ptr<FSReqBase> req_wrap(req_wrap_);
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+
+    Local<ArrayBuffer> errors_buffer =
+        ArrayBuffer::New(isolate, size() * sizeof(errors_[0]));
+    memcpy(errors_buffer->GetContents().Data(),
+           errors_.data(),
+           size() * sizeof(errors_[0]));
+
+    Local<Value> result[] = {
+      req_wrap->use_bigint() ? NewStatsArray<AliasedBigUint64Array>()
+                             : NewStatsArray<AliasedFloat64Array>(),
+      Int32Array::New(errors_buffer, 0, size())
+    };
+    req_wrap->Resolve(Array::New(isolate, result, arraysize(result)));
+  }
+
+  Environment* const env_;
+  FSReqBase* const req_wrap_;
+  const std::vector<std::string> paths_;
+  const bool follow_links_;
+  std::vector<uv_stat_t> stats_;
+  std::vector<int32_t> errors_;
+  size_t pending_;
+};
+
+class StatManyChunk final : public ThreadPoolWork {
+ public:
+  StatManyChunk(Environment* env,
+                StatManyBatch* batch,
+                size_t begin,
+                size_t end)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_FS),
+        batch_(batch),
+        begin_(begin),
+        end_(end) {}
+
+  void DoThreadPoolWork() override {
+    batch_->Stat(begin_, end_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<StatManyChunk> self(this);
+    if (status == UV_ECANCELED)
+      batch_->Cancel(begin_, end_);
+    batch_->ChunkDone();
+  }
+
+ private:
+  StatManyBatch* const batch_;
+  const size_t begin_;
+  const size_t end_;
+};
+
+/*
+ * statMany(paths, use_bigint, follow_links, req)
+ *
+ * 0 paths         a non-empty array of strings or Buffers
+ * 1 use_bigint    whether the stats are returned in a BigUint64Array
+ * 2 follow_links  stat() if true, lstat() otherwise
+ * 3 req           FSReqCallback or kUsePromises
+ *
+ * Resolves with [fields, errors], where `fields` holds kFsStatsFieldsNumber
+ * values for every path, in the same order as the stat() bindings, and
+ * `errors` is an Int32Array with 0 or the libuv error code for every path.
+ */
+static void StatMany(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 4);
+
+  CHECK(args[0]->IsArray());
+  Local<Array> array = args[0].As<Array>();
+  const uint32_t length = array->Length();
+  CHECK_GT(length, 0);
+
+  std::vector<std::string> paths;
+  paths.reserve(length);
+  for (uint32_t i = 0; i < length; i++) {
+    Local<Value> value;
+    if (!array->Get(env->context(), i).ToLocal(&value)) return;
+    BufferValue path(isolate, value);
+    CHECK_NOT_NULL(*path);
+    paths.emplace_back(*path, path.length());
+  }
+
+  const bool use_bigint = args[1]->IsTrue();
+  const bool follow_links = args[2]->IsTrue();
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[3], use_bigint);
+  CHECK_NOT_NULL(req_wrap_async);
+  StatManyBatch* batch = new StatManyBatch(env, req_wrap_async,
+                                           std::move(paths), follow_links);
+  const size_t size = batch->size();
+  for (size_t begin = 0; begin < size; begin += StatManyBatch::kChunkSize) {
+    const size_t end = std::min(begin + StatManyBatch::kChunkSize, size);
+    (new StatManyChunk(env, batch, begin, end))->ScheduleWork();
+  }
+  req_wrap_async->SetReturnValue(args);
+}
+
 static void Symlink(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   Isolate* isolate = env->isolate();
@@ -1817,6 +2224,955 @@ static void Read(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+bool FileContents::Read(const std::string& path, uv_file fd, int flags) {
+  uv_fs_t req;
+  const bool opened = fd < 0;
+  if (opened) {
+    fd = uv_fs_open(nullptr, &req, path.c_str(), flags, 0666, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (fd < 0) {
+      SetError(fd, "open");
+      return false;
+    }
+  }
+
+  bool ok = ReadAll(fd);
+
+  // Files that were passed in by descriptor are left open.
+  if (opened) {
+    int err = uv_fs_close(nullptr, &req, fd, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0 && ok) {
+      SetError(err, "close");
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+bool FileContents::ReadAll(uv_file fd) {
+  uv_fs_t req;
+  int err = uv_fs_fstat(nullptr, &req, fd, nullptr);
+  const bool is_regular = (req.statbuf.st_mode & S_IFMT) == S_IFREG;
+  size_ = is_regular ? req.statbuf.st_size : 0;
+  uv_fs_req_cleanup(&req);
+  if (err < 0) {
+    SetError(err, "fstat");
+    return false;
+  }
+  if (size_ > Buffer::kMaxLength) {
+    too_large_ = true;
+    return false;
+  }
+
+  capacity_ = size_ > 0 ? static_cast<size_t>(size_) : kUnknownSizeChunk;
+  data_ = UncheckedMalloc(capacity_);
+  if (data_ == nullptr) {
+    SetError(UV_ENOMEM, "read");
+    return false;
+  }
+
+  for (;;) {
+    if (length_ == capacity_) {
+      // Stop at the size that fstat reported, like the reads did before.
+      if (size_ > 0)
+        break;
+      if (capacity_ >= Buffer::kMaxLength) {
+        size_ = capacity_;
+        too_large_ = true;
+        return false;
+      }
+      size_t capacity = std::min<size_t>(capacity_ * 2, Buffer::kMaxLength);
+      char* data = UncheckedRealloc(data_, capacity);
+      if (data == nullptr) {
+        SetError(UV_ENOMEM, "read");
+        return false;
+      }
+      data_ = data;
+      capacity_ = capacity;
+    }
+    uv_buf_t buf = uv_buf_init(data_ + length_,
+                               std::min<size_t>(capacity_ - length_, INT_MAX));
+    int r = uv_fs_read(nullptr, &req, fd, &buf, 1, -1, nullptr);
+    uv_fs_req_cleanup(&req);
+    if (r < 0) {
+      SetError(r, "read");
+      return false;
+    }
+    if (r == 0)
+      break;
+    length_ += r;
+  }
+
+  if (length_ == 0) {
+    free(data_);
+    data_ = nullptr;
+    capacity_ = 0;
+  }
+  return true;
+}
+
+void FileContents::SetError(int err, const char* syscall) {
+  err_ = err;
+  syscall_ = syscall;
+}
+
+Local<Value> FileContents::ToException(Isolate* isolate,
+                                       const std::string& path) const {
+  if (too_large_)
+    return ERR_FS_FILE_TOO_LARGE(isolate, size_);
+  CHECK_NE(err_, 0);
+  const bool open_failed = strcmp(syscall_, "open") == 0;
+  return UVException(isolate, err_, syscall_, nullptr,
+                     open_failed ? path.c_str() : nullptr);
+}
+
+char* FileContents::Release() {
+  // Do not hold on to the rest of a grown allocation.
+  if (length_ < capacity_) {
+    char* data = UncheckedRealloc(data_, length_);
+    if (data != nullptr)
+      data_ = data;
+  }
+  char* data = data_;
+  data_ = nullptr;
+  length_ = capacity_ = 0;
+  return data;
+}
+
+// Reads a whole file in a single trip to the threadpool: the open, fstat,
+// reads and close that used to be separate requests all happen in
+// DoThreadPoolWork().
+class ReadFileJob final : public ThreadPoolWork {
+ public:
+  ReadFileJob(Environment* env,
+              FSReqBase* req_wrap,
+              std::string&& path,
+              uv_file fd,
+              int flags,
+              bool as_string,
+              enum encoding encoding)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_FS),
+        env_(env),
+        req_wrap_(req_wrap),
+        path_(std::move(path)),
+        fd_(fd),
+        flags_(flags),
+        as_string_(as_string),
+        encoding_(encoding) {}
+
+  void DoThreadPoolWork() override {
+    ok_ = contents_.Read(path_, fd_, flags_);
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<ReadFileJob> self(this);
+    std::unique_ptr<FSReqBase> req_wrap(req_wrap_);
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+
+    if (status == UV_ECANCELED) {
+      contents_.SetError(status, "read");
+      ok_ = false;
+    }
+    if (!ok_) {
+      req_wrap->Reject(contents_.ToException(isolate, path_));
+      return;
+    }
+
+    if (as_string_) {
+      Local<Value> error;
+      MaybeLocal<Value> result = StringBytes::Encode(isolate,
+                                                     contents_.data(),
+                                                     contents_.length(),
+                                                     encoding_,
+                                                     &error);
+      if (result.IsEmpty()) {
+        CHECK(!error.IsEmpty());
+        req_wrap->Reject(error);
+        return;
+      }
+      req_wrap->Resolve(result.ToLocalChecked());
+      return;
+    }
+
+    // The contents are at most Buffer::kMaxLength bytes long, so creating
+    // the Buffer can only fail if V8 cannot allocate the object. The request
+    // still has to settle then.
+    Local<Object> buffer;
+    Local<Value> error;
+    {
+      TryCatch try_catch(isolate);
+      const size_t length = contents_.length();
+      char* data = contents_.Release();
+      MaybeLocal<Object> maybe_buffer =
+          data == nullptr ? Buffer::New(env_, 0)
+                          : Buffer::New(env_, data, length, true);
+      if (!maybe_buffer.ToLocal(&buffer)) {
+        if (try_catch.HasCaught() && !try_catch.HasTerminated())
+          error = try_catch.Exception();
+        else
+          error = ERR_MEMORY_ALLOCATION_FAILED(isolate);
+      }
+    }
+    if (buffer.IsEmpty()) {
+      req_wrap->Reject(error);
+      return;
+    }
+    req_wrap->Resolve(buffer);
+  }
+
+ private:
+  Environment* env_;
+  FSReqBase* req_wrap_;
+  std::string path_;
+  const uv_file fd_;
+  const int flags_;
+  const bool as_string_;
+  const enum encoding encoding_;
+
+  FileContents contents_;
+  bool ok_ = false;
+};
+
+/*
+ * readFile(path, flags, encoding, req)
+ *
+ * 0 path      string, Buffer or, for files that are already open, an int32
+ *             file descriptor that is left open
+ * 1 flags     int32. flags to open the file with
+ * 2 encoding  the encoding to decode the contents with, or undefined for a
+ *             Buffer
+ * 3 req       FSReqCallback or kUsePromises
+ */
+static void ReadFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 4);
+
+  uv_file fd = -1;
+  std::string path;
+  if (args[0]->IsInt32()) {
+    fd = args[0].As<Int32>()->Value();
+    CHECK_GE(fd, 0);
+  } else {
+    BufferValue path_value(isolate, args[0]);
+    CHECK_NOT_NULL(*path_value);
+    path.assign(*path_value, path_value.length());
+  }
+
+  CHECK(args[1]->IsInt32());
+  const int flags = args[1].As<Int32>()->Value();
+
+  const bool as_string = !args[2]->IsUndefined();
+  const enum encoding encoding = ParseEncoding(isolate, args[2], UTF8);
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[3]);
+  CHECK_NOT_NULL(req_wrap_async);
+  ReadFileJob* job = new ReadFileJob(env, req_wrap_async, std::move(path), fd,
+                                     flags, as_string, encoding);
+  job->ScheduleWork();
+  req_wrap_async->SetReturnValue(args);
+}
+
+// The counterpart of ReadFileJob, which opens, writes and closes a file in a
+// single trip to the threadpool.
+class WriteFileJob final : public ThreadPoolWork {
+ public:
+  WriteFileJob(Environment* env,
+               FSReqBase* req_wrap,
+               std::string&& path,
+               uv_file fd,
+               int flags,
+               int mode,
+               int64_t position)
+      : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_FS),
+        env_(env),
+        req_wrap_(req_wrap),
+        path_(std::move(path)),
+        fd_(fd),
+        flags_(flags),
+        mode_(mode),
+        position_(position) {}
+
+  // Writes the contents of an ArrayBufferView, which is kept alive until the
+  // job is done.
+  void SetData(Local<Object> view) {
+    view_.Reset(env_->isolate(), view);
+    data_ = Buffer::Data(view);
+    length_ = Buffer::Length(view);
+  }
+
+  // Writes data that the job owns.
+  void SetData(std::string&& data) {
+    owned_data_ = std::move(data);
+    data_ = owned_data_.data();
+    length_ = owned_data_.size();
+  }
+
+  void DoThreadPoolWork() override {
+    uv_fs_t req;
+    uv_file fd = fd_;
+    if (fd < 0) {
+      fd = uv_fs_open(nullptr, &req, path_.c_str(), flags_, mode_, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (fd < 0) {
+        err_ = fd;
+        syscall_ = "open";
+        return;
+      }
+    }
+
+    size_t written = 0;
+    int64_t position = position_;
+    while (written < length_) {
+      uv_buf_t buf = uv_buf_init(const_cast<char*>(data_) + written,
+                                 std::min<size_t>(length_ - written,
+                                                  INT_MAX));
+      int r = uv_fs_write(nullptr, &req, fd, &buf, 1, position, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (r < 0) {
+        err_ = r;
+        syscall_ = "write";
+        break;
+      }
+      written += r;
+      if (position >= 0)
+        position += r;
+    }
+
+    // Files that were passed in by descriptor are left open.
+    if (fd_ < 0) {
+      int err = uv_fs_close(nullptr, &req, fd, nullptr);
+      uv_fs_req_cleanup(&req);
+      if (err < 0 && err_ == 0) {
+        err_ = err;
+        syscall_ = "close";
+      }
+    }
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<WriteFileJob> self(this);
+    std::unique_ptr<FSReqBase> req_wrap(req_wrap_);
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+
+    if (status == UV_ECANCELED) {
+      err_ = status;
+      syscall_ = "write";
+    }
+    if (err_ != 0) {
+      const bool open_failed = strcmp(syscall_, "open") == 0;
+      req_wrap->Reject(UVException(isolate, err_, syscall_, nullptr,
+                                   open_failed ? path_.c_str() : nullptr));
+      return;
+    }
+    req_wrap->Resolve(Undefined(isolate));
+  }
+
+ private:
+  Environment* env_;
+  FSReqBase* req_wrap_;
+  std::string path_;
+  const uv_file fd_;
+  const int flags_;
+  const int mode_;
+  const int64_t position_;
+
+  v8::Global<Object> view_;
+  std::string owned_data_;
+  const char* data_ = nullptr;
+  size_t length_ = 0;
+  int err_ = 0;
+  const char* syscall_ = nullptr;
+};
+
+/*
+ * writeFile(path, data, flags, mode, position, encoding, req)
+ *
+ * 0 path      string, Buffer or, for files that are already open, an int32
+ *             file descriptor that is left open
+ * 1 data      ArrayBufferView or string
+ * 2 flags     int32. flags to open the file with
+ * 3 mode      int32. mode to create the file with
+ * 4 position  int64. file position to start writing at, -1 for the current
+ *             position
+ * 5 encoding  the encoding of `data` if it is a string
+ * 6 req       FSReqCallback or kUsePromises
+ */
+static void WriteFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+
+  const int argc = args.Length();
+  CHECK_GE(argc, 7);
+
+  uv_file fd = -1;
+  std::string path;
+  if (args[0]->IsInt32()) {
+    fd = args[0].As<Int32>()->Value();
+    CHECK_GE(fd, 0);
+  } else {
+    BufferValue path_value(isolate, args[0]);
+    CHECK_NOT_NULL(*path_value);
+    path.assign(*path_value, path_value.length());
+  }
+
+  CHECK(args[1]->IsArrayBufferView() || args[1]->IsString());
+
+  CHECK(args[2]->IsInt32());
+  const int flags = args[2].As<Int32>()->Value();
+
+  CHECK(args[3]->IsInt32());
+  const int mode = args[3].As<Int32>()->Value();
+
+  CHECK(IsSafeJsInt(args[4]));
+  const int64_t position = args[4].As<Integer>()->Value();
+
+  const enum encoding encoding = ParseEncoding(isolate, args[5], UTF8);
+
+  // Encode strings right away rather than creating a Buffer for them.
+  std::string string_data;
+  if (args[1]->IsString()) {
+    size_t length;
+    if (!StringBytes::StorageSize(isolate, args[1], encoding).To(&length))
+      return;
+    string_data.resize(length);
+    string_data.resize(StringBytes::Write(isolate, &string_data[0], length,
+                                          args[1], encoding));
+  }
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[6]);
+  CHECK_NOT_NULL(req_wrap_async);
+  WriteFileJob* job = new WriteFileJob(env, req_wrap_async, std::move(path),
+                                       fd, flags, mode, position);
+  if (args[1]->IsString()) {
+    job->SetData(std::move(string_data));
+  } else {
+    job->SetData(args[1].As<Object>());
+  }
+  job->ScheduleWork();
+  req_wrap_async->SetReturnValue(args);
+}
+
+// Operates on a directory tree with several threadpool workers, so that wide
+// trees are processed in parallel. Every directory is a separate work item:
+// a worker returns once it has processed its directory, and the main thread
+// then hands the directories that it queued to new workers. This keeps the
+// job from holding on to threads while it has nothing to do, and lets other
+// requests run between the directories of a large tree.
+class TreeJob {
+ public:
+  virtual ~TreeJob() = default;
+
+  void Start(std::string&& path, std::string&& dest) {
+    std::unique_ptr<Task> root(new Task());
+    root->path = std::move(path);
+    root->dest = std::move(dest);
+    root->is_root = true;
+    queue_.push_back(root.get());
+    tasks_.emplace_back(std::move(root));
+    ScheduleWorkers();
+  }
+
+  // `on_progress` is called with the current counts each time a directory
+  // has been processed.
+  void SetProgressCallback(Local<Function> on_progress) {
+    on_progress_.Reset(env_->isolate(), on_progress);
+  }
+
+ protected:
+  struct Task {
+    std::string path;
+    std::string dest;
+    bool is_root = false;
+    // The directory that contains this one, and the number of subdirectories
+    // that still have to be processed, plus one while this directory is being
+    // read.
+    Task* parent = nullptr;
+    std::atomic<size_t> pending { 1 };
+    // Used by CopyTreeJob: the mode that `dest` is given once its subtree has
+    // been copied, or -1 if it already has the right one.
+    int mode = -1;
+  };
+
+  TreeJob(Environment* env, FSReqBase* req_wrap)
+      : env_(env), req_wrap_(req_wrap) {}
+
+  // Called on the threadpool for every queued directory.
+  virtual void Process(Task* task) = 0;
+
+  Task* Push(std::string&& path,
+             std::string&& dest,
+             Task* parent,
+             int mode = -1) {
+    std::unique_ptr<Task> task(new Task());
+    task->path = std::move(path);
+    task->dest = std::move(dest);
+    task->parent = parent;
+    task->mode = mode;
+    Task* result = task.get();
+    Mutex::ScopedLock lock(mutex_);
+    queue_.push_back(result);
+    tasks_.emplace_back(std::move(task));
+    return result;
+  }
+
+  // Records the first error, and stops the workers.
+  void SetError(int err,
+                const char* syscall,
+                const std::string& path,
+                const std::string& dest = std::string()) {
+    Mutex::ScopedLock lock(mutex_);
+    if (err_ != 0) return;
+    failed_ = true;
+    err_ = err;
+    syscall_ = syscall;
+    error_path_ = path;
+    error_dest_ = dest;
+  }
+
+  bool failed() const { return failed_; }
+
+  // Returns the entries of `path`, or an error.
+  static int ScanDir(const std::string& path,
+                     std::vector<std::pair<std::string, int>>* entries) {
+    uv_fs_t req;
+    int err = uv_fs_scandir(nullptr, &req, path.c_str(), 0, nullptr);
+    if (err >= 0) {
+      uv_dirent_t ent;
+      while (uv_fs_scandir_next(&req, &ent) != UV_EOF)
+        entries->emplace_back(ent.name, ent.type);
+      err = 0;
+    }
+    uv_fs_req_cleanup(&req);
+    return err;
+  }
+
+  // Returns the uv_dirent_type_t of `path` if readdir did not report it.
+  static int LStatType(const std::string& path, uv_stat_t* stat = nullptr) {
+    uv_fs_t req;
+    int err = uv_fs_lstat(nullptr, &req, path.c_str(), nullptr);
+    const uint64_t mode = req.statbuf.st_mode;
+    if (err == 0 && stat != nullptr)
+      *stat = req.statbuf;
+    uv_fs_req_cleanup(&req);
+    if (err < 0) return err;
+    switch (mode & S_IFMT) {
+      case S_IFDIR: return UV_DIRENT_DIR;
+      case S_IFREG: return UV_DIRENT_FILE;
+#ifdef S_IFLNK
+      case S_IFLNK: return UV_DIRENT_LINK;
+#endif
+      default: return UV_DIRENT_UNKNOWN;
+    }
+  }
+
+  static std::string Join(const std::string& dir, const std::string& name) {
+#ifdef _WIN32
+    return dir + '\\' + name;
+#else
+    return dir + '/' + name;
+#endif
+  }
+
+  std::atomic<uint64_t> files_ { 0 };
+  std::atomic<uint64_t> directories_ { 0 };
+
+ private:
+  class Worker final : public ThreadPoolWork {
+   public:
+    Worker(Environment* env, TreeJob* job, Task* task)
+        : ThreadPoolWork(env, performance::NODE_THREADPOOL_WORK_TYPE_FS),
+          job_(job),
+          task_(task) {}
+
+    void DoThreadPoolWork() override {
+      if (!job_->failed())
+        job_->Process(task_);
+    }
+
+    void AfterThreadPoolWork(int status) override {
+      std::unique_ptr<Worker> self(this);
+      job_->WorkerDone(task_, status);
+    }
+
+   private:
+    TreeJob* const job_;
+    Task* const task_;
+  };
+
+  // Leaves one thread of the threadpool to other requests, so that e.g.
+  // dns.lookup() does not have to wait for a whole tree.
+  static int MaxWorkers() {
+    static const int max_workers = [] {
+      // The same as libuv's default and limit for UV_THREADPOOL_SIZE.
+      int size = 4;
+      char buf[32];
+      size_t buf_size = sizeof(buf);
+      if (uv_os_getenv("UV_THREADPOOL_SIZE", buf, &buf_size) == 0)
+        size = std::min(std::max(atoi(buf), 1), 1024);
+      return std::max(size - 1, 1);
+    }();
+    return max_workers;
+  }
+
+  // Hands the queued directories to new workers. Only called on the main
+  // thread.
+  void ScheduleWorkers() {
+    Mutex::ScopedLock lock(mutex_);
+    while (running_ < MaxWorkers() && !queue_.empty() && err_ == 0) {
+      Task* task = queue_.back();
+      queue_.pop_back();
+      running_++;
+      (new Worker(env_, this, task))->ScheduleWork();
+    }
+  }
+
+  void WorkerDone(Task* task, int status) {
+    running_--;
+    if (status == UV_ECANCELED)
+      SetError(UV_ECANCELED, "scandir", task->path);
+
+    if (!failed()) {
+      ScheduleWorkers();
+      if (!on_progress_.IsEmpty() && env_->can_call_into_js()) {
+        Isolate* isolate = env_->isolate();
+        HandleScope handle_scope(isolate);
+        Context::Scope context_scope(env_->context());
+        Local<Value> counts[] = {
+          Number::New(isolate, static_cast<double>(files_.load())),
+          Number::New(isolate, static_cast<double>(directories_.load()))
+        };
+        // An exception in the callback is reported like any other uncaught
+        // exception; it does not stop the job.
+        USE(req_wrap_->MakeCallback(on_progress_.Get(isolate),
+                                    arraysize(counts), counts));
+      }
+    }
+    if (running_ > 0) return;
+
+    std::unique_ptr<TreeJob> self(this);
+    std::unique_ptr<FSReqBase> req_wrap(req_wrap_);
+    Isolate* isolate = env_->isolate();
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env_->context());
+    if (err_ != 0) {
+      req_wrap->Reject(UVException(
+          isolate, err_, syscall_, nullptr, error_path_.c_str(),
+          error_dest_.empty() ? nullptr : error_dest_.c_str()));
+      return;
+    }
+    Local<Value> counts[] = {
+      Number::New(isolate, static_cast<double>(files_.load())),
+      Number::New(isolate, static_cast<double>(directories_.load()))
+    };
+    req_wrap->Resolve(Array::New(isolate, counts, arraysize(counts)));
+  }
+
+  Environment* const env_;
+  FSReqBase* const req_wrap_;
+  v8::Global<Function> on_progress_;
+
+  Mutex mutex_;
+  std::vector<Task*> queue_;
+  std::vector<std::unique_ptr<Task>> tasks_;
+  // The number of workers that have been scheduled and have not finished.
+  // Only accessed on the main thread.
+  int running_ = 0;
+  std::atomic<bool> failed_ { false };
+
+  int err_ = 0;
+  const char* syscall_ = nullptr;
+  std::string error_path_;
+  std::string error_dest_;
+};
+
+// Removes a directory tree like rimraf does. Files are unlinked while their
+// directory is read, and a directory is removed once all of its
+// subdirectories have been, by whichever worker removed the last one.
+class RmTreeJob final : public TreeJob {
+ public:
+  RmTreeJob(Environment* env, FSReqBase* req_wrap)
+      : TreeJob(env, req_wrap) {}
+
+ private:
+  void Process(Task* task) override {
+    if (task->is_root) {
+      // Symbolic links are removed rather than followed, and rmdir() with
+      // `recursive` removes files, too.
+      int type = LStatType(task->path);
+      if (type == UV_ENOENT) return;
+      if (type < 0) return SetError(type, "lstat", task->path);
+      if (type != UV_DIRENT_DIR) {
+        if (Unlink(task->path))
+          files_++;
+        return;
+      }
+    }
+
+    std::vector<std::pair<std::string, int>> entries;
+    int err = ScanDir(task->path, &entries);
+    if (err < 0) {
+      if (err != UV_ENOENT)
+        return SetError(err, "scandir", task->path);
+      return Done(task);
+    }
+
+    for (auto& entry : entries) {
+      if (failed()) return;
+      std::string path = Join(task->path, entry.first);
+      int type = entry.second;
+      if (type == UV_DIRENT_UNKNOWN) {
+        type = LStatType(path);
+        if (type == UV_ENOENT) continue;
+        if (type < 0) return SetError(type, "lstat", path);
+      }
+      if (type == UV_DIRENT_DIR) {
+        task->pending++;
+        Push(std::move(path), std::string(), task);
+      } else if (Unlink(path)) {
+        files_++;
+      } else {
+        return;
+      }
+    }
+    Done(task);
+  }
+
+  // Returns false if an error has been recorded.
+  bool Unlink(const std::string& path) {
+    uv_fs_t req;
+    int err = uv_fs_unlink(nullptr, &req, path.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err < 0 && err != UV_ENOENT) {
+      SetError(err, "unlink", path);
+      return false;
+    }
+    return true;
+  }
+
+  // Removes the directories whose subdirectories are all gone.
+  void Done(Task* task) {
+    while (task != nullptr && --task->pending == 0) {
+      uv_fs_t req;
+      int err = uv_fs_rmdir(nullptr, &req, task->path.c_str(), nullptr);
+      uv_fs_req_cleanup(&req);
+      if (err < 0 && err != UV_ENOENT)
+        return SetError(err, "rmdir", task->path);
+      if (err == 0)
+        directories_++;
+      task = task->parent;
+    }
+  }
+};
+
+// Copies a directory tree. Directories are created before they are queued,
+// files are copied with uv_fs_copyfile(), which clones or uses
+// copy_file_range() where the platform supports it, and symbolic links are
+// recreated rather than followed. A directory is created writable by its
+// owner, so that read-only directories can be filled, and is given the mode
+// of its source once all of its subdirectories have been copied.
+class CopyTreeJob final : public TreeJob {
+ public:
+  CopyTreeJob(Environment* env, FSReqBase* req_wrap, int flags)
+      : TreeJob(env, req_wrap), flags_(flags) {}
+
+ private:
+  void Process(Task* task) override {
+    if (task->is_root) {
+      uv_stat_t stat;
+      int type = LStatType(task->path, &stat);
+      if (type < 0) return SetError(type, "lstat", task->path);
+      if (type != UV_DIRENT_DIR) {
+        CopyEntry(task->path, task->dest, type);
+        return;
+      }
+      if (!MakeDir(task->path, task->dest, &stat, &task->mode)) return;
+    }
+
+    std::vector<std::pair<std::string, int>> entries;
+    int err = ScanDir(task->path, &entries);
+    if (err < 0) return SetError(err, "scandir", task->path);
+
+    for (auto& entry : entries) {
+      if (failed()) return;
+      std::string src = Join(task->path, entry.first);
+      std::string dest = Join(task->dest, entry.first);
+      int type = entry.second;
+      uv_stat_t stat;
+      if (type == UV_DIRENT_UNKNOWN || type == UV_DIRENT_DIR) {
+        type = LStatType(src, &stat);
+        if (type < 0) return SetError(type, "lstat", src);
+      }
+      if (type == UV_DIRENT_DIR) {
+        int mode;
+        if (!MakeDir(src, dest, &stat, &mode)) return;
+        task->pending++;
+        Push(std::move(src), std::move(dest), task, mode);
+      } else if (!CopyEntry(src, dest, type)) {
+        return;
+      }
+    }
+    Done(task);
+  }
+
+  // Creates `dest` with the permissions of `src`, plus those that its owner
+  // needs to copy into it. `*mode` is set to the mode that Done() gives the
+  // directory, if that differs. Existing directories are merged into unless
+  // COPYFILE_EXCL is set, and keep their mode.
+  bool MakeDir(const std::string& src,
+               const std::string& dest,
+               const uv_stat_t* stat,
+               int* mode) {
+    const int src_mode = static_cast<int>(stat->st_mode & 07777);
+    *mode = -1;
+    uv_fs_t req;
+    int err = uv_fs_mkdir(nullptr, &req, dest.c_str(), src_mode | 0700,
+                          nullptr);
+    uv_fs_req_cleanup(&req);
+    if (err == 0 && (src_mode & 0700) != 0700) {
+      *mode = src_mode;
+    } else if (err == UV_EEXIST && !(flags_ & UV_FS_COPYFILE_EXCL) &&
+               LStatType(dest) == UV_DIRENT_DIR) {
+      err = 0;
+    }
+    if (err < 0) {
+      SetError(err, "mkdir", src, dest);
+      return false;
+    }
+    directories_++;
+    return true;
+  }
+
+  // Gives the directories whose subdirectories have all been copied the mode
+  // of their source.
+  void Done(Task* task) {
+    while (task != nullptr && --task->pending == 0) {
+      if (task->mode != -1) {
+        uv_fs_t req;
+        int err = uv_fs_chmod(nullptr, &req, task->dest.c_str(), task->mode,
+                              nullptr);
+        uv_fs_req_cleanup(&req);
+        if (err < 0)
+          return SetError(err, "chmod", task->dest);
+      }
+      task = task->parent;
+    }
+  }
+
+  // Returns false if an error has been recorded.
+  bool CopyEntry(const std::string& src, const std::string& dest, int type) {
+    uv_fs_t req;
+    int err;
+    const char* syscall;
+    if (type == UV_DIRENT_FILE) {
+      syscall = "copyfile";
+      err = uv_fs_copyfile(nullptr, &req, src.c_str(), dest.c_str(), flags_,
+                           nullptr);
+      uv_fs_req_cleanup(&req);
+    } else if (type == UV_DIRENT_LINK) {
+      syscall = "readlink";
+      err = uv_fs_readlink(nullptr, &req, src.c_str(), nullptr);
+      std::string target;
+      if (err == 0)
+        target = static_cast<const char*>(req.ptr);
+      uv_fs_req_cleanup(&req);
+      if (err == 0) {
+        syscall = "symlink";
+        err = uv_fs_symlink(nullptr, &req, target.c_str(), dest.c_str(), 0,
+                            nullptr);
+        uv_fs_req_cleanup(&req);
+        // Like copyfile, replace existing links unless COPYFILE_EXCL is set.
+        if (err == UV_EEXIST && !(flags_ & UV_FS_COPYFILE_EXCL) &&
+            LStatType(dest) == UV_DIRENT_LINK) {
+          err = uv_fs_unlink(nullptr, &req, dest.c_str(), nullptr);
+          uv_fs_req_cleanup(&req);
+          if (err == 0) {
+            err = uv_fs_symlink(nullptr, &req, target.c_str(), dest.c_str(),
+                                0, nullptr);
+            uv_fs_req_cleanup(&req);
+          }
+        }
+      }
+    } else {
+      // Sockets, FIFOs and devices cannot be copied.
+      syscall = "copyfile";
+      err = UV_ENOTSUP;
+    }
+    if (err < 0) {
+      SetError(err, syscall, src, dest);
+      return false;
+    }
+    files_++;
+    return true;
+  }
+
+  const int flags_;
+};
+
+/*
+ * rmTree(path, req)
+ *
+ * 0 path  string or Buffer, a directory or a file
+ * 1 req   FSReqCallback or kUsePromises
+ *
+ * Resolves with [files, directories], the number of entries that were
+ * removed. A path that does not exist is not an error.
+ */
+static void RmTree(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK_GE(args.Length(), 2);
+
+  BufferValue path(env->isolate(), args[0]);
+  CHECK_NOT_NULL(*path);
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[1]);
+  CHECK_NOT_NULL(req_wrap_async);
+  RmTreeJob* job = new RmTreeJob(env, req_wrap_async);
+  job->Start(std::string(*path, path.length()), std::string());
+  req_wrap_async->SetReturnValue(args);
+}
+
+/*
+ * copyTree(src, dest, flags, onProgress, req)
+ *
+ * 0 src         string or Buffer, a directory or a file
+ * 1 dest        string or Buffer
+ * 2 flags       int32. COPYFILE_* flags for the files
+ * 3 onProgress  a function that is called with (files, directories) each
+ *               time a directory has been copied, or undefined
+ * 4 req         FSReqCallback or kUsePromises
+ *
+ * Resolves with [files, directories], the number of entries that were
+ * copied.
+ */
+static void CopyTree(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK_GE(args.Length(), 5);
+
+  BufferValue src(env->isolate(), args[0]);
+  CHECK_NOT_NULL(*src);
+  BufferValue dest(env->isolate(), args[1]);
+  CHECK_NOT_NULL(*dest);
+  CHECK(args[2]->IsInt32());
+  const int flags = args[2].As<Int32>()->Value();
+
+  FSReqBase* req_wrap_async = GetReqWrap(env, args[4]);
+  CHECK_NOT_NULL(req_wrap_async);
+  CopyTreeJob* job = new CopyTreeJob(env, req_wrap_async, flags);
+  if (args[3]->IsFunction())
+    job->SetProgressCallback(args[3].As<Function>());
+  job->Start(std::string(*src, src.length()),
+             std::string(*dest, dest.length()));
+  req_wrap_async->SetReturnValue(args);
+}
+
 /* fs.chmod(path, mode);
  * Wrapper for chmod(1) / EIO_CHMOD
  */
@@ -2080,18 +3436,30 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "open", Open);
   env->SetMethod(target, "openFileHandle", OpenFileHandle);
   env->SetMethod(target, "read", Read);
+  env->SetMethod(target, "readFile", ReadFile);
   env->SetMethod(target, "fdatasync", Fdatasync);
   env->SetMethod(target, "fsync", Fsync);
   env->SetMethod(target, "rename", Rename);
   env->SetMethod(target, "ftruncate", FTruncate);
   env->SetMethod(target, "rmdir", RMDir);
+  env->SetMethod(target, "rmTree", RmTree);
   env->SetMethod(target, "mkdir", MKDir);
   env->SetMethod(target, "readdir", ReadDir);
   env->SetMethod(target, "internalModuleReadJSON", InternalModuleReadJSON);
   env->SetMethod(target, "internalModuleStat", InternalModuleStat);
+  env->SetMethod(target, "internalModuleFindFile", InternalModuleFindFile);
+  env->SetMethod(target,
+                 "internalModuleClearDirectoryCache",
+                 InternalModuleClearDirectoryCache);
+  env->SetMethod(target, "internalModuleBundleStat", InternalModuleBundleStat);
+  env->SetMethod(target, "internalModuleReadBundle", InternalModuleReadBundle);
+  env->SetMethod(target,
+                 "internalModuleReadBundleCodeCache",
+                 InternalModuleReadBundleCodeCache);
   env->SetMethod(target, "stat", Stat);
   env->SetMethod(target, "lstat", LStat);
   env->SetMethod(target, "fstat", FStat);
+  env->SetMethod(target, "statMany", StatMany);
   env->SetMethod(target, "link", Link);
   env->SetMethod(target, "symlink", Symlink);
   env->SetMethod(target, "readlink", ReadLink);
@@ -2099,8 +3467,10 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "writeBuffer", WriteBuffer);
   env->SetMethod(target, "writeBuffers", WriteBuffers);
   env->SetMethod(target, "writeString", WriteString);
+  env->SetMethod(target, "writeFile", WriteFile);
   env->SetMethod(target, "realpath", RealPath);
   env->SetMethod(target, "copyFile", CopyFile);
+  env->SetMethod(target, "copyTree", CopyTree);
 
   env->SetMethod(target, "chmod", Chmod);
   env->SetMethod(target, "fchmod", FChmod);
@@ -2131,7 +3501,7 @@ void Initialize(Local<Object> target,
               FIXED_ONE_BYTE_STRING(isolate, "bigintStatValues"),
               env->fs_stats_field_bigint_array()->GetJSArray()).Check();
 
-  StatWatcher::Initialize(env, target);
+  StatPoller::Initialize(env, target);
 
   // Create FunctionTemplate for FSReqCallback
   Local<FunctionTemplate> fst = env->NewFunctionTemplate(NewFSReqCallback);
@@ -113,6 +113,11 @@ class FSReqBase : public ReqWrap<uv_fs_t> {
 
   bool use_bigint() const { return use_bigint_; }
 
+  // Bookkeeping for the perf_hooks threadpool statistics, called when the
+  // request is dispatched and when its callback runs, respectively.
+  void MarkQueued();
+  void MarkFinished();
+
   static FSReqBase* from_req(uv_fs_t* req) {
     return static_cast<FSReqBase*>(ReqWrap::from_req(req));
   }
@@ -125,6 +130,8 @@ class FSReqBase : public ReqWrap<uv_fs_t> {
   bool has_data_ = false;
   const char* syscall_ = nullptr;
   bool use_bigint_ = false;
+  bool is_queued_ = false;
+  uint64_t queued_at_ = 0;
 
   // Typically, the content of buffer_ is something like a file name, so
   // something around 64 bytes should be enough.
@@ -463,6 +470,52 @@ class FSReqWrapSync {
   FSReqWrapSync& operator=(const FSReqWrapSync&) = delete;
 };
 
+// Opens, reads and closes a whole file with synchronous libuv calls, for use
+// from a ThreadPoolWork so that reading a file takes a single trip to the
+// threadpool. Regular files are read into a single allocation of the size that
+// fstat reports; for other files the allocation grows as needed.
+class FileContents {
+ public:
+  FileContents() = default;
+  ~FileContents() { free(data_); }
+
+  // Reads the file at `path`, opened with `flags`, or if `fd` is not
+  // negative, the file that is already open as `fd`, which is left open.
+  // Returns false if that fails; ToException() then describes the error.
+  bool Read(const std::string& path, uv_file fd, int flags);
+
+  // For the AfterThreadPoolWork() of a job that was cancelled.
+  void SetError(int err, const char* syscall);
+  // Creates the error to report to JS after Read() has failed. Like the
+  // separate requests of fs.readFile() did, it only includes the path if the
+  // file could not be opened.
+  v8::Local<v8::Value> ToException(v8::Isolate* isolate,
+                                   const std::string& path) const;
+
+  const char* data() const { return data_; }
+  size_t length() const { return length_; }
+  // Transfers ownership of the contents, which have been allocated with
+  // malloc(), to the caller.
+  char* Release();
+
+  FileContents(const FileContents&) = delete;
+  FileContents& operator=(const FileContents&) = delete;
+
+ private:
+  // For files of unknown size, e.g. pipes and character devices.
+  static constexpr size_t kUnknownSizeChunk = 64 * 1024;
+
+  bool ReadAll(uv_file fd);
+
+  char* data_ = nullptr;
+  size_t length_ = 0;
+  size_t capacity_ = 0;
+  uint64_t size_ = 0;
+  bool too_large_ = false;
+  int err_ = 0;
+  const char* syscall_ = nullptr;
+};
+
 // TODO(addaleax): Currently, callers check the return value and assume
 // that nullptr indicates a synchronous call, rather than a failure.
 // Failure conditions should be disambiguated and handled appropriately.
@@ -489,6 +542,7 @@ inline FSReqBase* AsyncDestCall(Environment* env, FSReqBase* req_wrap,
                                 Func fn, Args... fn_args) {
   CHECK_NOT_NULL(req_wrap);
   req_wrap->Init(syscall, dest, len, enc);
+  req_wrap->MarkQueued();
   int err = req_wrap->Dispatch(fn, fn_args..., after);
   if (err < 0) {
     uv_fs_t* uv_req = req_wrap->req();
@@ -28,6 +28,7 @@
 #include "node.h"
 #include "node_binding.h"
 #include "node_mutex.h"
+#include "node_perf_common.h"
 #include "tracing/trace_event.h"
 #include "util.h"
 #include "uv.h"
@@ -217,6 +218,7 @@ class InternalCallbackScope {
   Environment* env_;
   async_context async_context_;
   v8::Local<v8::Object> object_;
+  v8::Local<v8::Value> prev_async_context_;
   AsyncCallbackScope callback_scope_;
   bool failed_ = false;
   bool pushed_ids_ = false;
@@ -239,7 +241,9 @@ class DebugSealHandleScope {
 
 class ThreadPoolWork {
  public:
-  explicit inline ThreadPoolWork(Environment* env) : env_(env) {
+  inline ThreadPoolWork(Environment* env,
+                        performance::ThreadPoolWorkType type)
+      : env_(env), type_(type) {
     CHECK_NOT_NULL(env);
   }
   inline virtual ~ThreadPoolWork() = default;
@@ -252,6 +256,10 @@ class ThreadPoolWork {
 
  private:
   Environment* env_;
+  performance::ThreadPoolWorkType type_;
+  // Only set while perf_hooks threadpool histograms are enabled.
+  uint64_t queued_at_ = 0;
+  uint64_t started_at_ = 0;
   uv_work_t work_req_;
 };
 
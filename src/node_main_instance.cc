@@ -1,8 +1,14 @@
 #include "node_main_instance.h"
+#include "env-inl.h"
+#include "node_external_reference.h"
 #include "node_internals.h"
 #include "node_options-inl.h"
 #include "node_v8_platform-inl.h"
+#include "node_version.h"
 #include "util-inl.h"
+
+#include <cstring>
+#include <fstream>
 #if defined(LEAK_SANITIZER)
 #include <sanitizer/lsan_interface.h>
 #endif
@@ -16,6 +22,11 @@ using v8::Local;
 using v8::Locker;
 using v8::SealHandleScope;
 
+std::unique_ptr<ExternalReferenceRegistry> NodeMainInstance::registry_ =
+    nullptr;
+const std::vector<intptr_t>* NodeMainInstance::external_references_ =
+    nullptr;
+
 NodeMainInstance::NodeMainInstance(Isolate* isolate,
                                    uv_loop_t* event_loop,
                                    MultiIsolatePlatform* platform,
@@ -49,14 +60,16 @@ NodeMainInstance::NodeMainInstance(
     MultiIsolatePlatform* platform,
     const std::vector<std::string>& args,
     const std::vector<std::string>& exec_args,
-    const std::vector<size_t>* per_isolate_data_indexes)
+    const std::vector<size_t>* per_isolate_data_indexes,
+    const EnvSerializeInfo* env_info)
     : args_(args),
       exec_args_(exec_args),
       array_buffer_allocator_(ArrayBufferAllocator::Create()),
       isolate_(nullptr),
       platform_(platform),
       isolate_data_(nullptr),
-      owns_isolate_(true) {
+      owns_isolate_(true),
+      env_info_(env_info) {
   params->array_buffer_allocator = array_buffer_allocator_.get();
   isolate_ = Isolate::Allocate();
   CHECK_NOT_NULL(isolate_);
@@ -69,6 +82,7 @@ NodeMainInstance::NodeMainInstance(
   deserialize_mode_ = per_isolate_data_indexes != nullptr;
   // If the indexes are not nullptr, we are not deserializing
   CHECK_IMPLIES(deserialize_mode_, params->external_references != nullptr);
+  CHECK_IMPLIES(deserialize_mode_, env_info_ != nullptr);
   isolate_data_.reset(new IsolateData(isolate_,
                                       event_loop,
                                       platform,
@@ -164,6 +178,219 @@ int NodeMainInstance::Run() {
   return exit_code;
 }
 
+const std::vector<intptr_t>& NodeMainInstance::CollectExternalReferences() {
+  // The table can only be finalized once, later calls return the same table.
+  if (!external_references_) {
+    registry_.reset(new ExternalReferenceRegistry());
+    external_references_ = &registry_->external_references();
+  }
+  return *external_references_;
+}
+
+// The layout of a snapshot blob file is:
+//
+//   "NODESNAP"
+//   uint32_t version_length, char version[version_length]
+//   uint64_t checksum, see SnapshotBlobChecksum()
+//   uint32_t index_count, uint64_t isolate_data_indexes[index_count]
+//   the EnvSerializeInfo, see WriteEnvSerializeInfo()
+//   uint32_t blob_size, char blob[blob_size]
+//
+// The integers are stored in native byte order.
+static const char kSnapshotBlobMagic[] = "NODESNAP";
+
+static std::string SnapshotBlobVersion() {
+  return std::string(NODE_VERSION) + "/" + v8::V8::GetVersion();
+}
+
+// Identifies the build that a blob can be loaded by. The snapshot refers to
+// the external references by their position in the table, so a blob that was
+// written by a build with a different table cannot be deserialized. The
+// offsets of the references from a function in the same binary do not change
+// between runs, unlike their addresses.
+static uint64_t SnapshotBlobChecksum() {
+  const std::vector<intptr_t>& references =
+      NodeMainInstance::CollectExternalReferences();
+  const intptr_t base = reinterpret_cast<intptr_t>(&SnapshotBlobVersion);
+  // 64-bit FNV-1a.
+  uint64_t hash = 0xcbf29ce484222325;
+  auto mix = [&](uint64_t value) {
+    for (size_t i = 0; i < sizeof(value); i++) {
+      hash ^= (value >> (i * 8)) & 0xff;
+      hash *= 0x100000001b3;
+    }
+  };
+  mix(references.size());
+  for (intptr_t reference : references) {
+    // The table ends with a nullptr.
+    if (reference != 0)
+      mix(static_cast<uint64_t>(reference - base));
+  }
+  return hash;
+}
+
+template <typename T>
+static void AppendValue(std::string* out, T value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool ReadValue(std::ifstream* in, T* value) {
+  return static_cast<bool>(
+      in->read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+static void AppendString(std::string* out, const std::string& value) {
+  AppendValue<uint32_t>(out, value.size());
+  *out += value;
+}
+
+static bool ReadString(std::ifstream* in, std::string* value) {
+  uint32_t length;
+  if (!ReadValue(in, &length)) return false;
+  value->resize(length);
+  return length == 0 || static_cast<bool>(in->read(&(*value)[0], length));
+}
+
+static void AppendIndex(std::string* out, AliasedBufferIndex index) {
+  AppendValue<uint64_t>(out, index);
+}
+
+static bool ReadIndex(std::ifstream* in, AliasedBufferIndex* index) {
+  uint64_t value;
+  if (!ReadValue(in, &value)) return false;
+  *index = value;
+  return true;
+}
+
+static void AppendProps(std::string* out, const std::vector<PropInfo>& props) {
+  AppendValue<uint32_t>(out, props.size());
+  for (const PropInfo& prop : props) {
+    AppendString(out, prop.name);
+    AppendValue<uint64_t>(out, prop.id);
+    AppendValue<uint64_t>(out, prop.index);
+  }
+}
+
+static bool ReadProps(std::ifstream* in, std::vector<PropInfo>* props) {
+  uint32_t count;
+  if (!ReadValue(in, &count)) return false;
+  props->resize(count);
+  for (PropInfo& prop : *props) {
+    uint64_t id, index;
+    if (!ReadString(in, &prop.name) || !ReadValue(in, &id) ||
+        !ReadValue(in, &index)) {
+      return false;
+    }
+    prop.id = id;
+    prop.index = index;
+  }
+  return true;
+}
+
+static void WriteEnvSerializeInfo(std::string* out,
+                                  const EnvSerializeInfo& info) {
+  AppendValue<uint32_t>(out, info.native_modules.size());
+  for (const std::string& id : info.native_modules)
+    AppendString(out, id);
+  AppendIndex(out, info.async_hooks.async_ids_stack);
+  AppendIndex(out, info.async_hooks.fields);
+  AppendIndex(out, info.async_hooks.async_id_fields);
+  AppendIndex(out, info.tick_info.fields);
+  AppendIndex(out, info.immediate_info.fields);
+  AppendIndex(out, info.performance_state.root);
+  AppendIndex(out, info.performance_state.milestones);
+  AppendIndex(out, info.performance_state.loop_phases);
+  AppendIndex(out, info.performance_state.observers);
+  AppendIndex(out, info.performance_state.threadpool_pending);
+  AppendIndex(out, info.stream_base_state);
+  AppendIndex(out, info.should_abort_on_uncaught_toggle);
+  AppendIndex(out, info.fs_stats_field_array);
+  AppendIndex(out, info.fs_stats_field_bigint_array);
+  AppendProps(out, info.persistent_templates);
+  AppendProps(out, info.persistent_values);
+}
+
+static bool ReadEnvSerializeInfo(std::ifstream* in, EnvSerializeInfo* info) {
+  uint32_t count;
+  if (!ReadValue(in, &count)) return false;
+  info->native_modules.resize(count);
+  for (std::string& id : info->native_modules) {
+    if (!ReadString(in, &id)) return false;
+  }
+  return ReadIndex(in, &info->async_hooks.async_ids_stack) &&
+         ReadIndex(in, &info->async_hooks.fields) &&
+         ReadIndex(in, &info->async_hooks.async_id_fields) &&
+         ReadIndex(in, &info->tick_info.fields) &&
+         ReadIndex(in, &info->immediate_info.fields) &&
+         ReadIndex(in, &info->performance_state.root) &&
+         ReadIndex(in, &info->performance_state.milestones) &&
+         ReadIndex(in, &info->performance_state.loop_phases) &&
+         ReadIndex(in, &info->performance_state.observers) &&
+         ReadIndex(in, &info->performance_state.threadpool_pending) &&
+         ReadIndex(in, &info->stream_base_state) &&
+         ReadIndex(in, &info->should_abort_on_uncaught_toggle) &&
+         ReadIndex(in, &info->fs_stats_field_array) &&
+         ReadIndex(in, &info->fs_stats_field_bigint_array) &&
+         ReadProps(in, &info->persistent_templates) &&
+         ReadProps(in, &info->persistent_values);
+}
+
+std::string NodeMainInstance::SerializeSnapshotBlob(
+    const v8::StartupData& blob,
+    const std::vector<size_t>& isolate_data_indexes,
+    const EnvSerializeInfo& env_info) {
+  std::string out(kSnapshotBlobMagic, sizeof(kSnapshotBlobMagic) - 1);
+  AppendString(&out, SnapshotBlobVersion());
+  AppendValue<uint64_t>(&out, SnapshotBlobChecksum());
+  AppendValue<uint32_t>(&out, isolate_data_indexes.size());
+  for (size_t index : isolate_data_indexes)
+    AppendValue<uint64_t>(&out, index);
+  WriteEnvSerializeInfo(&out, env_info);
+  AppendValue<uint32_t>(&out, blob.raw_size);
+  out.append(blob.data, blob.raw_size);
+  return out;
+}
+
+bool NodeMainInstance::ReadSnapshotBlob(
+    const std::string& path,
+    std::vector<char>* blob_data,
+    std::vector<size_t>* isolate_data_indexes,
+    EnvSerializeInfo* env_info) {
+  std::ifstream in(path, std::ios::in | std::ios::binary);
+  if (!in.is_open()) return false;
+
+  char magic[sizeof(kSnapshotBlobMagic) - 1];
+  if (!in.read(magic, sizeof(magic)) ||
+      memcmp(magic, kSnapshotBlobMagic, sizeof(magic)) != 0) {
+    return false;
+  }
+
+  std::string version;
+  if (!ReadString(&in, &version) || version != SnapshotBlobVersion())
+    return false;
+
+  uint64_t checksum;
+  if (!ReadValue(&in, &checksum) || checksum != SnapshotBlobChecksum())
+    return false;
+
+  uint32_t count;
+  if (!ReadValue(&in, &count)) return false;
+  isolate_data_indexes->resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    uint64_t index;
+    if (!ReadValue(&in, &index)) return false;
+    (*isolate_data_indexes)[i] = index;
+  }
+
+  if (!ReadEnvSerializeInfo(&in, env_info)) return false;
+
+  uint32_t size;
+  if (!ReadValue(&in, &size) || size == 0) return false;
+  blob_data->resize(size);
+  return static_cast<bool>(in.read(blob_data->data(), size));
+}
+
 // TODO(joyeecheung): align this with the CreateEnvironment exposed in node.h
 // and the environment creation routine in workers somehow.
 std::unique_ptr<Environment> NodeMainInstance::CreateMainEnvironment(
@@ -198,12 +425,12 @@ std::unique_ptr<Environment> NodeMainInstance::CreateMainEnvironment(
       exec_args_,
       static_cast<Environment::Flags>(Environment::kIsMainThread |
                                       Environment::kOwnsProcessState |
-                                      Environment::kOwnsInspector));
+                                      Environment::kOwnsInspector),
+      Environment::kNoThreadId,
+      deserialize_mode_ ? env_info_ : nullptr);
   env->InitializeLibuv(per_process::v8_is_profiling);
   env->InitializeDiagnostics();
 
-  // TODO(joyeecheung): when we snapshot the bootstrapped context,
-  // the inspector and diagnostics setup should after after deserialization.
 #if HAVE_INSPECTOR && NODE_USE_V8_PLATFORM
   *exit_code = env->InitializeInspector(nullptr);
 #endif
@@ -211,7 +438,9 @@ std::unique_ptr<Environment> NodeMainInstance::CreateMainEnvironment(
     return env;
   }
 
-  if (env->RunBootstrapping().IsEmpty()) {
+  // An Environment that is deserialized from the snapshot has already been
+  // bootstrapped.
+  if (!deserialize_mode_ && env->RunBootstrapping().IsEmpty()) {
     *exit_code = 1;
   }
 
@@ -5,6 +5,8 @@
 
 #include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "node.h"
 #include "util.h"
@@ -13,6 +15,9 @@
 
 namespace node {
 
+class ExternalReferenceRegistry;
+struct EnvSerializeInfo;
+
 // TODO(joyeecheung): align this with the Worker/WorkerThreadData class.
 // We may be able to create an abstract class to reuse some of the routines.
 class NodeMainInstance {
@@ -51,7 +56,8 @@ class NodeMainInstance {
       MultiIsolatePlatform* platform,
       const std::vector<std::string>& args,
       const std::vector<std::string>& exec_args,
-      const std::vector<size_t>* per_isolate_data_indexes = nullptr);
+      const std::vector<size_t>* per_isolate_data_indexes = nullptr,
+      const EnvSerializeInfo* env_info = nullptr);
   ~NodeMainInstance();
 
   // Start running the Node.js instances, return the exit code when finished.
@@ -66,7 +72,28 @@ class NodeMainInstance {
   // If nullptr is returned, the binary is not built with embedded
   // snapshot.
   static const std::vector<size_t>* GetIsolateDataIndexes();
+  static const EnvSerializeInfo* GetEnvSerializeInfo();
   static v8::StartupData* GetEmbeddedSnapshotBlob();
+  // The external references of the bindings that are set up during
+  // bootstrap. This must be passed to the SnapshotCreator when building the
+  // snapshot and to the Isolate::CreateParams when using it.
+  static const std::vector<intptr_t>& CollectExternalReferences();
+
+  // Snapshot blobs written by `node_mksnapshot --blob` and loaded through
+  // --snapshot-blob. A blob can only be loaded by the node binary that was
+  // built together with the node_mksnapshot that wrote it, since the external
+  // references are not portable across builds. The blob carries a checksum
+  // of the external reference table to enforce this.
+  static std::string SerializeSnapshotBlob(
+      const v8::StartupData& blob,
+      const std::vector<size_t>& isolate_data_indexes,
+      const EnvSerializeInfo& env_info);
+  // Returns false if the file cannot be read or was created by a different
+  // version or build of Node.js.
+  static bool ReadSnapshotBlob(const std::string& path,
+                               std::vector<char>* blob_data,
+                               std::vector<size_t>* isolate_data_indexes,
+                               EnvSerializeInfo* env_info);
 
   static const size_t kNodeContextIndex = 0;
   NodeMainInstance(const NodeMainInstance&) = delete;
@@ -89,6 +116,10 @@ class NodeMainInstance {
   std::unique_ptr<IsolateData> isolate_data_;
   bool owns_isolate_ = false;
   bool deserialize_mode_ = false;
+  const EnvSerializeInfo* env_info_ = nullptr;
+
+  static std::unique_ptr<ExternalReferenceRegistry> registry_;
+  static const std::vector<intptr_t>* external_references_;
 };
 
 }  // namespace node
@@ -173,6 +173,12 @@ MaybeLocal<Function> NativeModuleLoader::CompileAsModule(
   return LookupAndCompile(context, id, &parameters, result);
 }
 
+void NativeModuleLoader::SetEagerCompileIds(std::set<std::string>&& ids) {
+  Mutex::ScopedLock lock(code_cache_mutex_);
+  eager_compile_all_ = false;
+  eager_compile_ids_ = std::move(ids);
+}
+
 // Returns Local<Function> of the compiled module if return_code_cache
 // is false (we are only compiling the function).
 // Otherwise return a Local<Object> containing the cache.
@@ -208,9 +214,12 @@ MaybeLocal<Function> NativeModuleLoader::LookupAndCompile(
   }
 
   const bool has_cache = cached_data != nullptr;
-  ScriptCompiler::CompileOptions options =
-      has_cache ? ScriptCompiler::kConsumeCodeCache
-                : ScriptCompiler::kEagerCompile;
+  ScriptCompiler::CompileOptions options = ScriptCompiler::kConsumeCodeCache;
+  if (!has_cache) {
+    options = eager_compile_all_ || eager_compile_ids_.count(id) != 0
+                  ? ScriptCompiler::kEagerCompile
+                  : ScriptCompiler::kNoCompileOptions;
+  }
   ScriptCompiler::Source script_source(source, origin, cached_data);
 
   MaybeLocal<Function> maybe_fun =
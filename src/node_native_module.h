@@ -77,11 +77,20 @@ class NativeModuleLoader {
                                                const char* id,
                                                Result* result);
 
+  // Sets the modules that are compiled eagerly when there is no code cache
+  // for them, e.g. the ones that are used during startup. Only the top-level
+  // code of the other modules is compiled, their inner functions are compiled
+  // when they are first called. If this is never called, all modules are
+  // compiled eagerly.
+  void SetEagerCompileIds(std::set<std::string>&& ids);
+
   static NativeModuleLoader instance_;
   ModuleCategories module_categories_;
   NativeModuleRecordMap source_;
   NativeModuleCacheMap code_cache_;
   UnionBytes config_;
+  bool eager_compile_all_ = true;
+  std::set<std::string> eager_compile_ids_;
 
   // Used to synchronize access to the code cache map
   Mutex code_cache_mutex_;
@@ -7,6 +7,7 @@
 
 namespace node {
 class Environment;
+class ExternalReferenceRegistry;
 
 namespace native_module {
 
@@ -35,6 +36,7 @@ class NativeModuleEnv {
   // the build is configured with --code-cache-path=.... They are noops
   // in node_code_cache_stub.cc
   static void InitializeCodeCache();
+  static void RegisterExternalReferences(ExternalReferenceRegistry* registry);
 
  private:
   static void RecordResult(const char* id,
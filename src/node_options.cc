@@ -317,6 +317,16 @@ EnvironmentOptionsParser::EnvironmentOptionsParser() {
             "experimental Source Map V3 support",
             &EnvironmentOptions::enable_source_maps,
             kAllowedInEnvironment);
+  AddOption("--experimental-code-cache-dir",
+            "experimental persistent V8 code cache for user modules, "
+            "stored in the specified directory",
+            &EnvironmentOptions::experimental_code_cache_dir,
+            kAllowedInEnvironment);
+  AddOption("--experimental-resolution-cache",
+            "experimental cache for CommonJS module resolution, persisted "
+            "in the specified file",
+            &EnvironmentOptions::experimental_resolution_cache,
+            kAllowedInEnvironment);
   AddOption("--experimental-json-modules",
             "experimental JSON interop support for the ES Module loader",
             &EnvironmentOptions::experimental_json_modules,
@@ -559,6 +569,9 @@ PerIsolateOptionsParser::PerIsolateOptionsParser(
             "",  // It's a debug-only option.
             &PerIsolateOptions::no_node_snapshot,
             kAllowedInEnvironment);
+  AddOption("--snapshot-blob",
+            "start from a snapshot blob created by node_mksnapshot --blob",
+            &PerIsolateOptions::snapshot_blob);
 
   // Explicitly add some V8 flags to mark them as allowed in NODE_OPTIONS.
   AddOption("--abort-on-uncaught-exception",
@@ -618,6 +631,10 @@ PerIsolateOptionsParser::PerIsolateOptionsParser(
 
 PerProcessOptionsParser::PerProcessOptionsParser(
   const PerIsolateOptionsParser& iop) {
+  AddOption("--experimental-bundle",
+            "look up module files in the given bundle before the file system",
+            &PerProcessOptions::module_bundle,
+            kAllowedInEnvironment);
   AddOption("--title",
             "the process title to use on startup",
             &PerProcessOptions::title,
@@ -101,6 +101,8 @@ class EnvironmentOptions : public Options {
  public:
   bool abort_on_uncaught_exception = false;
   bool enable_source_maps = false;
+  std::string experimental_code_cache_dir;
+  std::string experimental_resolution_cache;
   bool experimental_json_modules = false;
   bool experimental_modules = false;
   std::string es_module_specifier_resolution;
@@ -177,6 +179,7 @@ class PerIsolateOptions : public Options {
   std::shared_ptr<EnvironmentOptions> per_env { new EnvironmentOptions() };
   bool track_heap_objects = false;
   bool no_node_snapshot = false;
+  std::string snapshot_blob;
 
 #ifdef NODE_REPORT
   bool report_uncaught_exception = false;
@@ -195,6 +198,7 @@ class PerProcessOptions : public Options {
   std::shared_ptr<PerIsolateOptions> per_isolate { new PerIsolateOptions() };
 
   std::string title;
+  std::string module_bundle;
   std::string trace_event_categories;
   std::string trace_event_file_pattern = "node_trace.${rotation}.log";
   uint64_t max_http_header_size = 8 * 1024;
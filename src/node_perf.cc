@@ -31,7 +31,9 @@ using v8::Number;
 using v8::Object;
 using v8::PropertyAttribute;
 using v8::ReadOnly;
+using v8::SnapshotCreator;
 using v8::String;
+using v8::Uint32;
 using v8::Uint32Array;
 using v8::Value;
 
@@ -53,6 +55,72 @@ void performance_state::Mark(enum PerformanceMilestone milestone,
       TRACE_EVENT_SCOPE_THREAD, ts / 1000);
 }
 
+performance_state::SerializeInfo performance_state::Serialize(
+    Local<Context> context, SnapshotCreator* creator) {
+  SerializeInfo info{root.Serialize(context, creator),
+                     milestones.Serialize(context, creator),
+                     loop_phases.Serialize(context, creator),
+                     observers.Serialize(context, creator),
+                     threadpool_pending.Serialize(context, creator)};
+  return info;
+}
+
+void performance_state::Deserialize(Local<Context> context) {
+  root.Deserialize(context);
+  milestones.Deserialize(context);
+  loop_phases.Deserialize(context);
+  observers.Deserialize(context);
+  threadpool_pending.Deserialize(context);
+
+  // The timings are those of the process that built the snapshot, only the
+  // observer counts of the JS land are kept.
+  for (size_t i = 0; i < milestones.Length(); i++)
+    milestones[i] = -1.;
+  for (size_t i = 0; i < loop_phases.Length(); i++)
+    loop_phases[i] = 0;
+  for (size_t i = 0; i < threadpool_pending.Length(); i++)
+    threadpool_pending[i] = 0;
+}
+
+void performance_state::MarkLoopPrepare(uint64_t now) {
+  // Everything between the end of the previous check phase and now that was
+  // not spent running timers is attributed to the close phase.
+  if (check_end_ != 0) {
+    uint64_t elapsed = now - check_end_;
+    if (elapsed > timers_since_check_)
+      loop_phases[NODE_PERFORMANCE_LOOP_PHASE_CLOSE] +=
+          elapsed - timers_since_check_;
+  }
+  timers_since_check_ = 0;
+  in_poll_phase_ = true;
+  poll_start_ = now;
+  poll_callback_time_ = 0;
+}
+
+void performance_state::MarkLoopCheck(uint64_t now) {
+  if (!in_poll_phase_) return;
+  in_poll_phase_ = false;
+  uint64_t poll_time = now - poll_start_;
+  loop_phases[NODE_PERFORMANCE_LOOP_PHASE_POLL] += poll_time;
+  if (poll_time > poll_callback_time_) {
+    loop_phases[NODE_PERFORMANCE_LOOP_PHASE_IDLE] +=
+        poll_time - poll_callback_time_;
+  }
+  check_start_ = now;
+}
+
+void performance_state::MarkTimersDone(uint64_t start, uint64_t now) {
+  loop_phases[NODE_PERFORMANCE_LOOP_PHASE_TIMERS] += now - start;
+  timers_since_check_ += now - start;
+}
+
+void performance_state::MarkImmediatesDone(uint64_t now) {
+  if (check_start_ == 0) return;
+  loop_phases[NODE_PERFORMANCE_LOOP_PHASE_CHECK] += now - check_start_;
+  check_start_ = 0;
+  check_end_ = now;
+}
+
 // Initialize the performance entry object properties
 inline void InitObject(const PerformanceEntry& entry, Local<Object> obj) {
   Environment* env = entry.env();
@@ -391,52 +459,59 @@ void Notify(const FunctionCallbackInfo<Value>& args) {
 }
 
 
-// Event Loop Timing Histogram
+// Histogram accessors shared by ELDHistogram and ThreadPoolHistogram
 namespace {
-static void ELDHistogramMin(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramMin(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Min());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramMax(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramMax(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Max());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramMean(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramMean(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Mean());
 }
 
-static void ELDHistogramExceeds(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramExceeds(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   double value = static_cast<double>(histogram->Exceeds());
   args.GetReturnValue().Set(value);
 }
 
-static void ELDHistogramStddev(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramStddev(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Stddev());
 }
 
-static void ELDHistogramPercentile(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramPercentile(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   CHECK(args[0]->IsNumber());
   double percentile = args[0].As<Number>()->Value();
   args.GetReturnValue().Set(histogram->Percentile(percentile));
 }
 
-static void ELDHistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
+template <typename T>
+void HistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
-  ELDHistogram* histogram;
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   CHECK(args[0]->IsMap());
   Local<Map> map = args[0].As<Map>();
@@ -447,24 +522,42 @@ static void ELDHistogramPercentiles(const FunctionCallbackInfo<Value>& args) {
   });
 }
 
-static void ELDHistogramEnable(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramEnable(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Enable());
 }
 
-static void ELDHistogramDisable(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramDisable(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   args.GetReturnValue().Set(histogram->Disable());
 }
 
-static void ELDHistogramReset(const FunctionCallbackInfo<Value>& args) {
-  ELDHistogram* histogram;
+template <typename T>
+void HistogramReset(const FunctionCallbackInfo<Value>& args) {
+  T* histogram;
   ASSIGN_OR_RETURN_UNWRAP(&histogram, args.Holder());
   histogram->ResetState();
 }
 
+template <typename T>
+void SetHistogramMethods(Environment* env, Local<FunctionTemplate> tmpl) {
+  env->SetProtoMethod(tmpl, "exceeds", HistogramExceeds<T>);
+  env->SetProtoMethod(tmpl, "min", HistogramMin<T>);
+  env->SetProtoMethod(tmpl, "max", HistogramMax<T>);
+  env->SetProtoMethod(tmpl, "mean", HistogramMean<T>);
+  env->SetProtoMethod(tmpl, "stddev", HistogramStddev<T>);
+  env->SetProtoMethod(tmpl, "percentile", HistogramPercentile<T>);
+  env->SetProtoMethod(tmpl, "percentiles", HistogramPercentiles<T>);
+  env->SetProtoMethod(tmpl, "enable", HistogramEnable<T>);
+  env->SetProtoMethod(tmpl, "disable", HistogramDisable<T>);
+  env->SetProtoMethod(tmpl, "reset", HistogramReset<T>);
+}
+
+// Event Loop Timing Histogram
 static void ELDHistogramNew(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK(args.IsConstructCall());
@@ -472,6 +565,22 @@ static void ELDHistogramNew(const FunctionCallbackInfo<Value>& args) {
   CHECK_GT(resolution, 0);
   new ELDHistogram(env, args.This(), resolution);
 }
+
+// Threadpool Timing Histogram
+static void ThreadPoolHistogramNew(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args.IsConstructCall());
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  uint32_t type = args[0].As<Uint32>()->Value();
+  uint32_t metric = args[1].As<Uint32>()->Value();
+  CHECK_LT(type, NODE_THREADPOOL_WORK_TYPE_INVALID);
+  CHECK_LT(metric, NODE_THREADPOOL_WORK_METRIC_INVALID);
+  new ThreadPoolHistogram(env,
+                          args.This(),
+                          static_cast<ThreadPoolWorkType>(type),
+                          static_cast<ThreadPoolWorkMetric>(metric));
+}
 }  // namespace
 
 ELDHistogram::ELDHistogram(
@@ -542,6 +651,74 @@ bool ELDHistogram::Disable() {
   return true;
 }
 
+ThreadPoolHistogram::ThreadPoolHistogram(
+    Environment* env,
+    Local<Object> wrap,
+    ThreadPoolWorkType type,
+    ThreadPoolWorkMetric metric) : BaseObject(env, wrap),
+                                   Histogram(1, 3.6e12),
+                                   type_(type),
+                                   metric_(metric) {
+  MakeWeak();
+}
+
+ThreadPoolHistogram::~ThreadPoolHistogram() {
+  Disable();
+}
+
+void ThreadPoolHistogram::RecordWork(uint64_t queued,
+                                     uint64_t started,
+                                     uint64_t finished) {
+  int64_t value;
+  switch (metric_) {
+    case NODE_THREADPOOL_WORK_METRIC_WAIT:
+      if (started == 0) return;
+      value = started - queued;
+      break;
+    case NODE_THREADPOOL_WORK_METRIC_RUN:
+      if (started == 0) return;
+      value = finished - started;
+      break;
+    case NODE_THREADPOOL_WORK_METRIC_TOTAL:
+      value = finished - queued;
+      break;
+    default:
+      UNREACHABLE();
+  }
+  // Values are clamped to 1ns since the histogram's lowest trackable
+  // value is 1.
+  if (!Record(std::max<int64_t>(value, 1)) && exceeds_ < 0xFFFFFFFF)
+    exceeds_++;
+}
+
+bool ThreadPoolHistogram::Enable() {
+  if (enabled_) return false;
+  enabled_ = true;
+  env()->performance_state()->threadpool_histograms.push_back(this);
+  return true;
+}
+
+bool ThreadPoolHistogram::Disable() {
+  if (!enabled_) return false;
+  enabled_ = false;
+  std::vector<ThreadPoolHistogram*>* histograms =
+      &env()->performance_state()->threadpool_histograms;
+  histograms->erase(
+      std::remove(histograms->begin(), histograms->end(), this),
+      histograms->end());
+  return true;
+}
+
+void performance_state::RecordThreadPoolWork(enum ThreadPoolWorkType type,
+                                             uint64_t queued,
+                                             uint64_t started,
+                                             uint64_t finished) {
+  for (ThreadPoolHistogram* histogram : threadpool_histograms) {
+    if (histogram->type() == type)
+      histogram->RecordWork(queued, started, finished);
+  }
+}
+
 void Initialize(Local<Object> target,
                 Local<Value> unused,
                 Local<Context> context,
@@ -556,6 +733,12 @@ void Initialize(Local<Object> target,
   target->Set(context,
               FIXED_ONE_BYTE_STRING(isolate, "milestones"),
               state->milestones.GetJSArray()).Check();
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "loopPhases"),
+              state->loop_phases.GetJSArray()).Check();
+  target->Set(context,
+              FIXED_ONE_BYTE_STRING(isolate, "threadpoolPending"),
+              state->threadpool_pending.GetJSArray()).Check();
 
   Local<String> performanceEntryString =
       FIXED_ONE_BYTE_STRING(isolate, "PerformanceEntry");
@@ -597,6 +780,21 @@ void Initialize(Local<Object> target,
   NODE_PERFORMANCE_MILESTONES(V)
 #undef V
 
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_PERFORMANCE_LOOP_PHASE_##name);
+  NODE_PERFORMANCE_LOOP_PHASES(V)
+#undef V
+
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_THREADPOOL_WORK_TYPE_##name);
+  NODE_THREADPOOL_WORK_TYPES(V)
+#undef V
+
+#define V(name, _)                                                            \
+  NODE_DEFINE_HIDDEN_CONSTANT(constants, NODE_THREADPOOL_WORK_METRIC_##name);
+  NODE_THREADPOOL_WORK_METRICS(V)
+#undef V
+
   PropertyAttribute attr =
       static_cast<PropertyAttribute>(ReadOnly | DontDelete);
 
@@ -621,18 +819,19 @@ void Initialize(Local<Object> target,
       env->NewFunctionTemplate(ELDHistogramNew);
   eldh->SetClassName(eldh_classname);
   eldh->InstanceTemplate()->SetInternalFieldCount(1);
-  env->SetProtoMethod(eldh, "exceeds", ELDHistogramExceeds);
-  env->SetProtoMethod(eldh, "min", ELDHistogramMin);
-  env->SetProtoMethod(eldh, "max", ELDHistogramMax);
-  env->SetProtoMethod(eldh, "mean", ELDHistogramMean);
-  env->SetProtoMethod(eldh, "stddev", ELDHistogramStddev);
-  env->SetProtoMethod(eldh, "percentile", ELDHistogramPercentile);
-  env->SetProtoMethod(eldh, "percentiles", ELDHistogramPercentiles);
-  env->SetProtoMethod(eldh, "enable", ELDHistogramEnable);
-  env->SetProtoMethod(eldh, "disable", ELDHistogramDisable);
-  env->SetProtoMethod(eldh, "reset", ELDHistogramReset);
+  SetHistogramMethods<ELDHistogram>(env, eldh);
   target->Set(context, eldh_classname,
               eldh->GetFunction(env->context()).ToLocalChecked()).Check();
+
+  Local<String> tph_classname =
+      FIXED_ONE_BYTE_STRING(isolate, "ThreadPoolHistogram");
+  Local<FunctionTemplate> tph =
+      env->NewFunctionTemplate(ThreadPoolHistogramNew);
+  tph->SetClassName(tph_classname);
+  tph->InstanceTemplate()->SetInternalFieldCount(1);
+  SetHistogramMethods<ThreadPoolHistogram>(env, tph);
+  target->Set(context, tph_classname,
+              tph->GetFunction(env->context()).ToLocalChecked()).Check();
 }
 
 }  // namespace performance
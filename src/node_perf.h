@@ -156,6 +156,40 @@ class ELDHistogram : public HandleWrap, public Histogram {
   uv_timer_t timer_;
 };
 
+// Records timings of libuv threadpool requests of a single type, see
+// performance_state::RecordThreadPoolWork().
+class ThreadPoolHistogram : public BaseObject, public Histogram {
+ public:
+  ThreadPoolHistogram(Environment* env,
+                      Local<Object> wrap,
+                      ThreadPoolWorkType type,
+                      ThreadPoolWorkMetric metric);
+  ~ThreadPoolHistogram() override;
+
+  void RecordWork(uint64_t queued, uint64_t started, uint64_t finished);
+  bool Enable();
+  bool Disable();
+  void ResetState() {
+    Reset();
+    exceeds_ = 0;
+  }
+  int64_t Exceeds() { return exceeds_; }
+  ThreadPoolWorkType type() const { return type_; }
+
+  void MemoryInfo(MemoryTracker* tracker) const override {
+    tracker->TrackFieldWithSize("histogram", GetMemorySize());
+  }
+
+  SET_MEMORY_INFO_NAME(ThreadPoolHistogram)
+  SET_SELF_SIZE(ThreadPoolHistogram)
+
+ private:
+  bool enabled_ = false;
+  ThreadPoolWorkType type_;
+  ThreadPoolWorkMetric metric_;
+  int64_t exceeds_ = 0;
+};
+
 }  // namespace performance
 }  // namespace node
 
@@ -3,6 +3,7 @@
 
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
+#include "aliased_buffer.h"
 #include "node.h"
 #include "uv.h"
 #include "v8.h"
@@ -10,6 +11,7 @@
 #include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace node {
 namespace performance {
@@ -38,6 +40,27 @@ extern uint64_t performance_v8_start;
   V(HTTP2, "http2")                                                           \
   V(HTTP, "http")
 
+// IDLE is the part of POLL that was not spent running callbacks. CLOSE also
+// includes pending and idle handle callbacks, which libuv runs between the
+// close callbacks of one iteration and the poll phase of the next.
+#define NODE_PERFORMANCE_LOOP_PHASES(V)                                       \
+  V(TIMERS, "timers")                                                         \
+  V(POLL, "poll")                                                             \
+  V(IDLE, "idle")                                                             \
+  V(CHECK, "check")                                                           \
+  V(CLOSE, "close")
+
+#define NODE_THREADPOOL_WORK_TYPES(V)                                         \
+  V(FS, "fs")                                                                 \
+  V(CRYPTO, "crypto")                                                         \
+  V(ZLIB, "zlib")                                                             \
+  V(NAPI, "napi")
+
+#define NODE_THREADPOOL_WORK_METRICS(V)                                       \
+  V(WAIT, "wait")                                                             \
+  V(RUN, "run")                                                               \
+  V(TOTAL, "total")
+
 enum PerformanceMilestone {
 #define V(name, _) NODE_PERFORMANCE_MILESTONE_##name,
   NODE_PERFORMANCE_MILESTONES(V)
@@ -52,41 +75,145 @@ enum PerformanceEntryType {
   NODE_PERFORMANCE_ENTRY_TYPE_INVALID
 };
 
+enum PerformanceLoopPhase {
+#define V(name, _) NODE_PERFORMANCE_LOOP_PHASE_##name,
+  NODE_PERFORMANCE_LOOP_PHASES(V)
+#undef V
+  NODE_PERFORMANCE_LOOP_PHASE_INVALID
+};
+
+enum ThreadPoolWorkType {
+#define V(name, _) NODE_THREADPOOL_WORK_TYPE_##name,
+  NODE_THREADPOOL_WORK_TYPES(V)
+#undef V
+  NODE_THREADPOOL_WORK_TYPE_INVALID
+};
+
+enum ThreadPoolWorkMetric {
+#define V(name, _) NODE_THREADPOOL_WORK_METRIC_##name,
+  NODE_THREADPOOL_WORK_METRICS(V)
+#undef V
+  NODE_THREADPOOL_WORK_METRIC_INVALID
+};
+
+class ThreadPoolHistogram;
+
 class performance_state {
  public:
-  explicit performance_state(v8::Isolate* isolate) :
+  struct SerializeInfo {
+    AliasedBufferIndex root;
+    AliasedBufferIndex milestones;
+    AliasedBufferIndex loop_phases;
+    AliasedBufferIndex observers;
+    AliasedBufferIndex threadpool_pending;
+  };
+
+  explicit performance_state(v8::Isolate* isolate,
+                             const SerializeInfo* info = nullptr) :
     root(
       isolate,
-      sizeof(performance_state_internal)),
+      sizeof(performance_state_internal),
+      MAYBE_FIELD_PTR(info, root)),
     milestones(
       isolate,
       offsetof(performance_state_internal, milestones),
       NODE_PERFORMANCE_MILESTONE_INVALID,
-      root),
+      root,
+      MAYBE_FIELD_PTR(info, milestones)),
+    loop_phases(
+      isolate,
+      offsetof(performance_state_internal, loop_phases),
+      NODE_PERFORMANCE_LOOP_PHASE_INVALID,
+      root,
+      MAYBE_FIELD_PTR(info, loop_phases)),
     observers(
       isolate,
       offsetof(performance_state_internal, observers),
       NODE_PERFORMANCE_ENTRY_TYPE_INVALID,
-      root) {
-    for (size_t i = 0; i < milestones.Length(); i++)
-      milestones[i] = -1.;
+      root,
+      MAYBE_FIELD_PTR(info, observers)),
+    threadpool_pending(
+      isolate,
+      offsetof(performance_state_internal, threadpool_pending),
+      NODE_THREADPOOL_WORK_TYPE_INVALID,
+      root,
+      MAYBE_FIELD_PTR(info, threadpool_pending)) {
+    if (info == nullptr) {
+      for (size_t i = 0; i < milestones.Length(); i++)
+        milestones[i] = -1.;
+    }
   }
 
   AliasedUint8Array root;
   AliasedFloat64Array milestones;
+  // Cumulative time in nanoseconds spent in each event loop phase.
+  AliasedFloat64Array loop_phases;
   AliasedUint32Array observers;
+  // Number of requests of each type that are queued on or running in the
+  // libuv threadpool.
+  AliasedUint32Array threadpool_pending;
 
   uint64_t performance_last_gc_start_mark = 0;
 
+  // Histograms that are currently recording threadpool timings. Timestamps
+  // are only taken for work that is scheduled while this is non-empty.
+  std::vector<ThreadPoolHistogram*> threadpool_histograms;
+
   void Mark(enum PerformanceMilestone milestone,
             uint64_t ts = PERFORMANCE_NOW());
 
+  SerializeInfo Serialize(v8::Local<v8::Context> context,
+                          v8::SnapshotCreator* creator);
+  void Deserialize(v8::Local<v8::Context> context);
+
+  // Event loop phase accounting. Environment calls these from its idle
+  // prepare and check handles, RunTimers(), CheckImmediate() and the
+  // outermost AsyncCallbackScope.
+  void MarkLoopPrepare(uint64_t now = PERFORMANCE_NOW());
+  void MarkLoopCheck(uint64_t now = PERFORMANCE_NOW());
+  void MarkTimersDone(uint64_t start, uint64_t now = PERFORMANCE_NOW());
+  void MarkImmediatesDone(uint64_t now = PERFORMANCE_NOW());
+
+  inline void EnterCallbackScope() {
+    if (in_poll_phase_)
+      callback_start_ = PERFORMANCE_NOW();
+  }
+
+  inline void LeaveCallbackScope() {
+    if (in_poll_phase_ && callback_start_ != 0) {
+      poll_callback_time_ += PERFORMANCE_NOW() - callback_start_;
+      callback_start_ = 0;
+    }
+  }
+
+  bool is_tracking_threadpool() const {
+    return !threadpool_histograms.empty();
+  }
+
+  // Records the lifetime of a finished threadpool request. All timestamps are
+  // uv_hrtime() values; |started| is 0 when the start of execution on the
+  // threadpool is not observable (e.g. for uv_fs_* requests).
+  void RecordThreadPoolWork(enum ThreadPoolWorkType type,
+                            uint64_t queued,
+                            uint64_t started,
+                            uint64_t finished);
+
  private:
   struct performance_state_internal {
     // doubles first so that they are always sizeof(double)-aligned
     double milestones[NODE_PERFORMANCE_MILESTONE_INVALID];
+    double loop_phases[NODE_PERFORMANCE_LOOP_PHASE_INVALID];
     uint32_t observers[NODE_PERFORMANCE_ENTRY_TYPE_INVALID];
+    uint32_t threadpool_pending[NODE_THREADPOOL_WORK_TYPE_INVALID];
   };
+
+  bool in_poll_phase_ = false;
+  uint64_t poll_start_ = 0;
+  uint64_t poll_callback_time_ = 0;
+  uint64_t callback_start_ = 0;
+  uint64_t check_start_ = 0;
+  uint64_t check_end_ = 0;
+  uint64_t timers_since_check_ = 0;
 };
 
 }  // namespace performance
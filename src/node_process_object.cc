@@ -1,4 +1,5 @@
 #include "env-inl.h"
+#include "node_external_reference.h"
 #include "node_internals.h"
 #include "node_options-inl.h"
 #include "node_metadata.h"
@@ -200,4 +201,16 @@ void PatchProcessObject(const FunctionCallbackInfo<Value>& args) {
             .FromJust());
 }
 
+void RegisterProcessExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(RawDebug);
+  registry->Register(ProcessTitleGetter);
+  registry->Register(ProcessTitleSetter);
+  registry->Register(DebugPortGetter);
+  registry->Register(DebugPortSetter);
+  registry->Register(GetParentProcessId);
+}
+
 }  // namespace node
+
+NODE_MODULE_EXTERNAL_REFERENCE(process_object,
+                               node::RegisterProcessExternalReferences)
@@ -4,6 +4,7 @@
 #include "diagnosticfilename-inl.h"
 #include "node_internals.h"
 #include "node_metadata.h"
+#include "node_stat_watcher.h"
 #include "util.h"
 
 #ifdef _WIN32
@@ -58,6 +59,7 @@ static void PrintJavaScriptStack(JSONWriter* writer,
 static void PrintNativeStack(JSONWriter* writer);
 static void PrintResourceUsage(JSONWriter* writer);
 static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate);
+static void PrintPolledFiles(JSONWriter* writer, Environment* env);
 static void PrintSystemInformation(JSONWriter* writer);
 static void PrintLoadedLibraries(JSONWriter* writer);
 static void PrintComponentVersions(JSONWriter* writer);
@@ -249,6 +251,7 @@ static void WriteNodeReport(Isolate* isolate,
   writer.json_arraystart("libuv");
   if (env != nullptr) {
     uv_walk(env->event_loop(), WalkHandle, static_cast<void*>(&writer));
+    PrintPolledFiles(&writer, env);
 
     writer.json_start();
     writer.json_keyvalue("type", "loop");
@@ -494,6 +497,32 @@ static void PrintGCStatistics(JSONWriter* writer, Isolate* isolate) {
   writer->json_objectend();
 }
 
+// fs.watchFile() polls its files through a shared timer per StatPoller
+// instead of an fs_poll handle per file. Report each polled file as an fs_poll
+// entry, with the address and state of the timer that polls it.
+static void PrintPolledFiles(JSONWriter* writer, Environment* env) {
+  for (node::HandleWrap* wrap : *env->handle_wrap_queue()) {
+    if (!node::HandleWrap::IsAlive(wrap) ||
+        wrap->provider_type() != node::AsyncWrap::PROVIDER_STATPOLLER) {
+      continue;
+    }
+    uv_handle_t* timer = wrap->GetHandle();
+    static_cast<node::StatPoller*>(wrap)->ForEachPath(
+        [&](const std::string& path) {
+      writer->json_start();
+      writer->json_keyvalue("type", "fs_poll");
+      writer->json_keyvalue("is_active",
+                            static_cast<bool>(uv_is_active(timer)));
+      writer->json_keyvalue("is_referenced",
+                            static_cast<bool>(uv_has_ref(timer)));
+      writer->json_keyvalue(
+          "address", ValueToHexString(reinterpret_cast<uint64_t>(timer)));
+      writer->json_keyvalue("filename", path);
+      writer->json_end();
+    });
+  }
+}
+
 static void PrintResourceUsage(JSONWriter* writer) {
   // Get process uptime in seconds
   uint64_t uptime =
@@ -24,18 +24,28 @@
 #include "async_wrap-inl.h"
 #include "env.h"
 #include "node_file.h"
+#include "threadpoolwork-inl.h"
 #include "util-inl.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 namespace node {
 
+using v8::Array;
 using v8::Context;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
+using v8::Int32;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::Object;
 using v8::String;
@@ -43,78 +53,427 @@ using v8::Uint32;
 using v8::Value;
 
 
-void StatWatcher::Initialize(Environment* env, Local<Object> target) {
+class StatPollJob final : public ThreadPoolWork {
+ public:
+  struct Item {
+    int32_t id;
+    std::string path;
+    int err;
+    uv_stat_t statbuf;
+  };
+
+  StatPollJob(StatPoller* poller, uint64_t started)
+      : ThreadPoolWork(poller->env(), performance::NODE_THREADPOOL_WORK_TYPE_FS),
+        poller_(poller),
+        started_(started) {}
+
+  void DoThreadPoolWork() override {
+    for (Item& item : items_) {
+      uv_fs_t req;
+      item.err = uv_fs_stat(nullptr, &req, item.path.c_str(), nullptr);
+      if (item.err == 0)
+        item.statbuf = req.statbuf;
+      uv_fs_req_cleanup(&req);
+    }
+  }
+
+  void AfterThreadPoolWork(int status) override {
+    std::unique_ptr<StatPollJob> self(this);
+    // The poller is gone if it was closed while the files were stat'ed.
+    if (poller_ == nullptr)
+      return;
+    poller_->jobs_.erase(this);
+    if (status == 0)
+      poller_->OnStats(this);
+  }
+
+  StatPoller* poller_;
+  const uint64_t started_;
+  std::vector<Item> items_;
+};
+
+
+// The same comparison that uv_fs_poll_t uses.
+static bool StatsEqual(const uv_stat_t& a, const uv_stat_t& b) {
+  return a.st_ctim.tv_nsec == b.st_ctim.tv_nsec &&
+         a.st_mtim.tv_nsec == b.st_mtim.tv_nsec &&
+         a.st_birthtim.tv_nsec == b.st_birthtim.tv_nsec &&
+         a.st_ctim.tv_sec == b.st_ctim.tv_sec &&
+         a.st_mtim.tv_sec == b.st_mtim.tv_sec &&
+         a.st_birthtim.tv_sec == b.st_birthtim.tv_sec &&
+         a.st_size == b.st_size &&
+         a.st_mode == b.st_mode &&
+         a.st_uid == b.st_uid &&
+         a.st_gid == b.st_gid &&
+         a.st_ino == b.st_ino &&
+         a.st_dev == b.st_dev &&
+         a.st_flags == b.st_flags &&
+         a.st_gen == b.st_gen;
+}
+
+
+void StatPoller::Initialize(Environment* env, Local<Object> target) {
   HandleScope scope(env->isolate());
 
-  Local<FunctionTemplate> t = env->NewFunctionTemplate(StatWatcher::New);
+  Local<FunctionTemplate> t = env->NewFunctionTemplate(StatPoller::New);
   t->InstanceTemplate()->SetInternalFieldCount(1);
-  Local<String> statWatcherString =
-      FIXED_ONE_BYTE_STRING(env->isolate(), "StatWatcher");
-  t->SetClassName(statWatcherString);
+  Local<String> statPollerString =
+      FIXED_ONE_BYTE_STRING(env->isolate(), "StatPoller");
+  t->SetClassName(statPollerString);
   t->Inherit(HandleWrap::GetConstructorTemplate(env));
 
-  env->SetProtoMethod(t, "start", StatWatcher::Start);
+  env->SetProtoMethod(t, "add", StatPoller::Add);
+  env->SetProtoMethod(t, "remove", StatPoller::Remove);
 
-  target->Set(env->context(), statWatcherString,
+  target->Set(env->context(), statPollerString,
               t->GetFunction(env->context()).ToLocalChecked()).Check();
 }
 
 
-StatWatcher::StatWatcher(Environment* env,
-                         Local<Object> wrap,
-                         bool use_bigint)
+StatPoller::StatPoller(Environment* env,
+                       Local<Object> wrap,
+                       bool use_bigint)
     : HandleWrap(env,
                  wrap,
-                 reinterpret_cast<uv_handle_t*>(&watcher_),
-                 AsyncWrap::PROVIDER_STATWATCHER),
+                 reinterpret_cast<uv_handle_t*>(&timer_),
+                 AsyncWrap::PROVIDER_STATPOLLER),
       use_bigint_(use_bigint) {
-  CHECK_EQ(0, uv_fs_poll_init(env->event_loop(), &watcher_));
+  CHECK_EQ(0, uv_timer_init(env->event_loop(), &timer_));
+
+#ifdef __linux__
+  // Without inotify, the files are only polled.
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ == -1)
+    return;
+  inotify_poll_ = new uv_poll_t();
+  if (uv_poll_init(env->event_loop(), inotify_poll_, inotify_fd_) != 0) {
+    delete inotify_poll_;
+    inotify_poll_ = nullptr;
+    close(inotify_fd_);
+    inotify_fd_ = -1;
+    return;
+  }
+  inotify_poll_->data = this;
+  CHECK_EQ(0, uv_poll_start(inotify_poll_, UV_READABLE, OnInotify));
+  uv_unref(reinterpret_cast<uv_handle_t*>(inotify_poll_));
+#endif
+}
+
+
+void StatPoller::New(const FunctionCallbackInfo<Value>& args) {
+  CHECK(args.IsConstructCall());
+  Environment* env = Environment::GetCurrent(args);
+  new StatPoller(env, args.This(), args[0]->IsTrue());
 }
 
 
-void StatWatcher::Callback(uv_fs_poll_t* handle,
-                           int status,
-                           const uv_stat_t* prev,
-                           const uv_stat_t* curr) {
-  StatWatcher* wrap = ContainerOf(&StatWatcher::watcher_, handle);
-  Environment* env = wrap->env();
-  HandleScope handle_scope(env->isolate());
-  Context::Scope context_scope(env->context());
+// poller.add(id, filename, interval)
+void StatPoller::Add(const FunctionCallbackInfo<Value>& args) {
+  CHECK_EQ(args.Length(), 3);
+
+  StatPoller* poller;
+  ASSIGN_OR_RETURN_UNWRAP(&poller, args.Holder());
+  CHECK(!poller->IsHandleClosing());
+
+  CHECK(args[0]->IsInt32());
+  const int32_t id = args[0].As<Int32>()->Value();
+  CHECK_EQ(poller->entries_.count(id), 0);
+
+  node::Utf8Value path(args.GetIsolate(), args[1]);
+  CHECK_NOT_NULL(*path);
 
-  Local<Value> arr = fs::FillGlobalStatsArray(env, wrap->use_bigint_, curr);
-  USE(fs::FillGlobalStatsArray(env, wrap->use_bigint_, prev, true));
+  CHECK(args[2]->IsUint32());
 
-  Local<Value> argv[2] = { Integer::New(env->isolate(), status), arr };
-  wrap->MakeCallback(env->onchange_string(), arraysize(argv), argv);
+  Entry& entry = poller->entries_[id];
+  entry.path = *path;
+  // uv_fs_poll_start() treats an interval of 0 as 1 as well.
+  entry.interval = std::max(args[2].As<Uint32>()->Value(), 1u);
+  // The first stat only records the current state, like uv_fs_poll_start().
+  entry.due = uv_now(poller->env()->event_loop());
+  poller->WatchDirectory(id, &entry);
+  poller->ScheduleTimer();
 }
 
 
-void StatWatcher::New(const FunctionCallbackInfo<Value>& args) {
-  CHECK(args.IsConstructCall());
-  Environment* env = Environment::GetCurrent(args);
-  new StatWatcher(env, args.This(), args[0]->IsTrue());
+// poller.remove(id)
+void StatPoller::Remove(const FunctionCallbackInfo<Value>& args) {
+  StatPoller* poller;
+  ASSIGN_OR_RETURN_UNWRAP(&poller, args.Holder());
+
+  CHECK(args[0]->IsInt32());
+  const int32_t id = args[0].As<Int32>()->Value();
+  auto it = poller->entries_.find(id);
+  if (it == poller->entries_.end())
+    return;
+  poller->UnwatchDirectory(id, &it->second);
+  // Results of a stat that is in progress are ignored.
+  poller->entries_.erase(it);
+  poller->ScheduleTimer();
+}
+
+
+void StatPoller::Close(Local<Value> close_callback) {
+  if (inotify_poll_ != nullptr) {
+    env()->CloseHandle(inotify_poll_, [](uv_poll_t* handle) { delete handle; });
+    inotify_poll_ = nullptr;
+  }
+  HandleWrap::Close(close_callback);
 }
 
-// wrap.start(filename, interval)
-void StatWatcher::Start(const FunctionCallbackInfo<Value>& args) {
-  CHECK_EQ(args.Length(), 2);
 
-  StatWatcher* wrap;
-  ASSIGN_OR_RETURN_UNWRAP(&wrap, args.Holder());
-  CHECK(!uv_is_active(wrap->GetHandle()));
+void StatPoller::OnClose() {
+  for (StatPollJob* job : jobs_)
+    job->poller_ = nullptr;
+  jobs_.clear();
+#ifdef __linux__
+  if (inotify_fd_ != -1) {
+    close(inotify_fd_);
+    inotify_fd_ = -1;
+  }
+#endif
+}
+
+
+void StatPoller::OnTimer(uv_timer_t* handle) {
+  StatPoller* poller = ContainerOf(&StatPoller::timer_, handle);
+  poller->Poll();
+}
 
-  node::Utf8Value path(args.GetIsolate(), args[0]);
-  CHECK_NOT_NULL(*path);
 
-  CHECK(args[1]->IsUint32());
-  const uint32_t interval = args[1].As<Uint32>()->Value();
+// Starts stat'ing every file that is due, kBatchSize files per threadpool job.
+void StatPoller::Poll() {
+  const uint64_t now = uv_now(env()->event_loop());
+  StatPollJob* job = nullptr;
+  for (auto& it : entries_) {
+    Entry& entry = it.second;
+    if (entry.busy || entry.due > now)
+      continue;
+    if (job == nullptr) {
+      job = new StatPollJob(this, now);
+      job->items_.reserve(kBatchSize);
+    }
+    entry.busy = true;
+    job->items_.push_back({ it.first, entry.path, 0, {} });
+    if (job->items_.size() == kBatchSize) {
+      jobs_.insert(job);
+      job->ScheduleWork();
+      job = nullptr;
+    }
+  }
+  if (job != nullptr) {
+    jobs_.insert(job);
+    job->ScheduleWork();
+  }
+  ScheduleTimer();
+}
+
+
+// Arms the timer for the next file that is due and not being stat'ed.
+void StatPoller::ScheduleTimer() {
+  if (IsHandleClosing())
+    return;
+  uint64_t next = UINT64_MAX;
+  for (const auto& it : entries_) {
+    if (!it.second.busy)
+      next = std::min(next, it.second.due);
+  }
+  if (next == UINT64_MAX) {
+    uv_timer_stop(&timer_);
+    return;
+  }
+  const uint64_t now = uv_now(env()->event_loop());
+  uv_timer_start(&timer_, OnTimer, next > now ? next - now : 0, 0);
+}
+
+
+void StatPoller::OnStats(StatPollJob* job) {
+  if (IsHandleClosing())
+    return;
+  Environment* env = this->env();
+  Isolate* isolate = env->isolate();
+  const uint64_t now = uv_now(env->event_loop());
+
+  // The files that changed, with their current and previous stats.
+  std::vector<std::pair<int32_t, int>> changes;
+  std::vector<uv_stat_t> stats;
+  static const uv_stat_t zero_statbuf {};
+  for (const StatPollJob::Item& item : job->items_) {
+    auto it = entries_.find(item.id);
+    if (it == entries_.end())
+      continue;
+    Entry& entry = it->second;
+    entry.busy = false;
+
+    bool changed = false;
+    if (item.err != 0) {
+      if (entry.status != item.err) {
+        changed = true;
+        changes.emplace_back(item.id, item.err);
+        stats.push_back(zero_statbuf);
+        stats.push_back(entry.statbuf);
+        entry.status = item.err;
+      }
+    } else {
+      if (entry.status != 0 &&
+          (entry.status < 0 || !StatsEqual(entry.statbuf, item.statbuf))) {
+        changed = true;
+        changes.emplace_back(item.id, 0);
+        stats.push_back(item.statbuf);
+        stats.push_back(entry.statbuf);
+      }
+      entry.statbuf = item.statbuf;
+      entry.status = 1;
+    }
+
+    if (changed || entry.hinted)
+      entry.backoff = 1;
+    else
+      entry.backoff = std::min(entry.backoff * 2, kMaxBackoff);
+    entry.due = entry.hinted ? now :
+        job->started_ + entry.interval * entry.backoff;
+    entry.hinted = false;
+  }
+
+  if (!changes.empty()) {
+    HandleScope handle_scope(isolate);
+    Context::Scope context_scope(env->context());
+
+    const size_t fields_per_entry =
+        static_cast<size_t>(FsStatsOffset::kFsStatsFieldsNumber);
+    Local<Value> fields;
+    if (use_bigint_) {
+      AliasedBigUint64Array arr(isolate, fields_per_entry * stats.size());
+      for (size_t i = 0; i < stats.size(); i++)
+        fs::FillStatsArray(&arr, &stats[i], i * fields_per_entry);
+      fields = arr.GetJSArray();
+    } else {
+      AliasedFloat64Array arr(isolate, fields_per_entry * stats.size());
+      for (size_t i = 0; i < stats.size(); i++)
+        fs::FillStatsArray(&arr, &stats[i], i * fields_per_entry);
+      fields = arr.GetJSArray();
+    }
+
+    Local<Array> ids = Array::New(isolate, changes.size());
+    Local<Array> statuses = Array::New(isolate, changes.size());
+    for (size_t i = 0; i < changes.size(); i++) {
+      ids->Set(env->context(), i,
+               Integer::New(isolate, changes[i].first)).Check();
+      statuses->Set(env->context(), i,
+                    Integer::New(isolate, changes[i].second)).Check();
+    }
+
+    Local<Value> argv[] = { ids, statuses, fields };
+    MakeCallback(env->onchange_string(), arraysize(argv), argv);
+  }
+
+  ScheduleTimer();
+}
+
+
+// Makes the file due right away, or as soon as the stat that is in progress
+// has finished.
+void StatPoller::Hint(int32_t id) {
+  auto it = entries_.find(id);
+  if (it == entries_.end())
+    return;
+  Entry& entry = it->second;
+  entry.backoff = 1;
+  if (entry.busy)
+    entry.hinted = true;
+  else
+    entry.due = uv_now(env()->event_loop());
+}
+
+
+void StatPoller::WatchDirectory(int32_t id, Entry* entry) {
+#ifdef __linux__
+  if (inotify_fd_ == -1)
+    return;
+  const size_t slash = entry->path.rfind('/');
+  if (slash == std::string::npos)
+    return;
+  std::string dir = slash == 0 ? "/" : entry->path.substr(0, slash);
+  // Watching the directory instead of the file also catches files that are
+  // created, or replaced by a rename.
+  entry->wd = inotify_add_watch(inotify_fd_, dir.c_str(),
+                                IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE |
+                                IN_DELETE | IN_DELETE_SELF | IN_MODIFY |
+                                IN_MOVE_SELF | IN_MOVED_FROM | IN_MOVED_TO |
+                                IN_ONLYDIR);
+  if (entry->wd != -1)
+    directories_[entry->wd].emplace(entry->path.substr(slash + 1), id);
+#endif
+}
 
-  // Note that uv_fs_poll_start does not return ENOENT, we are handling
-  // mostly memory errors here.
-  const int err = uv_fs_poll_start(&wrap->watcher_, Callback, *path, interval);
-  if (err != 0) {
-    args.GetReturnValue().Set(err);
+
+void StatPoller::UnwatchDirectory(int32_t id, Entry* entry) {
+#ifdef __linux__
+  auto dir = directories_.find(entry->wd);
+  if (dir == directories_.end())
+    return;
+  const std::string name = entry->path.substr(entry->path.rfind('/') + 1);
+  auto range = dir->second.equal_range(name);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == id) {
+      dir->second.erase(it);
+      break;
+    }
+  }
+  if (dir->second.empty()) {
+    inotify_rm_watch(inotify_fd_, entry->wd);
+    directories_.erase(dir);
   }
+  entry->wd = -1;
+#endif
+}
+
+
+#ifdef __linux__
+void StatPoller::OnInotify(uv_poll_t* handle, int status, int events) {
+  StatPoller* poller = static_cast<StatPoller*>(handle->data);
+  if (status != 0)
+    return;
+
+  alignas(struct inotify_event) char buf[4096];
+  for (;;) {
+    ssize_t size = read(poller->inotify_fd_, buf, sizeof(buf));
+    if (size == -1 && errno == EINTR)
+      continue;
+    if (size <= 0)
+      break;
+    for (char* p = buf; p < buf + size;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(p);
+      p += sizeof(*event) + event->len;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        for (const auto& it : poller->entries_)
+          poller->Hint(it.first);
+        continue;
+      }
+      auto dir = poller->directories_.find(event->wd);
+      if (dir == poller->directories_.end())
+        continue;
+      if (event->len == 0) {
+        // Something happened to the directory itself.
+        for (const auto& it : dir->second)
+          poller->Hint(it.second);
+      } else {
+        auto range = dir->second.equal_range(event->name);
+        for (auto it = range.first; it != range.second; ++it)
+          poller->Hint(it->second);
+      }
+      if (event->mask & IN_IGNORED) {
+        // The directory is gone, the files are only polled from now on.
+        for (const auto& it : dir->second)
+          poller->entries_[it.second].wd = -1;
+        poller->directories_.erase(dir);
+      }
+    }
+  }
+
+  poller->ScheduleTimer();
 }
+#endif
 
 }  // namespace node
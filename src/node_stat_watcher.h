@@ -30,32 +30,93 @@
 #include "uv.h"
 #include "v8.h"
 
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 namespace node {
 
-class StatWatcher : public HandleWrap {
+class StatPollJob;
+
+// Polls the files of all fs.watchFile() watchers that use the same stats
+// format, instead of one uv_fs_poll_t per file. Files that are due are stat'ed
+// in batches on the threadpool, and files that have not changed are polled
+// less often, up to kMaxBackoff times their interval. On Linux, changes that
+// inotify reports for the directories of the files make them due right away.
+// The changes of a batch are passed to JS in a single callback.
+class StatPoller : public HandleWrap {
  public:
+  static constexpr size_t kBatchSize = 128;
+  static constexpr uint32_t kMaxBackoff = 4;
+
   static void Initialize(Environment* env, v8::Local<v8::Object> target);
 
- protected:
-  StatWatcher(Environment* env,
-              v8::Local<v8::Object> wrap,
-              bool use_bigint);
+  void Close(
+      v8::Local<v8::Value> close_callback = v8::Local<v8::Value>()) override;
 
-  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
-  static void Start(const v8::FunctionCallbackInfo<v8::Value>& args);
+  // Calls `fn` with the path of every file that is polled, for diagnostic
+  // reports.
+  template <typename Fn>
+  void ForEachPath(Fn fn) const {
+    for (const auto& it : entries_)
+      fn(it.second.path);
+  }
 
   SET_NO_MEMORY_INFO()
-  SET_MEMORY_INFO_NAME(StatWatcher)
-  SET_SELF_SIZE(StatWatcher)
+  SET_MEMORY_INFO_NAME(StatPoller)
+  SET_SELF_SIZE(StatPoller)
 
  private:
-  static void Callback(uv_fs_poll_t* handle,
-                       int status,
-                       const uv_stat_t* prev,
-                       const uv_stat_t* curr);
+  friend class StatPollJob;
+
+  struct Entry {
+    std::string path;
+    uint64_t interval;
+    uint32_t backoff = 1;
+    uint64_t due = 0;
+    // Whether a stat is in progress, and whether a change was hinted at
+    // while it was.
+    bool busy = false;
+    bool hinted = false;
+    // Like uv_fs_poll_t: 0 before the first stat, 1 after a successful one
+    // and the error code after a failed one.
+    int status = 0;
+    uv_stat_t statbuf {};
+    int wd = -1;
+  };
+
+  StatPoller(Environment* env, v8::Local<v8::Object> wrap, bool use_bigint);
 
-  uv_fs_poll_t watcher_;
+  static void New(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Add(const v8::FunctionCallbackInfo<v8::Value>& args);
+  static void Remove(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  void OnClose() override;
+
+  void Poll();
+  void ScheduleTimer();
+  void OnStats(StatPollJob* job);
+  void Hint(int32_t id);
+  void WatchDirectory(int32_t id, Entry* entry);
+  void UnwatchDirectory(int32_t id, Entry* entry);
+
+  static void OnTimer(uv_timer_t* handle);
+#ifdef __linux__
+  static void OnInotify(uv_poll_t* handle, int status, int events);
+#endif
+
+  uv_timer_t timer_;
   const bool use_bigint_;
+  std::unordered_map<int32_t, Entry> entries_;
+  std::unordered_set<StatPollJob*> jobs_;
+
+  // The inotify instance that provides the hints, and the files that are
+  // watched through each of its directory watches by name.
+  int inotify_fd_ = -1;
+  uv_poll_t* inotify_poll_ = nullptr;
+  std::unordered_map<int, std::unordered_multimap<std::string, int32_t>>
+      directories_;
 };
 
 }  // namespace node
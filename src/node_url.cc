@@ -1,11 +1,14 @@
 #include "node_url.h"
 #include "base_object-inl.h"
 #include "node_errors.h"
+#include "node_external_reference.h"
 #include "node_i18n.h"
 #include "util-inl.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -19,12 +22,14 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::HandleScope;
 using v8::Int32;
+using v8::Int32Array;
 using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::NewStringType;
 using v8::Null;
+using v8::Number;
 using v8::Object;
 using v8::String;
 using v8::Undefined;
@@ -195,6 +200,11 @@ CHAR_TEST(8, IsASCIIAlpha, ((ch >= 'A' && ch <= 'Z') ||
 // https://infra.spec.whatwg.org/#ascii-alphanumeric
 CHAR_TEST(8, IsASCIIAlphanumeric, (IsASCIIDigit(ch) || IsASCIIAlpha(ch)))
 
+// https://url.spec.whatwg.org/#concept-urlencoded-byte-serializer
+CHAR_TEST(8, IsFormUrlencodedSafe, (IsASCIIAlphanumeric(ch) ||
+                                    ch == '*' || ch == '-' ||
+                                    ch == '.' || ch == '_'))
+
 // https://infra.spec.whatwg.org/#ascii-lowercase
 template <typename T>
 inline T ASCIILowercase(T ch) {
@@ -682,6 +692,23 @@ inline void AppendOrEscape(std::string* str,
     *str += ch;
 }
 
+// Appends [pointer, end) to str like AppendOrEscape() does byte by byte, but
+// copies runs of bytes that are not in encode_set as a whole.
+inline void AppendOrEscape(std::string* str,
+                           const char* pointer,
+                           const char* end,
+                           const uint8_t encode_set[]) {
+  while (pointer < end) {
+    const char* run = pointer;
+    while (pointer < end && !BitAt(encode_set, *pointer))
+      pointer++;
+    str->append(run, pointer - run);
+    if (pointer == end)
+      break;
+    *str += hex[static_cast<unsigned char>(*pointer++)];
+  }
+}
+
 template <typename T>
 inline unsigned hex2bin(const T ch) {
   if (ch >= '0' && ch <= '9')
@@ -693,33 +720,141 @@ inline unsigned hex2bin(const T ch) {
   return static_cast<unsigned>(-1);
 }
 
+// The scanners below look at eight bytes at a time. Each byte of the result
+// of HasByte() has its high bit set if the corresponding byte of `word`
+// equals `byte`; this is the usual "has zero byte" trick applied to
+// `word ^ byte`. It can report false positives in bytes that follow a match,
+// but never misses one, which is all that is needed to skip runs of bytes.
+constexpr uint64_t kOnes = 0x0101010101010101ull;
+constexpr uint64_t kHighBits = 0x8080808080808080ull;
+
+inline uint64_t HasByte(uint64_t word, uint8_t byte) {
+  const uint64_t x = word ^ (kOnes * byte);
+  return (x - kOnes) & ~x & kHighBits;
+}
+
+// Each byte of the result has its high bit set if the corresponding byte of
+// `word` is less than `n`, which must be at most 0x80. Unlike HasByte(), this
+// is exact.
+inline uint64_t HasLess(uint64_t word, uint8_t n) {
+  return (word - kOnes * n) & ~word & kHighBits;
+}
+
+inline uint64_t LoadWord(const char* p) {
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+inline bool IsASCII(const char* input, size_t len) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    if (LoadWord(input + i) & kHighBits)
+      return false;
+  }
+  for (; i < len; i++) {
+    if (input[i] & 0x80)
+      return false;
+  }
+  return true;
+}
+
+// Whether [input, input + len) contains a C0 control or space. The parser
+// strips some of them and treats tabs and newlines specially.
+inline bool HasC0ControlOrSpace(const char* input, size_t len) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    if (HasLess(LoadWord(input + i), ' ' + 1))
+      return true;
+  }
+  for (; i < len; i++) {
+    if (IsC0ControlOrSpace(input[i]))
+      return true;
+  }
+  return false;
+}
+
+// Returns a pointer to the first '%' in [pointer, end), or to the first '%'
+// or '+' if `plus` is set, or `end` if there is none.
+inline const char* FindEscape(const char* pointer, const char* end, bool plus) {
+  if (!plus) {
+    const void* found = memchr(pointer, '%', end - pointer);
+    return found != nullptr ? static_cast<const char*>(found) : end;
+  }
+  while (end - pointer >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+    const uint64_t word = LoadWord(pointer);
+    if (HasByte(word, '%') | HasByte(word, '+'))
+      break;
+    pointer += sizeof(uint64_t);
+  }
+  while (pointer < end && *pointer != '%' && *pointer != '+')
+    pointer++;
+  return pointer;
+}
+
+// Appends [input, input + len) to `dest`, replacing valid percent-escapes by
+// the bytes they stand for, and '+' by a space if `plus` is set. Runs of
+// bytes without escapes are copied as a whole.
+inline void PercentDecodeInto(const char* input,
+                              size_t len,
+                              bool plus,
+                              std::string* dest) {
+  const char* pointer = input;
+  const char* end = input + len;
+
+  while (pointer < end) {
+    const char* escape = FindEscape(pointer, end, plus);
+    dest->append(pointer, escape - pointer);
+    if (escape == end)
+      break;
+    pointer = escape;
+    if (*pointer == '+') {
+      *dest += ' ';
+      pointer++;
+    } else if (end - pointer > 2 &&
+               IsASCIIHexDigit(pointer[1]) &&
+               IsASCIIHexDigit(pointer[2])) {
+      *dest += static_cast<char>(hex2bin(pointer[1]) * 16 +
+                                 hex2bin(pointer[2]));
+      pointer += 3;
+    } else {
+      *dest += '%';
+      pointer++;
+    }
+  }
+}
+
 inline std::string PercentDecode(const char* input, size_t len) {
   std::string dest;
   if (len == 0)
     return dest;
   dest.reserve(len);
+  PercentDecodeInto(input, len, false, &dest);
+  return dest;
+}
+
+// Appends the application/x-www-form-urlencoded form of
+// [input, input + len) to `dest`. Runs of bytes that are kept as they are
+// are copied as a whole.
+inline void FormUrlencodeInto(const char* input,
+                              size_t len,
+                              std::string* dest) {
   const char* pointer = input;
   const char* end = input + len;
 
   while (pointer < end) {
-    const char ch = pointer[0];
-    const size_t remaining = end - pointer - 1;
-    if (ch != '%' || remaining < 2 ||
-        (ch == '%' &&
-         (!IsASCIIHexDigit(pointer[1]) ||
-          !IsASCIIHexDigit(pointer[2])))) {
-      dest += ch;
+    const char* run = pointer;
+    while (pointer < end && IsFormUrlencodedSafe(*pointer))
       pointer++;
-      continue;
-    } else {
-      unsigned a = hex2bin(pointer[1]);
-      unsigned b = hex2bin(pointer[2]);
-      char c = static_cast<char>(a * 16 + b);
-      dest += c;
-      pointer += 3;
-    }
+    dest->append(run, pointer - run);
+    if (pointer == end)
+      break;
+    const unsigned char ch = *pointer++;
+    if (ch == ' ')
+      *dest += '+';
+    else
+      *dest += hex[ch];
   }
-  return dest;
 }
 
 #define SPECIALS(XX)                                                          \
@@ -2201,6 +2336,312 @@ static void Parse(const FunctionCallbackInfo<Value>& args) {
         args[5]);
 }
 
+// Serializes `url` like the href getter in lib/internal/url.js does, and
+// records where each component starts and ends in the result.
+static std::string SerializeURL(const url_data& url, int32_t* components) {
+  std::string href;
+  size_t size = url.scheme.size() + url.username.size() +
+                url.password.size() + url.host.size() + url.query.size() +
+                url.fragment.size() + 16;
+  for (const std::string& segment : url.path)
+    size += segment.size() + 1;
+  href.reserve(size);
+
+  auto mark = [&](url_component start, url_component end,
+                  const std::string& value) {
+    components[start] = href.size();
+    href += value;
+    components[end] = href.size();
+  };
+
+  href += url.scheme;
+  components[kURLSchemeEnd] = href.size();
+  if (url.flags & URL_FLAGS_HAS_HOST) {
+    href += "//";
+    const bool has_username = !url.username.empty();
+    const bool has_password = !url.password.empty();
+    mark(kURLUsernameStart, kURLUsernameEnd,
+         has_username ? url.username : std::string());
+    if (has_password)
+      href += ':';
+    mark(kURLPasswordStart, kURLPasswordEnd,
+         has_password ? url.password : std::string());
+    if (has_username || has_password)
+      href += '@';
+    mark(kURLHostStart, kURLHostEnd, url.host);
+    if (url.port > -1) {
+      href += ':';
+      href += std::to_string(url.port);
+    }
+  } else {
+    if (url.scheme == "file:")
+      href += "//";
+    mark(kURLUsernameStart, kURLUsernameEnd, std::string());
+    mark(kURLPasswordStart, kURLPasswordEnd, std::string());
+    mark(kURLHostStart, kURLHostEnd, std::string());
+  }
+
+  components[kURLPathStart] = href.size();
+  if (url.flags & URL_FLAGS_HAS_PATH) {
+    if (url.flags & URL_FLAGS_CANNOT_BE_BASE) {
+      if (!url.path.empty())
+        href += url.path[0];
+    } else {
+      for (const std::string& segment : url.path) {
+        href += '/';
+        href += segment;
+      }
+    }
+  }
+  components[kURLPathEnd] = href.size();
+
+  if (url.flags & URL_FLAGS_HAS_QUERY)
+    href += '?';
+  mark(kURLQueryStart, kURLQueryEnd,
+       (url.flags & URL_FLAGS_HAS_QUERY) ? url.query : std::string());
+  if (url.flags & URL_FLAGS_HAS_FRAGMENT)
+    href += '#';
+  mark(kURLFragmentStart, kURLFragmentEnd,
+       (url.flags & URL_FLAGS_HAS_FRAGMENT) ? url.fragment : std::string());
+
+  components[kURLFlags] = url.flags;
+  components[kURLPort] = url.port;
+  return href;
+}
+
+// Whether URLHost::ParseHost() leaves `host` as it is for a special URL:
+// a domain of lowercase letters, digits and hyphens that is not punycode, or
+// an IPv4 address in dotted-decimal form. Hosts whose last label starts with
+// a digit are numbers to the IPv4 parser, so they are only accepted in the
+// latter form.
+inline bool IsSimpleHost(const char* host, size_t len) {
+  if (len == 0 || len > 253)
+    return false;
+  const char* end = host + len;
+  const char* label = host;
+  int labels = 0;
+  bool ipv4 = true;
+  for (const char* p = host; p <= end; p++) {
+    if (p < end && *p != '.')
+      continue;
+    const size_t label_len = p - label;
+    if (label_len == 0 || label_len > 63 || label[0] == '-' || p[-1] == '-' ||
+        (label_len >= 4 && label[2] == '-' && label[3] == '-')) {
+      return false;
+    }
+    unsigned value = 0;
+    for (const char* q = label; q < p && ipv4; q++) {
+      if (!IsASCIIDigit(*q) || q - label > 2)
+        ipv4 = false;
+      else
+        value = value * 10 + (*q - '0');
+    }
+    if (value > 255 || (label[0] == '0' && label_len > 1))
+      ipv4 = false;
+    labels++;
+    if (p == end)
+      return IsASCIIDigit(label[0]) ? ipv4 && labels == 4 : true;
+    label = p + 1;
+  }
+  UNREACHABLE();
+}
+
+// Parses the common case of an absolute URL with a special scheme other than
+// file:, a simple host, and no credentials or dot segments straight into its
+// serialization, like SerializeURL() would have produced it, without building
+// a url_data. Each component is appended once, with runs of bytes that need
+// no percent-encoding copied as a whole. Returns false for everything else,
+// which URL::Parse() has to handle.
+static bool ParseSimpleHref(const char* input,
+                            size_t len,
+                            std::string* href,
+                            int32_t* components) {
+  const char* p = input;
+  const char* end = input + len;
+  if (len == 0 || HasC0ControlOrSpace(input, len) ||
+      memchr(input, '\\', len) != nullptr) {
+    return false;
+  }
+
+  // The longest special scheme is "gopher:".
+  const void* colon = memchr(p, ':', std::min(len, sizeof("gopher:") - 1));
+  if (colon == nullptr || colon == p)
+    return false;
+  std::string scheme;
+  for (; p < colon; p++) {
+    if (!IsASCIIAlpha(*p))
+      return false;
+    scheme += ASCIILowercase(*p);
+  }
+  scheme += ':';
+  p++;
+  if (!IsSpecial(scheme) || scheme == "file:" ||
+      end - p < 3 || p[0] != '/' || p[1] != '/' || p[2] == '/') {
+    return false;
+  }
+  int32_t flags = URL_FLAGS_SPECIAL | URL_FLAGS_HAS_HOST | URL_FLAGS_HAS_PATH;
+  href->reserve(len + 1);
+  *href += scheme;
+  components[kURLSchemeEnd] = href->size();
+  *href += "//";
+  p += 2;
+
+  const size_t host_start = href->size();
+  components[kURLUsernameStart] = components[kURLUsernameEnd] = host_start;
+  components[kURLPasswordStart] = components[kURLPasswordEnd] = host_start;
+  const char* host = p;
+  while (p < end && (IsASCIIDigit(*p) || (*p >= 'a' && *p <= 'z') ||
+                     *p == '-' || *p == '.')) {
+    p++;
+  }
+  if (!IsSimpleHost(host, p - host))
+    return false;
+  href->append(host, p - host);
+  components[kURLHostStart] = host_start;
+  components[kURLHostEnd] = href->size();
+
+  int port = -1;
+  if (p < end && *p == ':') {
+    const char* digits = ++p;
+    unsigned value = 0;
+    while (p < end && IsASCIIDigit(*p) && p - digits < 5)
+      value = value * 10 + (*p++ - '0');
+    if (p == digits || value > 0xffff)
+      return false;
+    port = NormalizePort(scheme, static_cast<int>(value));
+    if (port == -1) {
+      flags |= URL_FLAGS_IS_DEFAULT_SCHEME_PORT;
+    } else {
+      *href += ':';
+      *href += std::to_string(port);
+    }
+  }
+  if (p < end && *p != '/' && *p != '?' && *p != '#')
+    return false;
+
+  components[kURLPathStart] = href->size();
+  const char* path_end = p;
+  while (path_end < end && *path_end != '?' && *path_end != '#')
+    path_end++;
+  if (p == path_end) {
+    *href += '/';
+  } else {
+    for (const char* segment = p + 1; segment <= path_end; segment++) {
+      const char* segment_end = segment;
+      while (segment_end < path_end && *segment_end != '/')
+        segment_end++;
+      const size_t segment_len = segment_end - segment;
+      if (segment_len <= 6 && segment_len > 0 &&
+          (segment[0] == '.' || segment[0] == '%')) {
+        const std::string str(segment, segment_len);
+        if (IsSingleDotSegment(str) || IsDoubleDotSegment(str))
+          return false;
+      }
+      segment = segment_end;
+    }
+    AppendOrEscape(href, p, path_end, PATH_ENCODE_SET);
+  }
+  components[kURLPathEnd] = href->size();
+  p = path_end;
+
+  const char* query_end = p;
+  if (p < end && *p == '?') {
+    flags |= URL_FLAGS_HAS_QUERY;
+    const void* hash = memchr(p, '#', end - p);
+    query_end = hash != nullptr ? static_cast<const char*>(hash) : end;
+    *href += '?';
+  }
+  components[kURLQueryStart] = href->size();
+  if (p < query_end)
+    AppendOrEscape(href, p + 1, query_end, QUERY_ENCODE_SET_SPECIAL);
+  components[kURLQueryEnd] = href->size();
+  p = query_end;
+
+  if (p < end) {
+    flags |= URL_FLAGS_HAS_FRAGMENT;
+    *href += '#';
+  }
+  components[kURLFragmentStart] = href->size();
+  if (p < end)
+    AppendOrEscape(href, p + 1, end, FRAGMENT_ENCODE_SET);
+  components[kURLFragmentEnd] = href->size();
+
+  components[kURLFlags] = flags;
+  components[kURLPort] = port;
+  return true;
+}
+
+// parseHref(input, base, components) parses a URL into its serialization
+// and fills `components` with the flags, the port and the ranges of the
+// other components of it, so that JS land only has to create a single string
+// and can slice the components out of it. Returns undefined if the parser
+// ended up in an invalid state, and the input if parsing failed.
+static void ParseHref(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  CHECK(args[0]->IsString());  // input
+  CHECK(args[1]->IsUndefined() || args[1]->IsObject());  // base context
+  CHECK(args[2]->IsInt32Array());  // components
+  Local<Int32Array> components_array = args[2].As<Int32Array>();
+  CHECK_EQ(components_array->Length(), kURLComponentsCount);
+  int32_t* components = reinterpret_cast<int32_t*>(
+      static_cast<char*>(components_array->Buffer()->GetContents().Data()) +
+      components_array->ByteOffset());
+
+  Utf8Value input(isolate, args[0]);
+  std::string href;
+  if (ParseSimpleHref(*input, input.length(), &href, components)) {
+    // Everything that needs it was percent-encoded, so the href is ASCII.
+    args.GetReturnValue().Set(
+        OneByteString(isolate, href.data(), href.size()));
+    return;
+  }
+  href.clear();
+
+  url_data base;
+  const bool has_base = args[1]->IsObject();
+  if (has_base)
+    base = HarvestBase(env, args[1].As<Object>());
+
+  url_data url;
+  URL::Parse(*input, input.length(), kUnknownState, &url, false, &base,
+             has_base);
+  if (url.flags & URL_FLAGS_INVALID_PARSE_STATE)
+    return;
+
+  components[kURLFlags] = url.flags;
+  if (url.flags & URL_FLAGS_FAILED) {
+    args.GetReturnValue().Set(
+        String::NewFromUtf8(isolate, *input, NewStringType::kNormal)
+            .ToLocalChecked());
+    return;
+  }
+
+  href = SerializeURL(url, components);
+  // Everything that the parser produces is percent-encoded or punycoded, so
+  // the href is normally ASCII and can be copied into a one-byte string as is.
+  if (IsASCII(href.data(), href.size())) {
+    args.GetReturnValue().Set(
+        OneByteString(isolate, href.data(), href.size()));
+    return;
+  }
+
+  // JS land indexes the string in UTF-16 code units, so turn the byte
+  // offsets into those.
+  std::vector<int32_t> offsets(href.size() + 1);
+  int32_t units = 0;
+  for (size_t i = 0; i < href.size(); i++) {
+    offsets[i] = units;
+    const unsigned char c = href[i];
+    if ((c & 0xC0) != 0x80)
+      units += c >= 0xF0 ? 2 : 1;
+  }
+  offsets[href.size()] = units;
+  for (int i = kURLSchemeEnd; i < kURLComponentsCount; i++)
+    components[i] = offsets[components[i]];
+  args.GetReturnValue().Set(Utf8String(isolate, href));
+}
+
 static void EncodeAuthSet(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -2209,10 +2650,7 @@ static void EncodeAuthSet(const FunctionCallbackInfo<Value>& args) {
   std::string output;
   const size_t len = value.length();
   output.reserve(len);
-  for (size_t n = 0; n < len; n++) {
-    const char ch = (*value)[n];
-    AppendOrEscape(&output, ch, USERINFO_ENCODE_SET);
-  }
+  AppendOrEscape(&output, *value, *value + len, USERINFO_ENCODE_SET);
   args.GetReturnValue().Set(
       String::NewFromUtf8(env->isolate(),
                           output.c_str(),
@@ -2254,6 +2692,99 @@ static void ToUSVString(const FunctionCallbackInfo<Value>& args) {
                              n).ToLocalChecked());
 }
 
+// Returns the decoded form of a name or value of an
+// application/x-www-form-urlencoded string.
+static Local<String> DecodeFormComponent(Isolate* isolate,
+                                         const char* input,
+                                         size_t len,
+                                         std::string* scratch) {
+  if (FindEscape(input, input + len, true) == input + len)
+    return OneByteString(isolate, input, len);
+  scratch->clear();
+  PercentDecodeInto(input, len, true, scratch);
+  if (IsASCII(scratch->data(), scratch->size()))
+    return OneByteString(isolate, scratch->data(), scratch->size());
+  return String::NewFromUtf8(isolate,
+                             scratch->data(),
+                             NewStringType::kNormal,
+                             scratch->size()).ToLocalChecked();
+}
+
+// parseFormUrlencoded(input, maxPairs) splits an
+// application/x-www-form-urlencoded string into its name-value pairs and
+// decodes them, returning a flat array of names and values. Empty pairs are
+// skipped but count towards `maxPairs`, like they do in querystring.parse();
+// there is no limit unless `maxPairs` is a positive integer. Returns
+// undefined if the input is not ASCII, because the JS parsers handle
+// non-ASCII input in ways that do not match UTF-8 decoding exactly.
+static void ParseFormUrlencoded(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  CHECK(args[0]->IsString());
+  CHECK(args[1]->IsNumber());
+  const double max_pairs = args[1].As<Number>()->Value();
+  const bool limited = max_pairs >= 1 && std::floor(max_pairs) == max_pairs;
+
+  Utf8Value input(isolate, args[0]);
+  if (!IsASCII(*input, input.length()))
+    return;
+
+  std::vector<Local<Value>> out;
+  std::string scratch;
+  const char* end = *input + input.length();
+  double pairs = 0;
+  for (const char* start = *input; start < end;) {
+    const void* found = memchr(start, '&', end - start);
+    const char* pair_end =
+        found != nullptr ? static_cast<const char*>(found) : end;
+    if (pair_end != start) {
+      found = memchr(start, '=', pair_end - start);
+      const char* name_end =
+          found != nullptr ? static_cast<const char*>(found) : pair_end;
+      out.push_back(
+          DecodeFormComponent(isolate, start, name_end - start, &scratch));
+      if (name_end == pair_end) {
+        out.push_back(String::Empty(isolate));
+      } else {
+        out.push_back(DecodeFormComponent(
+            isolate, name_end + 1, pair_end - name_end - 1, &scratch));
+      }
+    }
+    if (limited && ++pairs == max_pairs)
+      break;
+    start = pair_end + 1;
+  }
+
+  args.GetReturnValue().Set(Array::New(isolate, out.data(), out.size()));
+}
+
+// serializeFormUrlencoded(list) is the counterpart of parseFormUrlencoded():
+// it encodes a flat array of names and values, which must be USVStrings, as
+// an application/x-www-form-urlencoded string.
+static void SerializeFormUrlencoded(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  CHECK(args[0]->IsArray());
+  Local<Array> list = args[0].As<Array>();
+
+  std::string output;
+  const uint32_t length = list->Length();
+  for (uint32_t i = 0; i < length; i++) {
+    Local<Value> item;
+    if (!list->Get(context, i).ToLocal(&item))
+      return;
+    CHECK(item->IsString());
+    if (i > 0)
+      output += i % 2 == 0 ? '&' : '=';
+    Utf8Value value(isolate, item);
+    FormUrlencodeInto(*value, value.length(), &output);
+  }
+
+  args.GetReturnValue().Set(
+      OneByteString(isolate, output.data(), output.size()));
+}
+
 static void DomainToASCII(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args);
   CHECK_GE(args.Length(), 1);
@@ -2424,8 +2955,13 @@ static void Initialize(Local<Object> target,
                        void* priv) {
   Environment* env = Environment::GetCurrent(context);
   env->SetMethod(target, "parse", Parse);
+  env->SetMethod(target, "parseHref", ParseHref);
   env->SetMethodNoSideEffect(target, "encodeAuth", EncodeAuthSet);
   env->SetMethodNoSideEffect(target, "toUSVString", ToUSVString);
+  env->SetMethodNoSideEffect(target, "parseFormUrlencoded",
+                             ParseFormUrlencoded);
+  env->SetMethodNoSideEffect(target, "serializeFormUrlencoded",
+                             SerializeFormUrlencoded);
   env->SetMethodNoSideEffect(target, "domainToASCII", DomainToASCII);
   env->SetMethodNoSideEffect(target, "domainToUnicode", DomainToUnicode);
   env->SetMethod(target, "setURLConstructor", SetURLConstructor);
@@ -2436,9 +2972,24 @@ static void Initialize(Local<Object> target,
 
 #define XX(name) NODE_DEFINE_CONSTANT(target, name);
   PARSESTATES(XX)
+  URL_COMPONENTS(XX)
 #undef XX
+  NODE_DEFINE_CONSTANT(target, kURLComponentsCount);
+}
+
+static void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(Parse);
+  registry->Register(ParseHref);
+  registry->Register(EncodeAuthSet);
+  registry->Register(ToUSVString);
+  registry->Register(ParseFormUrlencoded);
+  registry->Register(SerializeFormUrlencoded);
+  registry->Register(DomainToASCII);
+  registry->Register(DomainToUnicode);
+  registry->Register(SetURLConstructor);
 }
 }  // namespace url
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(url, node::url::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(url, node::url::RegisterExternalReferences)
@@ -49,6 +49,32 @@ namespace url {
   XX(URL_FLAGS_HAS_FRAGMENT, 0x400)                                           \
   XX(URL_FLAGS_IS_DEFAULT_SCHEME_PORT, 0x800)                                 \
 
+// The layout of the Int32Array that parseHref() fills in, next to the href.
+// Each component is the range [start, end) of the href.
+#define URL_COMPONENTS(XX)                                                    \
+  XX(kURLFlags)                                                               \
+  XX(kURLPort)                                                                \
+  XX(kURLSchemeEnd)                                                           \
+  XX(kURLUsernameStart)                                                       \
+  XX(kURLUsernameEnd)                                                         \
+  XX(kURLPasswordStart)                                                       \
+  XX(kURLPasswordEnd)                                                         \
+  XX(kURLHostStart)                                                           \
+  XX(kURLHostEnd)                                                             \
+  XX(kURLPathStart)                                                           \
+  XX(kURLPathEnd)                                                             \
+  XX(kURLQueryStart)                                                          \
+  XX(kURLQueryEnd)                                                            \
+  XX(kURLFragmentStart)                                                       \
+  XX(kURLFragmentEnd)
+
+enum url_component {
+#define XX(name) name,
+  URL_COMPONENTS(XX)
+#undef XX
+  kURLComponentsCount
+};
+
 enum url_parse_state {
   kUnknownState = -1,
 #define XX(name) name,
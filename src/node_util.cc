@@ -1,4 +1,5 @@
 #include "node_errors.h"
+#include "node_external_reference.h"
 #include "util-inl.h"
 #include "base_object-inl.h"
 
@@ -318,7 +319,24 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "guessHandleType", GuessHandleType);
 }
 
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(GetHiddenValue);
+  registry->Register(SetHiddenValue);
+  registry->Register(GetPromiseDetails);
+  registry->Register(GetProxyDetails);
+  registry->Register(PreviewEntries);
+  registry->Register(GetOwnNonIndexProperties);
+  registry->Register(GetConstructorName);
+  registry->Register(ArrayBufferViewHasBuffer);
+  registry->Register(WeakReference::New);
+  registry->Register(WeakReference::Get);
+  registry->Register(WeakReference::IncRef);
+  registry->Register(WeakReference::DecRef);
+  registry->Register(GuessHandleType);
+}
+
 }  // namespace util
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(util, node::util::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(util, node::util::RegisterExternalReferences)
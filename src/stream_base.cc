@@ -23,10 +23,13 @@ using v8::DontEnum;
 using v8::External;
 using v8::Function;
 using v8::FunctionCallbackInfo;
+using v8::Global;
 using v8::HandleScope;
 using v8::Integer;
+using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
+using v8::Number;
 using v8::Object;
 using v8::ReadOnly;
 using v8::String;
@@ -59,6 +62,13 @@ int StreamBase::UseUserBuffer(const FunctionCallbackInfo<Value>& args) {
   return 0;
 }
 
+int StreamBase::UseBatchedReads(const FunctionCallbackInfo<Value>& args) {
+  CHECK(!stream_env()->stream_read_batch_function().IsEmpty());
+
+  PushStreamListener(new BatchedJSStreamListener());
+  return 0;
+}
+
 int StreamBase::Shutdown(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsObject());
   Local<Object> req_wrap_obj = args[0].As<Object>();
@@ -380,6 +390,9 @@ void StreamBase::AddMethods(Environment* env, Local<FunctionTemplate> t) {
   env->SetProtoMethod(t,
                       "useUserBuffer",
                       JSMethod<&StreamBase::UseUserBuffer>);
+  env->SetProtoMethod(t,
+                      "useBatchedReads",
+                      JSMethod<&StreamBase::UseBatchedReads>);
   env->SetProtoMethod(t, "writev", JSMethod<&StreamBase::Writev>);
   env->SetProtoMethod(t, "writeBuffer", JSMethod<&StreamBase::WriteBuffer>);
   env->SetProtoMethod(
@@ -513,6 +526,96 @@ void CustomBufferJSListener::OnStreamRead(ssize_t nread, const uv_buf_t& buf) {
 }
 
 
+uv_buf_t BatchedJSStreamListener::OnStreamAlloc(size_t suggested_size) {
+  CHECK_NOT_NULL(stream_);
+  Environment* env = static_cast<StreamBase*>(stream_)->stream_env();
+  return env->AllocateManaged(suggested_size).release();
+}
+
+
+void BatchedJSStreamListener::OnStreamRead(ssize_t nread,
+                                           const uv_buf_t& buf_) {
+  CHECK_NOT_NULL(stream_);
+  StreamBase* stream = static_cast<StreamBase*>(stream_);
+  Environment* env = stream->stream_env();
+  HandleScope handle_scope(env->isolate());
+  AllocatedBuffer buf(env, buf_);
+
+  if (nread == 0)
+    return;
+
+  if (nread > 0) {
+    CHECK_LE(static_cast<size_t>(nread), buf.size());
+    buf.Resize(nread);
+  } else {
+    buf.clear();
+  }
+
+  AsyncWrap* wrap = stream->GetAsyncWrap();
+  CHECK_NOT_NULL(wrap);
+  env->batched_stream_reads().push_back(BatchedStreamRead {
+    Global<Object>(env->isolate(), wrap->object()),
+    nread,
+    std::move(buf),
+    wrap->get_async_id(),
+    wrap->get_trigger_async_id()
+  });
+}
+
+
+void BatchedJSStreamListener::Flush(Environment* env) {
+  std::vector<BatchedStreamRead> reads;
+  reads.swap(env->batched_stream_reads());
+  if (reads.empty() || !env->can_call_into_js())
+    return;
+
+  Isolate* isolate = env->isolate();
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env->context());
+
+  // The batch is passed as a flat array of
+  // [handle, nread, arrayBuffer, asyncId, triggerAsyncId, asyncContext]
+  // tuples.
+  bool uses_async_context = env->async_hooks()->uses_async_context();
+  std::vector<Local<Value>> entries;
+  entries.reserve(reads.size() * 6);
+  for (BatchedStreamRead& read : reads) {
+    DCHECK_EQ(static_cast<int32_t>(read.nread), read.nread);
+    Local<Object> object = read.object.Get(isolate);
+    Local<Value> async_context = Undefined(isolate);
+    if (uses_async_context) {
+      // Only this read loses its async context if the lookup fails, the
+      // data itself is still delivered along with the rest of the batch.
+      errors::TryCatchScope try_catch(env);
+      if (!object->GetPrivate(env->context(),
+                              env->async_context_private_symbol())
+              .ToLocal(&async_context)) {
+        async_context = Undefined(isolate);
+      }
+    }
+    entries.push_back(object);
+    entries.push_back(Integer::New(isolate, read.nread));
+    if (read.nread > 0)
+      entries.push_back(read.buffer.ToArrayBuffer());
+    else
+      entries.push_back(Undefined(isolate));
+    entries.push_back(Number::New(isolate, read.async_id));
+    entries.push_back(Number::New(isolate, read.trigger_async_id));
+    entries.push_back(async_context);
+  }
+
+  Local<Value> argv[] = {
+    Array::New(isolate, entries.data(), entries.size())
+  };
+  MakeCallback(isolate,
+               env->process_object(),
+               env->stream_read_batch_function(),
+               arraysize(argv),
+               argv,
+               {0, 0});
+}
+
+
 void ReportWritesToJSStreamListener::OnStreamAfterReqFinished(
     StreamReq* req_wrap, int status) {
   StreamBase* stream = static_cast<StreamBase*>(stream_);
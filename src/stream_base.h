@@ -195,6 +195,20 @@ class CustomBufferJSListener : public ReportWritesToJSStreamListener {
 };
 
 
+// An alternative to EmitToJSStreamListener that does not call into JS for
+// every chunk. Reads are queued on the Environment and delivered together,
+// as a single callback, once the poll phase of the event loop has finished.
+class BatchedJSStreamListener : public ReportWritesToJSStreamListener {
+ public:
+  uv_buf_t OnStreamAlloc(size_t suggested_size) override;
+  void OnStreamRead(ssize_t nread, const uv_buf_t& buf) override;
+  void OnStreamDestroy() override { delete this; }
+
+  // Deliver all queued reads to JS.
+  static void Flush(Environment* env);
+};
+
+
 // A generic stream, comparable to JS land’s `Duplex` streams.
 // A stream is always controlled through one `StreamListener` instance.
 class StreamResource {
@@ -343,6 +357,7 @@ class StreamBase : public StreamResource {
   template <enum encoding enc>
   int WriteString(const v8::FunctionCallbackInfo<v8::Value>& args);
   int UseUserBuffer(const v8::FunctionCallbackInfo<v8::Value>& args);
+  int UseBatchedReads(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   static void GetFD(const v8::FunctionCallbackInfo<v8::Value>& args);
   static void GetExternal(const v8::FunctionCallbackInfo<v8::Value>& args);
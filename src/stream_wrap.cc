@@ -40,6 +40,7 @@ namespace node {
 using v8::Context;
 using v8::DontDelete;
 using v8::EscapableHandleScope;
+using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
 using v8::HandleScope;
@@ -51,6 +52,13 @@ using v8::Signature;
 using v8::Value;
 
 
+static void SetupBatchedReads(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsFunction());
+  env->set_stream_read_batch_function(args[0].As<Function>());
+}
+
+
 void LibuvStreamWrap::Initialize(Local<Object> target,
                                  Local<Value> unused,
                                  Local<Context> context,
@@ -110,6 +118,8 @@ void LibuvStreamWrap::Initialize(Local<Object> target,
   NODE_DEFINE_CONSTANT(target, kLastWriteWasAsync);
   target->Set(context, FIXED_ONE_BYTE_STRING(env->isolate(), "streamBaseState"),
               env->stream_base_state().GetJSArray()).Check();
+
+  env->SetMethod(target, "setupBatchedReads", SetupBatchedReads);
 }
 
 
@@ -33,6 +33,10 @@
 #include <algorithm>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // When creating strings >= this length v8's gc spins up and consumes
 // most of the execution time. For these cases it's more performant to
 // use external string resources.
@@ -261,6 +265,201 @@ static size_t hex_decode(char* buf,
   return i;
 }
 
+// Both transcoders below stop before the first character that does not fit
+// into `dstlen` bytes, store the number of code units they consumed in
+// `*read` and return the number of bytes written. Runs of ASCII characters
+// are copied 16 (SSE2) or 8 characters at a time.
+static size_t latin1_to_utf8(const uint8_t* src,
+                             size_t len,
+                             char* dst,
+                             size_t dstlen,
+                             size_t* read) {
+  size_t i = 0;
+  size_t o = 0;
+
+  while (i < len) {
+#if defined(__SSE2__)
+    while (i + 16 <= len && o + 16 <= dstlen) {
+      const __m128i x =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      if (_mm_movemask_epi8(x) != 0)
+        break;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + o), x);
+      i += 16;
+      o += 16;
+    }
+#else
+    while (i + 8 <= len && o + 8 <= dstlen) {
+      uint64_t word;
+      memcpy(&word, src + i, sizeof(word));
+      if (word & 0x8080808080808080ull)
+        break;
+      memcpy(dst + o, &word, sizeof(word));
+      i += 8;
+      o += 8;
+    }
+#endif
+    if (i == len)
+      break;
+
+    const uint8_t c = src[i];
+    if (c < 0x80) {
+      if (o + 1 > dstlen)
+        break;
+      dst[o++] = c;
+    } else {
+      if (o + 2 > dstlen)
+        break;
+      dst[o++] = 0xC0 | (c >> 6);
+      dst[o++] = 0x80 | (c & 0x3F);
+    }
+    i++;
+  }
+
+  *read = i;
+  return o;
+}
+
+
+// Unpaired surrogates are replaced with U+FFFD, like String::WriteUtf8()
+// does with REPLACE_INVALID_UTF8. A high surrogate in the last code unit of
+// `src` is always treated as unpaired.
+static size_t utf16_to_utf8(const uint16_t* src,
+                            size_t len,
+                            char* dst,
+                            size_t dstlen,
+                            size_t* read) {
+  size_t i = 0;
+  size_t o = 0;
+
+  while (i < len) {
+#if defined(__SSE2__)
+    const __m128i high_bits = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+    while (i + 8 <= len && o + 8 <= dstlen) {
+      const __m128i x =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128i ascii =
+          _mm_cmpeq_epi16(_mm_and_si128(x, high_bits), _mm_setzero_si128());
+      if (_mm_movemask_epi8(ascii) != 0xFFFF)
+        break;
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + o),
+                       _mm_packus_epi16(x, x));
+      i += 8;
+      o += 8;
+    }
+#else
+    while (i + 4 <= len && o + 4 <= dstlen) {
+      uint64_t word;
+      memcpy(&word, src + i, sizeof(word));
+      if (word & 0xFF80FF80FF80FF80ull)
+        break;
+      dst[o++] = src[i++];
+      dst[o++] = src[i++];
+      dst[o++] = src[i++];
+      dst[o++] = src[i++];
+    }
+#endif
+    if (i == len)
+      break;
+
+    uint32_t c = src[i];
+    size_t units = 1;
+    if (c < 0x80) {
+      if (o + 1 > dstlen)
+        break;
+      dst[o++] = c;
+    } else if (c < 0x800) {
+      if (o + 2 > dstlen)
+        break;
+      dst[o++] = 0xC0 | (c >> 6);
+      dst[o++] = 0x80 | (c & 0x3F);
+    } else if (c >= 0xD800 && c <= 0xDBFF &&
+               i + 1 < len && (src[i + 1] & 0xFC00) == 0xDC00) {
+      if (o + 4 > dstlen)
+        break;
+      c = 0x10000 + ((c - 0xD800) << 10) + (src[i + 1] - 0xDC00);
+      dst[o++] = 0xF0 | (c >> 18);
+      dst[o++] = 0x80 | ((c >> 12) & 0x3F);
+      dst[o++] = 0x80 | ((c >> 6) & 0x3F);
+      dst[o++] = 0x80 | (c & 0x3F);
+      units = 2;
+    } else {
+      if (o + 3 > dstlen)
+        break;
+      if ((c & 0xF800) == 0xD800)
+        c = 0xFFFD;
+      dst[o++] = 0xE0 | (c >> 12);
+      dst[o++] = 0x80 | ((c >> 6) & 0x3F);
+      dst[o++] = 0x80 | (c & 0x3F);
+    }
+    i += units;
+  }
+
+  *read = i;
+  return o;
+}
+
+
+size_t StringBytes::WriteUtf8(Isolate* isolate,
+                              char* buf,
+                              size_t buflen,
+                              Local<String> str,
+                              size_t* chars_read) {
+  // Strings that are not external are copied out in chunks of this many code
+  // units, which keeps the copy in the L1 cache and needs no allocation.
+  static constexpr size_t kChunkSize = 2048;
+
+  const size_t length = str->Length();
+  size_t nbytes = 0;
+  size_t nchars = 0;
+
+  if (str->IsExternalOneByte()) {
+    auto ext = str->GetExternalOneByteStringResource();
+    nbytes = latin1_to_utf8(reinterpret_cast<const uint8_t*>(ext->data()),
+                            ext->length(), buf, buflen, &nchars);
+  } else if (str->IsExternal()) {
+    auto ext = str->GetExternalStringResource();
+    nbytes = utf16_to_utf8(ext->data(), ext->length(), buf, buflen, &nchars);
+  } else if (str->IsOneByte()) {
+    uint8_t chunk[kChunkSize];
+    while (nchars < length) {
+      const size_t n = std::min(kChunkSize, length - nchars);
+      str->WriteOneByte(isolate, chunk, nchars, n,
+                        String::HINT_MANY_WRITES_EXPECTED |
+                        String::NO_NULL_TERMINATION);
+      size_t read;
+      nbytes += latin1_to_utf8(chunk, n, buf + nbytes, buflen - nbytes, &read);
+      nchars += read;
+      if (read < n)
+        break;
+    }
+  } else {
+    uint16_t chunk[kChunkSize];
+    while (nchars < length) {
+      size_t n = std::min(kChunkSize, length - nchars);
+      str->Write(isolate, chunk, nchars, n,
+                 String::HINT_MANY_WRITES_EXPECTED |
+                 String::NO_NULL_TERMINATION);
+      // Leave a high surrogate at the end of the chunk for the next one, so
+      // that a pair that spans two chunks is not taken for two unpaired ones.
+      const bool split_pair = nchars + n < length &&
+                              (chunk[n - 1] & 0xFC00) == 0xD800;
+      if (split_pair)
+        n--;
+      size_t read;
+      nbytes += utf16_to_utf8(chunk, n, buf + nbytes, buflen - nbytes, &read);
+      nchars += read;
+      if (read < n)
+        break;
+    }
+  }
+
+  if (chars_read != nullptr)
+    *chars_read = nchars;
+  return nbytes;
+}
+
+
 size_t StringBytes::WriteUCS2(Isolate* isolate,
                               char* buf,
                               size_t buflen,
@@ -341,9 +540,12 @@ size_t StringBytes::Write(Isolate* isolate,
       break;
 
     case BUFFER:
-    case UTF8:
-      nbytes = str->WriteUtf8(isolate, buf, buflen, chars_written, flags);
+    case UTF8: {
+      size_t nchars;
+      nbytes = WriteUtf8(isolate, buf, buflen, str, &nchars);
+      *chars_written = static_cast<int>(nchars);
       break;
+    }
 
     case UCS2: {
       size_t nchars;
@@ -484,57 +686,55 @@ Maybe<size_t> StringBytes::Size(Isolate* isolate,
 
 
 
-static bool contains_non_ascii_slow(const char* buf, size_t len) {
-  for (size_t i = 0; i < len; ++i) {
-    if (buf[i] & 0x80)
-      return true;
-  }
-  return false;
-}
-
-
+// Checks 16 bytes at a time with SSE2 and 8 bytes at a time otherwise. Large
+// inputs are checked in blocks of four of those, with a single branch each.
 static bool contains_non_ascii(const char* src, size_t len) {
-  if (len < 16) {
-    return contains_non_ascii_slow(src, len);
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  for (; i + 64 <= len; i += 64) {
+    const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+    const __m128i x = _mm_or_si128(
+        _mm_or_si128(_mm_loadu_si128(p), _mm_loadu_si128(p + 1)),
+        _mm_or_si128(_mm_loadu_si128(p + 2), _mm_loadu_si128(p + 3)));
+    if (_mm_movemask_epi8(x) != 0)
+      return true;
   }
-
-  const unsigned bytes_per_word = sizeof(uintptr_t);
-  const unsigned align_mask = bytes_per_word - 1;
-  const unsigned unaligned = reinterpret_cast<uintptr_t>(src) & align_mask;
-
-  if (unaligned > 0) {
-    const unsigned n = bytes_per_word - unaligned;
-    if (contains_non_ascii_slow(src, n))
+  for (; i + 16 <= len; i += 16) {
+    const __m128i x =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(x) != 0)
       return true;
-    src += n;
-    len -= n;
   }
-
-
-#if defined(_WIN64) || defined(_LP64)
-  const uintptr_t mask = 0x8080808080808080ll;
 #else
-  const uintptr_t mask = 0x80808080l;
-#endif
-
-  const uintptr_t* srcw = reinterpret_cast<const uintptr_t*>(src);
-
-  for (size_t i = 0, n = len / bytes_per_word; i < n; ++i) {
-    if (srcw[i] & mask)
+  constexpr uint64_t kHighBits = 0x8080808080808080ull;
+  for (; i + 32 <= len; i += 32) {
+    uint64_t words[4];
+    memcpy(words, src + i, sizeof(words));
+    if ((words[0] | words[1] | words[2] | words[3]) & kHighBits)
       return true;
   }
-
-  const unsigned remainder = len & align_mask;
-  if (remainder > 0) {
-    const size_t offset = len - remainder;
-    if (contains_non_ascii_slow(src + offset, remainder))
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    memcpy(&word, src + i, sizeof(word));
+    if (word & kHighBits)
       return true;
   }
+#endif
 
+  for (; i < len; i++) {
+    if (src[i] & 0x80)
+      return true;
+  }
   return false;
 }
 
 
+bool StringBytes::IsAscii(const char* buf, size_t buflen) {
+  return !contains_non_ascii(buf, buflen);
+}
+
+
 static void force_ascii_slow(const char* src, char* dst, size_t len) {
   for (size_t i = 0; i < len; ++i) {
     dst[i] = src[i] & 0x7f;
@@ -655,6 +855,11 @@ MaybeLocal<Value> StringBytes::Encode(Isolate* isolate,
       }
 
     case UTF8:
+      // ASCII is a subset of both UTF-8 and Latin-1, so ASCII-only input can
+      // be copied into a one-byte string without going through V8's decoder,
+      // which would scan it twice.
+      if (!contains_non_ascii(buf, buflen))
+        return ExternOneByteString::NewFromCopy(isolate, buf, buflen, error);
       val = String::NewFromUtf8(isolate,
                                 buf,
                                 v8::NewStringType::kNormal,
@@ -76,6 +76,18 @@ class StringBytes {
                       enum encoding enc,
                       int* chars_written = nullptr);
 
+  // Like Write() with UTF8, but without going through String::WriteUtf8().
+  // Never splits a character, and stores the number of UTF-16 code units
+  // that were written in `chars_read`.
+  static size_t WriteUtf8(v8::Isolate* isolate,
+                          char* buf,
+                          size_t buflen,
+                          v8::Local<v8::String> str,
+                          size_t* chars_read = nullptr);
+
+  // Returns true if none of the bytes in `buf` has the high bit set.
+  static bool IsAscii(const char* buf, size_t buflen);
+
   // Take the bytes in the src, and turn it into a Buffer or String.
   static v8::MaybeLocal<v8::Value> Encode(v8::Isolate* isolate,
                                           const char* buf,
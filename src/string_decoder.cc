@@ -3,6 +3,7 @@
 
 #include "env-inl.h"
 #include "node_buffer.h"
+#include "node_external_reference.h"
 #include "string_bytes.h"
 #include "util.h"
 
@@ -26,22 +27,14 @@ MaybeLocal<String> MakeString(Isolate* isolate,
                               const char* data,
                               size_t length,
                               enum encoding encoding) {
+  // For UTF-8, this creates one-byte strings directly from ASCII-only input.
   Local<Value> error;
-  MaybeLocal<Value> ret;
-  if (encoding == UTF8) {
-    return String::NewFromUtf8(
-        isolate,
-        data,
-        v8::NewStringType::kNormal,
-        length);
-  } else {
-    ret = StringBytes::Encode(
-        isolate,
-        data,
-        length,
-        encoding,
-        &error);
-  }
+  MaybeLocal<Value> ret = StringBytes::Encode(
+      isolate,
+      data,
+      length,
+      encoding,
+      &error);
 
   if (ret.IsEmpty()) {
     CHECK(!error.IsEmpty());
@@ -320,9 +313,17 @@ void InitializeStringDecoder(Local<Object> target,
   env->SetMethod(target, "flush", FlushData);
 }
 
+void RegisterStringDecoderExternalReferences(
+    ExternalReferenceRegistry* registry) {
+  registry->Register(DecodeData);
+  registry->Register(FlushData);
+}
+
 }  // anonymous namespace
 
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(string_decoder,
                                    node::InitializeStringDecoder)
+NODE_MODULE_EXTERNAL_REFERENCE(string_decoder,
+                               node::RegisterStringDecoderExternalReferences)
@@ -12,6 +12,10 @@
 #include <cstring>
 #include <algorithm>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace node {
 namespace stringsearch {
 
@@ -76,6 +80,11 @@ class StringSearchBase {
   // to compensate for the algorithmic overhead compared to simple brute force.
   static const int kBMMinPatternLength = 8;
 
+  // Byte patterns up to this length are searched for by comparing their
+  // first and last bytes against a whole block of the subject at a time,
+  // see FindPacked().
+  static const int kPackedMaxPatternLength = 64;
+
   // Store for the BoyerMoore(Horspool) bad char shift table.
   int bad_char_shift_table_[kUC16AlphabetSize];
   // Store for the BoyerMoore good suffix shift table.
@@ -98,6 +107,11 @@ class StringSearch : private StringSearchBase {
 
     size_t pattern_length = pattern_.length();
     CHECK_GT(pattern_length, 0);
+    if (sizeof(Char) == 1 && pattern_length > 1 &&
+        pattern_length <= kPackedMaxPatternLength) {
+      strategy_ = &StringSearch::PackedSearch;
+      return;
+    }
     if (pattern_length < kBMMinPatternLength) {
       if (pattern_length == 1) {
         strategy_ = &StringSearch::SingleCharSearch;
@@ -131,6 +145,7 @@ class StringSearch : private StringSearchBase {
   typedef size_t (StringSearch::*SearchFunction)(Vector, size_t);
   size_t SingleCharSearch(Vector subject, size_t start_index);
   size_t LinearSearch(Vector subject, size_t start_index);
+  size_t PackedSearch(Vector subject, size_t start_index);
   size_t InitialSearch(Vector subject, size_t start_index);
   size_t BoyerMooreHorspoolSearch(Vector subject, size_t start_index);
   size_t BoyerMooreSearch(Vector subject, size_t start_index);
@@ -266,6 +281,141 @@ inline size_t FindFirstCharacter(Vector<const uint8_t> pattern,
   return subject.forward() ? raw_pos : (subj_len - raw_pos - 1);
 }
 
+// Finds the first occurrence of `pattern` in `subject`, which is only used
+// for byte patterns.
+template <typename Char>
+inline size_t FindPacked(Vector<const Char> pattern,
+                         Vector<const Char> subject,
+                         size_t index) {
+  UNREACHABLE();
+}
+
+// Returns true if the `length` bytes at `candidate` are the same as those
+// at `pattern`. The first and the last byte are known to match.
+inline bool MatchesPacked(const uint8_t* candidate,
+                          const uint8_t* pattern,
+                          size_t length) {
+  return length == 2 ||
+         memcmp(candidate + 1, pattern + 1, length - 2) == 0;
+}
+
+// The "generic SIMD" substring search: rather than looking for the first
+// byte of the pattern alone, which occurs often in most inputs, look for
+// positions where both the first and the last byte of the pattern match,
+// for a whole block of positions at a time. Only those positions are then
+// compared byte by byte. With SSE2 a block is 16 positions, elsewhere it is
+// 8 positions that are checked using 64-bit arithmetic.
+template <>
+inline size_t FindPacked(Vector<const uint8_t> pattern,
+                         Vector<const uint8_t> subject,
+                         size_t index) {
+  // Work on the memory ranges directly, so that the pattern is in its
+  // original order even if the search goes back to front.
+  const uint8_t* needle = pattern.start();
+  const uint8_t* haystack = subject.start();
+  const size_t length = pattern.length();
+  const size_t subject_length = subject.length();
+  const size_t max_n = subject_length - length;
+  const uint8_t first = needle[0];
+  const uint8_t last = needle[length - 1];
+  if (index > max_n)
+    return subject_length;
+
+#if defined(__SSE2__)
+  typedef unsigned Mask;
+  constexpr size_t kBlock = 16;
+  const __m128i first_block = _mm_set1_epi8(static_cast<char>(first));
+  const __m128i last_block = _mm_set1_epi8(static_cast<char>(last));
+  // Bit i of the result is set if position `pos + i` is a candidate.
+  auto candidates = [&](size_t pos) -> Mask {
+    const __m128i a = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(haystack + pos));
+    const __m128i b = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(haystack + pos + length - 1));
+    return _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first_block),
+                                           _mm_cmpeq_epi8(b, last_block)));
+  };
+#else
+  typedef uint64_t Mask;
+  constexpr size_t kBlock = sizeof(uint64_t);
+  constexpr uint64_t kOnes = 0x0101010101010101ull;
+  const uint64_t first_block = kOnes * first;
+  const uint64_t last_block = kOnes * last;
+  // Non-zero if any position in [pos, pos + 8) may be a candidate.
+  auto candidates = [&](size_t pos) -> Mask {
+    uint64_t a, b;
+    memcpy(&a, haystack + pos, sizeof(a));
+    memcpy(&b, haystack + pos + length - 1, sizeof(b));
+    // A zero byte in `x` means both bytes matched at that position.
+    const uint64_t x = (a ^ first_block) | (b ^ last_block);
+    return (x - kOnes) & ~x & (kOnes << 7);
+  };
+#endif
+
+  if (subject.forward()) {
+    size_t pos = index;
+    for (; pos + kBlock - 1 <= max_n; pos += kBlock) {
+      Mask mask = candidates(pos);
+      if (mask == 0)
+        continue;
+#if defined(__SSE2__)
+      do {
+        const size_t i = pos + __builtin_ctz(mask);
+        if (MatchesPacked(haystack + i, needle, length))
+          return i;
+        mask &= mask - 1;
+      } while (mask != 0);
+#else
+      for (size_t i = pos; i < pos + kBlock; i++) {
+        if (haystack[i] == first && haystack[i + length - 1] == last &&
+            MatchesPacked(haystack + i, needle, length)) {
+          return i;
+        }
+      }
+#endif
+    }
+    for (; pos <= max_n; pos++) {
+      if (haystack[pos] == first && haystack[pos + length - 1] == last &&
+          MatchesPacked(haystack + pos, needle, length)) {
+        return pos;
+      }
+    }
+    return subject_length;
+  }
+
+  // Back to front: `index` counts from the end, and so does the result.
+  size_t end = max_n - index + 1;  // One past the last position to check.
+  for (; end >= kBlock; end -= kBlock) {
+    const size_t pos = end - kBlock;
+    Mask mask = candidates(pos);
+    if (mask == 0)
+      continue;
+#if defined(__SSE2__)
+    do {
+      const size_t bit = 31 - __builtin_clz(mask);
+      const size_t i = pos + bit;
+      if (MatchesPacked(haystack + i, needle, length))
+        return max_n - i;
+      mask &= ~(Mask(1) << bit);
+    } while (mask != 0);
+#else
+    for (size_t i = end; i-- > pos;) {
+      if (haystack[i] == first && haystack[i + length - 1] == last &&
+          MatchesPacked(haystack + i, needle, length)) {
+        return max_n - i;
+      }
+    }
+#endif
+  }
+  while (end-- > 0) {
+    if (haystack[end] == first && haystack[end + length - 1] == last &&
+        MatchesPacked(haystack + end, needle, length)) {
+      return max_n - end;
+    }
+  }
+  return subject_length;
+}
+
 //---------------------------------------------------------------------
 // Single Character Pattern Search Strategy
 //---------------------------------------------------------------------
@@ -309,6 +459,18 @@ size_t StringSearch<Char>::LinearSearch(
   return subject.length();
 }
 
+//---------------------------------------------------------------------
+// Packed Search Strategy
+//---------------------------------------------------------------------
+
+template <typename Char>
+size_t StringSearch<Char>::PackedSearch(
+    Vector subject,
+    size_t index) {
+  CHECK_GT(pattern_.length(), 1);
+  return FindPacked(pattern_, subject, index);
+}
+
 //---------------------------------------------------------------------
 // Boyer-Moore string search
 //---------------------------------------------------------------------
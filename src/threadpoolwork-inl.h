@@ -25,22 +25,39 @@
 #if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
 
 #include "util-inl.h"
+#include "env-inl.h"
 #include "node_internals.h"
 
 namespace node {
 
 void ThreadPoolWork::ScheduleWork() {
   env_->IncreaseWaitingRequestCounter();
+  performance::performance_state* state = env_->performance_state();
+  state->threadpool_pending[type_] += 1;
+  queued_at_ = state->is_tracking_threadpool() ? uv_hrtime() : 0;
   int status = uv_queue_work(
       env_->event_loop(),
       &work_req_,
       [](uv_work_t* req) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
+        // queued_at_ is only written before the work is queued, so reading
+        // it here does not race with the main thread.
+        if (self->queued_at_ != 0)
+          self->started_at_ = uv_hrtime();
         self->DoThreadPoolWork();
       },
       [](uv_work_t* req, int status) {
         ThreadPoolWork* self = ContainerOf(&ThreadPoolWork::work_req_, req);
         self->env_->DecreaseWaitingRequestCounter();
+        performance::performance_state* state =
+            self->env_->performance_state();
+        state->threadpool_pending[self->type_] -= 1;
+        if (self->queued_at_ != 0 && status == 0) {
+          state->RecordThreadPoolWork(self->type_,
+                                      self->queued_at_,
+                                      self->started_at_,
+                                      uv_hrtime());
+        }
         self->AfterThreadPoolWork(status);
       });
   CHECK_EQ(status, 0);
@@ -0,0 +1,269 @@
+#include "timer_wheel.h"
+#include "env-inl.h"
+#include "node_errors.h"
+#include "node_internals.h"
+#include "util-inl.h"
+#include "v8.h"
+
+#include <algorithm>
+
+namespace node {
+
+using errors::TryCatchScope;
+using v8::Array;
+using v8::Context;
+using v8::Function;
+using v8::HandleScope;
+using v8::Integer;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::Object;
+using v8::Value;
+
+TimerWheel::TimerWheel(Environment* env)
+    : env_(env),
+      current_(uv_now(env->event_loop()) - env->timer_base()) {
+  heads_.fill(kNone);
+  tails_.fill(kNone);
+  CHECK_EQ(0, uv_timer_init(env->event_loop(), &timer_));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&timer_));
+}
+
+uint64_t TimerWheel::LevelShift(size_t level) {
+  if (level == 0) return 0;
+  return kFirstLevelBits + (level - 1) * kLevelBits;
+}
+
+size_t TimerWheel::LevelOf(uint32_t slot) {
+  if (slot < kFirstLevelSlots) return 0;
+  return 1 + (slot - kFirstLevelSlots) / kLevelSlots;
+}
+
+uint32_t TimerWheel::SlotFor(uint64_t expiry, size_t* level) const {
+  DCHECK_GE(expiry, current_);
+  uint64_t delta = expiry - current_;
+  if (delta < kFirstLevelSlots) {
+    *level = 0;
+    return expiry & (kFirstLevelSlots - 1);
+  }
+
+  // Timeouts that lie beyond the range of the last level are put into it
+  // anyway; they are placed again whenever their slot is reached.
+  size_t l = 1;
+  while (l < kLevels - 1 && delta >= (uint64_t{1} << (LevelShift(l + 1))))
+    l++;
+  *level = l;
+  return kFirstLevelSlots + (l - 1) * kLevelSlots +
+         ((expiry >> LevelShift(l)) & (kLevelSlots - 1));
+}
+
+void TimerWheel::Link(uint32_t id) {
+  Entry& entry = entries_[id];
+  size_t level;
+  uint32_t slot = SlotFor(entry.expiry, &level);
+
+  entry.slot = slot;
+  entry.next = kNone;
+  entry.prev = tails_[slot];
+  if (entry.prev != kNone)
+    entries_[entry.prev].next = id;
+  else
+    heads_[slot] = id;
+  tails_[slot] = id;
+  counts_[level]++;
+}
+
+void TimerWheel::Unlink(uint32_t id) {
+  Entry& entry = entries_[id];
+  DCHECK_NE(entry.slot, kNone);
+
+  if (entry.prev != kNone)
+    entries_[entry.prev].next = entry.next;
+  else
+    heads_[entry.slot] = entry.next;
+  if (entry.next != kNone)
+    entries_[entry.next].prev = entry.prev;
+  else
+    tails_[entry.slot] = entry.prev;
+
+  counts_[LevelOf(entry.slot)]--;
+  entry.slot = kNone;
+}
+
+uint32_t TimerWheel::New() {
+  uint32_t id;
+  if (free_ != kNone) {
+    id = free_;
+    free_ = entries_[id].next;
+  } else {
+    CHECK_LT(entries_.size(), kNone);
+    id = static_cast<uint32_t>(entries_.size());
+    entries_.emplace_back();
+  }
+
+  entries_[id] = Entry { 0, kNone, kNone, kNone };
+  size_++;
+  return id;
+}
+
+uint64_t TimerWheel::Schedule(uint32_t id, uint64_t msecs) {
+  CHECK_LT(id, entries_.size());
+  uint64_t now = Now();
+
+  Entry& entry = entries_[id];
+  if (entry.slot != kNone)
+    Unlink(id);
+  entry.expiry = std::max(now + msecs, current_);
+  Link(id);
+
+  // The timeout needs the wheel to run once its slot is reached: at the exact
+  // expiry for the first level, when the slot is cascaded for the others.
+  uint64_t shift = LevelShift(LevelOf(entry.slot));
+  uint64_t wakeup = (entry.expiry >> shift) << shift;
+  if (wakeup < wakeup_)
+    StartTimer(wakeup, now);
+
+  return now;
+}
+
+void TimerWheel::Release(uint32_t id) {
+  CHECK_LT(id, entries_.size());
+  if (entries_[id].slot != kNone)
+    Unlink(id);
+
+  entries_[id].next = free_;
+  free_ = id;
+  size_--;
+}
+
+uint64_t TimerWheel::Now() {
+  uv_update_time(env_->event_loop());
+  return uv_now(env_->event_loop()) - env_->timer_base();
+}
+
+// Moves the timeouts of the slots that the wheel has just reached down to the
+// lower levels. Like a clock, a level only advances when all lower levels have
+// wrapped around.
+void TimerWheel::Cascade() {
+  for (size_t level = 1; level < kLevels; level++) {
+    uint64_t index = (current_ >> LevelShift(level)) & (kLevelSlots - 1);
+    uint32_t slot = kFirstLevelSlots + (level - 1) * kLevelSlots + index;
+
+    uint32_t id = heads_[slot];
+    heads_[slot] = tails_[slot] = kNone;
+    while (id != kNone) {
+      uint32_t next = entries_[id].next;
+      counts_[level]--;
+      Link(id);
+      id = next;
+    }
+
+    if (index != 0)
+      break;
+  }
+}
+
+void TimerWheel::Advance(uint64_t now, std::vector<uint32_t>* expired) {
+  while (current_ <= now) {
+    if ((current_ & (kFirstLevelSlots - 1)) == 0)
+      Cascade();
+
+    uint32_t slot = current_ & (kFirstLevelSlots - 1);
+    uint32_t id = heads_[slot];
+    heads_[slot] = tails_[slot] = kNone;
+    while (id != kNone) {
+      Entry& entry = entries_[id];
+      DCHECK_EQ(entry.expiry, current_);
+      entry.slot = kNone;
+      counts_[0]--;
+      expired->push_back(id);
+      id = entry.next;
+    }
+    current_++;
+
+    // Without timeouts on the first level, nothing can happen until the next
+    // cascade, so there is no need to visit every single tick.
+    if (counts_[0] == 0)
+      current_ = std::min(NextWakeup(), now + 1);
+  }
+}
+
+uint64_t TimerWheel::NextWakeup() const {
+  uint64_t wakeup = kNever;
+  if (counts_[0] > 0) {
+    for (uint64_t i = 0; i < kFirstLevelSlots; i++) {
+      if (heads_[(current_ + i) & (kFirstLevelSlots - 1)] != kNone) {
+        wakeup = current_ + i;
+        break;
+      }
+    }
+    CHECK_NE(wakeup, kNever);
+  }
+
+  for (size_t level = 1; level < kLevels; level++) {
+    if (counts_[level] == 0) continue;
+    // The next time that all lower levels wrap around, which is when the
+    // timeouts of this level may have to be cascaded.
+    uint64_t shift = LevelShift(level);
+    uint64_t cascade =
+        ((current_ + (uint64_t{1} << shift) - 1) >> shift) << shift;
+    return std::min(wakeup, cascade);
+  }
+
+  return wakeup;
+}
+
+void TimerWheel::StartTimer(uint64_t wakeup, uint64_t now) {
+  uv_handle_t* handle = reinterpret_cast<uv_handle_t*>(&timer_);
+  if (uv_is_closing(handle)) return;
+
+  wakeup_ = wakeup;
+  if (wakeup == kNever) {
+    uv_timer_stop(&timer_);
+    return;
+  }
+  uv_timer_start(&timer_, OnTimeout, wakeup > now ? wakeup - now : 0, 0);
+}
+
+void TimerWheel::OnTimeout(uv_timer_t* handle) {
+  TimerWheel* wheel = ContainerOf(&TimerWheel::timer_, handle);
+  Environment* env = wheel->env_;
+  uint64_t start = uv_hrtime();
+  OnScopeLeave mark_done([&]() {
+    env->performance_state()->MarkTimersDone(start);
+  });
+
+  uint64_t now = uv_now(env->event_loop()) - env->timer_base();
+  std::vector<uint32_t> expired;
+  wheel->wakeup_ = kNever;
+  wheel->Advance(now, &expired);
+  wheel->StartTimer(wheel->NextWakeup(), now);
+
+  if (expired.empty() || !env->can_call_into_js())
+    return;
+
+  Isolate* isolate = env->isolate();
+  HandleScope handle_scope(isolate);
+  Context::Scope context_scope(env->context());
+
+  std::vector<Local<Value>> ids(expired.size());
+  for (size_t i = 0; i < expired.size(); i++)
+    ids[i] = Integer::NewFromUnsigned(isolate, expired[i]);
+  Local<Value> arg = Array::New(isolate, ids.data(), ids.size());
+
+  Local<Object> process = env->process_object();
+  InternalCallbackScope scope(env, process, {0, 0});
+
+  // Like in Environment::RunTimers(), the JS side keeps track of how far it
+  // got, so that an exception only interrupts the current timeout.
+  Local<Function> cb = env->timer_wheel_callback_function();
+  MaybeLocal<Value> ret;
+  do {
+    TryCatchScope try_catch(env);
+    try_catch.SetVerbose(true);
+    ret = cb->Call(env->context(), process, 1, &arg);
+  } while (ret.IsEmpty() && env->can_call_into_js());
+}
+
+}  // namespace node
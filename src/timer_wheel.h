@@ -0,0 +1,103 @@
+#ifndef SRC_TIMER_WHEEL_H_
+#define SRC_TIMER_WHEEL_H_
+
+#if defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#include "uv.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace node {
+
+class Environment;
+
+// A hierarchical timing wheel that backs the unrefed timeouts that core
+// creates through setUnrefTimeout() in lib/internal/timers.js, most notably
+// the idle timeouts of sockets.
+//
+// Timeouts are identified by small integer ids handed out by New(). They are
+// kept in per-slot intrusive lists, so that (re)scheduling and releasing a
+// timeout is O(1) and does not allocate. The first level has one slot per
+// millisecond; each of the following levels covers 64 slots of the previous
+// level's range, and its timeouts are moved down (cascaded) once the wheel
+// reaches them. All timeouts that expire during one run of the wheel's
+// uv_timer_t are passed to JS in a single call.
+class TimerWheel {
+ public:
+  explicit TimerWheel(Environment* env);
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Returns the id of a new, unscheduled timeout.
+  uint32_t New();
+  // Schedules the timeout to expire after `msecs` milliseconds, replacing any
+  // previous schedule. Returns the current loop time, relative to the
+  // Environment's timer base.
+  uint64_t Schedule(uint32_t id, uint64_t msecs);
+  // Unschedules the timeout and makes its id available for reuse.
+  void Release(uint32_t id);
+
+  inline uv_timer_t* timer_handle() { return &timer_; }
+  inline size_t size() const { return size_; }
+
+ private:
+  static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+  static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+
+  static constexpr size_t kLevels = 5;
+  static constexpr uint64_t kFirstLevelBits = 8;
+  static constexpr uint64_t kLevelBits = 6;
+  static constexpr uint64_t kFirstLevelSlots = 1 << kFirstLevelBits;
+  static constexpr uint64_t kLevelSlots = 1 << kLevelBits;
+  static constexpr size_t kSlots =
+      kFirstLevelSlots + (kLevels - 1) * kLevelSlots;
+
+  struct Entry {
+    uint64_t expiry;
+    uint32_t prev;
+    // Also links free entries together.
+    uint32_t next;
+    // Index into heads_/tails_, or kNone if the timeout is not scheduled.
+    uint32_t slot;
+  };
+
+  static inline uint64_t LevelShift(size_t level);
+  static inline size_t LevelOf(uint32_t slot);
+  inline uint32_t SlotFor(uint64_t expiry, size_t* level) const;
+  inline void Link(uint32_t id);
+  inline void Unlink(uint32_t id);
+
+  uint64_t Now();
+  void Cascade();
+  void Advance(uint64_t now, std::vector<uint32_t>* expired);
+  uint64_t NextWakeup() const;
+  void StartTimer(uint64_t wakeup, uint64_t now);
+
+  static void OnTimeout(uv_timer_t* handle);
+
+  Environment* env_;
+  uv_timer_t timer_;
+  // The next tick that has not been processed yet, in milliseconds relative
+  // to the Environment's timer base.
+  uint64_t current_;
+  // The tick at which timer_ is going to fire next.
+  uint64_t wakeup_ = kNever;
+
+  std::vector<Entry> entries_;
+  uint32_t free_ = kNone;
+  size_t size_ = 0;
+
+  std::array<uint32_t, kSlots> heads_;
+  std::array<uint32_t, kSlots> tails_;
+  std::array<size_t, kLevels> counts_ {};
+};
+
+}  // namespace node
+
+#endif  // defined(NODE_WANT_INTERNALS) && NODE_WANT_INTERNALS
+
+#endif  // SRC_TIMER_WHEEL_H_
@@ -1,4 +1,6 @@
 #include "env-inl.h"
+#include "node_external_reference.h"
+#include "timer_wheel.h"
 #include "util-inl.h"
 #include "v8.h"
 
@@ -13,16 +15,20 @@ using v8::Function;
 using v8::FunctionCallbackInfo;
 using v8::Integer;
 using v8::Local;
+using v8::Number;
 using v8::Object;
+using v8::Uint32;
 using v8::Value;
 
 void SetupTimers(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsFunction());
   CHECK(args[1]->IsFunction());
+  CHECK(args[2]->IsFunction());
   auto env = Environment::GetCurrent(args);
 
   env->set_immediate_callback_function(args[0].As<Function>());
   env->set_timers_callback_function(args[1].As<Function>());
+  env->set_timer_wheel_callback_function(args[2].As<Function>());
 }
 
 void GetLibuvNow(const FunctionCallbackInfo<Value>& args) {
@@ -43,6 +49,28 @@ void ToggleImmediateRef(const FunctionCallbackInfo<Value>& args) {
   Environment::GetCurrent(args)->ToggleImmediateRef(args[0]->IsTrue());
 }
 
+void NewWheelTimer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  args.GetReturnValue().Set(env->timer_wheel()->New());
+}
+
+void ScheduleWheelTimer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  CHECK(args[1]->IsUint32());
+  uint32_t id = args[0].As<Uint32>()->Value();
+  uint32_t msecs = args[1].As<Uint32>()->Value();
+  uint64_t now = env->timer_wheel()->Schedule(id, msecs);
+  args.GetReturnValue().Set(Number::New(env->isolate(),
+                                        static_cast<double>(now)));
+}
+
+void ReleaseWheelTimer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args);
+  CHECK(args[0]->IsUint32());
+  env->timer_wheel()->Release(args[0].As<Uint32>()->Value());
+}
+
 void Initialize(Local<Object> target,
                        Local<Value> unused,
                        Local<Context> context,
@@ -54,14 +82,29 @@ void Initialize(Local<Object> target,
   env->SetMethod(target, "scheduleTimer", ScheduleTimer);
   env->SetMethod(target, "toggleTimerRef", ToggleTimerRef);
   env->SetMethod(target, "toggleImmediateRef", ToggleImmediateRef);
+  env->SetMethod(target, "newWheelTimer", NewWheelTimer);
+  env->SetMethod(target, "scheduleWheelTimer", ScheduleWheelTimer);
+  env->SetMethod(target, "releaseWheelTimer", ReleaseWheelTimer);
 
   target->Set(env->context(),
               FIXED_ONE_BYTE_STRING(env->isolate(), "immediateInfo"),
               env->immediate_info()->fields().GetJSArray()).Check();
 }
 
+void RegisterExternalReferences(ExternalReferenceRegistry* registry) {
+  registry->Register(GetLibuvNow);
+  registry->Register(SetupTimers);
+  registry->Register(ScheduleTimer);
+  registry->Register(ToggleTimerRef);
+  registry->Register(ToggleImmediateRef);
+  registry->Register(NewWheelTimer);
+  registry->Register(ScheduleWheelTimer);
+  registry->Register(ReleaseWheelTimer);
+}
+
 
 }  // anonymous namespace
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_INTERNAL(timers, node::Initialize)
+NODE_MODULE_EXTERNAL_REFERENCE(timers, node::RegisterExternalReferences)
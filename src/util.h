@@ -184,6 +184,10 @@ void DumpBacktrace(FILE* fp);
 #define UNREACHABLE(...)                                                      \
   ERROR_AND_ABORT("Unreachable code reached" __VA_OPT__(": ") __VA_ARGS__)
 
+// Address of a field of a struct that may be absent, e.g. of the information
+// that is used to deserialize an object from the startup snapshot.
+#define MAYBE_FIELD_PTR(ptr, field) ((ptr) == nullptr ? nullptr : &(ptr)->field)
+
 // ECMA262 20.1.2.6 Number.MAX_SAFE_INTEGER (2^53-1)
 constexpr int64_t kMaxSafeJsInteger = 9007199254740991;
 
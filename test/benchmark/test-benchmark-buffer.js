@@ -19,6 +19,7 @@ runBenchmark('buffers',
                'linesCount=1',
                'method=',
                'n=1',
+               'needles=2',
                'partial=true',
                'pieces=1',
                'pieceSize=1',
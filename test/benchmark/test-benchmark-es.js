@@ -8,6 +8,8 @@ runBenchmark('es',
              [
                'method=',
                'count=1',
+               'fanout=2',
+               'files=1',
                'context=null',
                'rest=0',
                'mode=',
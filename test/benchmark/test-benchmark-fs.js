@@ -18,5 +18,8 @@ runBenchmark('fs', [
   'encodingType=buf',
   'filesize=1024',
   'dir=.github',
-  'withFileTypes=false'
+  'withFileTypes=false',
+  'paths=1',
+  'method=statMany',
+  'walker=walk'
 ], { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
@@ -13,5 +13,6 @@ runBenchmark('misc', [
   'code=1',
   'val=magyarország.icom.museum',
   'script=test/fixtures/semicolon',
-  'mode=worker'
+  'mode=worker',
+  'snapshot=on'
 ], { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
@@ -6,6 +6,8 @@ const runBenchmark = require('../common/benchmark');
 
 runBenchmark('querystring',
              [ 'n=1',
+               'encoding=none',
+               'pairs=1',
                'input="there is nothing to unescape here"',
                'type=noencode'
              ],
@@ -7,6 +7,9 @@ const runBenchmark = require('../common/benchmark');
 runBenchmark('url',
              [
                'method=legacy',
+               'operation=parse',
+               'encoding=none',
+               'pairs=1',
                'e=0',
                'loopMethod=forEach',
                'accessMethod=get',
@@ -20,6 +23,7 @@ runBenchmark('url',
                'prop=href',
                'n=1',
                'param=one',
-               'withBase=false'
+               'withBase=false',
+               'access=href'
              ],
              { NODEJS_BENCHMARK_ZERO_ALLOWED: 1 });
@@ -0,0 +1,92 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const net = require('net');
+const {
+  AsyncResource,
+  getAsyncContext,
+  setAsyncContext
+} = require('async_hooks');
+
+assert.strictEqual(getAsyncContext(), undefined);
+
+function inContext(value, fn) {
+  setImmediate(common.mustCall(() => {
+    setAsyncContext(value);
+    fn();
+  }));
+}
+
+// Timers, immediates and nextTick.
+inContext('timers', () => {
+  setTimeout(common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'timers');
+  }), 1);
+  setImmediate(common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'timers');
+  }));
+  process.nextTick(common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'timers');
+  }));
+  const interval = setInterval(common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'timers');
+    clearInterval(interval);
+  }), 1);
+});
+
+// Promises and async functions.
+inContext('promises', () => {
+  Promise.resolve().then(common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'promises');
+  }));
+  (async () => {
+    await null;
+    assert.strictEqual(getAsyncContext(), 'promises');
+    await new Promise((resolve) => setTimeout(resolve, 1));
+    assert.strictEqual(getAsyncContext(), 'promises');
+  })().then(common.mustCall());
+});
+
+// Native resources go through AsyncWrap and MakeCallback.
+inContext('fs', () => {
+  fs.stat(__filename, common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'fs');
+  }));
+});
+
+inContext('net', () => {
+  const server = net.createServer(common.mustCall((socket) => {
+    socket.end();
+    server.close();
+  }));
+  server.listen(0, common.mustCall(() => {
+    assert.strictEqual(getAsyncContext(), 'net');
+    net.connect(server.address().port)
+      .on('connect', common.mustCall(() => {
+        assert.strictEqual(getAsyncContext(), 'net');
+      }))
+      .resume();
+  }));
+});
+
+// AsyncResource captures the context at construction.
+inContext('resource', () => {
+  const resource = new AsyncResource('Test');
+  setImmediate(common.mustCall(() => {
+    setAsyncContext('other');
+    resource.runInAsyncScope(common.mustCall(() => {
+      assert.strictEqual(getAsyncContext(), 'resource');
+    }));
+    assert.strictEqual(getAsyncContext(), 'other');
+  }));
+});
+
+// The previous value is restored once a callback returns.
+setImmediate(common.mustCall(() => {
+  setAsyncContext('outer');
+  const resource = new AsyncResource('Test');
+  resource.runInAsyncScope(() => setAsyncContext('inner'));
+  assert.strictEqual(getAsyncContext(), 'outer');
+}));
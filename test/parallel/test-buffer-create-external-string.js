@@ -0,0 +1,65 @@
+// Flags: --expose-gc
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const { createExternalString } = require('buffer');
+const { MessageChannel } = require('worker_threads');
+
+{
+  const buf = Buffer.from('hello external world');
+  assert.strictEqual(createExternalString(buf), 'hello external world');
+  assert.strictEqual(createExternalString(buf, 6), 'external world');
+  assert.strictEqual(createExternalString(buf, 6, 14), 'external');
+  assert.strictEqual(createExternalString(buf, 5, 5), '');
+  assert.strictEqual(createExternalString(buf.subarray(15)), 'world');
+  assert.strictEqual(createExternalString(Buffer.alloc(0)), '');
+  assert.strictEqual(createExternalString(new Uint8Array([0x61, 0x62])), 'ab');
+}
+
+{
+  const buf = Buffer.from('abcdéf');
+  assert.strictEqual(createExternalString(buf, 0, 4), 'abcd');
+  assert.throws(() => createExternalString(buf), {
+    code: 'ERR_INVALID_ARG_VALUE',
+    name: 'TypeError'
+  });
+  assert.throws(() => createExternalString(buf, 0, 100), {
+    code: 'ERR_OUT_OF_RANGE',
+    name: 'RangeError'
+  });
+}
+
+[undefined, null, 'abc', [], {}].forEach((value) => {
+  assert.throws(() => createExternalString(value), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    name: 'TypeError'
+  });
+});
+
+assert.throws(
+  () => createExternalString(Buffer.from(new SharedArrayBuffer(4))),
+  { code: 'ERR_INVALID_ARG_VALUE', name: 'TypeError' });
+
+// The string stays valid after the Buffer is no longer reachable.
+{
+  let str = createExternalString(Buffer.from('x'.repeat(1 << 20)));
+  global.gc();
+  assert.strictEqual(str.length, 1 << 20);
+  assert.strictEqual(str, 'x'.repeat(1 << 20));
+  str = null;
+  global.gc();
+}
+
+// Transferring the ArrayBuffer copies it instead of detaching it.
+{
+  const buf = Buffer.from('transferred'.repeat(100));
+  const str = createExternalString(buf);
+  const { port1, port2 } = new MessageChannel();
+  port2.once('message', common.mustCall((ab) => {
+    assert.strictEqual(ab.byteLength, buf.buffer.byteLength);
+    assert.notStrictEqual(buf.buffer.byteLength, 0);
+    assert.strictEqual(str, 'transferred'.repeat(100));
+    port2.close();
+  }));
+  port1.postMessage(buf.buffer, [buf.buffer]);
+}
@@ -0,0 +1,84 @@
+'use strict';
+require('../common');
+
+// Checks the UTF-8 encoding of one-byte and two-byte strings against a
+// straightforward implementation, including strings that are longer than the
+// chunks that they are copied out in, and writes into too small buffers.
+
+const assert = require('assert');
+const { TextEncoder } = require('util');
+
+function encode(str) {
+  const bytes = [];
+  for (let i = 0; i < str.length; i++) {
+    let c = str.charCodeAt(i);
+    if (c >= 0xD800 && c <= 0xDBFF && i + 1 < str.length) {
+      const next = str.charCodeAt(i + 1);
+      if (next >= 0xDC00 && next <= 0xDFFF) {
+        c = 0x10000 + ((c - 0xD800) << 10) + (next - 0xDC00);
+        i++;
+      }
+    }
+    if (c >= 0xD800 && c <= 0xDFFF)
+      c = 0xFFFD;
+    if (c < 0x80) {
+      bytes.push(c);
+    } else if (c < 0x800) {
+      bytes.push(0xC0 | (c >> 6), 0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+      bytes.push(0xE0 | (c >> 12), 0x80 | ((c >> 6) & 0x3F),
+                 0x80 | (c & 0x3F));
+    } else {
+      bytes.push(0xF0 | (c >> 18), 0x80 | ((c >> 12) & 0x3F),
+                 0x80 | ((c >> 6) & 0x3F), 0x80 | (c & 0x3F));
+    }
+  }
+  return Buffer.from(bytes);
+}
+
+const encoder = new TextEncoder();
+const strings = [
+  '',
+  'a',
+  'hello world, this is plain ASCII text',
+  'café naïveté ÿ',
+  '\x80'.repeat(33),
+  'a'.repeat(31) + 'é' + 'a'.repeat(31),
+  '中文字符串測試',
+  '😀 emoji 😀',
+  '\uD800',
+  'a\uDC00b',
+  '\uDBFF􏿿',
+  'a'.repeat(2047) + '😀' + 'b'.repeat(10),
+  'é'.repeat(5000),
+  '中'.repeat(3000) + '😀'.repeat(3000) + '\uD83D',
+  'x'.repeat(100000),
+];
+
+for (const str of strings) {
+  const expected = encode(str);
+  assert.deepStrictEqual(Buffer.from(str), expected);
+  assert.deepStrictEqual(Buffer.from(str, 'utf8'), expected);
+  assert.deepStrictEqual(Buffer.from(encoder.encode(str)), expected);
+  assert.strictEqual(Buffer.byteLength(str), expected.length);
+
+  // Too small destinations are filled up to the last complete character.
+  for (const size of [0, 1, 2, 3, expected.length >> 1, expected.length - 1]) {
+    if (size < 0 || size > expected.length)
+      continue;
+    const dest = new Uint8Array(size);
+    const { read, written } = encoder.encodeInto(str, dest);
+    const prefix = encode(str.slice(0, read));
+    assert.strictEqual(written, prefix.length);
+    assert.ok(written <= size);
+    assert.deepStrictEqual(Buffer.from(dest.subarray(0, written)), prefix);
+    if (read < str.length) {
+      const next = String.fromCodePoint(str.codePointAt(read));
+      assert.ok(written + encode(next).length > size);
+    }
+
+    const buf = Buffer.alloc(size);
+    assert.strictEqual(buf.write(str), written);
+    assert.deepStrictEqual(buf.subarray(0, written), prefix);
+  }
+}
@@ -605,3 +605,24 @@ assert.strictEqual(reallyLong.lastIndexOf(pattern), 0);
   assert.strictEqual(haystack.indexOf(needle), 2);
   assert.strictEqual(haystack.lastIndexOf(needle), haystack.length - 3);
 }
+
+// Test needles up to and just past the length that is searched for
+// block-wise, at many alignments, in both directions.
+{
+  const haystack = Buffer.alloc(200, 'ab');
+  for (let length = 3; length <= 66; length++) {
+    const needle = Buffer.alloc(length, 'x');
+    needle[0] = 0x61;
+    needle[length - 1] = 0x62;
+    for (let pos = 0; pos + length <= haystack.length; pos += 7) {
+      const buf = Buffer.from(haystack);
+      needle.copy(buf, pos);
+      assert.strictEqual(buf.indexOf(needle), pos);
+      assert.strictEqual(buf.lastIndexOf(needle), pos);
+      assert.strictEqual(buf.indexOf(needle, pos + 1), -1);
+      if (pos > 0)
+        assert.strictEqual(buf.lastIndexOf(needle, pos - 1), -1);
+      assert.strictEqual(buf.includes(needle.toString()), true);
+    }
+  }
+}
@@ -0,0 +1,62 @@
+'use strict';
+require('../common');
+const assert = require('assert');
+
+const buf = Buffer.from('key: value\r\n\r\nbody\r\n');
+
+function check(values, ...args) {
+  const expected = args.pop();
+  assert.deepStrictEqual(buf.indexOfAny(values, ...args), expected);
+}
+
+check(['\r\n\r\n', ': '], { index: 3, valueIndex: 1 });
+check(['\r\n\r\n', ': '], 5, { index: 10, valueIndex: 0 });
+check(['\r\n\r\n', ': '], -4, { index: -1, valueIndex: -1 });
+check(['\r\n', '\r\n\r\n'], 5, { index: 10, valueIndex: 0 });
+check(['\r\n\r\n', '\r\n'], 5, { index: 10, valueIndex: 0 });
+check(['\n\n'], { index: -1, valueIndex: -1 });
+check(['body'], { index: 14, valueIndex: 0 });
+check([], { index: -1, valueIndex: -1 });
+check(['y', 'b', 'k'], { index: 0, valueIndex: 2 });
+check(['dy\r\n', 'x'], 10, { index: 16, valueIndex: 0 });
+check(['\r\n', 'body\r\n!'], 12, { index: 12, valueIndex: 0 });
+check(['body\r\n!', '\r\n'], 13, { index: 18, valueIndex: 1 });
+
+// Empty values match at the start of the search, like with indexOf().
+check(['x', ''], 3, { index: 3, valueIndex: 1 });
+check([''], 100, { index: buf.length, valueIndex: 0 });
+
+// Buffers, Uint8Arrays and encodings.
+check([Buffer.from('value'), new Uint8Array([0x62])],
+      { index: 5, valueIndex: 0 });
+check(['7661', '626f'], 'hex', { index: 5, valueIndex: 0 });
+check(['626f'], 0, 'hex', { index: 14, valueIndex: 0 });
+assert.deepStrictEqual(
+  Buffer.from('foé', 'latin1').indexOfAny(['é'], 'latin1'),
+  { index: 2, valueIndex: 0 });
+
+// Many values with different first bytes.
+{
+  const words = [];
+  for (let i = 0; i < 100; i++)
+    words.push(`w${i}x${String.fromCharCode(0x41 + i % 26)}`);
+  const text = Buffer.from(`${'-'.repeat(1000)}${words[42]}${words[7]}`);
+  assert.deepStrictEqual(text.indexOfAny(words),
+                         { index: 1000, valueIndex: 42 });
+  assert.deepStrictEqual(text.indexOfAny(words, 1001),
+                         { index: 1000 + words[42].length, valueIndex: 7 });
+}
+
+assert.throws(() => buf.indexOfAny('key'), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError'
+});
+assert.throws(() => buf.indexOfAny(['key', 1]), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  name: 'TypeError',
+  message: /"values\[1\]"/
+});
+assert.throws(() => buf.indexOfAny(['key'], 'nope'), {
+  code: 'ERR_UNKNOWN_ENCODING',
+  name: 'TypeError'
+});
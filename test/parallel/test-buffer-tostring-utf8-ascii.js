@@ -0,0 +1,45 @@
+'use strict';
+
+// ASCII-only UTF-8 input is turned into one-byte strings directly. Check that
+// a non-ASCII byte is noticed wherever it is, including in the blocks that
+// are checked at once and in external strings.
+
+require('../common');
+const assert = require('assert');
+const { StringDecoder } = require('string_decoder');
+
+for (const length of [1, 7, 8, 15, 16, 31, 32, 63, 64, 65, 200]) {
+  for (let offset = 0; offset < 8; offset++) {
+    const ascii = 'a'.repeat(length);
+    const buf = Buffer.from('x'.repeat(offset) + ascii).subarray(offset);
+    assert.strictEqual(buf.toString(), ascii);
+
+    for (const pos of [0, length >> 1, length - 1]) {
+      const copy = Buffer.from(buf);
+      copy[pos] = 0xe9;
+      const expected = `${ascii.slice(0, pos)}\ufffd${ascii.slice(pos + 1)}`;
+      assert.strictEqual(copy.toString(), expected);
+      assert.strictEqual(copy.toString('utf8', 0, length), expected);
+    }
+  }
+}
+
+// Large enough to become an external string.
+{
+  const ascii = 'abcdefghijklmnopqrstuvwxyz'.repeat(50000);
+  assert.strictEqual(Buffer.from(ascii).toString(), ascii);
+  const mixed = `${ascii}é${ascii}`;
+  assert.strictEqual(Buffer.from(mixed).toString(), mixed);
+}
+
+// StringDecoder, with characters that are split across chunks.
+{
+  const input = Buffer.from(`${'ascii '.repeat(20)}€é ${'x'.repeat(40)}`);
+  for (let split = 0; split <= input.length; split++) {
+    const decoder = new StringDecoder('utf8');
+    const output = decoder.write(input.subarray(0, split)) +
+                   decoder.write(input.subarray(split)) +
+                   decoder.end();
+    assert.strictEqual(output, input.toString());
+  }
+}
@@ -22,12 +22,16 @@ for (const key of canBeRequired) {
 // The computation has to be delayed until we have done loading modules
 const {
   compiledWithoutCache,
-  compiledWithCache
+  compiledWithCache,
+  compiledInSnapshot
 } = getCacheUsage();
 
+// The modules that are compiled when the startup snapshot is built are not
+// compiled again, with or without cache.
 const loadedModules = process.moduleLoadList
   .filter((m) => m.startsWith('NativeModule'))
-  .map((m) => m.replace('NativeModule ', ''));
+  .map((m) => m.replace('NativeModule ', ''))
+  .filter((m) => !compiledInSnapshot.has(m));
 
 // Cross-compiled binaries do not have code cache, verifies that the builtins
 // are all compiled without cache and we are doing the bookkeeping right.
@@ -68,4 +72,18 @@ if (!process.features.cached_builtins) {
     }
   }
   assert.strictEqual(wrong.length, 0, wrong.join('\n'));
+
+  // The scripts that are run during startup are in the startup profile that
+  // mkcodecache uses, so they have a code cache as well, even though they
+  // cannot be required.
+  if (isMainThread) {
+    for (const key of [
+      'internal/bootstrap/loaders',
+      'internal/bootstrap/node',
+      'internal/main/run_main_module'
+    ]) {
+      assert(compiledWithCache.has(key) || compiledInSnapshot.has(key),
+             `"${key}" should've been compiled with code cache`);
+    }
+  }
 }
@@ -0,0 +1,50 @@
+'use strict';
+const common = require('../common');
+const assert = require('assert');
+const async_hooks = require('async_hooks');
+const dns = require('dns');
+
+// Lookups for the same name that are in flight at the same time share a
+// getaddrinfo() call. Each of them keeps its own request and async context,
+// and its own `verbatim` setting.
+
+const options = [
+  { all: true },
+  { all: true, verbatim: true },
+  { all: true },
+];
+
+function lookupAll(callback) {
+  const results = [];
+  let pending = options.length;
+  options.forEach((opts, index) => {
+    dns.lookup('localhost', opts, common.mustCall((err, res) => {
+      assert.ifError(err);
+      results[index] = { res, asyncId: async_hooks.executionAsyncId() };
+      if (--pending === 0)
+        callback(results);
+    }));
+  });
+}
+
+// Look the name up one option at a time first, to know what to expect.
+const expected = [];
+function lookupSequentially(index) {
+  if (index === options.length)
+    return lookupAll(common.mustCall(check));
+  dns.lookup('localhost', options[index], common.mustCall((err, res) => {
+    assert.ifError(err);
+    expected[index] = res;
+    lookupSequentially(index + 1);
+  }));
+}
+lookupSequentially(0);
+
+function check(results) {
+  const asyncIds = new Set();
+  results.forEach(({ res, asyncId }, index) => {
+    assert.deepStrictEqual(res, expected[index]);
+    asyncIds.add(asyncId);
+  });
+  assert.strictEqual(asyncIds.size, options.length);
+}
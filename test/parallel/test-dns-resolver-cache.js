@@ -0,0 +1,102 @@
+'use strict';
+const common = require('../common');
+const dnstools = require('../common/dns');
+const { Resolver } = require('dns');
+const dnsPromises = require('dns').promises;
+const assert = require('assert');
+const dgram = require('dgram');
+
+const kNxDomainFlags = 0x8183;
+
+const server = dgram.createSocket('udp4');
+
+// Identical queries in flight and queries for cached answers never reach the
+// server, so it only sees the first query for each name.
+server.on('message', common.mustCall((msg, { address, port }) => {
+  const parsed = dnstools.parseDNSPacket(msg);
+  const { domain, type } = parsed.questions[0];
+
+  if (domain === 'example.org') {
+    assert.strictEqual(type, 'A');
+    server.send(dnstools.writeDNSPacket({
+      id: parsed.id,
+      questions: parsed.questions,
+      answers: [
+        { type: 'A', domain, address: '1.2.3.4', ttl: 60 },
+        { type: 'A', domain, address: '5.6.7.8', ttl: 30 }
+      ]
+    }), port, address);
+  } else {
+    assert.strictEqual(domain, 'missing.org');
+    assert.strictEqual(type, 'AAAA');
+    server.send(dnstools.writeDNSPacket({
+      id: parsed.id,
+      flags: kNxDomainFlags,
+      questions: parsed.questions,
+      answers: []
+    }), port, address);
+  }
+}, 2));
+
+server.bind(0, common.mustCall(async () => {
+  const resolver = new dnsPromises.Resolver({ cache: true });
+  resolver.setServers([`127.0.0.1:${server.address().port}`]);
+
+  const results = await Promise.all([
+    resolver.resolve4('example.org'),
+    resolver.resolve4('example.org'),
+    resolver.resolve4('example.org')
+  ]);
+  for (const addresses of results)
+    assert.deepStrictEqual(addresses, ['1.2.3.4', '5.6.7.8']);
+
+  const cached = await resolver.resolve4('Example.ORG', { ttl: true });
+  assert.deepStrictEqual(cached.map(({ address }) => address),
+                         ['1.2.3.4', '5.6.7.8']);
+  assert.ok(cached[0].ttl <= 60 && cached[0].ttl >= 58);
+  assert.ok(cached[1].ttl <= 30 && cached[1].ttl >= 28);
+
+  for (let i = 0; i < 2; i++) {
+    await assert.rejects(resolver.resolve6('missing.org'),
+                         { code: 'ENOTFOUND' });
+  }
+
+  assert.deepStrictEqual(resolver.getCacheStats(), {
+    hits: 2,
+    misses: 2,
+    coalesced: 2,
+    entries: 2
+  });
+
+  server.close();
+}));
+
+assert.deepStrictEqual(new Resolver().getCacheStats(), {
+  hits: 0,
+  misses: 0,
+  coalesced: 0,
+  entries: 0
+});
+
+[Resolver, dnsPromises.Resolver].forEach((ResolverClass) => {
+  [null, 'cache', 42].forEach((options) => {
+    assert.throws(() => new ResolverClass(options), {
+      code: 'ERR_INVALID_ARG_TYPE',
+      name: 'TypeError'
+    });
+  });
+  assert.throws(() => new ResolverClass({ cache: 'yes' }), {
+    code: 'ERR_INVALID_ARG_TYPE',
+    name: 'TypeError'
+  });
+  assert.throws(() => new ResolverClass({ cache: { maxEntries: 0 } }), {
+    code: 'ERR_OUT_OF_RANGE',
+    name: 'RangeError'
+  });
+  assert.throws(() => new ResolverClass({ cache: { maxTtl: -1 } }), {
+    code: 'ERR_OUT_OF_RANGE',
+    name: 'RangeError'
+  });
+  new ResolverClass({ cache: false });
+  new ResolverClass({ cache: { maxTtl: 10, negativeTtl: 0 } });
+});
@@ -0,0 +1,116 @@
+'use strict';
+const common = require('../common');
+const dnstools = require('../common/dns');
+const dns = require('dns');
+const assert = require('assert');
+const dgram = require('dgram');
+const http = require('http');
+
+// resolver.lookup() resolves names like dns.lookup() does, with the queries
+// and the cache of the resolver.
+
+const kNxDomainFlags = 0x8183;
+
+const records = {
+  'example.org': {
+    A: [{ address: '1.2.3.4' }],
+    AAAA: [{ address: '::42' }]
+  },
+  'v6only.org': {
+    A: [],
+    AAAA: [{ address: '::5' }]
+  },
+  'local.test': {
+    A: [{ address: '127.0.0.1' }],
+    AAAA: []
+  }
+};
+
+function toPromise(lookup, hostname, options) {
+  return new Promise((resolve, reject) => {
+    lookup(hostname, options, (err, address, family) => {
+      if (err)
+        reject(err);
+      else
+        resolve(family === undefined ? address : { address, family });
+    });
+  });
+}
+
+const queries = [];
+const server = dgram.createSocket('udp4');
+
+server.on('message', (msg, { address, port }) => {
+  const parsed = dnstools.parseDNSPacket(msg);
+  const { domain, type } = parsed.questions[0];
+  queries.push(`${type} ${domain}`);
+
+  const answers = records[domain] && records[domain][type];
+  server.send(dnstools.writeDNSPacket({
+    id: parsed.id,
+    flags: answers === undefined ? kNxDomainFlags : undefined,
+    questions: parsed.questions,
+    answers: (answers || []).map((answer) => ({
+      type, domain, ttl: 60, ...answer
+    }))
+  }), port, address);
+});
+
+server.bind(0, common.mustCall(async () => {
+  const resolver = new dns.Resolver({ cache: true });
+  resolver.setServers([`127.0.0.1:${server.address().port}`]);
+  const resolverLookup = resolver.lookup.bind(resolver);
+  const lookup = (hostname, options) =>
+    toPromise(resolverLookup, hostname, options);
+
+  assert.deepStrictEqual(await lookup('example.org'),
+                         { address: '1.2.3.4', family: 4 });
+  assert.deepStrictEqual(await lookup('example.org', { family: 6 }),
+                         { address: '::42', family: 6 });
+  assert.deepStrictEqual(await lookup('example.org', { all: true }), [
+    { address: '1.2.3.4', family: 4 },
+    { address: '::42', family: 6 }
+  ]);
+  assert.deepStrictEqual(await lookup('v6only.org'),
+                         { address: '::5', family: 6 });
+  assert.deepStrictEqual(queries, [
+    'A example.org',
+    'AAAA example.org',
+    'A v6only.org',
+    'AAAA v6only.org'
+  ]);
+
+  // IP addresses are returned without a query.
+  assert.deepStrictEqual(await lookup('127.0.0.1'),
+                         { address: '127.0.0.1', family: 4 });
+  assert.deepStrictEqual(await lookup('::1', { all: true }),
+                         [{ address: '::1', family: 6 }]);
+
+  // Names that the server does not know are looked up with dns.lookup().
+  assert.deepStrictEqual(
+    await lookup('localhost', { all: true }),
+    await toPromise(dns.lookup, 'localhost', { all: true }));
+
+  assert.throws(() => resolver.lookup('example.org', { family: 5 }, () => {}),
+                { code: 'ERR_INVALID_OPT_VALUE' });
+  assert.throws(() => resolver.lookup('example.org', {}),
+                { code: 'ERR_INVALID_CALLBACK' });
+
+  // It can take the place of dns.lookup() in networking APIs.
+  const httpServer = http.createServer(common.mustCall((req, res) => {
+    res.end('ok');
+  }));
+  httpServer.listen(0, '127.0.0.1', common.mustCall(() => {
+    const { port } = httpServer.address();
+    const options = { lookup: resolverLookup };
+    http.get(`http://local.test:${port}/`, options, common.mustCall((res) => {
+      res.resume();
+      res.on('end', common.mustCall(() => {
+        assert.strictEqual(queries.filter((q) => q.endsWith('local.test'))
+                                  .length, 1);
+        httpServer.close();
+        server.close();
+      }));
+    }));
+  }));
+}));
@@ -0,0 +1,164 @@
+'use strict';
+const common = require('../common');
+
+// Test fs.copyTree(), which copies a directory tree in a single request.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+const { COPYFILE_EXCL } = fs.constants;
+
+tmpdir.refresh();
+
+const src = path.join(tmpdir.path, 'src');
+let fileCount = 0;
+let dirCount = 1;
+(function makeTree(dir, depth) {
+  fs.mkdirSync(dir);
+  for (let i = 0; i < 5; i++) {
+    fs.writeFileSync(path.join(dir, `file-${i}`), `${dir} ${i}`);
+    fileCount++;
+  }
+  if (depth === 0)
+    return;
+  for (let i = 0; i < 3; i++) {
+    makeTree(path.join(dir, `dir-${i}`), depth - 1);
+    dirCount++;
+  }
+})(src, 3);
+fs.mkdirSync(path.join(src, 'empty'));
+dirCount++;
+
+const canSymlink = common.canCreateSymLink();
+if (canSymlink) {
+  fs.symlinkSync('file-0', path.join(src, 'link'));
+  fileCount++;
+}
+
+// Returns the entries below `dir` with their contents.
+function readTree(dir) {
+  const result = {};
+  (function read(relative) {
+    for (const dirent of fs.readdirSync(path.join(dir, relative),
+                                        { withFileTypes: true })) {
+      const name = path.join(relative, dirent.name);
+      const full = path.join(dir, name);
+      if (dirent.isDirectory()) {
+        result[name] = 'dir';
+        read(name);
+      } else if (dirent.isSymbolicLink()) {
+        result[name] = `link ${fs.readlinkSync(full)}`;
+      } else {
+        result[name] = fs.readFileSync(full, 'utf8');
+      }
+    }
+  })('');
+  return result;
+}
+
+const expected = readTree(src);
+
+{
+  const dest = path.join(tmpdir.path, 'dest-callback');
+  fs.copyTree(src, dest, common.mustCall((err, result) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(result, {
+      files: fileCount,
+      directories: dirCount
+    });
+    assert.deepStrictEqual(readTree(dest), expected);
+
+    // Existing directories are merged into and files are overwritten.
+    fs.writeFileSync(path.join(dest, 'file-0'), 'changed');
+    fs.writeFileSync(path.join(dest, 'extra'), 'extra');
+    fs.copyTree(src, dest, common.mustCall((err) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(readTree(dest),
+                             { ...expected, extra: 'extra' });
+
+      fs.copyTree(src, dest, COPYFILE_EXCL, common.mustCall((err) => {
+        assert.strictEqual(err.code, 'EEXIST');
+      }));
+    }));
+  }));
+}
+
+(async () => {
+  const dest = path.join(tmpdir.path, 'dest-promise');
+  const result = await fs.promises.copyTree(src, dest);
+  assert.strictEqual(result.files, fileCount);
+  assert.deepStrictEqual(readTree(dest), expected);
+
+  // A single file.
+  const file = path.join(tmpdir.path, 'single-file');
+  assert.deepStrictEqual(
+    await fs.promises.copyTree(path.join(src, 'file-1'), file),
+    { files: 1, directories: 0 });
+  assert.strictEqual(fs.readFileSync(file, 'utf8'), `${src} 1`);
+
+  await assert.rejects(
+    fs.promises.copyTree(path.join(tmpdir.path, 'missing'), dest), {
+      code: 'ENOENT',
+      syscall: 'lstat'
+    });
+})().then(common.mustCall());
+
+{
+  // Progress is reported after every directory, and only ever grows.
+  const dest = path.join(tmpdir.path, 'dest-progress');
+  const reports = [];
+  const onProgress = (progress) => reports.push(progress);
+  fs.copyTree(src, dest, { onProgress }, common.mustCall((err, result) => {
+    assert.ifError(err);
+    assert(reports.length > 0);
+    assert(reports.length <= dirCount);
+    let last = { files: 0, directories: 0 };
+    for (const report of reports) {
+      assert(report.files >= last.files);
+      assert(report.directories >= last.directories);
+      last = report;
+    }
+    assert.deepStrictEqual(last, result);
+  }));
+}
+
+if (!common.isWindows) {
+  // Read-only directories are copied with their contents, and get their mode
+  // once they have been filled.
+  const readOnly = path.join(tmpdir.path, 'read-only');
+  fs.mkdirSync(path.join(readOnly, 'sub'), { recursive: true });
+  fs.writeFileSync(path.join(readOnly, 'sub', 'file'), 'file');
+  fs.chmodSync(path.join(readOnly, 'sub'), 0o555);
+  fs.chmodSync(readOnly, 0o500);
+  const dest = path.join(tmpdir.path, 'dest-read-only');
+  fs.copyTree(readOnly, dest, common.mustCall((err, result) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(result, { files: 1, directories: 2 });
+    assert.strictEqual(fs.statSync(dest).mode & 0o777, 0o500);
+    assert.strictEqual(fs.statSync(path.join(dest, 'sub')).mode & 0o777,
+                       0o555);
+    assert.strictEqual(
+      fs.readFileSync(path.join(dest, 'sub', 'file'), 'utf8'), 'file');
+    // Let tmpdir remove the trees again.
+    for (const dir of [readOnly, dest]) {
+      fs.chmodSync(dir, 0o755);
+      fs.chmodSync(path.join(dir, 'sub'), 0o755);
+    }
+  }));
+}
+
+for (const options of [null, 'flags', { onProgress: 1 }]) {
+  assert.throws(() => fs.copyTree(src, 'dest', options, common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_TYPE'
+  });
+}
+
+for (const dest of [src, path.join(src, 'dir-0')]) {
+  assert.throws(() => fs.copyTree(src, dest, common.mustNotCall()), {
+    code: 'ERR_INVALID_ARG_VALUE'
+  });
+}
+assert.throws(() => fs.copyTree(src, 'dest'), {
+  code: 'ERR_INVALID_CALLBACK'
+});
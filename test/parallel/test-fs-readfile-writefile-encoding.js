@@ -0,0 +1,69 @@
+'use strict';
+const common = require('../common');
+
+// Test that fs.readFile() and fs.writeFile(), which open, read or write, and
+// close the file in a single request, decode and encode the contents like
+// the Buffer methods do, and leave file descriptors that they are given open.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const text = 'hello wörld €\n'.repeat(10000);
+const encodings = ['utf8', 'utf16le', 'latin1', 'hex', 'base64'];
+
+for (const encoding of encodings) {
+  const file = path.join(tmpdir.path, `callback-${encoding}.txt`);
+  const expected = Buffer.from(text, encoding).toString(encoding);
+  fs.writeFile(file, text, encoding, common.mustCall((err) => {
+    assert.ifError(err);
+    assert.deepStrictEqual(fs.readFileSync(file), Buffer.from(text, encoding));
+    fs.readFile(file, encoding, common.mustCall((err, data) => {
+      assert.ifError(err);
+      assert.strictEqual(data, expected);
+    }));
+    fs.readFile(file, common.mustCall((err, data) => {
+      assert.ifError(err);
+      assert.deepStrictEqual(data, Buffer.from(text, encoding));
+    }));
+  }));
+}
+
+{
+  const file = path.join(tmpdir.path, 'promises.txt');
+  (async () => {
+    await fs.promises.writeFile(file, text, 'latin1');
+    assert.strictEqual(await fs.promises.readFile(file, 'latin1'),
+                       Buffer.from(text, 'latin1').toString('latin1'));
+    await fs.promises.writeFile(file, new Uint16Array([0x6968]));
+    assert.strictEqual(await fs.promises.readFile(file, 'utf8'), 'hi');
+    await fs.promises.writeFile(file, '');
+    assert.deepStrictEqual(await fs.promises.readFile(file), Buffer.alloc(0));
+    await assert.rejects(fs.promises.readFile(path.join(file, 'nope')), {
+      code: 'ENOTDIR',
+      syscall: 'open',
+      path: path.join(file, 'nope')
+    });
+  })().then(common.mustCall());
+}
+
+// Descriptors are read from and written at their current position, and are
+// not closed.
+{
+  const file = path.join(tmpdir.path, 'fd.txt');
+  fs.writeFileSync(file, 'abcdef');
+  const fd = fs.openSync(file, 'r+');
+  fs.readSync(fd, Buffer.alloc(2), 0, 2, null);
+  fs.readFile(fd, 'utf8', common.mustCall((err, data) => {
+    assert.ifError(err);
+    assert.strictEqual(data, 'cdef');
+    fs.writeFile(fd, 'gh', common.mustCall((err) => {
+      assert.ifError(err);
+      assert.strictEqual(fs.readFileSync(file, 'utf8'), 'abcdefgh');
+      fs.closeSync(fd);
+    }));
+  }));
+}
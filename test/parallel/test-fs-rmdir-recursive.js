@@ -212,3 +212,26 @@ function removeAsync(dir) {
     message: /^The value of "maxBusyTries" is out of range\./
   });
 }
+
+// Symbolic links to directories are removed, not followed.
+if (common.canCreateSymLink()) {
+  const target = path.join(tmpdir.path, 'rmdir-link-target');
+  const dir = path.join(tmpdir.path, 'rmdir-with-link');
+  fs.mkdirSync(target);
+  fs.writeFileSync(path.join(target, 'keep.txt'), 'keep');
+  fs.mkdirSync(dir);
+  fs.symlinkSync(target, path.join(dir, 'link'), 'dir');
+  const rootLink = path.join(tmpdir.path, 'rmdir-root-link');
+  fs.symlinkSync(target, rootLink, 'dir');
+
+  fs.rmdir(dir, { recursive: true }, common.mustCall((err) => {
+    assert.ifError(err);
+    assert(!fs.existsSync(dir));
+    fs.rmdir(rootLink, { recursive: true }, common.mustCall((err) => {
+      assert.ifError(err);
+      assert(!fs.existsSync(rootLink));
+      assert.strictEqual(
+        fs.readFileSync(path.join(target, 'keep.txt'), 'utf8'), 'keep');
+    }));
+  }));
+}
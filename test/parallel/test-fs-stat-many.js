@@ -0,0 +1,102 @@
+'use strict';
+const common = require('../common');
+
+// Test fs.statMany() and fs.lstatMany(), which stat many paths in one call
+// and return the results in a StatsBatch.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const { getSystemErrorName } = require('util');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+// Enough paths to be split into several chunks on the threadpool.
+const paths = [];
+for (let i = 0; i < 1500; i++) {
+  const file = path.join(tmpdir.path, `file-${i}`);
+  if (i % 3 !== 0)
+    fs.writeFileSync(file, 'x'.repeat(i));
+  paths.push(file);
+}
+
+function checkBatch(batch, bigint) {
+  assert.strictEqual(batch.length, paths.length);
+  assert.strictEqual(batch.errors.length, paths.length);
+  assert.strictEqual(batch.fields.length % paths.length, 0);
+  for (let i = 0; i < paths.length; i++) {
+    if (i % 3 === 0) {
+      assert.strictEqual(getSystemErrorName(batch.errors[i]), 'ENOENT');
+      assert.strictEqual(batch.getStats(i), undefined);
+      continue;
+    }
+    assert.strictEqual(batch.errors[i], 0);
+    const stats = batch.getStats(i);
+    const expected = fs.statSync(paths[i], { bigint });
+    assert.strictEqual(stats.size, expected.size);
+    assert.strictEqual(stats.ino, expected.ino);
+    assert.deepStrictEqual(stats.mtime, expected.mtime);
+    assert(stats.isFile());
+  }
+}
+
+fs.statMany(paths, common.mustCall((err, batch) => {
+  assert.ifError(err);
+  assert(batch.fields instanceof Float64Array);
+  checkBatch(batch, false);
+}));
+
+fs.statMany(paths, { bigint: true }, common.mustCall((err, batch) => {
+  assert.ifError(err);
+  assert(batch.fields instanceof BigUint64Array);
+  checkBatch(batch, true);
+}));
+
+fs.promises.statMany(paths).then(common.mustCall((batch) => {
+  checkBatch(batch, false);
+}));
+
+fs.statMany([], common.mustCall((err, batch) => {
+  assert.ifError(err);
+  assert.strictEqual(batch.length, 0);
+}));
+
+fs.promises.lstatMany([], { bigint: true }).then(common.mustCall((batch) => {
+  assert.strictEqual(batch.length, 0);
+  assert(batch.fields instanceof BigUint64Array);
+}));
+
+if (common.canCreateSymLink()) {
+  const link = path.join(tmpdir.path, 'link');
+  fs.symlinkSync(paths[1], link);
+  fs.lstatMany([link, paths[1]], common.mustCall((err, batch) => {
+    assert.ifError(err);
+    assert(batch.getStats(0).isSymbolicLink());
+    assert(batch.getStats(1).isFile());
+  }));
+  fs.statMany([link], common.mustCall((err, batch) => {
+    assert.ifError(err);
+    assert(batch.getStats(0).isFile());
+  }));
+}
+
+fs.statMany([paths[1]], common.mustCall((err, batch) => {
+  assert.ifError(err);
+  assert.throws(() => batch.getStats(1), { code: 'ERR_OUT_OF_RANGE' });
+  assert.throws(() => batch.getStats(-1), { code: 'ERR_OUT_OF_RANGE' });
+}));
+
+assert.throws(() => fs.statMany('file', common.mustNotCall()), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => fs.statMany([paths[0], 1], common.mustNotCall()), {
+  code: 'ERR_INVALID_ARG_TYPE',
+  message: /paths\[1\]/
+});
+assert.throws(() => fs.statMany([paths[0]]), {
+  code: 'ERR_INVALID_CALLBACK'
+});
+assert.rejects(fs.promises.statMany(null), {
+  code: 'ERR_INVALID_ARG_TYPE'
+}).then(common.mustCall());
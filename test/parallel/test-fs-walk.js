@@ -0,0 +1,161 @@
+'use strict';
+const common = require('../common');
+
+// Test fs.walk(), which walks a directory tree natively and returns its
+// entries in batches.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const root = path.join(tmpdir.path, 'tree');
+const files = [
+  'a.txt',
+  'b/c.txt',
+  'b/d/e.txt',
+  'b/d/f/g.txt',
+  'node_modules/h.js',
+  'i/node_modules/j.js'
+];
+for (const file of files) {
+  fs.mkdirSync(path.join(root, path.dirname(file)), { recursive: true });
+  fs.writeFileSync(path.join(root, file), file);
+}
+fs.mkdirSync(path.join(root, 'empty'));
+
+// Returns the entries that fs.walk() should report, the same way.
+function expectedEntries(dir, depth, maxDepth, skip) {
+  const result = [];
+  for (const dirent of fs.readdirSync(path.join(root, dir),
+                                      { withFileTypes: true })) {
+    if (skip.includes(dirent.name))
+      continue;
+    const relative = dir ? path.join(dir, dirent.name) : dirent.name;
+    result.push({ path: relative, depth, isDirectory: dirent.isDirectory() });
+    if (dirent.isDirectory() && depth < maxDepth)
+      result.push(...expectedEntries(relative, depth + 1, maxDepth, skip));
+  }
+  return result;
+}
+
+async function collect(walker) {
+  const result = [];
+  for await (const batch of walker) {
+    assert(batch.length > 0);
+    for (let i = 0; i < batch.length; i++) {
+      const dirent = batch.getDirent(i);
+      assert.strictEqual(dirent.name, batch.getPath(i));
+      assert.strictEqual(batch.getError(i), 0);
+      result.push({
+        path: batch.getPath(i),
+        depth: batch.getDepth(i),
+        isDirectory: dirent.isDirectory()
+      });
+    }
+  }
+  return result;
+}
+
+function sortByPath(entries) {
+  return entries.sort((a, b) => (a.path < b.path ? -1 : 1));
+}
+
+(async () => {
+  assert.deepStrictEqual(
+    sortByPath(await collect(fs.walk(root))),
+    sortByPath(expectedEntries('', 0, Infinity, [])));
+
+  // Small batches.
+  assert.deepStrictEqual(
+    sortByPath(await collect(fs.walk(root, { batchSize: 2 }))),
+    sortByPath(expectedEntries('', 0, Infinity, [])));
+
+  assert.deepStrictEqual(
+    sortByPath(await collect(fs.walk(root, { maxDepth: 1 }))),
+    sortByPath(expectedEntries('', 0, 1, [])));
+
+  assert.deepStrictEqual(
+    sortByPath(await collect(fs.walk(root, { skip: ['node_modules'] }))),
+    sortByPath(expectedEntries('', 0, Infinity, ['node_modules'])));
+
+  // Parents are reported before their children.
+  const entries = await collect(fs.walk(root));
+  for (const [index, entry] of entries.entries()) {
+    if (entry.depth > 0) {
+      const parent = path.dirname(entry.path);
+      assert(entries.findIndex((e) => e.path === parent) < index);
+    }
+  }
+
+  // Stats.
+  for await (const batch of fs.walk(root, { stats: true })) {
+    for (let i = 0; i < batch.length; i++) {
+      const expected = fs.lstatSync(path.join(root, batch.getPath(i)));
+      const stats = batch.getStats(i);
+      assert.strictEqual(stats.ino, expected.ino);
+      assert.strictEqual(stats.size, expected.size);
+      assert.strictEqual(stats.isDirectory(), expected.isDirectory());
+    }
+  }
+  for await (const batch of fs.walk(root)) {
+    assert.strictEqual(batch.getStats(0), undefined);
+    assert.throws(() => batch.getPath(batch.length), {
+      code: 'ERR_OUT_OF_RANGE'
+    });
+  }
+
+  // Buffer paths.
+  for await (const batch of fs.walk(root, 'buffer')) {
+    assert(Buffer.isBuffer(batch.getPath(0)));
+  }
+
+  // read() and close().
+  const walker = fs.walk(root, { batchSize: 1 });
+  assert.strictEqual(walker.path, root);
+  const [first, second] = await Promise.all([walker.read(), walker.read()]);
+  assert.strictEqual(first.length, 1);
+  assert.strictEqual(second.length, 1);
+  assert.notStrictEqual(first.getPath(0), second.getPath(0));
+  await walker.close();
+  assert.throws(() => walker.read(), { code: 'ERR_DIR_CLOSED' });
+
+  // Leaving the loop early closes the walker.
+  // eslint-disable-next-line no-unused-vars
+  for await (const batch of fs.walk(root, { batchSize: 1 }))
+    break;
+
+  await assert.rejects(fs.walk(path.join(tmpdir.path, 'missing')).read(), {
+    code: 'ENOENT',
+    syscall: 'opendir'
+  });
+  await assert.rejects(fs.walk(path.join(root, 'a.txt')).read(), {
+    code: 'ENOTDIR'
+  });
+
+  assert.deepStrictEqual(await collect(fs.walk(path.join(root, 'empty'))), []);
+})().then(common.mustCall());
+
+if (common.canCreateSymLink()) {
+  // Symbolic links are reported but not followed.
+  const linkRoot = path.join(tmpdir.path, 'links');
+  fs.mkdirSync(linkRoot);
+  fs.symlinkSync(linkRoot, path.join(linkRoot, 'self'), 'dir');
+  collect(fs.walk(linkRoot)).then(common.mustCall((entries) => {
+    assert.deepStrictEqual(entries, [
+      { path: 'self', depth: 0, isDirectory: false }
+    ]);
+  }));
+}
+
+assert.throws(() => fs.walk(root, { maxDepth: -1 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+assert.throws(() => fs.walk(root, { skip: 'node_modules' }), {
+  code: 'ERR_INVALID_ARG_TYPE'
+});
+assert.throws(() => fs.walk(root, { batchSize: 0 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
@@ -0,0 +1,97 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.isLinux)
+  common.skip('inotify based recursive watching is linux specific');
+
+const assert = require('assert');
+const path = require('path');
+const fs = require('fs');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+assert.throws(() => fs.watch(tmpdir.path, { coalesceWindow: -1 }), {
+  code: 'ERR_OUT_OF_RANGE'
+});
+
+// Files are watched as usual.
+{
+  const file = path.join(tmpdir.path, 'file.txt');
+  fs.writeFileSync(file, 'hello');
+  const watcher = fs.watch(file, { recursive: true });
+  watcher.on('change', common.mustCall((event, filename) => {
+    assert.strictEqual(filename, 'file.txt');
+    watcher.close();
+  }));
+  fs.writeFileSync(file, 'world');
+}
+
+// Subdirectories that are created later are watched too, and events in
+// different trees arrive at their own watchers.
+{
+  const root = path.join(tmpdir.path, 'root');
+  const other = path.join(tmpdir.path, 'other');
+  fs.mkdirSync(root);
+  fs.mkdirSync(other);
+
+  const otherWatcher = fs.watch(other, { recursive: true });
+  otherWatcher.on('change', common.mustNotCall());
+
+  const nested = path.join('a', 'b', 'c');
+  const target = path.join(nested, 'file.txt');
+  const watcher = fs.watch(root, { recursive: true, coalesceWindow: 50 });
+  const seen = new Set();
+  watcher.on('change', (event, filename) => {
+    assert.ok(event === 'change' || event === 'rename');
+    seen.add(`${event} ${filename}`);
+    if (filename === target && event === 'change') {
+      watcher.close();
+      otherWatcher.close();
+    }
+  });
+  watcher.on('close', common.mustCall(() => {
+    assert.ok(seen.has(`rename ${path.join('a', 'b')}`));
+  }));
+
+  fs.mkdirSync(path.join(root, nested), { recursive: true });
+  // Wait until the watch for the new directories is in place.
+  const interval = setInterval(() => {
+    fs.appendFileSync(path.join(root, target), 'x');
+    if (seen.has(`change ${target}`))
+      clearInterval(interval);
+  }, 20);
+}
+
+// Existing trees are watched in the background, without emitting events for
+// what they already contain. Directories that cannot be read are skipped
+// rather than failing the watcher.
+{
+  const root = path.join(tmpdir.path, 'existing');
+  const dirs = [];
+  for (let i = 0; i < 10; i++) {
+    for (let j = 0; j < 20; j++)
+      dirs.push(path.join(`dir-${i}`, `sub-${j}`));
+  }
+  for (const dir of dirs)
+    fs.mkdirSync(path.join(root, dir), { recursive: true });
+  const target = path.join(dirs[dirs.length - 1], 'file.txt');
+  fs.writeFileSync(path.join(root, target), '');
+
+  const unreadable = path.join(root, 'unreadable');
+  fs.mkdirSync(path.join(unreadable, 'child'), { recursive: true });
+  fs.chmodSync(unreadable, 0);
+
+  const watcher = fs.watch(root, { recursive: true });
+  watcher.on('error', common.mustNotCall());
+  watcher.on('change', common.mustCallAtLeast((event, filename) => {
+    assert.strictEqual(filename, target);
+    watcher.close();
+    clearInterval(interval);
+    fs.chmodSync(unreadable, 0o755);
+  }));
+  const interval = setInterval(() => {
+    fs.appendFileSync(path.join(root, target), 'x');
+  }, 20);
+}
@@ -0,0 +1,32 @@
+'use strict';
+
+const common = require('../common');
+
+if (!common.isLinux)
+  common.skip('inotify hints are only used on Linux');
+if (!common.isMainThread)
+  common.skip('process.chdir is not available in Workers');
+
+// On Linux, changes that inotify reports make fs.watchFile() poll a file
+// right away. Check that this works for relative paths as well, with an
+// interval that is too long for the change to be noticed by polling.
+
+const assert = require('assert');
+const fs = require('fs');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+process.chdir(tmpdir.path);
+
+fs.writeFileSync('relative.txt', 'hello');
+
+const interval = 1e6;
+fs.watchFile('relative.txt', { interval }, common.mustCall((curr, prev) => {
+  assert.strictEqual(prev.size, 5);
+  assert.strictEqual(curr.size, 11);
+  fs.unwatchFile('relative.txt');
+}));
+
+// Give the poller time to record the current stats.
+setTimeout(() => fs.writeFileSync('relative.txt', 'hello world'),
+           common.platformTimeout(100));
@@ -0,0 +1,42 @@
+'use strict';
+
+const common = require('../common');
+
+// fs.watchFile() watchers share a poller. Check that changes arrive at the
+// right watchers, and that watchers can be stopped while changes are
+// delivered.
+
+const assert = require('assert');
+const fs = require('fs');
+const path = require('path');
+
+const tmpdir = require('../common/tmpdir');
+tmpdir.refresh();
+
+const files = [];
+for (let i = 0; i < 20; i++) {
+  const file = path.join(tmpdir.path, `file-${i}.txt`);
+  fs.writeFileSync(file, 'hello');
+  files.push(file);
+}
+
+const changed = files[7];
+for (const file of files) {
+  if (file !== changed)
+    fs.watchFile(file, { interval: 10 }, common.mustNotCall());
+}
+
+// Watchers that do not keep the process alive share the poller as well.
+const unreferenced = path.join(tmpdir.path, 'unreferenced.txt');
+fs.watchFile(unreferenced, { interval: 10, persistent: false }, () => {});
+
+fs.watchFile(changed, { interval: 10 }, common.mustCall((curr, prev) => {
+  assert.strictEqual(prev.size, 5);
+  assert.strictEqual(curr.size, 11);
+  for (const file of files)
+    fs.unwatchFile(file);
+}));
+
+// Give the pollers time to record the current stats.
+setTimeout(() => fs.writeFileSync(changed, 'hello world'),
+           common.platformTimeout(100));
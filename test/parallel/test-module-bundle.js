@@ -0,0 +1,80 @@
+'use strict';
+
+// Tests that --experimental-bundle serves module files from a bundle created
+// by tools/bundle/mkbundle.js, before it falls back to the file system.
+
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+const { createBundle } = require('../../tools/bundle/mkbundle');
+
+tmpdir.refresh();
+
+// The bundle resolves its paths against the real path of its directory.
+const root = fs.realpathSync(tmpdir.path);
+const bundle = path.join(root, 'app.bundle');
+const files = {
+  'node_modules/pkg/package.json': '{"main": "lib/main"}',
+  'node_modules/pkg/lib/main.js': 'module.exports = require("./data");',
+  'node_modules/pkg/lib/data.json': '{"value": "ünicode"}',
+  'esm/index.mjs': 'import dep from "./dep.mjs"; export default dep + 1;',
+  'esm/dep.mjs': 'export default 41;',
+  'main.js': `
+    const assert = require('assert');
+    assert.deepStrictEqual(require('pkg'), { value: 'ünicode' });
+    assert.strictEqual(require('./disk'), 'disk');
+    assert.throws(() => require('./missing'), { code: 'MODULE_NOT_FOUND' });
+    let imported = false;
+    import('./esm/index.mjs').then((ns) => {
+      assert.strictEqual(ns.default, 42);
+      imported = true;
+    });
+    process.on('exit', () => assert(imported));
+  `
+};
+
+for (const [name, content] of Object.entries(files)) {
+  const file = path.join(root, name);
+  fs.mkdirSync(path.dirname(file), { recursive: true });
+  fs.writeFileSync(file, content);
+}
+createBundle(bundle, Object.keys(files).map((name) => path.join(root, name)),
+             { codeCache: true });
+
+// Only the bundle has the files now, except for the one that is not in it.
+for (const name of Object.keys(files))
+  fs.unlinkSync(path.join(root, name));
+fs.writeFileSync(path.join(root, 'disk.js'), 'module.exports = "disk";');
+
+{
+  const child = spawnSync(process.execPath, [
+    `--experimental-bundle=${bundle}`,
+    '--experimental-modules',
+    '--no-warnings',
+    path.join(root, 'main.js')
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+}
+
+// Invalid bundles are refused at startup.
+function checkInvalid(file) {
+  const child = spawnSync(process.execPath,
+                          [`--experimental-bundle=${file}`, '-e', '0']);
+  assert.strictEqual(child.status, 9);
+  assert(child.stderr.toString().includes(`cannot load module bundle ${file}`),
+         child.stderr.toString());
+}
+
+checkInvalid(path.join(root, 'does-not-exist.bundle'));
+
+const garbage = path.join(root, 'garbage.bundle');
+fs.writeFileSync(garbage, 'this is not a bundle');
+checkInvalid(garbage);
+
+// An entry that points past the end of the file.
+const truncated = path.join(root, 'truncated.bundle');
+fs.writeFileSync(truncated, fs.readFileSync(bundle).subarray(0, 100));
+checkInvalid(truncated);
@@ -0,0 +1,84 @@
+'use strict';
+
+// Tests that --experimental-code-cache-dir writes the code cache of user
+// modules in the first run and uses it in the following ones.
+
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const cacheDir = path.join(tmpdir.path, 'cache');
+const dep = path.join(tmpdir.path, 'dep.js');
+const esm = path.join(tmpdir.path, 'dep.mjs');
+const entry = path.join(tmpdir.path, 'entry.js');
+
+fs.writeFileSync(dep, 'module.exports = (a, b) => a + b;');
+fs.writeFileSync(esm, 'export const mul = (a, b) => a * b;');
+fs.writeFileSync(entry, `
+  const { getCodeCacheStats } = require('module');
+  require('./dep.js');
+  process.on('exit', () => console.log(JSON.stringify(getCodeCacheStats())));
+`);
+
+function run(...flags) {
+  const child = spawnSync(process.execPath, [
+    `--experimental-code-cache-dir=${cacheDir}`,
+    ...flags,
+    entry
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  return JSON.parse(child.stdout.toString());
+}
+
+// Both the entry and its dependency are written in the first run...
+assert.deepStrictEqual(run(),
+                       { hits: 0, misses: 2, rejected: 0, written: 2 });
+assert.strictEqual(fs.readdirSync(cacheDir).length, 2);
+
+// ...and read in the second one.
+assert.deepStrictEqual(run(),
+                       { hits: 2, misses: 0, rejected: 0, written: 0 });
+
+// Changing a module invalidates its entry.
+fs.writeFileSync(dep, 'module.exports = (a, b) => b + a;');
+assert.deepStrictEqual(run(),
+                       { hits: 1, misses: 1, rejected: 0, written: 1 });
+
+// Without the option, nothing is recorded.
+{
+  const child = spawnSync(process.execPath, [entry]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.deepStrictEqual(JSON.parse(child.stdout.toString()),
+                         { hits: 0, misses: 0, rejected: 0, written: 0 });
+}
+
+// ES modules use the cache as well.
+{
+  const main = path.join(tmpdir.path, 'main.mjs');
+  fs.writeFileSync(main, `
+    import { mul } from './dep.mjs';
+    import module from 'module';
+    process.on('exit', () => {
+      console.log(JSON.stringify(module.getCodeCacheStats()));
+    });
+  `);
+  const args = [
+    '--experimental-modules',
+    '--no-warnings',
+    `--experimental-code-cache-dir=${cacheDir}`,
+    main
+  ];
+  let child = spawnSync(process.execPath, args);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.deepStrictEqual(JSON.parse(child.stdout.toString()),
+                         { hits: 0, misses: 2, rejected: 0, written: 2 });
+  child = spawnSync(process.execPath, args);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.deepStrictEqual(JSON.parse(child.stdout.toString()),
+                         { hits: 2, misses: 0, rejected: 0, written: 0 });
+}
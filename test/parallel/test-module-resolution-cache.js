@@ -0,0 +1,67 @@
+'use strict';
+
+// Tests that --experimental-resolution-cache persists the results of module
+// resolution and resolves modules from them in later runs.
+
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+const cacheFile = path.join(tmpdir.path, 'resolution.json');
+const pkg = path.join(tmpdir.path, 'node_modules', 'pkg');
+const entry = path.join(tmpdir.path, 'entry.js');
+
+fs.mkdirSync(path.join(pkg, 'lib'), { recursive: true });
+fs.writeFileSync(path.join(pkg, 'package.json'), '{"main": "lib/main"}');
+fs.writeFileSync(path.join(pkg, 'lib', 'main.js'), 'module.exports = 1;');
+fs.writeFileSync(path.join(tmpdir.path, 'local.json'), '2');
+fs.writeFileSync(entry, `
+  const assert = require('assert');
+  assert.strictEqual(require('pkg'), 1);
+  assert.strictEqual(require('./local'), 2);
+  assert.throws(() => require('missing'), { code: 'MODULE_NOT_FOUND' });
+
+  // Directory listings are only kept while a top-level require() runs, so a
+  // file that is created afterwards is found.
+  setImmediate(() => {
+    require('fs').writeFileSync(require('path').join(__dirname, 'late.js'),
+                                'module.exports = 3;');
+    assert.strictEqual(require('./late'), 3);
+  });
+`);
+
+function run() {
+  const child = spawnSync(process.execPath, [
+    `--experimental-resolution-cache=${cacheFile}`,
+    entry
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+}
+
+run();
+const { version, paths } = JSON.parse(fs.readFileSync(cacheFile, 'utf8'));
+assert.strictEqual(version, process.version);
+const resolved = Object.values(paths);
+assert(resolved.includes(fs.realpathSync(path.join(pkg, 'lib', 'main.js'))));
+assert(resolved.includes(
+  fs.realpathSync(path.join(tmpdir.path, 'local.json'))));
+
+// The next run uses the saved results, and has nothing new to save.
+const { mtimeMs } = fs.statSync(cacheFile);
+run();
+assert.strictEqual(fs.statSync(cacheFile).mtimeMs, mtimeMs);
+
+// A cache written by another version of Node.js is ignored.
+fs.writeFileSync(cacheFile, JSON.stringify({
+  version: 'v0.0.0',
+  paths: Object.fromEntries(
+    Object.keys(paths).map((key) => [key, '/does/not/exist.js']))
+}));
+run();
+assert.strictEqual(JSON.parse(fs.readFileSync(cacheFile, 'utf8')).version,
+                   process.version);
@@ -0,0 +1,59 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const net = require('net');
+
+// Reads of many sockets that use `batchReads` are delivered to JS together.
+// Make sure that data and 'end' still arrive in order for each of them.
+
+const N = 10;
+const payload = 'x'.repeat(1024);
+
+const server = net.createServer({ batchReads: true }, common.mustCall((c) => {
+  let data = '';
+  c.setEncoding('utf8');
+  c.on('data', (chunk) => data += chunk);
+  c.on('end', common.mustCall(() => {
+    assert.strictEqual(data, payload);
+    c.end(data.toUpperCase());
+  }));
+}, N));
+
+server.listen(0, common.mustCall(() => {
+  let pending = N;
+  for (let i = 0; i < N; i++) {
+    const client = net.connect({
+      port: server.address().port,
+      batchReads: true
+    });
+    let data = '';
+    client.setEncoding('utf8');
+    client.on('data', (chunk) => data += chunk);
+    client.on('end', common.mustCall(() => {
+      assert.strictEqual(data, payload.toUpperCase());
+      if (--pending === 0)
+        server.close();
+    }));
+    client.end(payload);
+  }
+}));
+
+// Errors thrown from a batched read are reported as uncaught exceptions.
+{
+  let conn;
+  const server = net.createServer({ batchReads: true }, common.mustCall((c) => {
+    conn = c;
+    c.on('data', common.mustCall(() => {
+      throw new Error('boom');
+    }));
+  }));
+  process.on('uncaughtException', common.mustCall((err) => {
+    assert.strictEqual(err.message, 'boom');
+    conn.destroy();
+    server.close();
+  }));
+  server.listen(0, common.mustCall(() => {
+    net.connect(server.address().port).end('hello').resume();
+  }));
+}
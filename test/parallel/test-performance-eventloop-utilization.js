@@ -0,0 +1,43 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const { performance } = require('perf_hooks');
+const { Worker, isMainThread } = require('worker_threads');
+
+// The event loop has not started yet. Worker scripts are loaded from within
+// the worker's event loop.
+if (isMainThread) {
+  const elu = performance.eventLoopUtilization();
+  assert.deepStrictEqual(elu, { idle: 0, active: 0, utilization: 0 });
+  assert.strictEqual(performance.nodeTiming.idleTime, 0);
+}
+
+setTimeout(common.mustCall(() => {
+  const elu1 = performance.eventLoopUtilization();
+  assert(elu1.idle > 0);
+  assert(elu1.active > 0);
+  assert(elu1.utilization > 0 && elu1.utilization < 1);
+  assert.strictEqual(elu1.idle, performance.nodeTiming.idleTime);
+
+  const phases = performance.eventLoopPhases();
+  assert(phases.poll >= phases.idle);
+  assert.strictEqual(phases.idle, elu1.idle);
+  for (const key of ['timers', 'poll', 'idle', 'check', 'close'])
+    assert.strictEqual(typeof phases[key], 'number');
+
+  common.busyLoop(50);
+  setImmediate(common.mustCall(() => {
+    const elu2 = performance.eventLoopUtilization(elu1);
+    assert(elu2.active >= 50);
+    assert(elu2.utilization > 0.5);
+
+    const elu3 = performance.eventLoopUtilization();
+    const delta = performance.eventLoopUtilization(elu3, elu1);
+    assert(delta.active >= elu2.active);
+    assert(performance.eventLoopPhases().check > 0);
+
+    if (isMainThread)
+      new Worker(__filename);
+  }));
+}), 50);
@@ -0,0 +1,97 @@
+'use strict';
+
+const common = require('../common');
+const assert = require('assert');
+const fs = require('fs');
+const zlib = require('zlib');
+const {
+  monitorThreadpool
+} = require('perf_hooks');
+
+{
+  const histogram = monitorThreadpool();
+  assert.strictEqual(histogram.type, 'fs');
+  assert.strictEqual(histogram.metric, 'total');
+  assert(histogram.enable());
+  assert(!histogram.enable());
+  histogram.reset();
+  assert(histogram.disable());
+  assert(!histogram.disable());
+}
+
+{
+  [null, 'a', 1, false, Infinity].forEach((i) => {
+    common.expectsError(
+      () => monitorThreadpool(i),
+      {
+        type: TypeError,
+        code: 'ERR_INVALID_ARG_TYPE'
+      }
+    );
+  });
+
+  [null, 1, false, {}, []].forEach((i) => {
+    common.expectsError(
+      () => monitorThreadpool({ type: i }),
+      {
+        type: TypeError,
+        code: 'ERR_INVALID_ARG_TYPE'
+      }
+    );
+    common.expectsError(
+      () => monitorThreadpool({ metric: i }),
+      {
+        type: TypeError,
+        code: 'ERR_INVALID_ARG_TYPE'
+      }
+    );
+  });
+
+  ['', 'dns', 'toString'].forEach((i) => {
+    common.expectsError(
+      () => monitorThreadpool({ type: i }),
+      {
+        type: TypeError,
+        code: 'ERR_INVALID_OPT_VALUE'
+      }
+    );
+  });
+
+  ['', 'latency', 'wait'].forEach((i) => {
+    common.expectsError(
+      () => monitorThreadpool({ type: 'fs', metric: i }),
+      {
+        type: TypeError,
+        code: 'ERR_INVALID_OPT_VALUE'
+      }
+    );
+  });
+}
+
+{
+  const total = monitorThreadpool({ type: 'fs' });
+  total.enable();
+  fs.stat(__filename, common.mustCall((err) => {
+    assert.ifError(err);
+    total.disable();
+    assert(total.min > 0);
+    assert(total.max >= total.min);
+    assert.strictEqual(total.pending, 0);
+  }));
+  assert.strictEqual(total.pending, 1);
+}
+
+{
+  const wait = monitorThreadpool({ type: 'zlib', metric: 'wait' });
+  const run = monitorThreadpool({ type: 'zlib', metric: 'run' });
+  wait.enable();
+  run.enable();
+  zlib.deflate(Buffer.alloc(1024), common.mustCall((err) => {
+    assert.ifError(err);
+    wait.disable();
+    run.disable();
+    assert(wait.min > 0);
+    assert(run.min > 0);
+    assert.strictEqual(run.exceeds, 0);
+  }));
+}
@@ -0,0 +1,45 @@
+'use strict';
+
+// Tests that --snapshot-blob refuses files that were not created by
+// node_mksnapshot --blob for this binary.
+
+require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+tmpdir.refresh();
+
+function check(blob) {
+  const child = spawnSync(process.execPath,
+                          [`--snapshot-blob=${blob}`, '-e', '0']);
+  assert.strictEqual(child.status, 9);
+  assert(child.stderr.toString().includes(`cannot load snapshot blob ${blob}`),
+         child.stderr.toString());
+}
+
+check(path.join(tmpdir.path, 'does-not-exist.blob'));
+
+const garbage = path.join(tmpdir.path, 'garbage.blob');
+fs.writeFileSync(garbage, 'this is not a snapshot');
+check(garbage);
+
+function writeHeader(file, version, checksum) {
+  const length = Buffer.alloc(4);
+  length.writeUInt32LE(Buffer.byteLength(version));
+  fs.writeFileSync(file, Buffer.concat([Buffer.from('NODESNAP'), length,
+                                        Buffer.from(version), checksum]));
+}
+
+// A blob with the right magic, but for a different version of Node.js.
+const other = path.join(tmpdir.path, 'other.blob');
+writeHeader(other, 'v0.0.0/0.0.0', Buffer.alloc(8));
+check(other);
+
+// A blob for this version, but for a different build.
+const otherBuild = path.join(tmpdir.path, 'other-build.blob');
+writeHeader(otherBuild, `${process.version}/${process.versions.v8}`,
+            Buffer.alloc(8));
+check(otherBuild);
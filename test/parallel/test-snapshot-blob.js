@@ -0,0 +1,72 @@
+'use strict';
+
+// Tests that a blob written by node_mksnapshot --blob can be loaded through
+// --snapshot-blob and that the state left by the entry script is restored.
+
+const common = require('../common');
+const assert = require('assert');
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const tmpdir = require('../common/tmpdir');
+
+const exe = common.isWindows ? '.exe' : '';
+const mksnapshot = path.join(path.dirname(process.execPath),
+                             `node_mksnapshot${exe}`);
+if (!fs.existsSync(mksnapshot))
+  common.skip('node_mksnapshot is not built next to the node binary');
+
+tmpdir.refresh();
+
+const entry = path.join(tmpdir.path, 'entry.js');
+fs.writeFileSync(entry, `
+  const { format } = require('util');
+  globalThis.snapshotted = {
+    answer: 6 * 7,
+    greet(name) { return format('hello %s', name); },
+    entry: require('path').basename(__filename)
+  };
+`);
+
+const blob = path.join(tmpdir.path, 'app.blob');
+{
+  const child = spawnSync(mksnapshot, ['--blob', blob, entry]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert(fs.statSync(blob).size > 0);
+}
+
+{
+  const child = spawnSync(process.execPath, [
+    `--snapshot-blob=${blob}`,
+    '-p',
+    'snapshotted.answer + " " + snapshotted.greet("world") + " " + ' +
+    'snapshotted.entry + " " + process.argv.length'
+  ]);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.stdout.toString().trim(),
+                     '42 hello world entry.js 1');
+}
+
+// The entry can only require built-in modules, and it cannot leave pending
+// work behind.
+for (const [source, message] of [
+  ['require("./entry.js");', 'No such built-in module: ./entry.js'],
+  ['setTimeout(() => {}, 1000);', 'Cannot snapshot pending timers'],
+  ['setImmediate(() => {});', 'Cannot snapshot pending immediates'],
+]) {
+  const invalid = path.join(tmpdir.path, 'invalid.js');
+  fs.writeFileSync(invalid, source);
+  const child = spawnSync(mksnapshot, [
+    '--blob', path.join(tmpdir.path, 'invalid.blob'), invalid
+  ]);
+  assert.strictEqual(child.status, 1);
+  assert(child.stderr.toString().includes(message), child.stderr.toString());
+}
+
+// Without the blob, the global is not there.
+{
+  const child = spawnSync(process.execPath,
+                          ['-p', 'typeof globalThis.snapshotted']);
+  assert.strictEqual(child.status, 0, child.stderr.toString());
+  assert.strictEqual(child.stdout.toString().trim(), 'undefined');
+}
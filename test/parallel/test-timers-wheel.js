@@ -0,0 +1,79 @@
+// Flags: --expose-internals
+'use strict';
+
+// Tests the timeouts created by setUnrefTimeout(), which live on the native
+// timing wheel rather than in the JS timer lists.
+
+const common = require('../common');
+const assert = require('assert');
+const util = require('util');
+const { setUnrefTimeout } = require('internal/timers');
+
+// Keep the process alive, the timeouts under test are all unrefed.
+const keepAlive = setTimeout(common.mustNotCall(),
+                             common.platformTimeout(10000));
+
+// Timeouts fire in the order of their expiry, also when they have to be
+// cascaded from the higher levels of the wheel.
+{
+  const order = [];
+  const start = Date.now();
+  setUnrefTimeout(common.mustCall(() => {
+    order.push(300);
+    assert.deepStrictEqual(order, [1, 10, 300]);
+    assert(Date.now() - start >= 300 - 1);
+  }), 300);
+  setUnrefTimeout(common.mustCall(() => order.push(10)), 10);
+  setUnrefTimeout(common.mustCall(() => order.push(1)), 1);
+}
+
+// A timeout can be cleared, and refresh() does not re-arm it afterwards.
+{
+  const timeout = setUnrefTimeout(common.mustNotCall(), 1);
+  assert.strictEqual(timeout.hasRef(), false);
+  clearTimeout(timeout);
+  assert.strictEqual(timeout._idleTimeout, -1);
+  assert.strictEqual(timeout.refresh(), timeout);
+}
+
+// refresh() postpones a timeout, and re-arms one that already fired. Timers
+// never fire early, so the timeout cannot fire before `delay` has passed
+// since the refresh(), however late that ran.
+{
+  const delay = common.platformTimeout(100);
+  let refreshedAt;
+  let fired = 0;
+  const timeout = setUnrefTimeout(common.mustCall(() => {
+    if (++fired === 1) {
+      const elapsed = Number(process.hrtime.bigint() - refreshedAt) / 1e6;
+      // Allow for the millisecond granularity of the loop time.
+      assert(elapsed >= delay - 2, `fired after ${elapsed} ms`);
+      setImmediate(() => timeout.refresh());
+    }
+  }, 2), delay);
+  setTimeout(common.mustCall(() => {
+    assert.strictEqual(fired, 0);
+    refreshedAt = process.hrtime.bigint();
+    timeout.refresh();
+  }), delay / 2);
+}
+
+// A timeout that is cleared by another one expiring at the same time does not
+// fire.
+{
+  let other;
+  setUnrefTimeout(common.mustCall(() => clearTimeout(other)), 30);
+  other = setUnrefTimeout(common.mustNotCall(), 30);
+}
+
+// Other timers still use the JS timer lists.
+{
+  const timeout = setTimeout(() => {}, 1);
+  const inspected = util.inspect([[ timeout._idlePrev ]]);
+  assert(inspected.includes('      _idlePrev: [Timeout]'));
+  assert(inspected.includes('      _idleNext: [Timeout]'));
+  assert(!inspected.includes('       _idleNext: [Timeout]'));
+}
+
+setTimeout(common.mustCall(() => clearTimeout(keepAlive)),
+           common.platformTimeout(500));
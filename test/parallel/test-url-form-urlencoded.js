@@ -0,0 +1,114 @@
+'use strict';
+
+require('../common');
+
+// URLSearchParams and querystring.parse() decode
+// application/x-www-form-urlencoded input natively when the default
+// querystring.unescape() is in use. Check the native parser and serializer
+// against the expected results and against the JS implementations.
+
+const assert = require('assert');
+const querystring = require('querystring');
+const { URLSearchParams } = require('url');
+
+function parse(input) {
+  return [...new URLSearchParams(input)];
+}
+
+// Forces querystring.parse() to use its JS parser.
+function parseInJS(input, options) {
+  const decodeURIComponent = (s) => querystring.unescape(s);
+  return querystring.parse(input, null, null,
+                           { ...options, decodeURIComponent });
+}
+
+const tests = [
+  ['', []],
+  ['a', [['a', '']]],
+  ['a+b=c+d', [['a b', 'c d']]],
+  ['%41%62=%2B%20', [['Ab', '+ ']]],
+  ['a=b=c', [['a', 'b=c']]],
+  ['=&=a&a=&&a', [['', ''], ['', 'a'], ['a', ''], ['a', '']]],
+  ['&&a=1&&', [['a', '1']]],
+  // Malformed percent-escapes are kept as they are.
+  ['a=%zz&b=%4', [['a', '%zz'], ['b', '%4']]],
+  ['a=%&b=%%41', [['a', '%'], ['b', '%A']]],
+  ['%=%2', [['%', '%2']]],
+  // Escaped bytes are decoded as UTF-8.
+  ['a=%E2%82%AC', [['a', '€']]],
+  ['a=%E2%82', [['a', '�']]],
+  ['a=%FF%41', [['a', '�A']]],
+  // Non-ASCII input.
+  ['€=ü&ü', [['€', 'ü'], ['ü', '']]],
+  ['é=%C3%A9+x', [['é', 'é x']]],
+];
+
+for (const [input, expected] of tests) {
+  assert.deepStrictEqual(parse(input), expected, input);
+
+  const expectedObject = Object.create(null);
+  for (const [name, value] of expected) {
+    if (name in expectedObject)
+      expectedObject[name] = [].concat(expectedObject[name], value);
+    else
+      expectedObject[name] = value;
+  }
+  assert.deepStrictEqual(querystring.parse(input), expectedObject, input);
+  assert.deepStrictEqual(parseInJS(input), expectedObject, input);
+}
+
+// maxKeys counts empty pairs as well.
+for (const input of ['a=1&b=2&c=3&d=4', '&&a=1&b=2', 'a=%41&&b=%zz&c']) {
+  for (const maxKeys of [0, 1, 2, 3, 1.5, -1]) {
+    assert.deepStrictEqual(querystring.parse(input, null, null, { maxKeys }),
+                           parseInJS(input, { maxKeys }),
+                           `${input} ${maxKeys}`);
+  }
+}
+assert.deepStrictEqual(
+  querystring.parse('a=1&b=2&c=3&d=4', null, null, { maxKeys: 2 }),
+  Object.assign(Object.create(null), { a: '1', b: '2' }));
+assert.deepStrictEqual(
+  querystring.parse('&&a=1&b=2', null, null, { maxKeys: 2 }),
+  Object.create(null));
+
+// URLSearchParams uses the JS parser while querystring.unescape() is
+// overridden, and calls the override.
+{
+  const unescape = querystring.unescape;
+  const inputs = [];
+  querystring.unescape = (s) => {
+    inputs.push(s);
+    return unescape(s).toUpperCase();
+  };
+  try {
+    assert.deepStrictEqual(parse('a=%62&%63=d+e'),
+                           [['a', 'B'], ['C', 'd e']]);
+    assert.deepStrictEqual(inputs, ['%62', '%63']);
+  } finally {
+    querystring.unescape = unescape;
+  }
+  assert.deepStrictEqual(parse('a=%62'), [['a', 'b']]);
+}
+
+// Serialization.
+{
+  const params = new URLSearchParams([
+    ['a b', 'c+d'],
+    ['*-._~', '!\'()'],
+    ['€', '😀'],
+    ['', '=&%'],
+    ['\ud800', 'x\udc00'],
+  ]);
+  assert.strictEqual(params.toString(),
+                     'a+b=c%2Bd&*-._%7E=%21%27%28%29&' +
+                     '%E2%82%AC=%F0%9F%98%80&=%3D%26%25&' +
+                     '%EF%BF%BD=x%EF%BF%BD');
+  assert.strictEqual(new URLSearchParams().toString(), '');
+  assert.strictEqual(new URLSearchParams('a=').toString(), 'a=');
+
+  for (const [input, expected] of tests) {
+    assert.deepStrictEqual(parse(new URLSearchParams(input).toString()),
+                           expected, input);
+  }
+}
@@ -12,7 +12,8 @@ if (process.argv[2] === 'child') {
   const http = require('http');
   const spawn = require('child_process').spawn;
 
-  // Watching files should result in fs_event/fs_poll uv handles.
+  // Watching files should result in fs_event/fs_poll uv handles. The fs_poll
+  // entries of fs.watchFile() are reported for the timer that polls them.
   let watcher;
   try {
     watcher = fs.watch(__filename);
@@ -116,6 +117,11 @@ if (process.argv[2] === 'child') {
     const report = JSON.parse(stdout);
     const prefix = common.isWindows ? '\\\\?\\' : '';
     const expected_filename = `${prefix}${__filename}`;
+    // The timers that fs.watchFile() polls its files with are referenced
+    // while a file is watched persistently, unlike the other timers.
+    const poller_timers = report.libuv
+      .filter((entry) => entry.type === 'fs_poll')
+      .map((entry) => entry.address);
     const found_tcp = [];
     const found_udp = [];
     // Functions are named to aid debugging when they are not called.
@@ -154,8 +160,13 @@ if (process.argv[2] === 'child') {
         }
         assert(handle.is_referenced);
       }, 3),
-      timer: common.mustCallAtLeast(function timer_validator(handle) {
+      // On Linux, fs.watchFile() also polls an inotify instance for hints.
+      poll: common.mustCall(function poll_validator(handle) {
         assert(!handle.is_referenced);
+      }, common.isLinux ? 1 : 0),
+      timer: common.mustCallAtLeast(function timer_validator(handle) {
+        assert.strictEqual(handle.is_referenced,
+                           poller_timers.includes(handle.address));
         assert.strictEqual(handle.repeat, 0);
       }),
       udp: common.mustCall(function udp_validator(handle) {
@@ -146,8 +146,12 @@ if (common.hasCrypto) { // eslint-disable-line node-core/crypto-check
   testInitialized(req, 'FSReqCallback');
   binding.access(path.toNamespacedPath('../'), fs.F_OK, req);
 
-  const StatWatcher = binding.StatWatcher;
-  testInitialized(new StatWatcher(), 'StatWatcher');
+  // fs.watchFile() reports a STATWATCHER resource for each watched file.
+  fs.watchFile(__filename, common.mustNotCall());
+  fs.unwatchFile(__filename);
+
+  const StatPoller = binding.StatPoller;
+  testInitialized(new StatPoller(), 'StatPoller');
 }
 
 
@@ -0,0 +1,114 @@
+'use strict';
+
+// Creates a module bundle for --experimental-bundle, see src/module_bundle.h
+// for the format.
+//
+// Usage: node tools/bundle/mkbundle.js [--code-cache] <bundle> <dir>...
+//
+// All .js, .cjs, .mjs and .json files below the given directories are added
+// to the bundle, with paths relative to the directory that will contain the
+// bundle. With --code-cache, a code cache is added for CommonJS sources; it
+// is only used by the same version of Node.js that created it.
+
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+const kMagic = 'NODEBNDL';
+const kVersion = 1;
+const kAsciiFlag = 1 << 0;
+const kExtensions = new Set(['.js', '.cjs', '.mjs', '.json']);
+const kWrapperParams = ['exports', 'require', 'module', '__filename',
+                        '__dirname'];
+
+function collectFiles(dir, files) {
+  for (const dirent of fs.readdirSync(dir, { withFileTypes: true })) {
+    const file = path.join(dir, dirent.name);
+    if (dirent.isDirectory())
+      collectFiles(file, files);
+    else if (dirent.isFile() && kExtensions.has(path.extname(dirent.name)))
+      files.push(file);
+  }
+  return files;
+}
+
+function createCodeCache(file, source) {
+  const ext = path.extname(file);
+  if (ext !== '.js' && ext !== '.cjs')
+    return Buffer.alloc(0);
+  try {
+    const fn = vm.compileFunction(source, kWrapperParams, {
+      filename: file,
+      produceCachedData: true
+    });
+    return fn.cachedDataProduced ? fn.cachedData : Buffer.alloc(0);
+  } catch {
+    // E.g. an ES module in a .js file.
+    return Buffer.alloc(0);
+  }
+}
+
+// Writes the given files, which must be below the directory of `output`.
+function createBundle(output, files, { codeCache = false } = {}) {
+  const root = path.dirname(path.resolve(output));
+  const entries = [];
+  for (const file of files) {
+    const relative = path.relative(root, path.resolve(file));
+    if (relative.startsWith('..') || path.isAbsolute(relative))
+      throw new Error(`${file} is not below ${root}`);
+    const source = fs.readFileSync(file);
+    const cache = codeCache ?
+      createCodeCache(file, source.toString('utf8')) : Buffer.alloc(0);
+    entries.push({
+      path: Buffer.from(relative.split(path.sep).join('/')),
+      isAscii: source.every((byte) => byte < 0x80),
+      source,
+      cache
+    });
+  }
+
+  let headerSize = kMagic.length + 8;
+  for (const entry of entries)
+    headerSize += 4 + entry.path.length + 4 + 4 * 8;
+
+  const chunks = [];
+  const header = Buffer.alloc(headerSize);
+  let offset = header.write(kMagic, 'latin1');
+  offset = header.writeUInt32LE(kVersion, offset);
+  offset = header.writeUInt32LE(entries.length, offset);
+
+  let dataOffset = headerSize;
+  const writeRange = (buffer) => {
+    offset = header.writeBigUInt64LE(BigInt(dataOffset), offset);
+    offset = header.writeBigUInt64LE(BigInt(buffer.length), offset);
+    chunks.push(buffer);
+    dataOffset += buffer.length;
+  };
+  for (const entry of entries) {
+    offset = header.writeUInt32LE(entry.path.length, offset);
+    offset += entry.path.copy(header, offset);
+    offset = header.writeUInt32LE(entry.isAscii ? kAsciiFlag : 0, offset);
+    writeRange(entry.source);
+    writeRange(entry.cache);
+  }
+
+  fs.writeFileSync(output, Buffer.concat([header, ...chunks]));
+}
+
+module.exports = { createBundle };
+
+if (require.main === module) {
+  const args = process.argv.slice(2);
+  const codeCache = args[0] === '--code-cache';
+  if (codeCache)
+    args.shift();
+  if (args.length < 2) {
+    console.error('Usage: node mkbundle.js [--code-cache] <bundle> <dir>...');
+    process.exit(1);
+  }
+  const [output, ...dirs] = args;
+  const files = [];
+  for (const dir of dirs)
+    collectFiles(dir, files);
+  createBundle(output, files, { codeCache });
+}
@@ -1,12 +1,14 @@
 #include "cache_builder.h"
 #include "node_native_module.h"
-#include "util.h"
+#include "util-inl.h"
 
 #include <iostream>
 #include <map>
+#include <set>
 #include <sstream>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
 
 namespace node {
 namespace native_module {
@@ -17,6 +19,7 @@ using v8::Isolate;
 using v8::Local;
 using v8::MaybeLocal;
 using v8::ScriptCompiler;
+using v8::String;
 
 static std::string GetDefName(const std::string& id) {
   char buf[64] = {0};
@@ -68,6 +71,7 @@ static void GetInitializer(const std::string& id, std::stringstream& ss) {
 
 static std::string GenerateCodeCache(
     const std::map<std::string, ScriptCompiler::CachedData*>& data,
+    const std::set<std::string>& eager_ids,
     bool log_progress) {
   std::stringstream ss;
   ss << R"(#include <cinttypes>
@@ -90,7 +94,9 @@ const bool has_code_cache = true;
     std::string def = GetDefinition(id, cached_data->length, cached_data->data);
     ss << def << "\n\n";
     if (log_progress) {
-      std::cout << "Generated cache for " << id
+      const bool eager = eager_ids.empty() || eager_ids.count(id) != 0;
+      std::cout << "Generated " << (eager ? "eager" : "lazy")
+                << " cache for " << id
                 << ", size = " << FormatSize(cached_data->length)
                 << ", total = " << FormatSize(total) << "\n";
     }
@@ -117,28 +123,71 @@ const bool has_code_cache = true;
   return ss.str();
 }
 
-std::string CodeCacheBuilder::Generate(Local<Context> context) {
+// The parameters that src/node.cc and src/api/environment.cc compile the
+// builtins that cannot be required with. The cache of a function can only be
+// consumed if it is compiled with the same parameters. Returns false for
+// builtins that are not run during startup.
+static bool GetStartupParameters(Isolate* isolate,
+                                 const std::string& id,
+                                 std::vector<Local<String>>* parameters) {
+  std::vector<const char*> names;
+  if (id.compare(0, strlen("internal/per_context/"),
+                 "internal/per_context/") == 0) {
+    names = {"global", "exports", "primordials"};
+  } else if (id == "internal/bootstrap/loaders") {
+    names = {"process", "getLinkedBinding", "getInternalBinding",
+             "primordials"};
+  } else if (id == "internal/bootstrap/node") {
+    names = {"process", "require", "internalBinding", "isMainThread",
+             "ownsProcessState", "primordials"};
+  } else if (id.compare(0, strlen("internal/main/"), "internal/main/") == 0) {
+    names = {"process", "require", "internalBinding", "primordials",
+             "markBootstrapComplete"};
+  } else {
+    return false;
+  }
+  for (const char* name : names)
+    parameters->push_back(OneByteString(isolate, name));
+  return true;
+}
+
+std::string CodeCacheBuilder::Generate(
+    Local<Context> context, const std::set<std::string>& eager_ids) {
   NativeModuleLoader* loader = NativeModuleLoader::GetInstance();
   std::vector<std::string> ids = loader->GetModuleIds();
 
+  for (const auto& id : eager_ids) {
+    if (!loader->Exists(id.c_str()))
+      std::cerr << "Ignoring unknown module " << id << " in the profile\n";
+  }
+  if (!eager_ids.empty())
+    loader->SetEagerCompileIds(std::set<std::string>(eager_ids));
+
   std::map<std::string, ScriptCompiler::CachedData*> data;
 
   for (const auto& id : ids) {
-    // TODO(joyeecheung): we can only compile the modules that can be
-    // required here because the parameters for other types of builtins
-    // are still very flexible. We should look into auto-generating
-    // the parameters from the source somehow.
+    // TODO(joyeecheung): the parameters of the builtins that cannot be
+    // required are still very flexible, so only those that are run during
+    // startup are compiled here, with the parameters of GetStartupParameters().
+    // We should look into auto-generating the parameters from the source
+    // somehow.
+    NativeModuleLoader::Result result;
+    std::vector<Local<String>> parameters;
     if (loader->CanBeRequired(id.c_str())) {
-      NativeModuleLoader::Result result;
       USE(loader->CompileAsModule(context, id.c_str(), &result));
-      ScriptCompiler::CachedData* cached_data =
-          loader->GetCodeCache(id.c_str());
-      if (cached_data == nullptr) {
-        // TODO(joyeecheung): display syntax errors
-        std::cerr << "Failed to compile " << id << "\n";
-      } else {
-        data.emplace(id, cached_data);
-      }
+    } else if (eager_ids.count(id) != 0 &&
+               GetStartupParameters(context->GetIsolate(), id, &parameters)) {
+      USE(loader->LookupAndCompile(context, id.c_str(), &parameters,
+                                   &result));
+    } else {
+      continue;
+    }
+    ScriptCompiler::CachedData* cached_data = loader->GetCodeCache(id.c_str());
+    if (cached_data == nullptr) {
+      // TODO(joyeecheung): display syntax errors
+      std::cerr << "Failed to compile " << id << "\n";
+    } else {
+      data.emplace(id, cached_data);
     }
   }
 
@@ -149,7 +198,7 @@ std::string CodeCacheBuilder::Generate(Local<Context> context) {
   if (ret == 0 && strcmp(env_buf, "mkcodecache") == 0) {
     log_progress = true;
   }
-  return GenerateCodeCache(data, log_progress);
+  return GenerateCodeCache(data, eager_ids, log_progress);
 }
 
 }  // namespace native_module
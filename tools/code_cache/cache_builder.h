@@ -1,6 +1,7 @@
 #ifndef TOOLS_CODE_CACHE_CACHE_BUILDER_H_
 #define TOOLS_CODE_CACHE_CACHE_BUILDER_H_
 
+#include <set>
 #include <string>
 #include "v8.h"
 
@@ -8,7 +9,11 @@ namespace node {
 namespace native_module {
 class CodeCacheBuilder {
  public:
-  static std::string Generate(v8::Local<v8::Context> context);
+  // Modules in `eager_ids` get a code cache with all their functions compiled,
+  // the others only one for their top-level code. If `eager_ids` is empty,
+  // all modules are compiled eagerly.
+  static std::string Generate(v8::Local<v8::Context> context,
+                              const std::set<std::string>& eager_ids);
 };
 }  // namespace native_module
 }  // namespace node
@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <fstream>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -29,10 +30,30 @@ int main(int argc, char* argv[]) {
   v8::V8::SetFlagsFromString("--random_seed=42");
 
   if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <path/to/output.cc>\n";
+    std::cerr << "Usage: " << argv[0]
+              << " <path/to/output.cc> [path/to/startup_profile.txt]\n";
     return 1;
   }
 
+  // The startup profile lists the ids of the modules that are used during
+  // startup, one per line; see tools/code_cache/startup_profile.js.
+  std::set<std::string> eager_ids;
+  if (argc > 2) {
+    std::ifstream profile(argv[2]);
+    if (!profile.is_open()) {
+      std::cerr << "Cannot open " << argv[2] << "\n";
+      return 1;
+    }
+    std::string line;
+    while (std::getline(profile, line)) {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      if (line.empty() || line[0] == '#')
+        continue;
+      eager_ids.insert(line);
+    }
+  }
+
   std::ofstream out;
   out.open(argv[1], std::ios::out | std::ios::binary);
   if (!out.is_open()) {
@@ -58,7 +79,7 @@ int main(int argc, char* argv[]) {
     // The command line flags are part of the code cache's checksum so reset
     // --random_seed= to its default value before creating the code cache.
     v8::V8::SetFlagsFromString("--random_seed=0");
-    std::string cache = CodeCacheBuilder::Generate(context);
+    std::string cache = CodeCacheBuilder::Generate(context, eager_ids);
     out << cache;
     out.close();
   }
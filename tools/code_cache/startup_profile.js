@@ -0,0 +1,93 @@
+'use strict';
+
+// Records the internal modules that Node.js uses during startup, and writes
+// them to tools/code_cache/startup_profile.txt for mkcodecache.
+//
+// Usage: out/Release/node tools/code_cache/startup_profile.js
+
+const { spawnSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+// process.moduleLoadList only contains the modules that have been required.
+// The native module loader also records the bootstrap and main scripts that
+// src/node.cc compiles, and the modules that were compiled when the startup
+// snapshot was built, so those are taken from its bookkeeping instead.
+const reportModules = `
+process.on('exit', () => {
+  const { internalBinding } = require('internal/test/binding');
+  const {
+    compiledWithCache,
+    compiledWithoutCache,
+    compiledInSnapshot
+  } = internalBinding('native_module').getCacheUsage();
+  process._rawDebug(JSON.stringify([...compiledWithCache,
+                                    ...compiledWithoutCache,
+                                    ...compiledInSnapshot]));
+});
+`;
+
+// These run before there is an Environment to record them in.
+const perContextIds = [
+  'internal/per_context/domexception',
+  'internal/per_context/primordials',
+];
+
+// Only required by the reporter itself.
+const reporterIds = [
+  'internal/test/binding',
+];
+
+const tmpdir = fs.mkdtempSync(path.join(os.tmpdir(), 'startup-profile-'));
+const mainFile = path.join(tmpdir, 'main.js');
+fs.writeFileSync(mainFile, `${reportModules}
+const fs = require('fs');
+const path = require('path');
+fs.readFileSync(path.join(__dirname, 'main.js'), 'utf8');
+`);
+
+const workloads = [
+  // `node -e 0`
+  ['-e', `${reportModules}\n0`],
+  // `node file.js`
+  [mainFile],
+  // A typical server boot.
+  ['-e', `${reportModules}
+   require('http').createServer().listen(0, function() {
+     this.close();
+   });`],
+  // A worker thread.
+  ['-e', `${reportModules}
+   const { Worker } = require('worker_threads');
+   new Worker(${JSON.stringify(reportModules)}, { eval: true });`],
+];
+
+const ids = new Set(perContextIds);
+for (const args of workloads) {
+  const child = spawnSync(process.execPath, ['--expose-internals', ...args],
+                          { encoding: 'utf8' });
+  if (child.status !== 0) {
+    console.error(child.stderr);
+    process.exit(1);
+  }
+  // Worker threads report their modules as well, on separate lines.
+  for (const line of child.stderr.split('\n')) {
+    if (!line.startsWith('['))
+      continue;
+    for (const id of JSON.parse(line))
+      ids.add(id);
+  }
+}
+for (const id of reporterIds)
+  ids.delete(id);
+fs.rmdirSync(tmpdir, { recursive: true });
+
+const header = `# Generated by tools/code_cache/startup_profile.js, do not edit.
+#
+# The internal modules that are used by the startup workloads of that script.
+# mkcodecache compiles these eagerly into the code cache that is embedded in
+# the binary, and only the top-level code of the other modules.
+`;
+fs.writeFileSync(path.join(__dirname, 'startup_profile.txt'),
+                 `${header}${[...ids].sort().join('\n')}\n`);
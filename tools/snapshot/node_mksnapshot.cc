@@ -14,22 +14,68 @@
 #ifdef _WIN32
 #include <windows.h>
 
+static std::string ToUtf8(const wchar_t* arg) {
+  int size = WideCharToMultiByte(CP_UTF8, 0, arg, -1, nullptr, 0, nullptr,
+                                 nullptr);
+  CHECK_GT(size, 0);
+  std::string result(size - 1, '\0');
+  WideCharToMultiByte(CP_UTF8, 0, arg, -1, &result[0], size, nullptr,
+                      nullptr);
+  return result;
+}
+
 int wmain(int argc, wchar_t* argv[]) {
 #else   // UNIX
+static std::string ToUtf8(const char* arg) {
+  return arg;
+}
+
 int main(int argc, char* argv[]) {
 #endif  // _WIN32
 
   v8::V8::SetFlagsFromString("--random_seed=42");
 
-  if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <path/to/output.cc>\n";
+  // node_mksnapshot <path/to/output.cc> embeds the snapshot of Node.js's own
+  // startup into the binary, while
+  // node_mksnapshot --blob <path/to/output.blob> [path/to/entry.js] writes a
+  // snapshot for --snapshot-blob, which may include the state created by an
+  // entry script.
+  int output_arg = 1;
+  node::SnapshotBuilder::OutputFormat format =
+      node::SnapshotBuilder::OutputFormat::kSource;
+  if (argc >= 2 && ToUtf8(argv[1]) == "--blob") {
+    output_arg = 2;
+    format = node::SnapshotBuilder::OutputFormat::kBlob;
+  }
+
+  int max_argc = output_arg + 1;
+  if (format == node::SnapshotBuilder::OutputFormat::kBlob)
+    max_argc++;  // The optional entry script.
+  if (argc <= output_arg || argc > max_argc) {
+    std::cerr << "Usage: " << ToUtf8(argv[0]) << " <path/to/output.cc>\n"
+              << "       " << ToUtf8(argv[0])
+              << " --blob <path/to/output.blob> [path/to/entry.js]\n";
     return 1;
   }
 
+  std::string entry_source;
+  std::string entry_filename;
+  if (argc == output_arg + 2) {
+    entry_filename = ToUtf8(argv[output_arg + 1]);
+    std::ifstream entry(argv[output_arg + 1], std::ios::in | std::ios::binary);
+    if (!entry.is_open()) {
+      std::cerr << "Cannot open " << entry_filename << "\n";
+      return 1;
+    }
+    std::stringstream ss;
+    ss << entry.rdbuf();
+    entry_source = ss.str();
+  }
+
   std::ofstream out;
-  out.open(argv[1], std::ios::out | std::ios::binary);
+  out.open(argv[output_arg], std::ios::out | std::ios::binary);
   if (!out.is_open()) {
-    std::cerr << "Cannot open " << argv[1] << "\n";
+    std::cerr << "Cannot open " << ToUtf8(argv[output_arg]) << "\n";
     return 1;
   }
 
@@ -42,13 +88,19 @@ int main(int argc, char* argv[]) {
   CHECK(!result.early_return);
   CHECK_EQ(result.exit_code, 0);
 
+  int exit_code = 0;
   {
     std::string snapshot =
-        node::SnapshotBuilder::Generate(result.args, result.exec_args);
+        node::SnapshotBuilder::Generate(result.args, result.exec_args, format,
+                                        entry_source, entry_filename);
+    if (snapshot.empty()) {
+      std::cerr << "Cannot create a snapshot\n";
+      exit_code = 1;
+    }
     out << snapshot;
     out.close();
   }
 
   node::TearDownOncePerProcess();
-  return 0;
+  return exit_code;
 }
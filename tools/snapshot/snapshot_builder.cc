@@ -1,17 +1,28 @@
 #include "snapshot_builder.h"
 #include <iostream>
 #include <sstream>
+#include "env-inl.h"
 #include "node_internals.h"
 #include "node_main_instance.h"
+#include "node_process.h"
 #include "node_v8_platform-inl.h"
 
 namespace node {
 
 using v8::Context;
+using v8::Function;
 using v8::HandleScope;
 using v8::Isolate;
+using v8::Local;
+using v8::NewStringType;
+using v8::ScriptCompiler;
+using v8::ScriptOrigin;
 using v8::SnapshotCreator;
 using v8::StartupData;
+using v8::String;
+using v8::TryCatch;
+using v8::Undefined;
+using v8::Value;
 
 template <typename T>
 void WriteVector(std::stringstream* ss, const T* vec, size_t size) {
@@ -20,11 +31,50 @@ void WriteVector(std::stringstream* ss, const T* vec, size_t size) {
   }
 }
 
+static void WriteProps(std::stringstream* ss,
+                       const std::vector<PropInfo>& props) {
+  *ss << "  {\n";
+  for (const PropInfo& prop : props) {
+    *ss << "    { \"" << prop.name << "\", " << prop.id << ", " << prop.index
+        << " },\n";
+  }
+  *ss << "  },\n";
+}
+
+static std::string FormatEnvSerializeInfo(const EnvSerializeInfo& info) {
+  std::stringstream ss;
+  ss << "static const EnvSerializeInfo env_info {\n";
+  ss << "  {\n";
+  for (const std::string& id : info.native_modules)
+    ss << "    \"" << id << "\",\n";
+  ss << "  },\n";
+  ss << "  { " << info.async_hooks.async_ids_stack << ", "
+     << info.async_hooks.fields << ", " << info.async_hooks.async_id_fields
+     << " },\n";
+  ss << "  { " << info.tick_info.fields << " },\n";
+  ss << "  { " << info.immediate_info.fields << " },\n";
+  ss << "  { " << info.performance_state.root << ", "
+     << info.performance_state.milestones << ", "
+     << info.performance_state.loop_phases << ", "
+     << info.performance_state.observers << ", "
+     << info.performance_state.threadpool_pending << " },\n";
+  ss << "  " << info.stream_base_state << ",\n";
+  ss << "  " << info.should_abort_on_uncaught_toggle << ",\n";
+  ss << "  " << info.fs_stats_field_array << ",\n";
+  ss << "  " << info.fs_stats_field_bigint_array << ",\n";
+  WriteProps(&ss, info.persistent_templates);
+  WriteProps(&ss, info.persistent_values);
+  ss << "};\n";
+  return ss.str();
+}
+
 std::string FormatBlob(v8::StartupData* blob,
-                       const std::vector<size_t>& isolate_data_indexes) {
+                       const std::vector<size_t>& isolate_data_indexes,
+                       const EnvSerializeInfo& env_info) {
   std::stringstream ss;
 
   ss << R"(#include <cstddef>
+#include "env.h"
 #include "node_main_instance.h"
 #include "v8.h"
 
@@ -54,27 +104,106 @@ static const std::vector<size_t> isolate_data_indexes {
 const std::vector<size_t>* NodeMainInstance::GetIsolateDataIndexes() {
   return &isolate_data_indexes;
 }
+
+)";
+  ss << FormatEnvSerializeInfo(env_info);
+  ss << R"(
+const EnvSerializeInfo* NodeMainInstance::GetEnvSerializeInfo() {
+  return &env_info;
+}
 }  // namespace node
 )";
 
   return ss.str();
 }
 
+// Runs the entry script of a user-land snapshot in the bootstrapped
+// Environment that is about to be serialized. The entry is compiled as a
+// function that receives `require`, `__filename` and `__dirname`, like a
+// CommonJS module, and is called by lib/internal/main/mksnapshot.js.
+// Returns false if it throws.
+static bool RunEntry(Environment* env,
+                     const std::string& source,
+                     const std::string& filename) {
+  Isolate* isolate = env->isolate();
+  Local<Context> context = env->context();
+  TryCatch try_catch(isolate);
+
+  std::vector<Local<String>> parameters = {
+      env->process_string(),
+      env->require_string(),
+      env->internal_binding_string(),
+      env->primordials_string()};
+  std::vector<Local<Value>> arguments = {
+      env->process_object(),
+      env->native_module_require(),
+      env->internal_binding_loader(),
+      env->primordials()};
+  Local<Value> run_entry;
+  Local<String> code;
+  Local<String> filename_string;
+  if (!ExecuteBootstrapper(
+           env, "internal/main/mksnapshot", &parameters, &arguments)
+           .ToLocal(&run_entry) ||
+      !String::NewFromUtf8(isolate, source.c_str(), NewStringType::kNormal,
+                           source.size()).ToLocal(&code) ||
+      !String::NewFromUtf8(isolate, filename.c_str(), NewStringType::kNormal,
+                           filename.size()).ToLocal(&filename_string)) {
+    PrintCaughtException(isolate, context, try_catch);
+    return false;
+  }
+  CHECK(run_entry->IsFunction());
+
+  ScriptOrigin origin(filename_string);
+  ScriptCompiler::Source script_source(code, origin);
+  Local<String> entry_parameters[] = {
+      env->require_string(),
+      FIXED_ONE_BYTE_STRING(isolate, "__filename"),
+      FIXED_ONE_BYTE_STRING(isolate, "__dirname")};
+  Local<Function> entry;
+  if (!ScriptCompiler::CompileFunctionInContext(context,
+                                                &script_source,
+                                                arraysize(entry_parameters),
+                                                entry_parameters,
+                                                0,
+                                                nullptr)
+           .ToLocal(&entry)) {
+    PrintCaughtException(isolate, context, try_catch);
+    return false;
+  }
+  Local<Value> run_entry_arguments[] = {entry, filename_string};
+  if (run_entry.As<Function>()
+          ->Call(context,
+                 Undefined(isolate),
+                 arraysize(run_entry_arguments),
+                 run_entry_arguments)
+          .IsEmpty() ||
+      !task_queue::RunNextTicksNative(env)) {
+    PrintCaughtException(isolate, context, try_catch);
+    return false;
+  }
+  return true;
+}
+
 std::string SnapshotBuilder::Generate(
     const std::vector<std::string> args,
-    const std::vector<std::string> exec_args) {
-  // TODO(joyeecheung): collect external references and set it in
-  // params.external_references.
-  std::vector<intptr_t> external_references = {
-      reinterpret_cast<intptr_t>(nullptr)};
+    const std::vector<std::string> exec_args,
+    OutputFormat format,
+    const std::string& entry_source,
+    const std::string& entry_filename) {
+  const std::vector<intptr_t>& external_references =
+      NodeMainInstance::CollectExternalReferences();
   Isolate* isolate = Isolate::Allocate();
   per_process::v8_platform.Platform()->RegisterIsolate(isolate,
                                                        uv_default_loop());
   std::unique_ptr<NodeMainInstance> main_instance;
   std::string result;
+  bool snapshotable = true;
 
   {
     std::vector<size_t> isolate_data_indexes;
+    EnvSerializeInfo env_info;
+    Environment* env;
     SnapshotCreator creator(isolate, external_references.data());
     {
       main_instance =
@@ -87,7 +216,31 @@ std::string SnapshotBuilder::Generate(
       creator.SetDefaultContext(Context::New(isolate));
       isolate_data_indexes = main_instance->isolate_data()->Serialize(&creator);
 
-      size_t index = creator.AddContext(NewContext(isolate));
+      Local<Context> context = NewContext(isolate);
+      Context::Scope context_scope(context);
+
+      // The Environment is bootstrapped here, so that the processes started
+      // from the snapshot deserialize it instead of running the bootstrap.
+      env = new Environment(main_instance->isolate_data(),
+                            context,
+                            args,
+                            exec_args,
+                            static_cast<Environment::Flags>(
+                                Environment::kIsMainThread |
+                                Environment::kOwnsProcessState |
+                                Environment::kOwnsInspector));
+      // The libuv handles of the Environment are set up like they are for
+      // the main instance, so that the entry can use timers. The snapshot is
+      // refused if any of them is left active.
+      env->InitializeLibuv(false);
+      snapshotable = !env->RunBootstrapping().IsEmpty();
+      if (snapshotable && !entry_source.empty())
+        snapshotable = RunEntry(env, entry_source, entry_filename);
+      snapshotable = snapshotable && env->IsSnapshotable();
+
+      env_info = env->Serialize(&creator);
+      size_t index = creator.AddContext(
+          context, {SerializeNodeContextInternalFields, env});
       CHECK_EQ(index, NodeMainInstance::kNodeContextIndex);
     }
 
@@ -97,8 +250,17 @@ std::string SnapshotBuilder::Generate(
     CHECK(blob.CanBeRehashed());
     // Must be done while the snapshot creator isolate is entered i.e. the
     // creator is still alive.
+    env->set_can_call_into_js(false);
+    FreeEnvironment(env);
     main_instance->Dispose();
-    result = FormatBlob(&blob, isolate_data_indexes);
+    if (!snapshotable) {
+      result = "";
+    } else if (format == OutputFormat::kBlob) {
+      result = NodeMainInstance::SerializeSnapshotBlob(
+          blob, isolate_data_indexes, env_info);
+    } else {
+      result = FormatBlob(&blob, isolate_data_indexes, env_info);
+    }
     delete[] blob.data;
   }
 
@@ -7,8 +7,23 @@
 namespace node {
 class SnapshotBuilder {
  public:
+  enum class OutputFormat {
+    // A C++ source file that embeds the snapshot into the binary.
+    kSource,
+    // A blob that can be loaded at runtime through --snapshot-blob.
+    kBlob
+  };
+
+  // The main context is bootstrapped before the snapshot is taken. If
+  // `entry_source` is not empty, it is run in that context afterwards, so
+  // that the state that it creates is part of the snapshot. Returns an empty
+  // string if the bootstrap or the entry throws, or if they leave native
+  // state behind that cannot be snapshotted.
   static std::string Generate(const std::vector<std::string> args,
-                              const std::vector<std::string> exec_args);
+                              const std::vector<std::string> exec_args,
+                              OutputFormat format = OutputFormat::kSource,
+                              const std::string& entry_source = "",
+                              const std::string& entry_filename = "");
 };
 }  // namespace node
 